@@ -0,0 +1,155 @@
+/*=============================================================================*/
+// EFastMath.h: Opt-in approximations of the libm based math in EVector2/EMathUtilities
+// (square roots, atan2, sin/cos) with bounded error, and a branch-free angle wrap.
+// The regular functions stay exact, hot paths switch to the Fast* variants where the error bounds are acceptable.
+/*=============================================================================*/
+#ifndef ELITE_MATH_FAST_MATH
+#define ELITE_MATH_FAST_MATH
+
+#include <cfloat>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define ELITE_FAST_MATH_SSE
+#endif
+
+namespace Elite
+{
+	namespace FastMathDetail
+	{
+		//Adding and subtracting 1.5 * 2^23 rounds to the nearest integer (ties to even) for |f| < 2^22
+		constexpr float RoundMagic = 12582912.f;
+		inline float Round(float f)
+		{
+			return (f + RoundMagic) - RoundMagic;
+		}
+
+		//Odd arctangent polynomial on [0, 1] (Abramowitz & Stegun 4.4.49), highest degree first, in powers of x^2
+		constexpr float AtanCoefficients[] = { -0.0040540580f, 0.0218612288f, -0.0559098861f, 0.0964200441f,
+			-0.1390853351f, 0.1994653599f, -0.3332985605f, 0.9999993329f };
+
+		//pi / 2 in three parts (Cody-Waite), the first ones short enough that quadrant * part is exact
+		constexpr float HalfPiPart1 = 1.5703125f;
+		constexpr float HalfPiPart2 = 4.837512969970703125e-4f;
+		constexpr float HalfPiPart3 = 7.54978995489188216e-8f;
+
+		//2 pi as the nearest float and the remainder: subtracting one turn of TwoPiHigh is exact
+		constexpr float TwoPiHigh = 6.2831854820251464844f;
+		constexpr float TwoPiLow = -1.7484556000744883e-7f;
+	}
+
+#pragma region SquareRoot
+	/*! Reciprocal square root: the SSE estimate refined by one Newton-Raphson step, relative error below 5e-7.
+		More accurate than InvSqrtFst, which starts from the bit trick estimate */
+	inline float FastInvSqrt(float f)
+	{
+#if defined(ELITE_FAST_MATH_SSE)
+		const float estimate = _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(f)));
+		return estimate * (1.5f - 0.5f * f * estimate * estimate);
+#else
+		return InvSqrt(f);
+#endif
+	}
+
+	/*! Square root through FastInvSqrt, 0 for 0 */
+	inline float FastSqrt(float f)
+	{
+		return f > 0.f ? f * FastInvSqrt(f) : 0.f;
+	}
+
+	inline float FastMagnitude(const Vector2& v)
+	{
+		return FastSqrt(v.MagnitudeSquared());
+	}
+
+	inline float FastDistance(const Vector2& v1, const Vector2& v2)
+	{
+		return FastSqrt(v1.DistanceSquared(v2));
+	}
+
+	/*! Same contract as Vector2::Normalize: returns the length, vectors shorter than FLT_EPSILON become zero */
+	inline float FastNormalize(Vector2& v)
+	{
+		const float magnitudeSqr = v.MagnitudeSquared();
+		if (magnitudeSqr <= FLT_EPSILON * FLT_EPSILON)
+		{
+			v = ZeroVector2;
+			return 0.f;
+		}
+		const float invMagnitude = FastInvSqrt(magnitudeSqr);
+		v *= invMagnitude;
+		return magnitudeSqr * invMagnitude;
+	}
+
+	inline Vector2 FastGetNormalized(const Vector2& v)
+	{
+		Vector2 normalized = v;
+		FastNormalize(normalized);
+		return normalized;
+	}
+#pragma endregion
+
+#pragma region Angles
+	/*! atan2 with an absolute error below 1e-6 radians, atan2(0, 0) is 0 */
+	inline float FastAtan2(float y, float x)
+	{
+		const float absX = fabsf(x);
+		const float absY = fabsf(y);
+		const float maxAbs = absX > absY ? absX : absY;
+		const float ratio = (absX < absY ? absX : absY) / (maxAbs > FLT_MIN ? maxAbs : FLT_MIN);
+		const float s = ratio * ratio;
+		float poly = 0.f;
+		for (const float coefficient : FastMathDetail::AtanCoefficients) poly = poly * s + coefficient;
+		float angle = poly * ratio;
+		if (absY > absX) angle = static_cast<float>(E_PI_2) - angle;
+		if (x < 0.f) angle = static_cast<float>(E_PI) - angle;
+		return y < 0.f ? -angle : angle;
+	}
+
+	/*! sin and cos at once, absolute error below 1e-6 for |radians| up to 1e4 (Cephes sinf/cosf polynomials) */
+	inline void FastSinCos(float radians, float& sine, float& cosine)
+	{
+		//Reduce to [-pi/4, pi/4] and the quadrant
+		const float quadrant = FastMathDetail::Round(radians * static_cast<float>(2.0 / E_PI));
+		const float r = ((radians - quadrant * FastMathDetail::HalfPiPart1) - quadrant * FastMathDetail::HalfPiPart2)
+			- quadrant * FastMathDetail::HalfPiPart3;
+		const float r2 = r * r;
+		const float sinR = ((-1.9515295891e-4f * r2 + 8.3321608736e-3f) * r2 - 1.6666654611e-1f) * r2 * r + r;
+		const float cosR = ((2.443315711809948e-5f * r2 - 1.388731625493765e-3f) * r2 + 4.166664568298827e-2f) * r2 * r2
+			- 0.5f * r2 + 1.f;
+		switch (static_cast<int>(quadrant) & 3)
+		{
+		case 0: sine = sinR; cosine = cosR; break;
+		case 1: sine = cosR; cosine = -sinR; break;
+		case 2: sine = -sinR; cosine = -cosR; break;
+		default: sine = -cosR; cosine = sinR; break;
+		}
+	}
+
+	inline float FastVectorToOrientation(const Vector2& vector)
+	{
+		return FastAtan2(vector.y, vector.x);
+	}
+
+	inline Vector2 FastOrientationToVector(float orientation)
+	{
+		Vector2 vector;
+		FastSinCos(orientation, vector.y, vector.x);
+		return vector;
+	}
+
+	/*! Wraps an angle to [-pi, pi] without loops or branches, the branch-free counterpart of ClampedAngle.
+		Within one turn (|radians| <= 2 pi) it gives the same floats as subtracting or adding 2 pi in double while the angle
+		is beyond +-pi. Further out the error stays below one ulp of radians */
+	inline float WrapAngle(float radians)
+	{
+		const float turns = FastMathDetail::Round(radians * static_cast<float>(0.5 / E_PI));
+		const float wrapped = (radians - turns * FastMathDetail::TwoPiHigh) - turns * FastMathDetail::TwoPiLow;
+		//float(pi) lies above pi, so +-float(pi) (a tie for the rounding above) still takes one more turn
+		const float pi = 0.5f * FastMathDetail::TwoPiHigh;
+		const float fixTurn = wrapped >= pi ? 1.f : (wrapped <= -pi ? -1.f : 0.f);
+		return (wrapped - fixTurn * FastMathDetail::TwoPiHigh) - fixTurn * FastMathDetail::TwoPiLow;
+	}
+#pragma endregion
+}
+#endif
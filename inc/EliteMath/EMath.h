@@ -10,12 +10,16 @@
 /* --- STANDARD --- */
 #include <math.h>
 /* --- UTILITIES --- */
+#include "ERandom.h"
 #include "EMathUtilities.h"
 /* --- TYPES --- */
 #include "EVector2.h"
 #include "EVector3.h"
 #include "EMat22.h"
 #include "FMatrix.h"
+/* --- ALGORITHMS --- */
+#include "ENearestPoint.h"
+#include "EFastMath.h"
 
 /* --- TYPE DEFINES --- */
 #endif
@@ -10,6 +10,7 @@
 #include <cstdlib>
 #include <cfloat>
 #include <type_traits>
+#include "ERandom.h"
 
 namespace Elite {
 	/* --- CONSTANTS --- */
@@ -110,6 +111,22 @@ namespace Elite {
 	inline float randomBinomial(float max = 1.f)
 	{ return randomFloat(max) - randomFloat(max); }
 
+	/*! Random Integer, from a seeded engine instead of the global rand() */
+	inline int randomInt(RandomEngine& rng, int max = 1)
+	{ return rng.NextInt(max); }
+
+	/*! Random Float, from a seeded engine instead of the global rand() */
+	inline float randomFloat(RandomEngine& rng, float max = 1.f)
+	{ return max * rng.NextFloat(); }
+
+	/*! Random Float, from a seeded engine instead of the global rand() */
+	inline float randomFloat(RandomEngine& rng, float min, float max)
+	{ return rng.NextFloat(min, max); }
+
+	/*! Random Binomial Float, from a seeded engine instead of the global rand() */
+	inline float randomBinomial(RandomEngine& rng, float max = 1.f)
+	{ return rng.NextBinomial(max); }
+
 	/*! Linear Interpolation */
 	/*inline float Lerp(float v0, float v1, float t)
 	{ return (1 - t) * v0 + t * v1;	}*/
@@ -0,0 +1,253 @@
+/*=============================================================================*/
+// ENearestPoint.h: Nearest point kernels (argmin of the squared distance to a position)
+// over packed coordinates, vectorized with AVX2 or SSE2 when the build allows it.
+/*=============================================================================*/
+#ifndef ELITE_MATH_NEAREST_POINT
+#define ELITE_MATH_NEAREST_POINT
+
+#include <cfloat>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define ELITE_NEAREST_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ELITE_NEAREST_SSE2
+#endif
+
+namespace Elite
+{
+	static_assert(sizeof(Vector2) == 2 * sizeof(float), "Nearest point kernels read Vector2 arrays as interleaved floats");
+
+	//Index value returned when there are no points
+	constexpr size_t NearestPointNone = static_cast<size_t>(-1);
+
+	//Name of the kernel the build uses, for benchmarks and logs
+	inline const char* NearestPointKernelName()
+	{
+#if defined(ELITE_NEAREST_AVX2)
+		return "AVX2";
+#elif defined(ELITE_NEAREST_SSE2)
+		return "SSE2";
+#else
+		return "scalar";
+#endif
+	}
+
+#pragma region Scalar
+	//Reference implementations, also used for the tails of the vector kernels.
+	//On equal distances the lowest index wins.
+	inline size_t FindNearestPointScalar(const float* xs, const float* ys, size_t count, const Vector2& position,
+		size_t first = 0, size_t bestIdx = NearestPointNone, float bestDistSqr = FLT_MAX)
+	{
+		for (size_t i = first; i < count; ++i)
+		{
+			const float dx = xs[i] - position.x;
+			const float dy = ys[i] - position.y;
+			const float distSqr = dx * dx + dy * dy;
+			if (distSqr < bestDistSqr)
+			{
+				bestDistSqr = distSqr;
+				bestIdx = i;
+			}
+		}
+		return bestIdx;
+	}
+
+	inline size_t FindNearestPointScalar(const Vector2* points, size_t count, const Vector2& position,
+		size_t first = 0, size_t bestIdx = NearestPointNone, float bestDistSqr = FLT_MAX)
+	{
+		for (size_t i = first; i < count; ++i)
+		{
+			const float dx = points[i].x - position.x;
+			const float dy = points[i].y - position.y;
+			const float distSqr = dx * dx + dy * dy;
+			if (distSqr < bestDistSqr)
+			{
+				bestDistSqr = distSqr;
+				bestIdx = i;
+			}
+		}
+		return bestIdx;
+	}
+#pragma endregion
+
+#pragma region Vectorized
+	namespace NearestPointDetail
+	{
+		//Picks the lane with the smallest distance (lowest index on ties), lanes that never matched hold index -1
+		inline void ReduceLanes(const float* dists, const int32_t* indices, int numLanes, float& bestDistSqr, size_t& bestIdx)
+		{
+			for (int lane = 0; lane < numLanes; ++lane)
+			{
+				const size_t idx = static_cast<size_t>(indices[lane]);
+				if (dists[lane] < bestDistSqr || (dists[lane] == bestDistSqr && idx < bestIdx))
+				{
+					bestDistSqr = dists[lane];
+					bestIdx = idx;
+				}
+			}
+		}
+	}
+
+#if defined(ELITE_NEAREST_AVX2)
+	inline size_t FindNearestPoint(const float* xs, const float* ys, size_t count, const Vector2& position)
+	{
+		const size_t vectorCount = count & ~static_cast<size_t>(7);
+		float bestDistSqr = FLT_MAX;
+		size_t bestIdx = NearestPointNone;
+		if (vectorCount > 0)
+		{
+			const __m256 px = _mm256_set1_ps(position.x);
+			const __m256 py = _mm256_set1_ps(position.y);
+			const __m256i step = _mm256_set1_epi32(8);
+			__m256i indices = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+			__m256 bestDists = _mm256_set1_ps(FLT_MAX);
+			__m256i bestIndices = _mm256_set1_epi32(-1);
+			for (size_t i = 0; i < vectorCount; i += 8)
+			{
+				const __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(xs + i), px);
+				const __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(ys + i), py);
+				const __m256 dists = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+				const __m256 closer = _mm256_cmp_ps(dists, bestDists, _CMP_LT_OQ);
+				bestDists = _mm256_blendv_ps(bestDists, dists, closer);
+				bestIndices = _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(bestIndices), _mm256_castsi256_ps(indices), closer));
+				indices = _mm256_add_epi32(indices, step);
+			}
+			alignas(32) float laneDists[8];
+			alignas(32) int32_t laneIndices[8];
+			_mm256_store_ps(laneDists, bestDists);
+			_mm256_store_si256(reinterpret_cast<__m256i*>(laneIndices), bestIndices);
+			NearestPointDetail::ReduceLanes(laneDists, laneIndices, 8, bestDistSqr, bestIdx);
+		}
+		return FindNearestPointScalar(xs, ys, count, position, vectorCount, bestIdx, bestDistSqr);
+	}
+
+	inline size_t FindNearestPoint(const Vector2* points, size_t count, const Vector2& position)
+	{
+		const size_t vectorCount = count & ~static_cast<size_t>(7);
+		float bestDistSqr = FLT_MAX;
+		size_t bestIdx = NearestPointNone;
+		if (vectorCount > 0)
+		{
+			const float* data = reinterpret_cast<const float*>(points);
+			const __m256 px = _mm256_set1_ps(position.x);
+			const __m256 py = _mm256_set1_ps(position.y);
+			const __m256i step = _mm256_set1_epi32(8);
+			//The in-lane shuffle below leaves the points in the order 0 1 4 5 2 3 6 7
+			__m256i indices = _mm256_setr_epi32(0, 1, 4, 5, 2, 3, 6, 7);
+			__m256 bestDists = _mm256_set1_ps(FLT_MAX);
+			__m256i bestIndices = _mm256_set1_epi32(-1);
+			for (size_t i = 0; i < vectorCount; i += 8)
+			{
+				const __m256 lo = _mm256_loadu_ps(data + 2 * i);
+				const __m256 hi = _mm256_loadu_ps(data + 2 * i + 8);
+				const __m256 dx = _mm256_sub_ps(_mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0)), px);
+				const __m256 dy = _mm256_sub_ps(_mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1)), py);
+				const __m256 dists = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+				const __m256 closer = _mm256_cmp_ps(dists, bestDists, _CMP_LT_OQ);
+				bestDists = _mm256_blendv_ps(bestDists, dists, closer);
+				bestIndices = _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(bestIndices), _mm256_castsi256_ps(indices), closer));
+				indices = _mm256_add_epi32(indices, step);
+			}
+			alignas(32) float laneDists[8];
+			alignas(32) int32_t laneIndices[8];
+			_mm256_store_ps(laneDists, bestDists);
+			_mm256_store_si256(reinterpret_cast<__m256i*>(laneIndices), bestIndices);
+			NearestPointDetail::ReduceLanes(laneDists, laneIndices, 8, bestDistSqr, bestIdx);
+		}
+		return FindNearestPointScalar(points, count, position, vectorCount, bestIdx, bestDistSqr);
+	}
+#elif defined(ELITE_NEAREST_SSE2)
+	namespace NearestPointDetail
+	{
+		//SSE2 has no blendv
+		inline __m128 Select(__m128 mask, __m128 a, __m128 b)
+		{
+			return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+		}
+	}
+
+	inline size_t FindNearestPoint(const float* xs, const float* ys, size_t count, const Vector2& position)
+	{
+		const size_t vectorCount = count & ~static_cast<size_t>(3);
+		float bestDistSqr = FLT_MAX;
+		size_t bestIdx = NearestPointNone;
+		if (vectorCount > 0)
+		{
+			const __m128 px = _mm_set1_ps(position.x);
+			const __m128 py = _mm_set1_ps(position.y);
+			const __m128i step = _mm_set1_epi32(4);
+			__m128i indices = _mm_setr_epi32(0, 1, 2, 3);
+			__m128 bestDists = _mm_set1_ps(FLT_MAX);
+			__m128 bestIndices = _mm_castsi128_ps(_mm_set1_epi32(-1));
+			for (size_t i = 0; i < vectorCount; i += 4)
+			{
+				const __m128 dx = _mm_sub_ps(_mm_loadu_ps(xs + i), px);
+				const __m128 dy = _mm_sub_ps(_mm_loadu_ps(ys + i), py);
+				const __m128 dists = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+				const __m128 closer = _mm_cmplt_ps(dists, bestDists);
+				bestDists = _mm_min_ps(dists, bestDists);
+				bestIndices = NearestPointDetail::Select(closer, _mm_castsi128_ps(indices), bestIndices);
+				indices = _mm_add_epi32(indices, step);
+			}
+			alignas(16) float laneDists[4];
+			alignas(16) int32_t laneIndices[4];
+			_mm_store_ps(laneDists, bestDists);
+			_mm_store_si128(reinterpret_cast<__m128i*>(laneIndices), _mm_castps_si128(bestIndices));
+			NearestPointDetail::ReduceLanes(laneDists, laneIndices, 4, bestDistSqr, bestIdx);
+		}
+		return FindNearestPointScalar(xs, ys, count, position, vectorCount, bestIdx, bestDistSqr);
+	}
+
+	inline size_t FindNearestPoint(const Vector2* points, size_t count, const Vector2& position)
+	{
+		const size_t vectorCount = count & ~static_cast<size_t>(3);
+		float bestDistSqr = FLT_MAX;
+		size_t bestIdx = NearestPointNone;
+		if (vectorCount > 0)
+		{
+			const float* data = reinterpret_cast<const float*>(points);
+			const __m128 px = _mm_set1_ps(position.x);
+			const __m128 py = _mm_set1_ps(position.y);
+			const __m128i step = _mm_set1_epi32(4);
+			__m128i indices = _mm_setr_epi32(0, 1, 2, 3);
+			__m128 bestDists = _mm_set1_ps(FLT_MAX);
+			__m128 bestIndices = _mm_castsi128_ps(_mm_set1_epi32(-1));
+			for (size_t i = 0; i < vectorCount; i += 4)
+			{
+				//x0 y0 x1 y1 | x2 y2 x3 y3 -> x0 x1 x2 x3 and y0 y1 y2 y3
+				const __m128 lo = _mm_loadu_ps(data + 2 * i);
+				const __m128 hi = _mm_loadu_ps(data + 2 * i + 4);
+				const __m128 dx = _mm_sub_ps(_mm_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0)), px);
+				const __m128 dy = _mm_sub_ps(_mm_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1)), py);
+				const __m128 dists = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+				const __m128 closer = _mm_cmplt_ps(dists, bestDists);
+				bestDists = _mm_min_ps(dists, bestDists);
+				bestIndices = NearestPointDetail::Select(closer, _mm_castsi128_ps(indices), bestIndices);
+				indices = _mm_add_epi32(indices, step);
+			}
+			alignas(16) float laneDists[4];
+			alignas(16) int32_t laneIndices[4];
+			_mm_store_ps(laneDists, bestDists);
+			_mm_store_si128(reinterpret_cast<__m128i*>(laneIndices), _mm_castps_si128(bestIndices));
+			NearestPointDetail::ReduceLanes(laneDists, laneIndices, 4, bestDistSqr, bestIdx);
+		}
+		return FindNearestPointScalar(points, count, position, vectorCount, bestIdx, bestDistSqr);
+	}
+#else
+	inline size_t FindNearestPoint(const float* xs, const float* ys, size_t count, const Vector2& position)
+	{
+		return FindNearestPointScalar(xs, ys, count, position);
+	}
+
+	inline size_t FindNearestPoint(const Vector2* points, size_t count, const Vector2& position)
+	{
+		return FindNearestPointScalar(points, count, position);
+	}
+#endif
+#pragma endregion
+}
+#endif
@@ -0,0 +1,94 @@
+/*=============================================================================*/
+// ERandom.h: Small seeded random engine (PCG32) for per-agent random streams.
+// Unlike rand() it keeps no global state and takes no lock, and a seed gives the same numbers on every platform.
+/*=============================================================================*/
+#ifndef ELITE_MATH_RANDOM
+#define ELITE_MATH_RANDOM
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Elite
+{
+	/*! PCG32 (XSH RR variant, pcg-random.org): 64 bit state and 32 bit output.
+	Every stream is a different sequence, so engines with the same seed but another stream don't correlate.
+	Also a UniformRandomBitGenerator, but the members below are preferred: the std distributions differ per standard library. */
+	class RandomEngine final
+	{
+	public:
+		using result_type = uint32_t;
+
+		explicit RandomEngine(uint64_t seed = DefaultSeed, uint64_t stream = DefaultStream)
+		{ Seed(seed, stream); }
+
+		void Seed(uint64_t seed, uint64_t stream = DefaultStream)
+		{
+			m_State = 0;
+			m_Increment = (stream << 1u) | 1u;
+			Next();
+			m_State += seed;
+			Next();
+		}
+
+		/*! Next 32 random bits */
+		uint32_t Next()
+		{
+			const uint64_t oldState = m_State;
+			m_State = oldState * Multiplier + m_Increment;
+			const uint32_t xorShifted = static_cast<uint32_t>(((oldState >> 18u) ^ oldState) >> 27u);
+			const uint32_t rotation = static_cast<uint32_t>(oldState >> 59u);
+			return (xorShifted >> rotation) | (xorShifted << ((32u - rotation) & 31u));
+		}
+		result_type operator()() { return Next(); }
+		static constexpr result_type min() { return 0; }
+		static constexpr result_type max() { return UINT32_MAX; }
+
+		/*! Uniform float in [0, 1), uses the top 24 bits so every value is exact */
+		float NextFloat()
+		{ return static_cast<float>(Next() >> 8u) * (1.f / 16777216.f); }
+
+		/*! Uniform float in [min, max) */
+		float NextFloat(float min, float max)
+		{ return min + (max - min) * NextFloat(); }
+
+		/*! Uniform integer in [0, max), max has to be positive. Multiply and shift instead of %, the bias is below 2^-32 * max */
+		int NextInt(int max)
+		{ return static_cast<int>((static_cast<uint64_t>(Next()) * static_cast<uint32_t>(max)) >> 32u); }
+
+		/*! Float in (-max, max), the difference of two uniforms so values near 0 are the most likely */
+		float NextBinomial(float max = 1.f)
+		{
+			const float a = NextFloat();
+			return max * (a - NextFloat());
+		}
+
+		/*! Fills pOut with count binomial floats in one go. Same values as count NextBinomial calls, but the state
+		stays in a register and the float math of the whole batch vectorizes */
+		void FillBinomial(float* pOut, size_t count, float max = 1.f)
+		{
+			constexpr size_t batchSize = 32;
+			uint32_t bits[2 * batchSize];
+			for (size_t first{}; first < count; first += batchSize)
+			{
+				const size_t num = count - first < batchSize ? count - first : batchSize;
+				for (size_t i{}; i < 2 * num; ++i) bits[i] = Next();
+				for (size_t i{}; i < num; ++i)
+				{
+					const float a = static_cast<float>(bits[2 * i] >> 8u) * (1.f / 16777216.f);
+					const float b = static_cast<float>(bits[2 * i + 1] >> 8u) * (1.f / 16777216.f);
+					pOut[first + i] = max * (a - b);
+				}
+			}
+		}
+
+		static constexpr uint64_t DefaultSeed = 0x853c49e6748fea9bULL;
+		static constexpr uint64_t DefaultStream = 0xda3e39cb94b95bdbULL;
+
+	private:
+		static constexpr uint64_t Multiplier = 6364136223846793005ULL;
+
+		uint64_t m_State = 0;
+		uint64_t m_Increment = 0;
+	};
+}
+#endif
@@ -106,10 +106,10 @@ namespace Elite
 		inline auto GetAbs() const
 		{ return Vector2(abs(x), abs(y)); }
 
-		inline auto MagnitudeSquared() const
+		inline float MagnitudeSquared() const
 		{ return x*x + y*y;	}
 
-		inline auto Magnitude() const
+		inline float Magnitude() const
 		{ return sqrtf(MagnitudeSquared()); }
 
 		inline float Normalize()
@@ -2,47 +2,42 @@
 #include "IExamInterface.h"
 
 #include "Agent.h"
+#include "BlackboardKeys.h"
 #include "MapSearchSystem.h"
+#include "Profiler.h"
 #include "DecisionMaking/BehaviorActions.h"
 #include "DecisionMaking/BehaviorCondition.h"
 #include "DecisionMaking/BehaviorTree.h"
 #include "DecisionMaking/BTComposites.h"
 #include "DecisionMaking/BTDecorators.h"
-#include "Steering/CombinedSteeringBehaviors.h"
+#include "Steering/AgentSteering.h"
 #include "Steering/SteeringBehaviors.h"
 #include "Steering/SteeringHelpers.h"
 
-Agent::Agent(IExamInterface *const pInterface): m_pInterface(pInterface)
+Agent::Agent(IExamInterface *const pInterface, uint64_t seed):
+    m_pInterface(pInterface),
+    m_Rng(seed),
+    m_BlendedSeekAndWanderSteeringBehavior(m_SeekSteeringBehavior, m_WanderSteeringBehavior),
+    m_BlendedSeekAndEvadeSteeringBehavior(m_SeekSteeringBehavior, m_EvadeBehavior),
+    m_PrioritySteeringBehavior(m_BlendedSeekAndWanderSteeringBehavior, m_SeekSteeringBehavior,
+                               m_FleeWhileFacingSteeringBehavior, m_FaceBehavior, m_WanderSteeringBehavior,
+                               m_BlendedSeekAndEvadeSteeringBehavior),
+    m_MapSearch(pInterface->Agent_GetInfo()),
+    m_FrameQueries(&m_FrameSnapshot),
+    m_Inventory(pInterface),
+    m_BehaviorTree(&m_Blackboard, CreateBehaviorTree(), false)
 {
-    m_pEvadeBehavior = new Evade();
-    m_pSeekSteeringBehavior = new Seek();
-    m_pBlendedSeekAndEvadeSteeringBehavior = new BlendedSteering({
-        {m_pSeekSteeringBehavior, 0.4f}, {m_pEvadeBehavior, 0.6f}
-    });
-    m_pWanderSteeringBehavior = new Wander();
-    m_pFleeWhileFacingSteeringBehavior = new FleeWhileFacing();
-    m_pBlendedSeekAndWanderSteeringBehavior = new BlendedSteering({
-        {m_pSeekSteeringBehavior, 0.8f}, {m_pWanderSteeringBehavior, 0.2f}
-    });
-    m_pFaceBehavior = new Face();
-    m_pPrioritySteeringBehavior = new PrioritySteering({
-        m_pBlendedSeekAndWanderSteeringBehavior, m_pSeekSteeringBehavior, m_pFleeWhileFacingSteeringBehavior,
-        m_pFaceBehavior, m_pWanderSteeringBehavior, m_pBlendedSeekAndEvadeSteeringBehavior
-    });
-    m_pMapSearch = new MapSearchSystem(pInterface->Agent_GetInfo());
-
-    CreateBehaviorTree();
+    m_WanderSteeringBehavior.SetRandomEngine(&m_Rng);
+    FillBlackboard();
+    BT_Conditions::ObserveDependencies(&m_BehaviorTree);
+    BT_Conditions::NameFunctions(&m_BehaviorTree);
+    BT_Actions::NameFunctions(&m_BehaviorTree);
 }
 
-Agent::~Agent()
+void Agent::SetPathCostRanking(bool isEnabled)
 {
-    SAFE_DELETE(m_pWanderSteeringBehavior);
-    SAFE_DELETE(m_pSeekSteeringBehavior);
-    SAFE_DELETE(m_pFleeWhileFacingSteeringBehavior);
-    SAFE_DELETE(m_pBlendedSeekAndWanderSteeringBehavior);
-    SAFE_DELETE(m_pPrioritySteeringBehavior);
-    SAFE_DELETE(m_pBehaviorTree);
-    SAFE_DELETE(m_pFaceBehavior);
+    if (isEnabled) m_MapSearch.EnablePathCostRanking(m_pInterface->World_GetInfo());
+    else m_MapSearch.DisablePathCostRanking();
 }
 
 void Agent::UpdateDebug(float dt)
@@ -62,20 +57,22 @@ void Agent::UpdateDebug(float dt)
 
 void Agent::Update(float dt)
 {
+    EXAM_PROFILE_SCOPE("Agent::Update");
     // check if the target has been reached
-    m_pMapSearch->Update(dt);
-    m_pBlackboard->GetData("currentTarget", m_CurrTarget);
-    if (m_CurrTarget.has_value() && m_CurrTarget.value().DistanceSquared(m_pInterface->Agent_GetInfo().Position) <=
-        16.f)
+    m_MapSearch.Update(dt);
+    m_Blackboard.GetData(BlackboardKeys::CurrentTarget, m_CurrTarget);
+    const AgentInfo &agentInfo = m_FrameSnapshot.GetAgentInfo();
+    if (m_CurrTarget.has_value() && m_CurrTarget.value().DistanceSquared(agentInfo.Position) <= 16.f)
     {
-        m_pMapSearch->ReachedTarget(m_CurrTarget.value());
+        m_MapSearch.ReachedTarget(m_CurrTarget.value());
         Elite::Vector2 targetPos;
-        m_pMapSearch->GetCurrentTarget(m_pInterface->Agent_GetInfo().Position, targetPos);
+        m_MapSearch.GetCurrentTarget(agentInfo.Position, targetPos);
         m_CurrTarget = targetPos;
     }
-    m_pBlackboard->ChangeData("wasBitten", m_pInterface->Agent_GetInfo().WasBitten);
+    m_Blackboard.ChangeData(BlackboardKeys::WasBitten, agentInfo.WasBitten);
     SetChaseData(dt);
-    m_pBehaviorTree->Update();
+    EXAM_PROFILE_SCOPE("BehaviorTree::Update");
+    m_BehaviorTree.Update();
 }
 
 void Agent::RenderDebug(float dt) const
@@ -84,53 +81,81 @@ void Agent::RenderDebug(float dt) const
     if (m_CurrTarget.has_value()) m_pInterface->Draw_SolidCircle(m_CurrTarget.value(), 2.f, {0, 0}, {1, 1, 1});
 
     Elite::Vector2 lastEnemyPos;
-    m_pBlackboard->GetData("lastEnemyPos", lastEnemyPos);
+    m_Blackboard.GetData(BlackboardKeys::LastEnemyPos, lastEnemyPos);
     m_pInterface->Draw_SolidCircle(lastEnemyPos, 1.f, {0, 0}, {52.f / 255.f, 213.f / 255.f, 235.f / 255.f});
-    m_pMapSearch->RenderDebug(m_pInterface);
+    m_MapSearch.RenderDebug(m_pInterface);
 }
 
 SteeringOutput Agent::GetSteeringOutput(float dt)
 {
-    auto agentInfo = m_pInterface->Agent_GetInfo();
-    auto steering = m_pPrioritySteeringBehavior->CalculateSteering(agentInfo);
+    EXAM_PROFILE_SCOPE("Agent::GetSteeringOutput");
+    const AgentInfo &agentInfo = m_FrameSnapshot.GetAgentInfo();
+    auto steering = m_PrioritySteeringBehavior.CalculateSteering(agentInfo);
     HandleRadarMode(dt, steering);
     return steering;
 }
 
-Elite::Blackboard *Agent::CreateBlackboard() const
+void Agent::CaptureFrameSnapshot()
+{
+    EXAM_PROFILE_SCOPE("Agent::CaptureFrameSnapshot");
+    m_FrameSnapshot.Capture(m_pInterface);
+    m_FrameQueries.Invalidate();
+
+    // Wakes up the observed conditions of the event-driven BT that read a field that changed
+    const std::pair<SnapshotField, const Elite::BlackboardChannel*> channels[]{
+        {SnapshotField::AgentInfo, &BlackboardKeys::SnapshotAgentInfo},
+        {SnapshotField::FOVStats, &BlackboardKeys::SnapshotFOVStats},
+        {SnapshotField::HousesInFOV, &BlackboardKeys::SnapshotHousesInFOV},
+        {SnapshotField::EnemiesInFOV, &BlackboardKeys::SnapshotEnemiesInFOV},
+        {SnapshotField::ItemsInFOV, &BlackboardKeys::SnapshotItemsInFOV},
+        {SnapshotField::PurgeZonesInFOV, &BlackboardKeys::SnapshotPurgeZonesInFOV}
+    };
+    for (const auto &[field, pChannel]: channels)
+    {
+        if (m_FrameSnapshot.HasChanged(field)) m_Blackboard.MarkChanged(*pChannel);
+    }
+}
+
+void Agent::MarkInventoryChanged()
+{
+    m_Blackboard.MarkChanged(BlackboardKeys::Inventory);
+}
+
+void Agent::FillBlackboard()
 {
-    Elite::Blackboard *const pBlackboard = new Elite::Blackboard();
-    pBlackboard->AddData("interface", m_pInterface);
-    pBlackboard->AddData("prioritySteering", m_pPrioritySteeringBehavior);
-    pBlackboard->AddData("isBeingChased", false);
+    Elite::Blackboard *const pBlackboard = &m_Blackboard;
+    pBlackboard->AddData(BlackboardKeys::Interface, m_pInterface);
+    pBlackboard->AddData(BlackboardKeys::PrioritySteering, &m_PrioritySteeringBehavior);
+    pBlackboard->AddData(BlackboardKeys::Snapshot, &m_FrameSnapshot);
+    pBlackboard->AddData(BlackboardKeys::Queries, &m_FrameQueries);
+    pBlackboard->AddData(BlackboardKeys::PathCache, &m_PathCache);
+    pBlackboard->AddData(BlackboardKeys::InventoryMirror, &m_Inventory);
+    pBlackboard->AddData(BlackboardKeys::RandomEngine, &m_Rng);
+    pBlackboard->AddData(BlackboardKeys::IsBeingChased, false);
     std::vector<EnemyInfo> enemiesInFov{};
-    pBlackboard->AddData("enemiesInFovInfo", enemiesInFov);
-    pBlackboard->AddData("lastEnemyPos", Elite::Vector2(0, 0));
-    pBlackboard->AddData("shotLastFrame", false);
-    pBlackboard->AddData("radarMode", false);
-    pBlackboard->AddData("wasBitten", false);
-    pBlackboard->AddData("mapSearch", m_pMapSearch);
-    pBlackboard->AddData("currentTarget", m_CurrTarget);
+    pBlackboard->AddData(BlackboardKeys::EnemiesInFovInfo, enemiesInFov);
+    pBlackboard->AddData(BlackboardKeys::LastEnemyPos, Elite::Vector2(0, 0));
+    pBlackboard->AddData(BlackboardKeys::ShotLastFrame, false);
+    pBlackboard->AddData(BlackboardKeys::RadarMode, false);
+    pBlackboard->AddData(BlackboardKeys::WasBitten, false);
+    pBlackboard->AddData(BlackboardKeys::MapSearch, &m_MapSearch);
+    pBlackboard->AddData(BlackboardKeys::CurrentTarget, m_CurrTarget);
     std::optional<eItemType> itemTarget;
-    pBlackboard->AddData("targetItemType", itemTarget);
+    pBlackboard->AddData(BlackboardKeys::TargetItemType, itemTarget);
     std::map<eItemType, bool> itemNeedList{};
     itemNeedList[eItemType::PISTOL] = false;
     itemNeedList[eItemType::SHOTGUN] = false;
     itemNeedList[eItemType::FOOD] = false;
     itemNeedList[eItemType::MEDKIT] = false;
-    pBlackboard->AddData("itemNeedList", itemNeedList);
-    pBlackboard->AddData("itemSeekList", std::vector<ItemInfo>{});
-    pBlackboard->AddData("itemsInFOV", 0);
-    pBlackboard->AddData("currentItemInFOV", 0);
-    return pBlackboard;
+    pBlackboard->AddData(BlackboardKeys::ItemNeedList, itemNeedList);
+    pBlackboard->AddData(BlackboardKeys::ItemSeekList, std::vector<ItemInfo>{});
+    pBlackboard->AddData(BlackboardKeys::ItemsInFOV, 0);
+    pBlackboard->AddData(BlackboardKeys::CurrentItemInFOV, 0);
 }
 
-void Agent::CreateBehaviorTree()
+Elite::IBehavior *Agent::CreateBehaviorTree()
 {
-    m_pBlackboard = CreateBlackboard();
-    m_pBehaviorTree = new Elite::BehaviorTree(
-        m_pBlackboard,
-        new Elite::BehaviorSelector({
+    return new Elite::BehaviorSelector({
             // Use item
             new Elite::BehaviorForceFailure(new Elite::BehaviorAction(BT_Actions::UseItemIfNeeded)),
             // Purge zone action
@@ -225,20 +250,19 @@ void Agent::CreateBehaviorTree()
             new Elite::BehaviorAction(BT_Actions::Wander)
             // DEBUG Steering
            // new Elite::BehaviorAction(BT_Actions::SetDebugSteering)
-        })
-    );
+        });
 }
 
 void Agent::SetChaseData(float dt)
 {
     bool isBeingChased;
-    m_pBlackboard->GetData("isBeingChased", isBeingChased);
+    m_Blackboard.GetData(BlackboardKeys::IsBeingChased, isBeingChased);
     //std::cout<<isBeingChased<<"\n";
-    if (m_pInterface->FOV_GetStats().NumEnemies > 0)
+    if (m_FrameSnapshot.GetFOVStats().NumEnemies > 0)
     {
         m_CurrChaseTime = 0.f;
-        m_pBlackboard->ChangeData("isBeingChased", true);
-        m_pBlackboard->ChangeData("lastEnemyPos", m_pInterface->GetEnemiesInFOV()[0].Location);
+        m_Blackboard.ChangeData(BlackboardKeys::IsBeingChased, true);
+        m_Blackboard.ChangeData(BlackboardKeys::LastEnemyPos, m_FrameSnapshot.GetEnemiesInFOV()[0].Location);
         return;
     }
     if (isBeingChased)
@@ -247,21 +271,21 @@ void Agent::SetChaseData(float dt)
         if (m_CurrChaseTime > m_MaxChaseTime)
         {
             m_CurrChaseTime = 0.f;
-            m_pBlackboard->ChangeData("isBeingChased", false);
+            m_Blackboard.ChangeData(BlackboardKeys::IsBeingChased, false);
         }
     }
 }
 
-void Agent::HandleRadarMode(float dt, SteeringOutput &steeringOutput) const
+void Agent::HandleRadarMode(float dt, SteeringOutput &steeringOutput)
 {
     bool radarMode;
-    m_pBlackboard->GetData("radarMode", radarMode);
+    m_Blackboard.GetData(BlackboardKeys::RadarMode, radarMode);
 
     if (radarMode)
     {
         steeringOutput.AutoOrient = false;
-        steeringOutput.AngularVelocity = m_pInterface->Agent_GetInfo().MaxAngularSpeed;
+        steeringOutput.AngularVelocity = m_FrameSnapshot.GetAgentInfo().MaxAngularSpeed;
     }
     //reset at the end of the frame
-    m_pBlackboard->ChangeData("radarMode", false);
+    m_Blackboard.ChangeData(BlackboardKeys::RadarMode, false);
 }
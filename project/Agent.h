@@ -1,56 +1,76 @@
 #pragma once
+#include <cstdint>
 #include <optional>
-class Flee;
-class Evade;
-class Face;
-class MapSearchSystem;
+#include "FrameQueries.h"
+#include "FrameSnapshot.h"
+#include "InventoryMirror.h"
+#include "MapSearchSystem.h"
+#include "PathPointCache.h"
+#include "DecisionMaking/BehaviorTree.h"
+#include "Steering/AgentSteering.h"
 class IExamInterface;
 struct SteeringOutput;
-class FleeWhileFacing;
-class Seek;
-class Wander;
-class PrioritySteering;
-class BlendedSteering;
-
-namespace Elite
-{
-    class BehaviorTree;
-    class Blackboard;
-}
 
 class Agent final {
 public:
-    explicit Agent(IExamInterface* pInterface);
-    ~Agent();
+    // The seed starts the agent's own random stream, the only randomness its decisions use,
+    // so the same seed on the same world replays the run
+    Agent(IExamInterface* pInterface, uint64_t seed);
+    ~Agent() = default;
+
+    // The blackboard and the steering behaviors point into the Agent, so it can't be copied or moved
+    Agent(const Agent&) = delete;
+    Agent& operator=(const Agent&) = delete;
+    Agent(Agent&&) = delete;
+    Agent& operator=(Agent&&) = delete;
+
     void UpdateDebug(float dt);
     void Update(float dt);
     void RenderDebug(float dt) const;
     SteeringOutput GetSteeringOutput(float dt);
+    // Has to run before Update, every query of this frame is served from the snapshot
+    void CaptureFrameSnapshot();
+    // For inventory changes made outside of the BT actions, they have to go through GetInventory too
+    void MarkInventoryChanged();
+    [[nodiscard]] InventoryMirror& GetInventory() { return m_Inventory; }
+    [[nodiscard]] const InventoryMirror& GetInventory() const { return m_Inventory; }
+    [[nodiscard]] const FrameSnapshot& GetFrameSnapshot() const { return m_FrameSnapshot; }
+    [[nodiscard]] const FrameQueries& GetFrameQueries() const { return m_FrameQueries; }
+    // Ranks the search targets by path cost around the found houses instead of by distance, off by default
+    void SetPathCostRanking(bool isEnabled);
+    [[nodiscard]] bool IsPathCostRankingEnabled() const { return m_MapSearch.IsPathCostRankingEnabled(); }
+    [[nodiscard]] PathPointCache& GetPathCache() { return m_PathCache; }
+    [[nodiscard]] const PathPointCache& GetPathCache() const { return m_PathCache; }
+    [[nodiscard]] Elite::BehaviorTree* GetBehaviorTree() { return &m_BehaviorTree; }
+    [[nodiscard]] const Elite::BehaviorTree* GetBehaviorTree() const { return &m_BehaviorTree; }
 private:
     Elite::Vector2 m_MouseTarget;
     std::optional<Elite::Vector2> m_CurrTarget{};
 	IExamInterface* m_pInterface = nullptr;
-    MapSearchSystem* m_pMapSearch = nullptr;
-    [[nodiscard]] Elite::Blackboard* CreateBlackboard() const;
-    void CreateBehaviorTree();
+    FrameSnapshot m_FrameSnapshot{};
+    void FillBlackboard();
+    [[nodiscard]] static Elite::IBehavior* CreateBehaviorTree();
     // Checks the FOV every frame for enemies
     void SetChaseData(float dt);
-    void HandleRadarMode(float dt, SteeringOutput& steeringOutput) const;
+    void HandleRadarMode(float dt, SteeringOutput& steeringOutput);
 
-    Elite::Blackboard* m_pBlackboard = nullptr;
     const float m_MaxChaseTime = 5.f;
     float m_CurrChaseTime = 0.f;
 
-    Elite::BehaviorTree* m_pBehaviorTree = nullptr;
-    BlendedSteering* m_pBlendedSeekAndWanderSteeringBehavior;
-    BlendedSteering* m_pBlendedSeekAndEvadeSteeringBehavior;
-    PrioritySteering* m_pPrioritySteeringBehavior;
-    Wander* m_pWanderSteeringBehavior;
-    Seek* m_pSeekSteeringBehavior;
-    Face* m_pFaceBehavior;
-    Evade* m_pEvadeBehavior;
-    FleeWhileFacing* m_pFleeWhileFacingSteeringBehavior;
+    // Everything the agent owns is stored inline, an AgentPool keeps all of it in one contiguous array
+    Elite::RandomEngine m_Rng;
+    Wander m_WanderSteeringBehavior{};
+    Seek m_SeekSteeringBehavior{};
+    Face m_FaceBehavior{};
+    Evade m_EvadeBehavior{};
+    FleeWhileFacing m_FleeWhileFacingSteeringBehavior{};
+    SeekAndWanderSteering m_BlendedSeekAndWanderSteeringBehavior;
+    SeekAndEvadeSteering m_BlendedSeekAndEvadeSteeringBehavior;
+    AgentSteering m_PrioritySteeringBehavior;
+    MapSearchSystem m_MapSearch;
+    Elite::Blackboard m_Blackboard{};
+    FrameQueries m_FrameQueries;
+    PathPointCache m_PathCache{};
+    InventoryMirror m_Inventory;
+    Elite::BehaviorTree m_BehaviorTree;
 };
-
-
-
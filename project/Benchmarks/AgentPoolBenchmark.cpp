@@ -0,0 +1,69 @@
+#include "../stdafx.h"
+#include "Benchmark.h"
+#include "../Headless/AgentPool.h"
+
+EXAM_BENCHMARK(AgentPoolThroughput)
+{
+    // Agent frames per second on one core, GodMode keeps every agent ticking for the whole run
+    constexpr int numFrames = 600;
+    constexpr float dt = 1.f / 60.f;
+    for (const int numAgents: {1, 16, 128, 512})
+    {
+        HeadlessWorldParams params{};
+        params.GodMode = true;
+
+        using Clock = std::chrono::steady_clock;
+        const auto setupStart = Clock::now();
+        AgentPool pool{numAgents, params};
+        const double setupMs = std::chrono::duration<double, std::milli>(Clock::now() - setupStart).count();
+
+        const auto start = Clock::now();
+        for (int frame{}; frame < numFrames; ++frame) pool.Tick(dt);
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+        const double agentFrames = static_cast<double>(pool.GetNumAgentFrames());
+        const std::string label = std::to_string(numAgents) + " agents x " + std::to_string(numFrames) + " frames";
+        printf("  %-48s %12.2f ns/op %14.0f agent frames/s (setup %.1f ms)\n", label.c_str(),
+               seconds * 1e9 / agentFrames, agentFrames / seconds, setupMs);
+    }
+}
+
+EXAM_BENCHMARK(AgentPoolScaling)
+{
+    // Agent frames per second from 1 to 64 threads on the same pool. Agents die on their own here,
+    // so the chunks get uneven and the threads have to steal. Every thread count has to end in the same place
+    constexpr int numAgents = 512;
+    constexpr int numFrames = 600;
+    constexpr float dt = 1.f / 60.f;
+    printf("  %u hardware threads\n", std::thread::hardware_concurrency());
+    double singleThreadRate{};
+    long long singleThreadScore{};
+    for (const int numThreads: {1, 2, 4, 8, 16, 32, 64})
+    {
+        AgentPool pool{numAgents, HeadlessWorldParams{}, Elite::BehaviorTreeBackend::Virtual, numThreads};
+
+        using Clock = std::chrono::steady_clock;
+        const auto start = Clock::now();
+        for (int frame{}; frame < numFrames && pool.GetNumAlive() > 0; ++frame) pool.Tick(dt);
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+        long long totalScore{};
+        for (int i{}; i < numAgents; ++i) totalScore += pool.GetWorld(i).GetStats().Score;
+        const double rate = static_cast<double>(pool.GetNumAgentFrames()) / seconds;
+        if (numThreads == 1)
+        {
+            singleThreadRate = rate;
+            singleThreadScore = totalScore;
+        }
+        else if (totalScore != singleThreadScore)
+        {
+            printf("  ERROR: %d threads ended with another score than 1 thread\n", numThreads);
+        }
+
+        const double speedup = rate / singleThreadRate;
+        const std::string label = std::to_string(numThreads) + " threads, " + std::to_string(numAgents) + " agents";
+        printf("  %-48s %14.0f agent frames/s  speedup %5.2fx  efficiency %5.1f%%  steals %llu\n", label.c_str(),
+               rate, speedup, 100.0 * speedup / numThreads,
+               static_cast<unsigned long long>(pool.GetJobSystem().GetNumSteals()));
+    }
+}
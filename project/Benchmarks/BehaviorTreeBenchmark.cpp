@@ -0,0 +1,194 @@
+#include "../stdafx.h"
+#include "Benchmark.h"
+#include "../Agent.h"
+#include "../SurvivalAgentPlugin.h"
+#include "../DecisionMaking/BehaviorTree.h"
+#include "../DecisionMaking/BTComposites.h"
+#include "../DecisionMaking/BTDecorators.h"
+#include "../DecisionMaking/FlatBehaviorTree.h"
+#include "../Headless/HeadlessInterface.h"
+#include "../Headless/HeadlessWorld.h"
+
+namespace
+{
+    constexpr float Dt = 1.f / 60.f;
+
+    constexpr Elite::BehaviorTreeBackend Backends[]{
+        Elite::BehaviorTreeBackend::Virtual, Elite::BehaviorTreeBackend::Flat, Elite::BehaviorTreeBackend::EventDriven
+    };
+
+    const char* GetBackendName(Elite::BehaviorTreeBackend backend)
+    {
+        switch (backend)
+        {
+            case Elite::BehaviorTreeBackend::Flat: return "flat";
+            case Elite::BehaviorTreeBackend::EventDriven: return "event-driven";
+            default: return "virtual";
+        }
+    }
+
+    // The survival agent on a seeded headless world, like Exam_Headless runs it
+    class SurvivalRun final
+    {
+    public:
+        explicit SurvivalRun(Elite::BehaviorTreeBackend backend): m_World{MakeParams()}, m_Interface{&m_World}
+        {
+            m_Plugin.SetSeed(static_cast<int>(MakeParams().Seed));
+            PluginInfo info{};
+            m_Plugin.DllInit();
+            m_Plugin.Initialize(&m_Interface, info);
+            if (!GetBehaviorTree()->SetBackend(backend))
+                printf("  ERROR: The survival tree can't run on the %s backend\n", GetBackendName(backend));
+        }
+
+        ~SurvivalRun() { m_Plugin.DllShutdown(); }
+
+        SurvivalRun(const SurvivalRun&) = delete;
+        SurvivalRun& operator=(const SurvivalRun&) = delete;
+
+        // Returns the nanoseconds UpdateSteering took
+        double Step()
+        {
+            using Clock = std::chrono::steady_clock;
+            const auto start = Clock::now();
+            const SteeringPlugin_Output steering = m_Plugin.UpdateSteering(Dt);
+            const double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+            m_World.Step(Dt, steering);
+            return ns;
+        }
+
+        [[nodiscard]] Elite::BehaviorTree* GetBehaviorTree() { return m_Plugin.GetAgent()->GetBehaviorTree(); }
+        [[nodiscard]] const HeadlessWorld& GetWorld() const { return m_World; }
+
+    private:
+        static HeadlessWorldParams MakeParams()
+        {
+            HeadlessWorldParams params{};
+            params.GodMode = true; // Keeps every run going for the same number of frames
+            return params;
+        }
+
+        HeadlessWorld m_World;
+        HeadlessInterface m_Interface;
+        SurvivalAgentPlugin m_Plugin{};
+    };
+
+    // Leaves that do next to nothing, so the shape benchmark only measures the walk over the tree.
+    // Only the actions are counted, the event-driven backend skips the conditions
+    int g_NumActionCalls{};
+    bool ReturnTrue(Elite::Blackboard*) { return true; }
+    bool ReturnFalse(Elite::Blackboard*) { return false; }
+    Elite::BehaviorState Fail(Elite::Blackboard*) { ++g_NumActionCalls; return Elite::BehaviorState::Failure; }
+    Elite::BehaviorState Succeed(Elite::Blackboard*) { ++g_NumActionCalls; return Elite::BehaviorState::Success; }
+
+    // A selector over ten children that all fail, every tick visits the whole tree
+    Elite::IBehavior* MakeShape(int shape)
+    {
+        std::vector<Elite::IBehavior*> children{};
+        for (int i{}; i < 10; ++i)
+        {
+            switch (shape)
+            {
+            case 0:
+                children.push_back(new Elite::BehaviorAction(Fail));
+                break;
+            case 1:
+                children.push_back(new Elite::BehaviorSequence({new Elite::BehaviorAction(Succeed), new Elite::BehaviorConditional(ReturnFalse)}));
+                break;
+            default:
+                children.push_back(new Elite::BehaviorConditionDecorator(new Elite::BehaviorAction(Fail), ReturnTrue));
+                break;
+            }
+        }
+        return new Elite::BehaviorSelector(children);
+    }
+}
+
+EXAM_BENCHMARK(BehaviorTreeShapes)
+{
+    constexpr size_t iterations = 2'000'000;
+    const char* shapeNames[]{"10 actions", "10 sequences", "10 condition decorators"};
+    for (int shape{}; shape < 3; ++shape)
+    {
+        double ticks[std::size(Backends)]{};
+        int numActionCalls[std::size(Backends)]{};
+        for (const Elite::BehaviorTreeBackend backend: Backends)
+        {
+            Elite::BehaviorTree tree{new Elite::Blackboard(), MakeShape(shape)};
+            // Nothing ever marks the channel, so the conditions only run once on the event-driven backend
+            const Elite::BlackboardChannel quietChannel{"benchmark.quiet"};
+            tree.ObserveCondition(ReturnTrue, {quietChannel});
+            tree.ObserveCondition(ReturnFalse, {quietChannel});
+            if (!tree.SetBackend(backend)) printf("  ERROR: Shape %d can't run on the %s backend\n", shape, GetBackendName(backend));
+
+            g_NumActionCalls = 0;
+            const std::string label = std::string{GetBackendName(backend)} + " tick, " + shapeNames[shape];
+            ticks[static_cast<int>(backend)] = Bench::Measure(label, iterations, [&tree]() { tree.Update(); });
+            numActionCalls[static_cast<int>(backend)] = g_NumActionCalls;
+        }
+        if (numActionCalls[0] != numActionCalls[1] || numActionCalls[0] != numActionCalls[2])
+            printf("  ERROR: The backends ran a different number of actions\n");
+        printf("  speedup flat %.1fx, event-driven %.1fx\n", ticks[0] / ticks[1], ticks[0] / ticks[2]);
+    }
+}
+
+EXAM_BENCHMARK(BehaviorTreeTick)
+{
+    // Ticks the tree over and over on the frame the agent reached, the world is thrown away afterwards.
+    // Nothing but the tree itself changes between those ticks, the quietest frames there can be
+    constexpr size_t iterations = 200'000;
+    for (const int numFrames: {1, 600, 3'000, 6'000})
+    {
+        double ticks[std::size(Backends)]{};
+        for (const Elite::BehaviorTreeBackend backend: Backends)
+        {
+            SurvivalRun run{backend};
+            for (int frame{}; frame < numFrames; ++frame) run.Step();
+
+            Elite::BehaviorTree* const pTree = run.GetBehaviorTree();
+            const Elite::FlatBehaviorTree* const pFlatTree = pTree->GetFlatTree();
+            const size_t conditionCallsBefore = pFlatTree ? pFlatTree->GetNumConditionCalls() : 0;
+            const size_t cachedConditionsBefore = pFlatTree ? pFlatTree->GetNumCachedConditions() : 0;
+
+            const std::string label = std::string{GetBackendName(backend)} + " tick, frame " + std::to_string(numFrames);
+            ticks[static_cast<int>(backend)] = Bench::Measure(label, iterations, [pTree]() { pTree->Update(); });
+            if (pFlatTree)
+            {
+                // Measure also runs a warm-up tenth
+                const double numTicks = static_cast<double>(iterations + iterations / 10 + 1);
+                printf("    conditions per tick: %.2f run, %.2f from cache\n",
+                       static_cast<double>(pFlatTree->GetNumConditionCalls() - conditionCallsBefore) / numTicks,
+                       static_cast<double>(pFlatTree->GetNumCachedConditions() - cachedConditionsBefore) / numTicks);
+            }
+        }
+        printf("  speedup flat %.1fx, event-driven %.1fx\n", ticks[0] / ticks[1], ticks[0] / ticks[2]);
+    }
+}
+
+EXAM_BENCHMARK(BehaviorTreeSurvivalRun)
+{
+    // Whole frames of a survival run, both backends have to end up in the same place
+    constexpr int numFrames = 6'000;
+    double frameNs[std::size(Backends)]{};
+    AgentInfo finalAgent[std::size(Backends)]{};
+    int finalScore[std::size(Backends)]{};
+    for (const Elite::BehaviorTreeBackend backend: Backends)
+    {
+        SurvivalRun run{backend};
+        double totalNs{};
+        for (int frame{}; frame < numFrames; ++frame) totalNs += run.Step();
+
+        const int idx = static_cast<int>(backend);
+        frameNs[idx] = totalNs / numFrames;
+        finalAgent[idx] = run.GetWorld().GetAgentInfo();
+        finalScore[idx] = run.GetWorld().GetStats().Score;
+        const std::string label = std::string{GetBackendName(backend)} + " UpdateSteering, " + std::to_string(numFrames) + " frames";
+        printf("  %-48s %12.2f ns/op %14.0f ops/s\n", label.c_str(), frameNs[idx], 1e9 / frameNs[idx]);
+    }
+    for (size_t i{1}; i < std::size(Backends); ++i)
+    {
+        if (finalAgent[0].Position != finalAgent[i].Position || finalScore[0] != finalScore[i])
+            printf("  ERROR: The %s backend ended the run somewhere else than the virtual one\n", GetBackendName(Backends[i]));
+    }
+    printf("  speedup flat %.2fx, event-driven %.2fx\n", frameNs[0] / frameNs[1], frameNs[0] / frameNs[2]);
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Tiny benchmark harness for Exam_Bench.
+// Benchmarks register themselves with EXAM_BENCHMARK and are run by name filter from BenchmarkMain.cpp
+namespace Bench
+{
+    using BenchmarkFn = void(*)();
+
+    struct BenchmarkEntry
+    {
+        const char* Name;
+        BenchmarkFn Fn;
+    };
+
+    inline std::vector<BenchmarkEntry>& GetRegistry()
+    {
+        static std::vector<BenchmarkEntry> registry{};
+        return registry;
+    }
+
+    struct Registrar
+    {
+        Registrar(const char* name, BenchmarkFn fn) { GetRegistry().push_back({name, fn}); }
+    };
+
+    // Keeps the compiler from optimizing away a value the benchmark computes
+    template<typename T>
+    inline void DoNotOptimize(const T& value)
+    {
+#if defined(_MSC_VER)
+        static volatile const void* sink;
+        sink = &value;
+#else
+        asm volatile("" : : "r,m"(value) : "memory");
+#endif
+    }
+
+    // Runs fn iterations times (after a short warm-up) and prints the time per operation.
+    // Returns nanoseconds per iteration.
+    template<typename Fn>
+    double Measure(const std::string& label, size_t iterations, Fn&& fn)
+    {
+        for (size_t i{}; i < iterations / 10 + 1; ++i) fn();
+
+        using Clock = std::chrono::steady_clock;
+        const auto start = Clock::now();
+        for (size_t i{}; i < iterations; ++i) fn();
+        const double totalNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+        const double nsPerOp = totalNs / static_cast<double>(iterations);
+        printf("  %-48s %12.2f ns/op %14.0f ops/s\n", label.c_str(), nsPerOp, 1e9 / nsPerOp);
+        return nsPerOp;
+    }
+}
+
+#define EXAM_BENCHMARK(name) \
+    static void name(); \
+    static const Bench::Registrar name##_Registrar{#name, name}; \
+    static void name()
@@ -0,0 +1,20 @@
+#include "../stdafx.h"
+#include <cstring>
+#include "Benchmark.h"
+
+// Usage: Exam_Bench [filter]
+// Runs every registered benchmark whose name contains the filter (all of them without one)
+int main(int argc, char* argv[])
+{
+    const char* filter = argc > 1 ? argv[1] : "";
+    int numRun{};
+    for (const Bench::BenchmarkEntry& entry: Bench::GetRegistry())
+    {
+        if (strstr(entry.Name, filter) == nullptr) continue;
+        printf("[%s]\n", entry.Name);
+        entry.Fn();
+        ++numRun;
+    }
+    if (numRun == 0) printf("No benchmark matches '%s'\n", filter);
+    return 0;
+}
@@ -0,0 +1,96 @@
+#include "../stdafx.h"
+#include "Benchmark.h"
+#include "../BlackboardKeys.h"
+
+namespace
+{
+    // Same layout as Agent::CreateBlackboard, the pointers are never dereferenced
+    void FillBlackboard(Elite::Blackboard& blackboard)
+    {
+        blackboard.AddData("interface", reinterpret_cast<IExamInterface*>(0x1));
+        blackboard.AddData("prioritySteering", reinterpret_cast<AgentSteering*>(0x2));
+        blackboard.AddData("isBeingChased", false);
+        blackboard.AddData("enemiesInFovInfo", std::vector<EnemyInfo>{});
+        blackboard.AddData("lastEnemyPos", Elite::Vector2(0, 0));
+        blackboard.AddData("shotLastFrame", false);
+        blackboard.AddData("radarMode", false);
+        blackboard.AddData("wasBitten", false);
+        blackboard.AddData("mapSearch", reinterpret_cast<MapSearchSystem*>(0x3));
+        blackboard.AddData("currentTarget", std::optional<Elite::Vector2>{});
+        blackboard.AddData("targetItemType", std::optional<eItemType>{});
+        blackboard.AddData("itemNeedList", std::map<eItemType, bool>{});
+        blackboard.AddData("itemSeekList", std::vector<ItemInfo>{});
+        blackboard.AddData("itemsInFOV", 0);
+        blackboard.AddData("currentItemInFOV", 0);
+    }
+}
+
+EXAM_BENCHMARK(BlackboardLookup)
+{
+    constexpr size_t iterations = 5'000'000;
+    Elite::Blackboard blackboard{};
+    FillBlackboard(blackboard);
+
+    const double stringRead = Bench::Measure("GetData(\"interface\") string key", iterations, [&blackboard]()
+    {
+        IExamInterface* pInterface = nullptr;
+        blackboard.GetData("interface", pInterface);
+        Bench::DoNotOptimize(pInterface);
+    });
+    const double typedRead = Bench::Measure("GetData(BlackboardKeys::Interface) typed key", iterations, [&blackboard]()
+    {
+        IExamInterface* pInterface = nullptr;
+        blackboard.GetData(BlackboardKeys::Interface, pInterface);
+        Bench::DoNotOptimize(pInterface);
+    });
+
+    bool flag = false;
+    const double stringWrite = Bench::Measure("ChangeData(\"radarMode\") string key", iterations, [&blackboard, &flag]()
+    {
+        flag = !flag;
+        blackboard.ChangeData("radarMode", flag);
+    });
+    const double typedWrite = Bench::Measure("ChangeData(BlackboardKeys::RadarMode) typed key", iterations, [&blackboard, &flag]()
+    {
+        flag = !flag;
+        blackboard.ChangeData(BlackboardKeys::RadarMode, flag);
+    });
+
+    const double stringVector = Bench::Measure("GetData(\"lastEnemyPos\") string key", iterations, [&blackboard]()
+    {
+        Elite::Vector2 pos;
+        blackboard.GetData("lastEnemyPos", pos);
+        Bench::DoNotOptimize(pos);
+    });
+    const double typedVector = Bench::Measure("GetData(BlackboardKeys::LastEnemyPos) typed key", iterations, [&blackboard]()
+    {
+        Elite::Vector2 pos;
+        blackboard.GetData(BlackboardKeys::LastEnemyPos, pos);
+        Bench::DoNotOptimize(pos);
+    });
+
+    printf("  speedup read %.1fx | write %.1fx | Vector2 read %.1fx\n",
+           stringRead / typedRead, stringWrite / typedWrite, stringVector / typedVector);
+}
+
+EXAM_BENCHMARK(BlackboardContainerAccess)
+{
+    constexpr size_t iterations = 5'000'000;
+    Elite::Blackboard blackboard{};
+    FillBlackboard(blackboard);
+    blackboard.ChangeData(BlackboardKeys::ItemSeekList, std::vector<ItemInfo>(4, ItemInfo{eItemType::FOOD}));
+
+    const double copyRead = Bench::Measure("GetData(ItemSeekList) copy", iterations, [&blackboard]()
+    {
+        std::vector<ItemInfo> seekList;
+        blackboard.GetData(BlackboardKeys::ItemSeekList, seekList);
+        Bench::DoNotOptimize(seekList.front());
+    });
+    const double viewRead = Bench::Measure("View(ItemSeekList) span", iterations, [&blackboard]()
+    {
+        const std::span<const ItemInfo> seekList = blackboard.View(BlackboardKeys::ItemSeekList);
+        Bench::DoNotOptimize(seekList.front());
+    });
+
+    printf("  speedup container read %.1fx\n", copyRead / viewRead);
+}
@@ -0,0 +1,129 @@
+#include "../stdafx.h"
+#include "Benchmark.h"
+
+namespace
+{
+    constexpr size_t NumInputs = 1024;
+    constexpr size_t NumAccuracySamples = 1'000'000;
+
+    // Largest error against the double precision result, printed next to the bound the header documents
+    class MaxError
+    {
+    public:
+        MaxError(const char* name, double bound): m_Name(name), m_Bound(bound) {}
+
+        void Add(double error) { m_MaxError = std::max(m_MaxError, std::abs(error)); }
+
+        bool Report() const
+        {
+            const bool isWithinBound = m_MaxError <= m_Bound;
+            printf("  %s%-44s max error %.3g (bound %.0e)\n", isWithinBound ? "" : "ERROR: ", m_Name, m_MaxError, m_Bound);
+            return isWithinBound;
+        }
+
+    private:
+        const char* m_Name;
+        double m_Bound;
+        double m_MaxError = 0.;
+    };
+
+    bool CheckAccuracy()
+    {
+        Elite::RandomEngine rng{5};
+        MaxError invSqrt{"FastInvSqrt (relative)", 5e-7};
+        MaxError normalize{"FastNormalize (length - 1)", 1e-6};
+        MaxError atan2{"FastAtan2", 1e-6};
+        MaxError sinCos{"FastSinCos, |radians| < 1e4", 1e-6};
+        MaxError wrap{"WrapAngle, |radians| < 1e4 (ulp of radians)", 1.};
+        size_t numWrapLoopMismatches{};
+        for (size_t i{}; i < NumAccuracySamples; ++i)
+        {
+            const float f = std::exp(rng.NextFloat(-30.f, 30.f));
+            invSqrt.Add(Elite::FastInvSqrt(f) * std::sqrt(static_cast<double>(f)) - 1.);
+
+            Elite::Vector2 v{rng.NextFloat(-1000.f, 1000.f), rng.NextFloat(-1000.f, 1000.f)};
+            Elite::FastNormalize(v);
+            normalize.Add(std::hypot(static_cast<double>(v.x), static_cast<double>(v.y)) - 1.);
+
+            const float x = rng.NextFloat(-1000.f, 1000.f);
+            const float y = rng.NextFloat(-1000.f, 1000.f);
+            atan2.Add(Elite::FastAtan2(y, x) - std::atan2(static_cast<double>(y), static_cast<double>(x)));
+
+            const float angle = rng.NextFloat(-1e4f, 1e4f);
+            float sine, cosine;
+            Elite::FastSinCos(angle, sine, cosine);
+            sinCos.Add(std::max(std::abs(sine - std::sin(static_cast<double>(angle))),
+                                std::abs(cosine - std::cos(static_cast<double>(angle)))));
+
+            // +-pi are the same angle
+            const double wrapError = std::remainder(Elite::WrapAngle(angle) - static_cast<double>(angle), 2 * M_PI);
+            wrap.Add(wrapError / (std::nextafter(std::abs(angle), FLT_MAX) - std::abs(angle)));
+
+            // Against the loops Face::CalculateSteering used before, over the angle differences it sees
+            const float angleDifference = rng.NextFloat(-2.f * static_cast<float>(M_PI), 2.f * static_cast<float>(M_PI));
+            float looped = angleDifference;
+            while (looped > M_PI) looped -= 2 * M_PI;
+            while (looped < -M_PI) looped += 2 * M_PI;
+            if (Elite::WrapAngle(angleDifference) != looped) ++numWrapLoopMismatches;
+        }
+        // The ties at +-float(pi) go the same way as the loops
+        for (const float angle: {static_cast<float>(M_PI), -static_cast<float>(M_PI)})
+        {
+            float looped = angle;
+            while (looped > M_PI) looped -= 2 * M_PI;
+            while (looped < -M_PI) looped += 2 * M_PI;
+            if (Elite::WrapAngle(angle) != looped) ++numWrapLoopMismatches;
+        }
+        printf("  WrapAngle differs from the while loops (|radians| <= 2 pi) %zu times\n", numWrapLoopMismatches);
+
+        bool isAccurate = numWrapLoopMismatches == 0;
+        for (const MaxError* pError: {&invSqrt, &normalize, &atan2, &sinCos, &wrap}) isAccurate &= pError->Report();
+        return isAccurate;
+    }
+
+    template<typename LibmFn, typename FastFn>
+    void CompareSpeed(const char* libmLabel, LibmFn libmFn, const char* fastLabel, FastFn fastFn)
+    {
+        constexpr size_t iterations = 20'000'000;
+        const double libmNs = Bench::Measure(libmLabel, iterations, libmFn);
+        const double fastNs = Bench::Measure(fastLabel, iterations, fastFn);
+        printf("  speedup %.2fx\n", libmNs / fastNs);
+    }
+}
+
+EXAM_BENCHMARK(FastMath)
+{
+    if (!CheckAccuracy()) return;
+
+    Elite::RandomEngine rng{6};
+    std::vector<float> values(NumInputs), angles(NumInputs);
+    std::vector<Elite::Vector2> vectors(NumInputs);
+    for (size_t i{}; i < NumInputs; ++i)
+    {
+        values[i] = rng.NextFloat(0.01f, 1000.f);
+        angles[i] = rng.NextFloat(-10.f, 10.f);
+        vectors[i] = {rng.NextFloat(-100.f, 100.f), rng.NextFloat(-100.f, 100.f)};
+    }
+
+    size_t next{};
+    CompareSpeed("InvSqrt (1 / sqrtf)", [&]() { Bench::DoNotOptimize(Elite::InvSqrt(values[++next % NumInputs])); },
+                 "FastInvSqrt", [&]() { Bench::DoNotOptimize(Elite::FastInvSqrt(values[++next % NumInputs])); });
+    CompareSpeed("Vector2::GetNormalized", [&]() { Bench::DoNotOptimize(vectors[++next % NumInputs].GetNormalized()); },
+                 "FastGetNormalized", [&]() { Bench::DoNotOptimize(Elite::FastGetNormalized(vectors[++next % NumInputs])); });
+    CompareSpeed("VectorToOrientation (atan2f)",
+                 [&]() { Bench::DoNotOptimize(Elite::VectorToOrientation(vectors[++next % NumInputs])); },
+                 "FastVectorToOrientation",
+                 [&]() { Bench::DoNotOptimize(Elite::FastVectorToOrientation(vectors[++next % NumInputs])); });
+    CompareSpeed("OrientationToVector (cos, sin)",
+                 [&]() { Bench::DoNotOptimize(Elite::OrientationToVector(angles[++next % NumInputs])); },
+                 "FastOrientationToVector",
+                 [&]() { Bench::DoNotOptimize(Elite::FastOrientationToVector(angles[++next % NumInputs])); });
+    CompareSpeed("while loops (Face before)", [&]()
+                 {
+                     float angle = angles[++next % NumInputs];
+                     while (angle > M_PI) angle -= 2 * M_PI;
+                     while (angle < -M_PI) angle += 2 * M_PI;
+                     Bench::DoNotOptimize(angle);
+                 },
+                 "WrapAngle", [&]() { Bench::DoNotOptimize(Elite::WrapAngle(angles[++next % NumInputs])); });
+}
@@ -0,0 +1,194 @@
+#include "../stdafx.h"
+#include <random>
+#include <set>
+#include "Benchmark.h"
+#include "../FlatPointSet.h"
+#include "../MapSearchSystem.h"
+
+namespace
+{
+    constexpr float MapHalfExtent = 1000.f;
+    constexpr size_t NumQueries = 1024;
+
+    AgentInfo MakeAgentInfo()
+    {
+        AgentInfo agentInfo{};
+        agentInfo.FOV_Range = 20.f;
+        agentInfo.FOV_Angle = Elite::ToRadians(90.f);
+        return agentInfo;
+    }
+
+    std::vector<Elite::Vector2> RandomPoints(std::mt19937& rng, size_t count)
+    {
+        std::uniform_real_distribution<float> coord{-MapHalfExtent, MapHalfExtent};
+        std::vector<Elite::Vector2> points(count);
+        for (Elite::Vector2& point: points) point = {coord(rng), coord(rng)};
+        return points;
+    }
+
+    // What MapSearchSystem did before the grids: a linear min_element over a std::set
+    Elite::Vector2 LinearClosest(const Elite::Vector2& position, const std::set<Elite::Vector2>& points)
+    {
+        return *std::ranges::min_element(points, [&position](const Elite::Vector2& a, const Elite::Vector2& b)
+        {
+            return (a - position).MagnitudeSquared() < (b - position).MagnitudeSquared();
+        });
+    }
+}
+
+EXAM_BENCHMARK(MapSearchClosestItem)
+{
+    for (const size_t numItems: {100, 1'000, 4'000, 16'000})
+    {
+        std::mt19937 rng{42};
+        MapSearchSystem mapSearch{MakeAgentInfo()};
+        std::set<Elite::Vector2> baseline{};
+        for (const Elite::Vector2& location: RandomPoints(rng, numItems))
+        {
+            mapSearch.RememberItemLocation(ItemInfo{eItemType::FOOD, location});
+            baseline.emplace(location);
+        }
+        const std::vector<Elite::Vector2> queries = RandomPoints(rng, NumQueries);
+
+        size_t queryIdx{};
+        const size_t iterations = 20'000'000 / numItems + 1000;
+        const double linear = Bench::Measure("std::set linear, " + std::to_string(numItems) + " items", iterations,
+                                             [&]()
+                                             {
+                                                 const Elite::Vector2& position = queries[++queryIdx % NumQueries];
+                                                 Bench::DoNotOptimize(LinearClosest(position, baseline));
+                                             });
+        const double grid = Bench::Measure("hash grid, " + std::to_string(numItems) + " items", iterations, [&]()
+        {
+            Elite::Vector2 closest;
+            mapSearch.GetItemClosestLocation(queries[++queryIdx % NumQueries], eItemType::FOOD, closest);
+            Bench::DoNotOptimize(closest);
+        });
+        printf("  speedup %.1fx\n", linear / grid);
+    }
+}
+
+EXAM_BENCHMARK(MapSearchPointInHouse)
+{
+    for (const size_t numHouses: {20, 200, 1'000, 4'000})
+    {
+        std::mt19937 rng{42};
+        std::uniform_real_distribution<float> size{10.f, 30.f};
+        MapSearchSystem mapSearch{MakeAgentInfo()};
+        std::vector<HouseInfo> baseline{};
+        for (const Elite::Vector2& center: RandomPoints(rng, numHouses))
+        {
+            const HouseInfo house{center, {size(rng), size(rng)}};
+            mapSearch.FoundHouse(house);
+            baseline.push_back(house);
+        }
+        const std::vector<Elite::Vector2> queries = RandomPoints(rng, NumQueries);
+
+        size_t queryIdx{};
+        const size_t iterations = 20'000'000 / numHouses + 1000;
+        const double linear = Bench::Measure("linear any_of, " + std::to_string(numHouses) + " houses", iterations,
+                                             [&]()
+                                             {
+                                                 const Elite::Vector2& point = queries[++queryIdx % NumQueries];
+                                                 Bench::DoNotOptimize(std::ranges::any_of(baseline, [&point](const HouseInfo& house)
+                                                 {
+                                                     return MapSearchSystem::IsPointInHouse(point, house, 4.f);
+                                                 }));
+                                             });
+        const double grid = Bench::Measure("hash grid, " + std::to_string(numHouses) + " houses", iterations, [&]()
+        {
+            Bench::DoNotOptimize(mapSearch.IsPointInAnyFoundHouse(queries[++queryIdx % NumQueries]));
+        });
+        printf("  speedup %.1fx\n", linear / grid);
+    }
+}
+
+EXAM_BENCHMARK(MapSearchTargetSet)
+{
+    for (const size_t numTargets: {8, 64, 1'000})
+    {
+        std::mt19937 rng{42};
+        const std::vector<Elite::Vector2> targets = RandomPoints(rng, numTargets);
+        std::set<Elite::Vector2> tree{targets.begin(), targets.end()};
+        FlatPointSet flat{};
+        for (const Elite::Vector2& target: targets) flat.Insert(target);
+        const std::vector<Elite::Vector2> queries = RandomPoints(rng, NumQueries);
+
+        size_t queryIdx{};
+        const size_t iterations = 20'000'000 / numTargets + 1000;
+        const std::string suffix = ", " + std::to_string(numTargets) + " targets";
+        const double treeNearest = Bench::Measure("std::set nearest" + suffix, iterations, [&]()
+        {
+            Bench::DoNotOptimize(LinearClosest(queries[++queryIdx % NumQueries], tree));
+        });
+        const double flatNearest = Bench::Measure("FlatPointSet nearest" + suffix, iterations, [&]()
+        {
+            Elite::Vector2 closest;
+            flat.FindNearest(queries[++queryIdx % NumQueries], closest);
+            Bench::DoNotOptimize(closest);
+        });
+
+        // Erase and re-insert the same target, what ReachedTarget and a recheck do
+        const double treeChurn = Bench::Measure("std::set erase+insert" + suffix, iterations, [&]()
+        {
+            const Elite::Vector2& target = targets[++queryIdx % numTargets];
+            tree.erase(target);
+            tree.emplace(target);
+        });
+        const double flatChurn = Bench::Measure("FlatPointSet erase+insert" + suffix, iterations, [&]()
+        {
+            const Elite::Vector2& target = targets[++queryIdx % numTargets];
+            flat.Erase(target);
+            flat.Insert(target);
+        });
+        printf("  speedup nearest %.1fx | erase+insert %.1fx\n", treeNearest / flatNearest, treeChurn / flatChurn);
+    }
+}
+
+EXAM_BENCHMARK(NearestPointKernel)
+{
+    printf("  kernel: %s\n", Elite::NearestPointKernelName());
+    for (const size_t numPoints: {7, 64, 1'000, 16'000})
+    {
+        std::mt19937 rng{42};
+        const std::vector<Elite::Vector2> points = RandomPoints(rng, numPoints);
+        std::vector<float> xs{}, ys{};
+        for (const Elite::Vector2& point: points)
+        {
+            xs.push_back(point.x);
+            ys.push_back(point.y);
+        }
+        const std::vector<Elite::Vector2> queries = RandomPoints(rng, NumQueries);
+
+        // The vector kernels have to pick exactly what the scalar loop picks
+        size_t numMismatches{};
+        for (const Elite::Vector2& query: queries)
+        {
+            const size_t expected = Elite::FindNearestPointScalar(points.data(), numPoints, query);
+            if (Elite::FindNearestPoint(points.data(), numPoints, query) != expected) ++numMismatches;
+            if (Elite::FindNearestPoint(xs.data(), ys.data(), numPoints, query) != expected) ++numMismatches;
+        }
+        if (numMismatches > 0) printf("  ERROR: %zu queries disagree with the scalar kernel\n", numMismatches);
+
+        size_t queryIdx{};
+        const size_t iterations = 50'000'000 / numPoints + 1000;
+        const std::string suffix = ", " + std::to_string(numPoints) + " points";
+        const double minElement = Bench::Measure("std::ranges::min_element" + suffix, iterations, [&]()
+        {
+            const Elite::Vector2& position = queries[++queryIdx % NumQueries];
+            Bench::DoNotOptimize(*std::ranges::min_element(points, [&position](const Elite::Vector2& a, const Elite::Vector2& b)
+            {
+                return (a - position).MagnitudeSquared() < (b - position).MagnitudeSquared();
+            }));
+        });
+        const double interleaved = Bench::Measure("FindNearestPoint Vector2[]" + suffix, iterations, [&]()
+        {
+            Bench::DoNotOptimize(Elite::FindNearestPoint(points.data(), numPoints, queries[++queryIdx % NumQueries]));
+        });
+        const double packed = Bench::Measure("FindNearestPoint x[] y[]" + suffix, iterations, [&]()
+        {
+            Bench::DoNotOptimize(Elite::FindNearestPoint(xs.data(), ys.data(), numPoints, queries[++queryIdx % NumQueries]));
+        });
+        printf("  speedup Vector2[] %.1fx | x[] y[] %.1fx\n", minElement / interleaved, minElement / packed);
+    }
+}
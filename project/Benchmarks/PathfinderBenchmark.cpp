@@ -0,0 +1,82 @@
+#include "../stdafx.h"
+#include <random>
+#include "Benchmark.h"
+#include "../GridPathfinder.h"
+#include "Exam_HelperStructs.h"
+
+namespace
+{
+    constexpr size_t NumQueries = 1024;
+
+    // A square grid of 1 m cells with houses scattered over it, a tenth of its area inside houses
+    OccupancyGrid MakeVillageGrid(std::mt19937& rng, uint32_t size)
+    {
+        OccupancyGrid grid{};
+        grid.Reset({0.f, 0.f}, 1.f, size, size);
+        std::uniform_real_distribution<float> houseSize{8.f, 40.f};
+        std::uniform_real_distribution<float> coord{0.f, static_cast<float>(size)};
+        const size_t numHouses = static_cast<size_t>(size) * size / 5'000;
+        for (size_t h{}; h < numHouses; ++h) grid.AddHouseWalls(HouseInfo{{coord(rng), coord(rng)}, {houseSize(rng), houseSize(rng)}});
+        return grid;
+    }
+
+    std::vector<std::pair<Elite::Vector2, Elite::Vector2>> RandomQueries(std::mt19937& rng, const OccupancyGrid& grid)
+    {
+        std::uniform_real_distribution<float> coord{0.f, static_cast<float>(grid.GetWidth())};
+        std::vector<std::pair<Elite::Vector2, Elite::Vector2>> queries(NumQueries);
+        for (auto& [from, to]: queries)
+        {
+            from = {coord(rng), coord(rng)};
+            to = {coord(rng), coord(rng)};
+        }
+        return queries;
+    }
+}
+
+EXAM_BENCHMARK(GridPathfinding)
+{
+    for (const uint32_t size: {256u, 1024u})
+    {
+        std::mt19937 rng{42};
+        const OccupancyGrid grid = MakeVillageGrid(rng, size);
+        const auto queries = RandomQueries(rng, grid);
+        GridPathfinder aStar{};
+        aStar.SetAlgorithm(GridPathfinder::Algorithm::AStar);
+        GridPathfinder jumpPoint{};
+
+        // Both searches have to find paths of the same length, JPS only skips the cells in between
+        size_t numMismatches{};
+        size_t numUnreachable{};
+        size_t aStarExpanded{};
+        size_t jumpPointExpanded{};
+        const size_t numChecked = size > 256 ? 100 : NumQueries;
+        for (size_t q{}; q < numChecked; ++q)
+        {
+            const float expected = aStar.GetPathCost(grid, queries[q].first, queries[q].second);
+            const float cost = jumpPoint.GetPathCost(grid, queries[q].first, queries[q].second);
+            aStarExpanded += aStar.GetNumExpanded();
+            jumpPointExpanded += jumpPoint.GetNumExpanded();
+            if (expected == GridPathfinder::NoPath) ++numUnreachable;
+            if ((expected == GridPathfinder::NoPath) != (cost == GridPathfinder::NoPath)
+                || std::abs(expected - cost) > 1e-3f * expected)
+                ++numMismatches;
+        }
+        if (numMismatches > 0) printf("  ERROR: %zu of %zu paths differ between A* and JPS\n", numMismatches, numChecked);
+        printf("  %ux%u grid: %zu unreachable, cells expanded per query A* %.0f, JPS %.0f\n", size, size, numUnreachable,
+               static_cast<double>(aStarExpanded) / numChecked, static_cast<double>(jumpPointExpanded) / numChecked);
+
+        size_t queryIdx{};
+        const std::string suffix = ", " + std::to_string(size) + "x" + std::to_string(size);
+        const double aStarNs = Bench::Measure("A* path cost" + suffix, size > 256 ? 200 : 5'000, [&]()
+        {
+            const auto& [from, to] = queries[++queryIdx % NumQueries];
+            Bench::DoNotOptimize(aStar.GetPathCost(grid, from, to));
+        });
+        const double jumpPointNs = Bench::Measure("JPS path cost" + suffix, size > 256 ? 2'000 : 20'000, [&]()
+        {
+            const auto& [from, to] = queries[++queryIdx % NumQueries];
+            Bench::DoNotOptimize(jumpPoint.GetPathCost(grid, from, to));
+        });
+        printf("  speedup JPS %.1fx\n", aStarNs / jumpPointNs);
+    }
+}
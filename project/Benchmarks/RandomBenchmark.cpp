@@ -0,0 +1,47 @@
+#include "../stdafx.h"
+#include "Benchmark.h"
+#include "EliteMath/ERandom.h"
+
+EXAM_BENCHMARK(RandomEngine)
+{
+    // Wander's angle change: the difference of two uniform floats, per call or a batch of 32 at a time
+    constexpr size_t iterations = 20'000'000;
+    constexpr float maxAngleChange = 0.785f;
+    srand(1337);
+    const double randNs = Bench::Measure("rand() binomial", iterations, []()
+    {
+        const float a = maxAngleChange * static_cast<float>(rand()) / RAND_MAX;
+        Bench::DoNotOptimize(a - maxAngleChange * static_cast<float>(rand()) / RAND_MAX);
+    });
+
+    Elite::RandomEngine rng{1337};
+    const double engineNs = Bench::Measure("RandomEngine::NextBinomial", iterations, [&rng]()
+    {
+        Bench::DoNotOptimize(rng.NextBinomial(maxAngleChange));
+    });
+
+    float batch[32]{};
+    size_t next{std::size(batch)};
+    const double batchNs = Bench::Measure("RandomEngine::FillBinomial, 32 per batch", iterations, [&]()
+    {
+        if (next == std::size(batch))
+        {
+            rng.FillBinomial(batch, std::size(batch), maxAngleChange);
+            next = 0;
+        }
+        Bench::DoNotOptimize(batch[next++]);
+    });
+    printf("  speedup over rand() %.1fx, batched %.1fx\n", randNs / engineNs, randNs / batchNs);
+
+    // The batch has to hand out exactly what single calls would
+    Elite::RandomEngine single{42}, batched{42};
+    batched.FillBinomial(batch, std::size(batch), maxAngleChange);
+    for (const float value: batch)
+    {
+        if (value != single.NextBinomial(maxAngleChange))
+        {
+            printf("  ERROR: FillBinomial differs from NextBinomial\n");
+            break;
+        }
+    }
+}
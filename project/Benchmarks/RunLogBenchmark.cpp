@@ -0,0 +1,197 @@
+#include "../stdafx.h"
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include "Benchmark.h"
+#include "../Trajectory/RunLogReader.h"
+#include "../Trajectory/RunLogWriter.h"
+
+namespace
+{
+    constexpr size_t NumFrames = 10'000'000;
+    constexpr const char* ActionNames[]{"Wander", "Seek", "Flee", "EatFood", "UseMedkit", "Shoot", "GrabItem", "EnterHouse"};
+    constexpr size_t NumActions = std::size(ActionNames);
+
+    using Clock = std::chrono::steady_clock;
+
+    double MsSince(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    // Everything a scan over the whole run computes, once per column
+    struct ScanResult
+    {
+        double Sums[RunLog::NumFloatColumns]{};
+        float MinHealth = FLT_MAX;
+        // The last slot counts the frames without an action
+        uint64_t ActionCounts[NumActions + 1]{};
+    };
+
+    double Sum(std::span<const float> column)
+    {
+        // Independent accumulators, so the adds don't wait on each other
+        double sums[4]{};
+        size_t i{};
+        for (; i + 4 <= column.size(); i += 4)
+            for (size_t lane{}; lane < 4; ++lane) sums[lane] += column[i + lane];
+        for (; i < column.size(); ++i) sums[0] += column[i];
+        return sums[0] + sums[1] + sums[2] + sums[3];
+    }
+
+    ScanResult Scan(const std::span<const float> (&columns)[RunLog::NumFloatColumns], std::span<const uint16_t> actions)
+    {
+        ScanResult result{};
+        for (uint32_t c{}; c < RunLog::NumFloatColumns; ++c) result.Sums[c] = Sum(columns[c]);
+        for (const float health: columns[static_cast<size_t>(RunLog::Column::Health)])
+            result.MinHealth = std::min(result.MinHealth, health);
+        for (const uint16_t action: actions) ++result.ActionCounts[std::min<size_t>(action, NumActions)];
+        return result;
+    }
+
+    ScanResult Scan(const RunLogReader& reader)
+    {
+        std::span<const float> columns[RunLog::NumFloatColumns]{};
+        for (uint32_t c{}; c < RunLog::NumFloatColumns; ++c) columns[c] = reader.GetColumn(static_cast<RunLog::Column>(c));
+        return Scan(columns, reader.GetActions());
+    }
+
+    // What loading a run without the mapping costs: every column read through an ifstream into its own vector
+    ScanResult LoadAndScan(const std::string& path)
+    {
+        std::ifstream file{path, std::ios::binary};
+        RunLog::FileHeader header{};
+        file.read(reinterpret_cast<char*>(&header), sizeof(header));
+        std::vector<float> floatColumns[RunLog::NumFloatColumns]{};
+        std::span<const float> columns[RunLog::NumFloatColumns]{};
+        for (uint32_t c{}; c < RunLog::NumFloatColumns; ++c)
+        {
+            floatColumns[c].resize(header.NumFrames);
+            file.seekg(static_cast<std::streamoff>(header.Columns[c].Offset));
+            file.read(reinterpret_cast<char*>(floatColumns[c].data()), static_cast<std::streamsize>(header.Columns[c].Size));
+            columns[c] = floatColumns[c];
+        }
+        std::vector<uint16_t> actions(header.NumFrames);
+        const RunLog::Section& actionSection = header.Columns[static_cast<size_t>(RunLog::Column::Action)];
+        file.seekg(static_cast<std::streamoff>(actionSection.Offset));
+        file.read(reinterpret_cast<char*>(actions.data()), static_cast<std::streamsize>(actionSection.Size));
+        return Scan(columns, actions);
+    }
+
+    bool IsClose(double a, double b)
+    {
+        return std::abs(a - b) <= 1e-9 * std::max(std::abs(a), std::abs(b)) + 1e-6;
+    }
+}
+
+EXAM_BENCHMARK(RunLogScan)
+{
+    // A made up run: a random walk that drains its stats and sticks with an action for a while
+    std::mt19937 rng{42};
+    std::uniform_real_distribution<float> unit{-1.f, 1.f};
+    RunLogWriter writer{};
+    writer.Reserve(NumFrames);
+    ScanResult expected{};
+    std::vector<AgentInfo> samples{};
+    AgentInfo agentInfo{};
+    agentInfo.Health = 10.f;
+    agentInfo.Energy = 10.f;
+    agentInfo.Stamina = 10.f;
+    uint16_t action = RunLog::NoAction;
+    for (size_t frame{}; frame < NumFrames; ++frame)
+    {
+        agentInfo.LinearVelocity = {unit(rng) * 5.f, unit(rng) * 5.f};
+        agentInfo.Position += agentInfo.LinearVelocity * 0.016f;
+        agentInfo.Health = std::clamp(agentInfo.Health + unit(rng) * 0.05f, 0.f, 10.f);
+        agentInfo.Energy = std::clamp(agentInfo.Energy + unit(rng) * 0.05f, 0.f, 10.f);
+        agentInfo.Stamina = std::clamp(agentInfo.Stamina + unit(rng) * 0.05f, 0.f, 10.f);
+        if (rng() % 64 == 0)
+        {
+            const size_t next = rng() % (NumActions + 1);
+            action = next == NumActions ? RunLog::NoAction : writer.GetActionId(ActionNames[next], ActionNames[next]);
+        }
+        writer.AddFrame(agentInfo, action);
+
+        const float values[RunLog::NumFloatColumns]{agentInfo.Position.x, agentInfo.Position.y, agentInfo.LinearVelocity.x,
+                                                    agentInfo.LinearVelocity.y, agentInfo.Health, agentInfo.Energy, agentInfo.Stamina};
+        for (uint32_t c{}; c < RunLog::NumFloatColumns; ++c) expected.Sums[c] += values[c];
+        expected.MinHealth = std::min(expected.MinHealth, agentInfo.Health);
+        ++expected.ActionCounts[std::min<size_t>(action, NumActions)];
+        if (frame % 4096 == 0) samples.push_back(agentInfo);
+    }
+
+    const std::string path = (std::filesystem::temp_directory_path() / "exam_bench_runlog.bin").string();
+    auto start = Clock::now();
+    if (!writer.Write(path))
+    {
+        printf("  ERROR: could not write %s\n", path.c_str());
+        return;
+    }
+    const double writeMs = MsSince(start);
+    const uint64_t fileSize = std::filesystem::file_size(path);
+    printf("  %zu frames, %.1f MB, written in %.1f ms\n", NumFrames, static_cast<double>(fileSize) / 1e6, writeMs);
+    // Just written, so the file comes from the page cache: these are the numbers of a warm file, not of the disk
+    printf("  the file is in the page cache, the scans measure memory, not the disk\n");
+
+    // Unmapped before the file is removed
+    {
+        RunLogReader reader{};
+        start = Clock::now();
+        if (!reader.Open(path))
+        {
+            printf("  ERROR: could not open %s\n", path.c_str());
+            std::filesystem::remove(path);
+            return;
+        }
+        printf("  open (map + check the header)  %.3f ms\n", MsSince(start));
+
+        // What a scan computes has to match what went into the file
+        const ScanResult result = Scan(reader);
+        size_t numMismatches{};
+        if (result.MinHealth != expected.MinHealth) ++numMismatches;
+        for (size_t a{}; a <= NumActions; ++a)
+            if (result.ActionCounts[a] != expected.ActionCounts[a]) ++numMismatches;
+        for (uint32_t c{}; c < RunLog::NumFloatColumns; ++c)
+            if (!IsClose(result.Sums[c], expected.Sums[c])) ++numMismatches;
+        for (size_t s{}; s < samples.size(); ++s)
+        {
+            const RunLogFrame frame = reader.GetFrame(s * 4096);
+            if (frame.Position != samples[s].Position || frame.Health != samples[s].Health || frame.Stamina != samples[s].Stamina)
+                ++numMismatches;
+        }
+        for (size_t a{}; a < reader.GetNumActions(); ++a)
+            if (std::ranges::find(ActionNames, std::string_view{reader.GetActionName(static_cast<uint16_t>(a))}) == std::end(ActionNames))
+                ++numMismatches;
+        if (numMismatches > 0) printf("  ERROR: %zu values read back differ from the ones written\n", numMismatches);
+
+        const double scanNs = Bench::Measure("mmap full scan, 8 columns x 10M frames", 5, [&]()
+        {
+            Bench::DoNotOptimize(Scan(reader));
+        });
+        const double loadNs = Bench::Measure("ifstream load + full scan", 3, [&]()
+        {
+            Bench::DoNotOptimize(LoadAndScan(path));
+        });
+        printf("  full scan %.1f ms (%.2f GB/s) | ifstream load + scan %.1f ms | speedup %.1fx\n", scanNs / 1e6,
+               static_cast<double>(fileSize) / scanNs, loadNs / 1e6, loadNs / scanNs);
+
+        // Windows of a few seconds of a run, what a plot or a per-event query reads
+        constexpr size_t RangeSize = 1024;
+        std::vector<size_t> starts(4096);
+        for (size_t& first: starts) first = rng() % NumFrames;
+        size_t startIdx{};
+        Bench::Measure("range scan, health of 1024 frames", 200'000, [&]()
+        {
+            Bench::DoNotOptimize(Sum(reader.GetColumn(RunLog::Column::Health, starts[++startIdx % starts.size()], RangeSize)));
+        });
+
+        std::vector<size_t> frames(1 << 16);
+        for (size_t& frame: frames) frame = rng() % NumFrames;
+        size_t frameIdx{};
+        Bench::Measure("random GetFrame", 2'000'000, [&]()
+        {
+            Bench::DoNotOptimize(reader.GetFrame(frames[++frameIdx % frames.size()]));
+        });
+    }
+    std::filesystem::remove(path);
+}
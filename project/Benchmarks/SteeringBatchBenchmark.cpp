@@ -0,0 +1,142 @@
+#include "../stdafx.h"
+#include "Benchmark.h"
+#include "../Steering/SteeringBatch.h"
+#include "../Steering/SteeringBehaviors.h"
+
+namespace
+{
+    // One agent per element, as arrays for the batch and as AgentInfo/TargetData for the behaviors
+    struct Agents
+    {
+        explicit Agents(size_t count)
+        {
+            Elite::RandomEngine rng{99};
+            for (std::vector<float>* pArray: {&posX, &posY, &orientation, &maxLinearSpeed, &maxAngularSpeed,
+                                              &targetX, &targetY, &targetVelX, &targetVelY, &linearX, &linearY, &angular})
+            {
+                pArray->resize(count);
+            }
+            agentInfos.resize(count);
+            targets.resize(count);
+            for (size_t i{}; i < count; ++i)
+            {
+                // Targets close enough that some are reached (Seek) and some are in evasion range (Evade)
+                posX[i] = rng.NextFloat(-250.f, 250.f);
+                posY[i] = rng.NextFloat(-250.f, 250.f);
+                orientation[i] = rng.NextFloat(-3.14f, 3.14f);
+                maxLinearSpeed[i] = rng.NextFloat(3.f, 8.f);
+                maxAngularSpeed[i] = 2.f;
+                targetX[i] = posX[i] + rng.NextFloat(-20.f, 20.f);
+                targetY[i] = posY[i] + rng.NextFloat(-20.f, 20.f);
+                targetVelX[i] = rng.NextFloat(-5.f, 5.f);
+                targetVelY[i] = rng.NextFloat(-5.f, 5.f);
+
+                AgentInfo& agentInfo = agentInfos[i];
+                agentInfo = {};
+                agentInfo.Position = {posX[i], posY[i]};
+                agentInfo.Orientation = orientation[i];
+                agentInfo.MaxLinearSpeed = maxLinearSpeed[i];
+                agentInfo.MaxAngularSpeed = maxAngularSpeed[i];
+                agentInfo.Stamina = 10.f;
+                targets[i] = TargetData{{targetX[i], targetY[i]}, 0.f, {targetVelX[i], targetVelY[i]}};
+            }
+        }
+
+        SteeringBatch::Input GetInput(size_t count) const
+        {
+            return {posX.data(), posY.data(), orientation.data(), maxLinearSpeed.data(), maxAngularSpeed.data(),
+                    targetX.data(), targetY.data(), targetVelX.data(), targetVelY.data(), count};
+        }
+
+        SteeringBatch::Output GetOutput() { return {linearX.data(), linearY.data(), angular.data()}; }
+
+        std::vector<float> posX, posY, orientation, maxLinearSpeed, maxAngularSpeed;
+        std::vector<float> targetX, targetY, targetVelX, targetVelY;
+        std::vector<float> linearX, linearY, angular;
+        std::vector<AgentInfo> agentInfos;
+        std::vector<TargetData> targets;
+    };
+
+    // The behavior reused for every agent, retargeted before each call like an agent's own behavior would be
+    template<typename Behavior>
+    SteeringOutput CalculateReference(Behavior& behavior, const AgentInfo& agentInfo, const TargetData& target)
+    {
+        behavior.SetTarget(target);
+        return behavior.Behavior::CalculateSteering(agentInfo);
+    }
+
+    // Face picks its direction with an approximated atan2, within this of the dead zone edge or of +-pi it may differ
+    bool IsFaceBorderline(const AgentInfo& agentInfo, const TargetData& target)
+    {
+        const double dx = static_cast<double>(target.Position.x) - agentInfo.Position.x;
+        const double dy = static_cast<double>(target.Position.y) - agentInfo.Position.y;
+        const double angleDifference = std::remainder(std::atan2(dy, dx) - agentInfo.Orientation, 2 * M_PI);
+        constexpr double tolerance = 1e-5;
+        return std::abs(std::abs(angleDifference) - Elite::ToRadians(5.f)) < tolerance
+            || std::abs(std::abs(angleDifference) - M_PI) < tolerance;
+    }
+
+    template<typename Behavior, typename BatchFn>
+    void BenchmarkBehavior(const char* name, Agents& agents, BatchFn batchFn)
+    {
+        // Odd count, so the scalar tail is checked as well
+        const size_t numChecked = std::min<size_t>(agents.agentInfos.size(), 100'003);
+        batchFn(agents.GetInput(numChecked), agents.GetOutput());
+        Behavior behavior{};
+        size_t numBorderline{};
+        for (size_t i{}; i < numChecked; ++i)
+        {
+            const SteeringOutput expected = CalculateReference(behavior, agents.agentInfos[i], agents.targets[i]);
+            if (expected.LinearVelocity.x == agents.linearX[i] && expected.LinearVelocity.y == agents.linearY[i]
+                && expected.AngularVelocity == agents.angular[i])
+            {
+                continue;
+            }
+            if (IsFaceBorderline(agents.agentInfos[i], agents.targets[i]))
+            {
+                ++numBorderline;
+                continue;
+            }
+            printf("  ERROR: batched %s differs from %s::CalculateSteering at agent %zu\n", name, name, i);
+            return;
+        }
+        printf("  %s: %zu agents match the behavior (%zu on the Face dead zone edge)\n", name, numChecked, numBorderline);
+
+        for (const size_t count: {1'000, 10'000, 100'000, 1'000'000})
+        {
+            const size_t iterations = 10'000'000 / count;
+            const std::string suffix = ", " + std::to_string(count) + " agents";
+            const double scalarNs = Bench::Measure(std::string{name} + "::CalculateSteering" + suffix, iterations, [&]()
+            {
+                for (size_t i{}; i < count; ++i)
+                {
+                    Bench::DoNotOptimize(CalculateReference(behavior, agents.agentInfos[i], agents.targets[i]));
+                }
+            });
+            const SteeringBatch::Input input = agents.GetInput(count);
+            const SteeringBatch::Output output = agents.GetOutput();
+            const double batchNs = Bench::Measure(std::string{"SteeringBatch::"} + name + suffix, iterations, [&]()
+            {
+                batchFn(input, output);
+                Bench::DoNotOptimize(output.LinearX[count - 1]);
+            });
+            printf("  %-48s %8.1f M/s scalar %8.1f M/s batched, speedup %.2fx\n", "evaluations", count / scalarNs * 1e3,
+                   count / batchNs * 1e3, scalarNs / batchNs);
+        }
+    }
+}
+
+EXAM_BENCHMARK(SteeringBatched)
+{
+    printf("  kernel: %s\n", SteeringBatch::GetKernelName());
+    Agents agents{1'000'000};
+    BenchmarkBehavior<Seek>("Seek", agents, SteeringBatch::Seek);
+    BenchmarkBehavior<Flee>("Flee", agents, SteeringBatch::Flee);
+    BenchmarkBehavior<Pursuit>("Pursuit", agents, SteeringBatch::Pursuit);
+    BenchmarkBehavior<Evade>("Evade", agents, [](const SteeringBatch::Input& input, const SteeringBatch::Output& output)
+    {
+        SteeringBatch::Evade(input, output);
+    });
+    BenchmarkBehavior<Face>("Face", agents, SteeringBatch::Face);
+    BenchmarkBehavior<FleeWhileFacing>("FleeWhileFacing", agents, SteeringBatch::FleeWhileFacing);
+}
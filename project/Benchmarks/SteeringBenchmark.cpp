@@ -0,0 +1,128 @@
+#include "../stdafx.h"
+#include "Benchmark.h"
+#include "../Steering/AgentSteering.h"
+#include "../Steering/CombinedSteeringBehaviors.h"
+
+namespace
+{
+    constexpr size_t NumAgentInfos = 1024;
+
+    std::vector<AgentInfo> RandomAgentInfos(Elite::RandomEngine& rng)
+    {
+        std::vector<AgentInfo> agentInfos(NumAgentInfos);
+        for (AgentInfo& agentInfo: agentInfos)
+        {
+            agentInfo.Position = {rng.NextFloat(-250.f, 250.f), rng.NextFloat(-250.f, 250.f)};
+            agentInfo.LinearVelocity = {rng.NextFloat(-5.f, 5.f), rng.NextFloat(-5.f, 5.f)};
+            agentInfo.Orientation = rng.NextFloat(-3.14f, 3.14f);
+            agentInfo.MaxLinearSpeed = 5.f;
+            agentInfo.MaxAngularSpeed = 2.f;
+            agentInfo.Stamina = rng.NextFloat(0.f, 10.f);
+        }
+        return agentInfos;
+    }
+
+    // One set of behaviors per pipeline, both are configured the same way and start from the same random stream
+    struct Behaviors
+    {
+        Behaviors()
+        {
+            wander.SetRandomEngine(&rng);
+            seek.SetTarget(TargetData{{40.f, -20.f}});
+            evade.SetTarget(TargetData{{-10.f, 30.f}});
+            face.SetTarget(TargetData{{5.f, 5.f}});
+            fleeWhileFacing.SetTarget(TargetData{{-30.f, -30.f}});
+        }
+
+        Elite::RandomEngine rng{1337};
+        Seek seek{};
+        Wander wander{};
+        Evade evade{};
+        Face face{};
+        FleeWhileFacing fleeWhileFacing{};
+    };
+
+    struct VirtualPipeline
+    {
+        explicit VirtualPipeline(Behaviors& b):
+            seekAndWander({{&b.seek, 0.8f}, {&b.wander, 0.2f}}),
+            seekAndEvade({{&b.seek, 0.4f}, {&b.evade, 0.6f}}),
+            priority({&seekAndWander, &b.seek, &b.fleeWhileFacing, &b.face, &b.wander, &seekAndEvade})
+        {}
+
+        BlendedSteering seekAndWander;
+        BlendedSteering seekAndEvade;
+        PrioritySteering priority;
+    };
+
+    struct StaticPipeline
+    {
+        explicit StaticPipeline(Behaviors& b):
+            seekAndWander(b.seek, b.wander),
+            seekAndEvade(b.seek, b.evade),
+            priority(seekAndWander, b.seek, b.fleeWhileFacing, b.face, b.wander, seekAndEvade)
+        {}
+
+        SeekAndWanderSteering seekAndWander;
+        SeekAndEvadeSteering seekAndEvade;
+        AgentSteering priority;
+    };
+}
+
+EXAM_BENCHMARK(SteeringPipeline)
+{
+    constexpr size_t iterations = 10'000'000;
+    Elite::RandomEngine rng{7};
+    const std::vector<AgentInfo> agentInfos = RandomAgentInfos(rng);
+
+    // The two pipelines have to steer the same way before their speed means anything
+    {
+        Behaviors virtualBehaviors{}, staticBehaviors{};
+        VirtualPipeline virtualPipeline{virtualBehaviors};
+        StaticPipeline staticPipeline{staticBehaviors};
+        for (size_t i{}; i < NumAgentInfos; ++i)
+        {
+            const int idx = static_cast<int>(i % AgentSteering::NumBehaviors);
+            virtualPipeline.priority.SetValidSteeringIdx(idx);
+            staticPipeline.priority.SetValidSteeringIdx(idx);
+            const SteeringOutput expected = virtualPipeline.priority.CalculateSteering(agentInfos[i]);
+            const SteeringOutput actual = staticPipeline.priority.CalculateSteering(agentInfos[i]);
+            if (expected.LinearVelocity != actual.LinearVelocity || expected.AngularVelocity != actual.AngularVelocity
+                || expected.RunMode != actual.RunMode)
+            {
+                printf("  ERROR: Priority<...> differs from PrioritySteering at slot %d\n", idx);
+                return;
+            }
+        }
+    }
+
+    Behaviors virtualBehaviors{}, staticBehaviors{};
+    VirtualPipeline virtualPipeline{virtualBehaviors};
+    StaticPipeline staticPipeline{staticBehaviors};
+
+    size_t next{};
+    const double virtualBlendNs = Bench::Measure("BlendedSteering seek 0.4 + evade 0.6", iterations, [&]()
+    {
+        Bench::DoNotOptimize(virtualPipeline.seekAndEvade.CalculateSteering(agentInfos[++next % NumAgentInfos]));
+    });
+    const double staticBlendNs = Bench::Measure("Blended<Weighted<Seek, 0.4f>, Weighted<Evade, 0.6f>>", iterations, [&]()
+    {
+        Bench::DoNotOptimize(staticPipeline.seekAndEvade.CalculateSteering(agentInfos[++next % NumAgentInfos]));
+    });
+    printf("  blend speedup %.2fx\n", virtualBlendNs / staticBlendNs);
+
+    // Every call switches to the next slot, the branch predictor can't settle on one behavior
+    const double virtualPriorityNs = Bench::Measure("PrioritySteering, all 6 slots in turn", iterations, [&]()
+    {
+        ++next;
+        virtualPipeline.priority.SetValidSteeringIdx(static_cast<int>(next % AgentSteering::NumBehaviors));
+        Bench::DoNotOptimize(virtualPipeline.priority.CalculateSteering(agentInfos[next % NumAgentInfos]));
+    });
+    const double staticPriorityNs = Bench::Measure("Priority<...>, all 6 slots in turn", iterations, [&]()
+    {
+        ++next;
+        staticPipeline.priority.SetValidSteeringIdx(static_cast<int>(next % AgentSteering::NumBehaviors));
+        Bench::DoNotOptimize(staticPipeline.priority.CalculateSteering(agentInfos[next % NumAgentInfos]));
+    });
+    printf("  priority speedup %.2fx\n", virtualPriorityNs / staticPriorityNs);
+}
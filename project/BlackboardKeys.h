@@ -0,0 +1,55 @@
+#pragma once
+#include <map>
+#include <optional>
+#include <vector>
+#include "Exam_HelperStructs.h"
+#include "DecisionMaking/Blackboard.h"
+#include "Steering/AgentSteering.h"
+
+class IExamInterface;
+class FrameSnapshot;
+class FrameQueries;
+class InventoryMirror;
+class MapSearchSystem;
+class PathPointCache;
+
+namespace BlackboardKeys
+{
+    // Typed handles for every entry of the Agent's blackboard, resolved once at startup
+    inline const Elite::BlackboardKey<IExamInterface*> Interface{"interface"};
+    inline const Elite::BlackboardKey<AgentSteering*> PrioritySteering{"prioritySteering"};
+    inline const Elite::BlackboardKey<MapSearchSystem*> MapSearch{"mapSearch"};
+    inline const Elite::BlackboardKey<const FrameSnapshot*> Snapshot{"snapshot"};
+    inline const Elite::BlackboardKey<FrameQueries*> Queries{"queries"};
+    inline const Elite::BlackboardKey<PathPointCache*> PathCache{"pathCache"};
+    inline const Elite::BlackboardKey<::InventoryMirror*> InventoryMirror{"inventoryMirror"};
+    inline const Elite::BlackboardKey<Elite::RandomEngine*> RandomEngine{"randomEngine"};
+
+    // Enemy data
+    inline const Elite::BlackboardKey<bool> IsBeingChased{"isBeingChased"};
+    inline const Elite::BlackboardKey<std::vector<EnemyInfo>> EnemiesInFovInfo{"enemiesInFovInfo"};
+    inline const Elite::BlackboardKey<Elite::Vector2> LastEnemyPos{"lastEnemyPos"};
+    inline const Elite::BlackboardKey<bool> ShotLastFrame{"shotLastFrame"};
+    inline const Elite::BlackboardKey<bool> WasBitten{"wasBitten"};
+
+    // Steering data
+    inline const Elite::BlackboardKey<bool> RadarMode{"radarMode"};
+    inline const Elite::BlackboardKey<std::optional<Elite::Vector2>> CurrentTarget{"currentTarget"};
+
+    // Item data
+    inline const Elite::BlackboardKey<std::optional<eItemType>> TargetItemType{"targetItemType"};
+    inline const Elite::BlackboardKey<std::map<eItemType, bool>> ItemNeedList{"itemNeedList"};
+    inline const Elite::BlackboardKey<std::vector<ItemInfo>> ItemSeekList{"itemSeekList"};
+    inline const Elite::BlackboardKey<int> ItemsInFOV{"itemsInFOV"};
+    inline const Elite::BlackboardKey<int> CurrentItemInFOV{"currentItemInFOV"};
+
+    // Channels without data, marked by the Agent and the actions so the event-driven BT can observe them
+    inline const Elite::BlackboardChannel SnapshotAgentInfo{"snapshot.agentInfo"};
+    inline const Elite::BlackboardChannel SnapshotFOVStats{"snapshot.fovStats"};
+    inline const Elite::BlackboardChannel SnapshotHousesInFOV{"snapshot.housesInFOV"};
+    inline const Elite::BlackboardChannel SnapshotEnemiesInFOV{"snapshot.enemiesInFOV"};
+    inline const Elite::BlackboardChannel SnapshotItemsInFOV{"snapshot.itemsInFOV"};
+    inline const Elite::BlackboardChannel SnapshotPurgeZonesInFOV{"snapshot.purgeZonesInFOV"};
+    inline const Elite::BlackboardChannel Inventory{"inventory"};
+    inline const Elite::BlackboardChannel FoundHouses{"mapSearch.foundHouses"};
+}
@@ -1,5 +1,6 @@
 #include "../stdafx.h"
 #include "BTComposites.h"
+#include "FlatBehaviorTree.h"
 
 using namespace Elite;
 //SELECTOR
@@ -12,7 +13,7 @@ BehaviorState BehaviorSelector::Execute(Blackboard *const pBlackBoard)
     {
         auto *childBehavior = m_ChildBehaviors[i];
         //Check the current state and apply the selector Logic:
-        m_CurrentState = childBehavior->Execute(pBlackBoard);
+        m_CurrentState = childBehavior->Tick(pBlackBoard);
 
         switch (m_CurrentState)
         {
@@ -49,7 +50,7 @@ BehaviorState BehaviorSequence::Execute(Blackboard *const pBlackBoard)
         auto *childBehavior = m_ChildBehaviors[i];
         //Every Child: Execute and store the result in m_CurrentState
         //Check the current state and apply the sequence Logic:
-        m_CurrentState = childBehavior->Execute(pBlackBoard);
+        m_CurrentState = childBehavior->Tick(pBlackBoard);
         switch (m_CurrentState)
         {
             //if a child returns Failed:
@@ -76,7 +77,7 @@ BehaviorState BehaviorPartialSequence::Execute(Blackboard *const pBlackBoard)
 {
     while (m_CurrentBehaviorIndex < static_cast<int>(m_ChildBehaviors.size()))
     {
-        m_CurrentState = m_ChildBehaviors[m_CurrentBehaviorIndex]->Execute(pBlackBoard);
+        m_CurrentState = m_ChildBehaviors[m_CurrentBehaviorIndex]->Tick(pBlackBoard);
         switch (m_CurrentState)
         {
             case BehaviorState::Failure:
@@ -95,3 +96,18 @@ BehaviorState BehaviorPartialSequence::Execute(Blackboard *const pBlackBoard)
     m_CurrentState = BehaviorState::Success;
     return m_CurrentState;
 }
+
+uint32_t BehaviorSelector::Compile(FlatBehaviorTree &flatTree) const
+{
+    return flatTree.AddNode({FlatNodeType::Selector}, m_ChildBehaviors);
+}
+
+uint32_t BehaviorSequence::Compile(FlatBehaviorTree &flatTree) const
+{
+    return flatTree.AddNode({FlatNodeType::Sequence}, m_ChildBehaviors);
+}
+
+uint32_t BehaviorPartialSequence::Compile(FlatBehaviorTree &flatTree) const
+{
+    return flatTree.AddNode({FlatNodeType::PartialSequence}, m_ChildBehaviors);
+}
@@ -18,6 +18,7 @@ namespace Elite
         }
 
         BehaviorState Execute(Blackboard* const pBlackBoard) override = 0;
+        std::span<IBehavior* const> GetChildren() const override { return m_ChildBehaviors; }
 
     protected:
         std::vector<IBehavior*> m_ChildBehaviors = {};
@@ -34,6 +35,8 @@ namespace Elite
         ~BehaviorSelector() override = default;
 
         BehaviorState Execute(Blackboard* const pBlackBoard) override;
+        uint32_t Compile(FlatBehaviorTree& flatTree) const override;
+        const char* GetTypeName() const override { return "Selector"; }
     };
 
     //--- SEQUENCE ---
@@ -46,6 +49,8 @@ namespace Elite
         ~BehaviorSequence() override = default;
 
         BehaviorState Execute(Blackboard* const pBlackBoard) override;
+        uint32_t Compile(FlatBehaviorTree& flatTree) const override;
+        const char* GetTypeName() const override { return "Sequence"; }
     };
 
     //--- PARTIAL SEQUENCE ---
@@ -58,6 +63,8 @@ namespace Elite
         ~BehaviorPartialSequence() override = default;
 
         BehaviorState Execute(Blackboard* const pBlackBoard) override;
+        uint32_t Compile(FlatBehaviorTree& flatTree) const override;
+        const char* GetTypeName() const override { return "PartialSequence"; }
 
     private:
         unsigned int m_CurrentBehaviorIndex = 0;
@@ -1,5 +1,6 @@
 #include "../stdafx.h"
 #include "BTDecorators.h"
+#include "FlatBehaviorTree.h"
 
 using namespace Elite;
 
@@ -7,7 +8,7 @@ BehaviorState BehaviorConditionDecorator::Execute(Blackboard * const pBlackBoard
 {
     if (m_fpConditional == nullptr) return BehaviorState::Failure;
     if (!m_fpConditional(pBlackBoard)) return BehaviorState::Failure;
-    return m_pChildBehavior->Execute(pBlackBoard);
+    return m_pChildBehavior->Tick(pBlackBoard);
 }
 
 BehaviorState BehaviorBlackboardCondition::Execute(Blackboard * const pBlackBoard)
@@ -16,12 +17,12 @@ BehaviorState BehaviorBlackboardCondition::Execute(Blackboard * const pBlackBoar
     pBlackBoard->GetData(m_BlackboardKey, condition);
     condition = m_Invert ? !condition : condition;
     if (!condition) return BehaviorState::Failure;
-    return m_pChildBehavior->Execute(pBlackBoard);
+    return m_pChildBehavior->Tick(pBlackBoard);
 }
 
 BehaviorState Elite::BehaviorInverter::Execute(Blackboard *const pBlackBoard)
 {
-    BehaviorState state = m_pChildBehavior->Execute(pBlackBoard);
+    BehaviorState state = m_pChildBehavior->Tick(pBlackBoard);
     switch (state)
     {
         case Elite::BehaviorState::Failure:
@@ -44,7 +45,7 @@ BehaviorState BehaviorConditionalInverter::Execute(Blackboard *const pBlackBoard
 
 BehaviorState BehaviorForceSuccess::Execute(Blackboard *const pBlackBoard)
 {
-    BehaviorState state = m_pChildBehavior->Execute(pBlackBoard);
+    BehaviorState state = m_pChildBehavior->Tick(pBlackBoard);
     switch (state)
     {
         case Elite::BehaviorState::Failure:
@@ -59,7 +60,7 @@ BehaviorState BehaviorForceSuccess::Execute(Blackboard *const pBlackBoard)
 
 BehaviorState BehaviorForceFailure::Execute(Blackboard *const pBlackBoard)
 {
-    BehaviorState state = m_pChildBehavior->Execute(pBlackBoard);
+    BehaviorState state = m_pChildBehavior->Tick(pBlackBoard);
     switch (state)
     {
         case Elite::BehaviorState::Failure:
@@ -80,14 +81,14 @@ BehaviorState BehaviorRepeat::Execute(Blackboard *const pBlackBoard)
         for (int i = m_CurrentNumCycles; i < m_NumCycles; ++i)
         {
             ++m_CurrentNumCycles;
-            BehaviorState state = m_pChildBehavior->Execute(pBlackBoard);
+            BehaviorState state = m_pChildBehavior->Tick(pBlackBoard);
             if (state == Elite::BehaviorState::Failure) return BehaviorState::Failure;
             if (state == Elite::BehaviorState::Running) return BehaviorState::Running;
         }
         m_CurrentNumCycles = 0;
         if (start == 0) return BehaviorState::Success;
     }
-    BehaviorState state = m_pChildBehavior->Execute(pBlackBoard);
+    BehaviorState state = m_pChildBehavior->Tick(pBlackBoard);
     switch (state)
     {
         case Elite::BehaviorState::Failure:
@@ -119,7 +120,7 @@ BehaviorState BehaviorRepeatBlackboardValue::Execute(Blackboard * const pBlackBo
 
 BehaviorState BehaviorRetryUntilSuccessful::Execute(Blackboard *const pBlackBoard)
 {
-    BehaviorState state = m_pChildBehavior->Execute(pBlackBoard);
+    BehaviorState state = m_pChildBehavior->Tick(pBlackBoard);
     switch (state)
     {
         case Elite::BehaviorState::Failure:
@@ -144,7 +145,7 @@ BehaviorState BehaviorRetryUntilSuccessful::Execute(Blackboard *const pBlackBoar
 
 BehaviorState BehaviorKeepRunningUntilFailure::Execute(Blackboard *const pBlackBoard)
 {
-    BehaviorState state = m_pChildBehavior->Execute(pBlackBoard);
+    BehaviorState state = m_pChildBehavior->Tick(pBlackBoard);
     switch (state)
     {
         case Elite::BehaviorState::Running:
@@ -159,7 +160,7 @@ BehaviorState BehaviorKeepRunningUntilFailure::Execute(Blackboard *const pBlackB
 
 BehaviorState BehaviorRepeatUntil::Execute(Blackboard *const pBlackBoard)
 {
-    BehaviorState state = m_pChildBehavior->Execute(pBlackBoard);
+    BehaviorState state = m_pChildBehavior->Tick(pBlackBoard);
     if (m_fpConditional == nullptr) return BehaviorState::Failure;
 
     switch (state)
@@ -179,8 +180,88 @@ BehaviorState BehaviorRepeatUntil::Execute(Blackboard *const pBlackBoard)
 
 BehaviorState BehaviorAbortIf::Execute(Blackboard * const pBlackBoard)
 {
-    BehaviorState state = m_pChildBehavior->Execute(pBlackBoard);
+    BehaviorState state = m_pChildBehavior->Tick(pBlackBoard);
     if (m_fpConditional == nullptr || m_fpConditional(pBlackBoard)) return BehaviorState::Failure;
 
     return state;
-}
\ No newline at end of file
+}
+
+//FLAT BACKEND
+uint32_t BehaviorConditionDecorator::Compile(FlatBehaviorTree &flatTree) const
+{
+    FlatNode node{FlatNodeType::Pass};
+    node.pGuard = m_fpConditional ? m_fpConditional : &FlatBehaviorTree::AlwaysFalse;
+    return flatTree.AddDecorator(node, m_pChildBehavior);
+}
+
+uint32_t BehaviorBlackboardCondition::Compile(FlatBehaviorTree &flatTree) const
+{
+    FlatNode node{FlatNodeType::BlackboardCondition};
+    node.Flag = m_Invert;
+    node.Param = flatTree.AddKey(m_BlackboardKey);
+    return flatTree.AddDecorator(node, m_pChildBehavior);
+}
+
+uint32_t BehaviorInverter::Compile(FlatBehaviorTree &flatTree) const
+{
+    return flatTree.AddDecorator({FlatNodeType::Inverter}, m_pChildBehavior);
+}
+
+uint32_t BehaviorConditionalInverter::Compile(FlatBehaviorTree &flatTree) const
+{
+    FlatNode node{FlatNodeType::ConditionalInverter};
+    node.pCondition = m_fpConditional;
+    return flatTree.AddNode(node);
+}
+
+uint32_t BehaviorForceSuccess::Compile(FlatBehaviorTree &flatTree) const
+{
+    return flatTree.AddDecorator({FlatNodeType::Pass, FlatForce::Success}, m_pChildBehavior);
+}
+
+uint32_t BehaviorForceFailure::Compile(FlatBehaviorTree &flatTree) const
+{
+    return flatTree.AddDecorator({FlatNodeType::Pass, FlatForce::Failure}, m_pChildBehavior);
+}
+
+uint32_t BehaviorRepeat::Compile(FlatBehaviorTree &flatTree) const
+{
+    FlatNode node{FlatNodeType::Repeat};
+    node.Flag = m_TryToRunInOneFrame;
+    node.Param = m_NumCycles;
+    return flatTree.AddDecorator(node, m_pChildBehavior);
+}
+
+uint32_t BehaviorRepeatBlackboardValue::Compile(FlatBehaviorTree &flatTree) const
+{
+    FlatNode node{FlatNodeType::RepeatBlackboardValue};
+    node.Flag = m_TryToRunInOneFrame;
+    node.Param = flatTree.AddKey(m_BlackboardKey);
+    return flatTree.AddDecorator(node, m_pChildBehavior);
+}
+
+uint32_t BehaviorRetryUntilSuccessful::Compile(FlatBehaviorTree &flatTree) const
+{
+    FlatNode node{FlatNodeType::RetryUntilSuccessful};
+    node.Param = m_NumAttempts;
+    return flatTree.AddDecorator(node, m_pChildBehavior);
+}
+
+uint32_t BehaviorKeepRunningUntilFailure::Compile(FlatBehaviorTree &flatTree) const
+{
+    return flatTree.AddDecorator({FlatNodeType::KeepRunningUntilFailure}, m_pChildBehavior);
+}
+
+uint32_t BehaviorRepeatUntil::Compile(FlatBehaviorTree &flatTree) const
+{
+    FlatNode node{FlatNodeType::RepeatUntil};
+    node.pCondition = m_fpConditional;
+    return flatTree.AddDecorator(node, m_pChildBehavior);
+}
+
+uint32_t BehaviorAbortIf::Compile(FlatBehaviorTree &flatTree) const
+{
+    FlatNode node{FlatNodeType::AbortIf};
+    node.pCondition = m_fpConditional;
+    return flatTree.AddDecorator(node, m_pChildBehavior);
+}
@@ -1,5 +1,4 @@
 #pragma once
-#include <utility>
 #include "BehaviorTree.h"
 
 
@@ -11,13 +10,17 @@ namespace Elite
 	class BehaviorConditionDecorator final : public IBehavior
 	{
 	public:
-		explicit BehaviorConditionDecorator(IBehavior* const childBehavior, std::function<bool(Blackboard*)> fp) :
-		m_pChildBehavior(childBehavior), m_fpConditional(std::move(fp)) {}
+		explicit BehaviorConditionDecorator(IBehavior* const childBehavior, BehaviorConditionFn fp) :
+		m_pChildBehavior(childBehavior), m_fpConditional(fp) {}
 		~BehaviorConditionDecorator() override { SAFE_DELETE(m_pChildBehavior); }
 
 		BehaviorState Execute(Blackboard* const pBlackBoard) override;
+		uint32_t Compile(FlatBehaviorTree& flatTree) const override;
+		std::span<IBehavior* const> GetChildren() const override { return {&m_pChildBehavior, 1}; }
+		const char* GetTypeName() const override { return "ConditionDecorator"; }
+		const void* GetFunctionAddress() const override { return reinterpret_cast<const void*>(m_fpConditional); }
 	private:
-		std::function<bool(Blackboard*)> m_fpConditional = nullptr;
+		BehaviorConditionFn m_fpConditional = nullptr;
 		IBehavior* m_pChildBehavior = nullptr;
 	};
 
@@ -29,8 +32,11 @@ namespace Elite
 		~BehaviorBlackboardCondition() override { SAFE_DELETE(m_pChildBehavior); }
 
 		BehaviorState Execute(Blackboard* const pBlackBoard) override;
+		uint32_t Compile(FlatBehaviorTree& flatTree) const override;
+		std::span<IBehavior* const> GetChildren() const override { return {&m_pChildBehavior, 1}; }
+		const char* GetTypeName() const override { return "BlackboardCondition"; }
 	private:
-		const std::string m_BlackboardKey{};
+		const BlackboardKey<bool> m_BlackboardKey;
 		bool m_Invert = false;
 		IBehavior* m_pChildBehavior = nullptr;
 	};
@@ -42,6 +48,9 @@ namespace Elite
 		~BehaviorInverter() override { SAFE_DELETE(m_pChildBehavior); }
 
 		BehaviorState Execute(Blackboard* const pBlackBoard) override;
+		uint32_t Compile(FlatBehaviorTree& flatTree) const override;
+		std::span<IBehavior* const> GetChildren() const override { return {&m_pChildBehavior, 1}; }
+		const char* GetTypeName() const override { return "Inverter"; }
 	private:
 		IBehavior* m_pChildBehavior = nullptr;
 	};
@@ -49,12 +58,15 @@ namespace Elite
 	class BehaviorConditionalInverter final : public IBehavior
 	{
 	public:
-		explicit BehaviorConditionalInverter(std::function<bool(Blackboard*)> fp) : m_fpConditional(std::move(fp)) {}
+		explicit BehaviorConditionalInverter(BehaviorConditionFn fp) : m_fpConditional(fp) {}
 
 		BehaviorState Execute(Blackboard* const pBlackBoard) override;
+		uint32_t Compile(FlatBehaviorTree& flatTree) const override;
+		const char* GetTypeName() const override { return "ConditionalInverter"; }
+		const void* GetFunctionAddress() const override { return reinterpret_cast<const void*>(m_fpConditional); }
 
 	private:
-		std::function<bool(Blackboard*)> m_fpConditional = nullptr;
+		BehaviorConditionFn m_fpConditional = nullptr;
 	};
 
 	class BehaviorForceSuccess final : public IBehavior
@@ -64,6 +76,9 @@ namespace Elite
 		~BehaviorForceSuccess() override { SAFE_DELETE(m_pChildBehavior); }
 
 		BehaviorState Execute(Blackboard* const pBlackBoard) override;
+		uint32_t Compile(FlatBehaviorTree& flatTree) const override;
+		std::span<IBehavior* const> GetChildren() const override { return {&m_pChildBehavior, 1}; }
+		const char* GetTypeName() const override { return "ForceSuccess"; }
 	private:
 		IBehavior* m_pChildBehavior = nullptr;
 	};
@@ -75,6 +90,9 @@ namespace Elite
 		~BehaviorForceFailure() override { SAFE_DELETE(m_pChildBehavior); }
 
 		BehaviorState Execute(Blackboard* const pBlackBoard) override;
+		uint32_t Compile(FlatBehaviorTree& flatTree) const override;
+		std::span<IBehavior* const> GetChildren() const override { return {&m_pChildBehavior, 1}; }
+		const char* GetTypeName() const override { return "ForceFailure"; }
 	private:
 		IBehavior* m_pChildBehavior = nullptr;
 	};
@@ -87,6 +105,9 @@ namespace Elite
 		~BehaviorRepeat() override { SAFE_DELETE(m_pChildBehavior); }
 
 		virtual BehaviorState Execute(Blackboard* const pBlackBoard) override;
+		uint32_t Compile(FlatBehaviorTree& flatTree) const override;
+		std::span<IBehavior* const> GetChildren() const override { return {&m_pChildBehavior, 1}; }
+		const char* GetTypeName() const override { return "Repeat"; }
 	protected:
 		void SetNumCycles(int numCycles) { m_NumCycles = numCycles; }
 		IBehavior* m_pChildBehavior = nullptr;
@@ -105,8 +126,10 @@ namespace Elite
 		~BehaviorRepeatBlackboardValue() override { SAFE_DELETE(m_pChildBehavior); }
 
 		BehaviorState Execute(Blackboard* const pBlackBoard) override;
+		uint32_t Compile(FlatBehaviorTree& flatTree) const override;
+		const char* GetTypeName() const override { return "RepeatBlackboardValue"; }
 	private:
-		std::string m_BlackboardKey{};
+		BlackboardKey<int> m_BlackboardKey;
 	};
 
 	class BehaviorRetryUntilSuccessful final : public IBehavior
@@ -116,6 +139,9 @@ namespace Elite
 		~BehaviorRetryUntilSuccessful() override { SAFE_DELETE(m_pChildBehavior); }
 
 		BehaviorState Execute(Blackboard* const pBlackBoard) override;
+		uint32_t Compile(FlatBehaviorTree& flatTree) const override;
+		std::span<IBehavior* const> GetChildren() const override { return {&m_pChildBehavior, 1}; }
+		const char* GetTypeName() const override { return "RetryUntilSuccessful"; }
 	private:
 		IBehavior* m_pChildBehavior = nullptr;
 		const int m_NumAttempts;
@@ -129,6 +155,9 @@ namespace Elite
 		~BehaviorKeepRunningUntilFailure() override { SAFE_DELETE(m_pChildBehavior); }
 
 		BehaviorState Execute(Blackboard* const pBlackBoard) override;
+		uint32_t Compile(FlatBehaviorTree& flatTree) const override;
+		std::span<IBehavior* const> GetChildren() const override { return {&m_pChildBehavior, 1}; }
+		const char* GetTypeName() const override { return "KeepRunningUntilFailure"; }
 	private:
 		IBehavior* m_pChildBehavior = nullptr;
 	};
@@ -136,23 +165,31 @@ namespace Elite
 	class BehaviorRepeatUntil final : public IBehavior
 	{
 	public:
-		explicit BehaviorRepeatUntil(IBehavior* const childBehavior, std::function<bool(Blackboard*)> fp) : m_pChildBehavior(childBehavior), m_fpConditional(std::move(fp)) {}
+		explicit BehaviorRepeatUntil(IBehavior* const childBehavior, BehaviorConditionFn fp) : m_pChildBehavior(childBehavior), m_fpConditional(fp) {}
 		~BehaviorRepeatUntil() override { SAFE_DELETE(m_pChildBehavior); }
 
 		BehaviorState Execute(Blackboard* const pBlackBoard) override;
+		uint32_t Compile(FlatBehaviorTree& flatTree) const override;
+		std::span<IBehavior* const> GetChildren() const override { return {&m_pChildBehavior, 1}; }
+		const char* GetTypeName() const override { return "RepeatUntil"; }
+		const void* GetFunctionAddress() const override { return reinterpret_cast<const void*>(m_fpConditional); }
 	private:
 		IBehavior* m_pChildBehavior = nullptr;
-		std::function<bool(Blackboard*)> m_fpConditional = nullptr;
+		BehaviorConditionFn m_fpConditional = nullptr;
 	};
 	class BehaviorAbortIf final : public IBehavior
 	{
 	public:
-		explicit BehaviorAbortIf(IBehavior* const childBehavior, std::function<bool(Blackboard*)> fp) : m_pChildBehavior(childBehavior), m_fpConditional(std::move(fp)) {}
+		explicit BehaviorAbortIf(IBehavior* const childBehavior, BehaviorConditionFn fp) : m_pChildBehavior(childBehavior), m_fpConditional(fp) {}
 		~BehaviorAbortIf() override { SAFE_DELETE(m_pChildBehavior); }
 
 		BehaviorState Execute(Blackboard* const pBlackBoard) override;
+		uint32_t Compile(FlatBehaviorTree& flatTree) const override;
+		std::span<IBehavior* const> GetChildren() const override { return {&m_pChildBehavior, 1}; }
+		const char* GetTypeName() const override { return "AbortIf"; }
+		const void* GetFunctionAddress() const override { return reinterpret_cast<const void*>(m_fpConditional); }
 	private:
 		IBehavior* m_pChildBehavior = nullptr;
-		std::function<bool(Blackboard*)> m_fpConditional = nullptr;
+		BehaviorConditionFn m_fpConditional = nullptr;
 	};
 }
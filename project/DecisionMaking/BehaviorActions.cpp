@@ -5,23 +5,59 @@
 #include "BehaviorTree.h"
 #include "Blackboard.h"
 #include "IExamInterface.h"
+#include "../BlackboardKeys.h"
+#include "../FrameQueries.h"
+#include "../FrameSnapshot.h"
 #include "../IndexMaps.h"
+#include "../InventoryMirror.h"
 #include "../MapSearchSystem.h"
-#include "../Steering/CombinedSteeringBehaviors.h"
+#include "../Steering/AgentSteering.h"
 #include "../Steering/SteeringBehaviors.h"
+#include "../Profiler.h"
+
+void BT_Actions::NameFunctions(Elite::BehaviorTree * const pBehaviorTree)
+{
+    pBehaviorTree->NameFunction(FleePurgeZone, "BT_Actions::FleePurgeZone");
+    pBehaviorTree->NameFunction(SetIsBeingChased, "BT_Actions::SetIsBeingChased");
+    pBehaviorTree->NameFunction(EvadeInHouseInFOV, "BT_Actions::EvadeInHouseInFOV");
+    pBehaviorTree->NameFunction(EvadeToClosestRememberedHouse, "BT_Actions::EvadeToClosestRememberedHouse");
+    pBehaviorTree->NameFunction(FleeEnemy, "BT_Actions::FleeEnemy");
+    pBehaviorTree->NameFunction(SetEnemyBehindPos, "BT_Actions::SetEnemyBehindPos");
+    pBehaviorTree->NameFunction(SetRunModeTrue, "BT_Actions::SetRunModeTrue");
+    pBehaviorTree->NameFunction(FaceAndFleeEnemy, "BT_Actions::FaceAndFleeEnemy");
+    pBehaviorTree->NameFunction(Shoot, "BT_Actions::Shoot");
+    pBehaviorTree->NameFunction(ShotLastFrameActions, "BT_Actions::ShotLastFrameActions");
+    pBehaviorTree->NameFunction(DiscardWeapon, "BT_Actions::DiscardWeapon");
+    pBehaviorTree->NameFunction(SeekFirstItemInSeekList, "BT_Actions::SeekFirstItemInSeekList");
+    pBehaviorTree->NameFunction(SeekTargetItem, "BT_Actions::SeekTargetItem");
+    pBehaviorTree->NameFunction(SeekGarbageInGrabRange, "BT_Actions::SeekGarbageInGrabRange");
+    pBehaviorTree->NameFunction(GrabItem, "BT_Actions::GrabItem");
+    pBehaviorTree->NameFunction(RemoveGarbage, "BT_Actions::RemoveGarbage");
+    pBehaviorTree->NameFunction(CheckItemNeeds, "BT_Actions::CheckItemNeeds");
+    pBehaviorTree->NameFunction(SetPossibleItemTarget, "BT_Actions::SetPossibleItemTarget");
+    pBehaviorTree->NameFunction(UseItemIfNeeded, "BT_Actions::UseItemIfNeeded");
+    pBehaviorTree->NameFunction(CheckoutItems, "BT_Actions::CheckoutItems");
+    pBehaviorTree->NameFunction(CheckoutHouse, "BT_Actions::CheckoutHouse");
+    pBehaviorTree->NameFunction(GoToNextTarget, "BT_Actions::GoToNextTarget");
+    pBehaviorTree->NameFunction(GoToClosestHouse, "BT_Actions::GoToClosestHouse");
+    pBehaviorTree->NameFunction(SetNextTarget, "BT_Actions::SetNextTarget");
+    pBehaviorTree->NameFunction(GoIntoRadarMode, "BT_Actions::GoIntoRadarMode");
+    pBehaviorTree->NameFunction(Wander, "BT_Actions::Wander");
+    pBehaviorTree->NameFunction(SetDebugSteering, "BT_Actions::SetDebugSteering");
+}
 
 #pragma region PurgeZone
 
 Elite::BehaviorState BT_Actions::FleePurgeZone(Elite::Blackboard * const pBlackboard)
 {
+    EXAM_PROFILE_SCOPE("BT_Actions::FleePurgeZone");
     if (DEBUG_MODE) std::cout << "FleePurgeZone\n";
-    IExamInterface *pInterface;
+    const FrameSnapshot *pSnapshot;
+    pBlackboard->GetData(BlackboardKeys::Snapshot, pSnapshot);
+    assert(pSnapshot && "Snapshot not found in blackboard");
 
-    pBlackboard->GetData("interface", pInterface);
-    assert(pInterface && "Interface not found in blackboard");
-
-    int numPurgeZones = pInterface->FOV_GetStats().NumPurgeZones;
-    auto purgeZones = pInterface->GetPurgeZonesInFOV();
+    int numPurgeZones = pSnapshot->GetFOVStats().NumPurgeZones;
+    const auto &purgeZones = pSnapshot->GetPurgeZonesInFOV();
     Elite::Vector2 fleeDir;
     switch (numPurgeZones)
     {
@@ -32,7 +68,7 @@ Elite::BehaviorState BT_Actions::FleePurgeZone(Elite::Blackboard * const pBlackb
             Elite::Vector2 perp = Elite::Vector2::Perpendicular(diff).GetNormalized();
 
             // Choose the perpendicular direction that points away from zones
-            const Elite::Vector2 toAgent = pInterface->Agent_GetInfo().Position - (
+            const Elite::Vector2 toAgent = pSnapshot->GetAgentInfo().Position - (
                                                purgeZones[0].Center + purgeZones[1].Center) * 0.5f;
             if (perp.Dot(toAgent) < 0)
                 perp = -perp;
@@ -50,7 +86,7 @@ Elite::BehaviorState BT_Actions::FleePurgeZone(Elite::Blackboard * const pBlackb
             Elite::Vector2 perp = Elite::Vector2::Perpendicular(diff).GetNormalized();
 
             // Ensure it’s facing away from the center
-            const Elite::Vector2 toAgent = (pInterface->Agent_GetInfo().Position - avgCenter).GetNormalized();
+            const Elite::Vector2 toAgent = (pSnapshot->GetAgentInfo().Position - avgCenter).GetNormalized();
             if (perp.Dot(toAgent) < 0)
                 perp = -perp;
             fleeDir = perp;
@@ -59,7 +95,7 @@ Elite::BehaviorState BT_Actions::FleePurgeZone(Elite::Blackboard * const pBlackb
         // More than 3 zones or just one: flee from the first zone
         default:
         {
-            fleeDir = pInterface->Agent_GetInfo().Position - purgeZones[0].Center;
+            fleeDir = pSnapshot->GetAgentInfo().Position - purgeZones[0].Center;
             fleeDir.Normalize();
             break;
         }
@@ -76,22 +112,23 @@ Elite::BehaviorState BT_Actions::FleePurgeZone(Elite::Blackboard * const pBlackb
 
 Elite::BehaviorState BT_Actions::SetIsBeingChased(Elite::Blackboard * const pBlackboard)
 {
+    EXAM_PROFILE_SCOPE("BT_Actions::SetIsBeingChased");
     if (DEBUG_MODE) std::cout << "SetIsBeingChased\n";
-    pBlackboard->ChangeData("isBeingChased", true);
+    pBlackboard->ChangeData(BlackboardKeys::IsBeingChased, true);
     return Elite::BehaviorState::Success;
 }
 
 Elite::BehaviorState BT_Actions::EvadeInHouseInFOV(Elite::Blackboard * const pBlackboard)
 {
+    EXAM_PROFILE_SCOPE("BT_Actions::EvadeInHouseInFOV");
     if (DEBUG_MODE) std::cout << "EvadeInHouseInFOV\n";
-    IExamInterface *pInterface;
-
-    pBlackboard->GetData("interface", pInterface);
-    assert(pInterface && "Interface not found in blackboard");
+    const FrameSnapshot *pSnapshot;
+    pBlackboard->GetData(BlackboardKeys::Snapshot, pSnapshot);
+    assert(pSnapshot && "Snapshot not found in blackboard");
 
-    const Elite::Vector2 agentPos = pInterface->Agent_GetInfo().Position;
+    const Elite::Vector2 agentPos = pSnapshot->GetAgentInfo().Position;
 
-    const Elite::Vector2 target = BT_Helpers::FindClosestCornerInHouse(agentPos, pInterface->GetHousesInFOV()[0]);
+    const Elite::Vector2 target = BT_Helpers::FindClosestCornerInHouse(agentPos, pSnapshot->GetHousesInFOV()[0]);
 
     BT_Helpers::SetSteeringEvade(pBlackboard, target);
     return Elite::BehaviorState::Success;
@@ -99,16 +136,16 @@ Elite::BehaviorState BT_Actions::EvadeInHouseInFOV(Elite::Blackboard * const pBl
 
 Elite::BehaviorState BT_Actions::EvadeToClosestRememberedHouse(Elite::Blackboard * const pBlackboard)
 {
+    EXAM_PROFILE_SCOPE("BT_Actions::EvadeToClosestRememberedHouse");
     if (DEBUG_MODE) std::cout << "EvadeToClosestRememberedHouse\n";
     MapSearchSystem *pMapSearch;
-    IExamInterface *pInterface;
-
-    pBlackboard->GetData("interface", pInterface);
-    assert(pInterface && "Interface not found in blackboard");
-    pBlackboard->GetData("mapSearch", pMapSearch);
+    const FrameSnapshot *pSnapshot;
+    pBlackboard->GetData(BlackboardKeys::Snapshot, pSnapshot);
+    assert(pSnapshot && "Snapshot not found in blackboard");
+    pBlackboard->GetData(BlackboardKeys::MapSearch, pMapSearch);
     assert(pMapSearch && "MapSearch not found in blackboard");
 
-    const Elite::Vector2 agentPos = pInterface->Agent_GetInfo().Position;
+    const Elite::Vector2 agentPos = pSnapshot->GetAgentInfo().Position;
     HouseInfo houseInfo;
     pMapSearch->GetClosestHouse(agentPos, houseInfo);
     const Elite::Vector2 target = BT_Helpers::FindClosestCornerInHouse(agentPos, houseInfo);
@@ -119,17 +156,21 @@ Elite::BehaviorState BT_Actions::EvadeToClosestRememberedHouse(Elite::Blackboard
 
 Elite::BehaviorState BT_Actions::FleeEnemy(Elite::Blackboard * const pBlackboard)
 {
+    EXAM_PROFILE_SCOPE("BT_Actions::FleeEnemy");
     if (DEBUG_MODE) std::cout << "FleeEnemy\n";
 
     if (DEBUG_MODE) std::cout << "EvadeToTarget\n";
-    IExamInterface *pInterface;
-    pBlackboard->GetData("interface", pInterface);
-    assert(pInterface && "Interface not found in blackboard");
+    const FrameSnapshot *pSnapshot;
+    pBlackboard->GetData(BlackboardKeys::Snapshot, pSnapshot);
+    assert(pSnapshot && "Snapshot not found in blackboard");
 
     // find a random point around the agent in a radius of 30 units
-    const Elite::Vector2 agentPos = pInterface->Agent_GetInfo().Position;
+    const Elite::Vector2 agentPos = pSnapshot->GetAgentInfo().Position;
     const float fleeRadius = 200.f;
-    const Elite::Vector2 fleeDir = Elite::OrientationToVector(Elite::ToRadians(rand() % 360));
+    Elite::RandomEngine *pRng;
+    pBlackboard->GetData(BlackboardKeys::RandomEngine, pRng);
+    assert(pRng && "Random engine not found in blackboard");
+    const Elite::Vector2 fleeDir = Elite::OrientationToVector(Elite::ToRadians(static_cast<float>(Elite::randomInt(*pRng, 360))));
     const Elite::Vector2 target = agentPos + fleeDir * fleeRadius;
 
     BT_Helpers::SetSteeringEvade(pBlackboard, target);
@@ -138,29 +179,31 @@ Elite::BehaviorState BT_Actions::FleeEnemy(Elite::Blackboard * const pBlackboard
 
 Elite::BehaviorState BT_Actions::SetEnemyBehindPos(Elite::Blackboard * const pBlackboard)
 {
+    EXAM_PROFILE_SCOPE("BT_Actions::SetEnemyBehindPos");
     if (DEBUG_MODE) std::cout << "SetEnemyBehindPos\n";
 
     Elite::Vector2 lastEnemyPos(0, 0);
-    IExamInterface *pInterface;
-    pBlackboard->GetData("interface", pInterface);
-    assert(pInterface && "Interface not found in blackboard");
+    const FrameSnapshot *pSnapshot;
+    pBlackboard->GetData(BlackboardKeys::Snapshot, pSnapshot);
+    assert(pSnapshot && "Snapshot not found in blackboard");
 
     // Set the last enemy position to be behind the agent
-    const Elite::Vector2 agentPos = pInterface->Agent_GetInfo().Position;
-    const Elite::Vector2 agentForward = Elite::OrientationToVector( pInterface->Agent_GetInfo().Orientation);
-    const float agentSize = pInterface->Agent_GetInfo().AgentSize;
+    const Elite::Vector2 agentPos = pSnapshot->GetAgentInfo().Position;
+    const Elite::Vector2 agentForward = Elite::OrientationToVector( pSnapshot->GetAgentInfo().Orientation);
+    const float agentSize = pSnapshot->GetAgentInfo().AgentSize;
     lastEnemyPos = agentPos - agentForward * agentSize * 2.f;
 
-    pBlackboard->ChangeData("lastEnemyPos", lastEnemyPos);
+    pBlackboard->ChangeData(BlackboardKeys::LastEnemyPos, lastEnemyPos);
     return Elite::BehaviorState::Success;
 }
 
 Elite::BehaviorState BT_Actions::SetRunModeTrue(Elite::Blackboard * const pBlackboard)
 {
+    EXAM_PROFILE_SCOPE("BT_Actions::SetRunModeTrue");
     if (DEBUG_MODE) std::cout << "SetRunModeTrue\n";
 
-    PrioritySteering *pSteering;
-    pBlackboard->GetData("prioritySteering", pSteering);
+    AgentSteering *pSteering;
+    pBlackboard->GetData(BlackboardKeys::PrioritySteering, pSteering);
     assert(pSteering && "Steering not found in blackboard");
     pSteering->SetRunningForIdx(pSteering->GetValidIdx(), true);
     return Elite::BehaviorState::Success;
@@ -173,18 +216,19 @@ Elite::BehaviorState BT_Actions::SetRunModeTrue(Elite::Blackboard * const pBlack
 
 Elite::BehaviorState BT_Actions::FaceAndFleeEnemy(Elite::Blackboard * const pBlackboard)
 {
+    EXAM_PROFILE_SCOPE("BT_Actions::FaceAndFleeEnemy");
     if (DEBUG_MODE) std::cout << "FaceAndFleeEnemy\n";
     Elite::Vector2 lastEnemyPos(0, 0);
-    PrioritySteering *pSteering;
+    AgentSteering *pSteering;
 
-    pBlackboard->GetData("lastEnemyPos", lastEnemyPos);
+    pBlackboard->GetData(BlackboardKeys::LastEnemyPos, lastEnemyPos);
 
-    IExamInterface *pInterface;
-    pBlackboard->GetData("interface", pInterface);
-    assert(pInterface && "Interface not found in blackboard");
-    const float distSqrToEnemy = pInterface->Agent_GetInfo().Position.DistanceSquared(lastEnemyPos);
+    const FrameSnapshot *pSnapshot;
+    pBlackboard->GetData(BlackboardKeys::Snapshot, pSnapshot);
+    assert(pSnapshot && "Snapshot not found in blackboard");
+    const float distSqrToEnemy = pSnapshot->GetAgentInfo().Position.DistanceSquared(lastEnemyPos);
 
-    pBlackboard->GetData("prioritySteering", pSteering);
+    pBlackboard->GetData(BlackboardKeys::PrioritySteering, pSteering);
     assert(pSteering && "Steering not found in blackboard");
 
     int steeringIdx = AgentIndexMaps::SteeringSlot.at(SteeringBehaviorType::FleeWhileFacing);
@@ -198,30 +242,33 @@ Elite::BehaviorState BT_Actions::FaceAndFleeEnemy(Elite::Blackboard * const pBla
 
 Elite::BehaviorState BT_Actions::Shoot(Elite::Blackboard * const pBlackboard)
 {
+    EXAM_PROFILE_SCOPE("BT_Actions::Shoot");
     if (DEBUG_MODE) std::cout << "Shoot\n";
-    IExamInterface *pInterface;
-
-    pBlackboard->GetData("interface", pInterface);
-    assert(pInterface && "Interface not found in blackboard");
+    InventoryMirror *pInventory;
+    pBlackboard->GetData(BlackboardKeys::InventoryMirror, pInventory);
+    assert(pInventory && "Inventory not found in blackboard");
+    const FrameSnapshot *pSnapshot;
+    pBlackboard->GetData(BlackboardKeys::Snapshot, pSnapshot);
+    assert(pSnapshot && "Snapshot not found in blackboard");
 
     int pistolSlot = AgentIndexMaps::InventorySlot.at(eItemType::PISTOL);
     int rifleSlot = AgentIndexMaps::InventorySlot.at(eItemType::SHOTGUN);
-    ItemInfo pistol;
-    bool hasPistol = pInterface->Inventory_GetItem(pistolSlot, pistol);
-    ItemInfo rifle;
-    bool hasRifle = pInterface->Inventory_GetItem(rifleSlot, rifle);
+    const bool hasPistol = pInventory->IsOccupied(pistolSlot);
+    const bool hasRifle = pInventory->IsOccupied(rifleSlot);
 
-    if (hasRifle && (pInterface->FOV_GetStats().NumEnemies > 1 || !hasPistol))
+    if (hasRifle && (pSnapshot->GetFOVStats().NumEnemies > 1 || !hasPistol))
     {
-        pInterface->Inventory_UseItem(rifleSlot);
-        pBlackboard->ChangeData("shotLastFrame", true);
+        pInventory->UseItem(rifleSlot);
+        pBlackboard->MarkChanged(BlackboardKeys::Inventory);
+        pBlackboard->ChangeData(BlackboardKeys::ShotLastFrame, true);
 
         return Elite::BehaviorState::Success;
     }
     if (hasPistol)
     {
-        pInterface->Inventory_UseItem(pistolSlot);
-        pBlackboard->ChangeData("shotLastFrame", true);
+        pInventory->UseItem(pistolSlot);
+        pBlackboard->MarkChanged(BlackboardKeys::Inventory);
+        pBlackboard->ChangeData(BlackboardKeys::ShotLastFrame, true);
         return Elite::BehaviorState::Success;
     }
 
@@ -230,49 +277,46 @@ Elite::BehaviorState BT_Actions::Shoot(Elite::Blackboard * const pBlackboard)
 
 Elite::BehaviorState BT_Actions::ShotLastFrameActions(Elite::Blackboard * const pBlackboard)
 {
+    EXAM_PROFILE_SCOPE("BT_Actions::ShotLastFrameActions");
     if (DEBUG_MODE) std::cout << "CheckIfShotLastFrame\n";
     bool shotLastFrame;
 
-    pBlackboard->GetData("shotLastFrame", shotLastFrame);
+    pBlackboard->GetData(BlackboardKeys::ShotLastFrame, shotLastFrame);
 
     if (!shotLastFrame) return Elite::BehaviorState::Success;
 
-    IExamInterface *pInterface;
-
-    pBlackboard->GetData("interface", pInterface);
-    assert(pInterface && "Interface not found in blackboard");
+    const FrameSnapshot *pSnapshot;
+    pBlackboard->GetData(BlackboardKeys::Snapshot, pSnapshot);
+    assert(pSnapshot && "Snapshot not found in blackboard");
 
     // If no enemy in sight, then the enemy was killed after being shot
-    if (pInterface->FOV_GetStats().NumEnemies == 0)
+    if (pSnapshot->GetFOVStats().NumEnemies == 0)
     {
-        pBlackboard->ChangeData("isBeingChased", false);
+        pBlackboard->ChangeData(BlackboardKeys::IsBeingChased, false);
     }
-    pBlackboard->ChangeData("shotLastFrame", false);
+    pBlackboard->ChangeData(BlackboardKeys::ShotLastFrame, false);
     return Elite::BehaviorState::Failure;
 }
 
 Elite::BehaviorState BT_Actions::DiscardWeapon(Elite::Blackboard * const pBlackboard)
 {
+    EXAM_PROFILE_SCOPE("BT_Actions::DiscardWeapon");
     if (DEBUG_MODE) std::cout << "DiscardWeapon\n";
-    IExamInterface *pInterface;
-
-    pBlackboard->GetData("interface", pInterface);
-    assert(pInterface && "Interface not found in blackboard");
+    InventoryMirror *pInventory;
+    pBlackboard->GetData(BlackboardKeys::InventoryMirror, pInventory);
+    assert(pInventory && "Inventory not found in blackboard");
 
     int pistolSlot = AgentIndexMaps::InventorySlot.at(eItemType::PISTOL);
     int rifleSlot = AgentIndexMaps::InventorySlot.at(eItemType::SHOTGUN);
-    ItemInfo pistol;
-    bool hasPistol = pInterface->Inventory_GetItem(pistolSlot, pistol);
-    ItemInfo rifle;
-    bool hasRifle = pInterface->Inventory_GetItem(rifleSlot, rifle);
-
-    if (hasPistol)
+    if (pInventory->IsOccupied(pistolSlot) && pInventory->GetValue(pistolSlot) <= 0)
     {
-        if (pistol.Value <= 0) pInterface->Inventory_RemoveItem(pistolSlot);
+        pInventory->RemoveItem(pistolSlot);
+        pBlackboard->MarkChanged(BlackboardKeys::Inventory);
     }
-    if (hasRifle)
+    if (pInventory->IsOccupied(rifleSlot) && pInventory->GetValue(rifleSlot) <= 0)
     {
-        if (rifle.Value <= 0) pInterface->Inventory_RemoveItem(rifleSlot);
+        pInventory->RemoveItem(rifleSlot);
+        pBlackboard->MarkChanged(BlackboardKeys::Inventory);
     }
     return Elite::BehaviorState::Success;
 }
@@ -283,22 +327,21 @@ Elite::BehaviorState BT_Actions::DiscardWeapon(Elite::Blackboard * const pBlackb
 
 Elite::BehaviorState BT_Actions::SeekFirstItemInSeekList(Elite::Blackboard * const pBlackboard)
 {
+    EXAM_PROFILE_SCOPE("BT_Actions::SeekFirstItemInSeekList");
     if (DEBUG_MODE) std::cout << "SeekFirstItemInSeekList\n";
-    IExamInterface *pInterface;
-
-    pBlackboard->GetData("interface", pInterface);
-    assert(pInterface && "Interface not found in blackboard");
-    std::vector<ItemInfo> seekList;
-    pBlackboard->GetData("itemSeekList", seekList);
+    const FrameSnapshot *pSnapshot;
+    pBlackboard->GetData(BlackboardKeys::Snapshot, pSnapshot);
+    assert(pSnapshot && "Snapshot not found in blackboard");
+    const std::span<const ItemInfo> seekList = pBlackboard->View(BlackboardKeys::ItemSeekList);
 
     if (seekList.empty()) return Elite::BehaviorState::Failure;
 
     const Elite::Vector2 itemPos = seekList[0].Location;
-    const Elite::Vector2 itemToAgent = (pInterface->Agent_GetInfo().Position - itemPos);
+    const Elite::Vector2 itemToAgent = (pSnapshot->GetAgentInfo().Position - itemPos);
     const Elite::Vector2 itemToAgentDir = itemToAgent.GetNormalized();
-    const Elite::Vector2 target = itemPos + itemToAgentDir * pInterface->Agent_GetInfo().GrabRange * 0.2f;
+    const Elite::Vector2 target = itemPos + itemToAgentDir * pSnapshot->GetAgentInfo().GrabRange * 0.2f;
     // If the item is within grab range, face it instead of seeking
-    if (itemToAgent.MagnitudeSquared() <= pInterface->Agent_GetInfo().GrabRange * pInterface->Agent_GetInfo().
+    if (itemToAgent.MagnitudeSquared() <= pSnapshot->GetAgentInfo().GrabRange * pSnapshot->GetAgentInfo().
         GrabRange * 0.3f)
     {
         BT_Helpers::SetSteeringFaceTarget(pBlackboard, itemPos);
@@ -311,31 +354,31 @@ Elite::BehaviorState BT_Actions::SeekFirstItemInSeekList(Elite::Blackboard * con
 
 Elite::BehaviorState BT_Actions::SeekTargetItem(Elite::Blackboard * const pBlackboard)
 {
+    EXAM_PROFILE_SCOPE("BT_Actions::SeekTargetItem");
     if (DEBUG_MODE) std::cout << "SeekTargetItem\n";
-    IExamInterface *pInterface;
-
-    pBlackboard->GetData("interface", pInterface);
-    assert(pInterface && "Interface not found in blackboard");
+    const FrameSnapshot *pSnapshot;
+    pBlackboard->GetData(BlackboardKeys::Snapshot, pSnapshot);
+    assert(pSnapshot && "Snapshot not found in blackboard");
 
     MapSearchSystem *pMapSearch;
-    pBlackboard->GetData("mapSearch", pMapSearch);
+    pBlackboard->GetData(BlackboardKeys::MapSearch, pMapSearch);
     assert(pMapSearch && "MapSearch not found in blackboard");
     std::optional < eItemType > targetItemType;
-    pBlackboard->GetData("targetItemType", targetItemType);
+    pBlackboard->GetData(BlackboardKeys::TargetItemType, targetItemType);
 
     Elite::Vector2 itemPos;
-    if (!pMapSearch->GetItemClosestLocation(pInterface->Agent_GetInfo().Position, targetItemType.value(), itemPos))
+    if (!pMapSearch->GetItemClosestLocation(pSnapshot->GetAgentInfo().Position, targetItemType.value(), itemPos))
     {
         return Elite::BehaviorState::Failure; // No item found
     }
-    const Elite::Vector2 itemToAgent = (pInterface->Agent_GetInfo().Position - itemPos);
-    if (itemToAgent.MagnitudeSquared() <= pInterface->Agent_GetInfo().GrabRange * pInterface->Agent_GetInfo().
+    const Elite::Vector2 itemToAgent = (pSnapshot->GetAgentInfo().Position - itemPos);
+    if (itemToAgent.MagnitudeSquared() <= pSnapshot->GetAgentInfo().GrabRange * pSnapshot->GetAgentInfo().
         GrabRange)
     {
         BT_Helpers::SetSteeringFaceTarget(pBlackboard, itemPos);
         return Elite::BehaviorState::Success;
     }
-    const Elite::Vector2 target = itemPos + itemToAgent.GetNormalized() * pInterface->Agent_GetInfo().GrabRange *
+    const Elite::Vector2 target = itemPos + itemToAgent.GetNormalized() * pSnapshot->GetAgentInfo().GrabRange *
                                   0.3f;
     BT_Helpers::SetSteeringSeekTarget(pBlackboard, target);
     return Elite::BehaviorState::Success;
@@ -343,70 +386,70 @@ Elite::BehaviorState BT_Actions::SeekTargetItem(Elite::Blackboard * const pBlack
 
 Elite::BehaviorState BT_Actions::SeekGarbageInGrabRange(Elite::Blackboard * const pBlackboard)
 {
+    EXAM_PROFILE_SCOPE("BT_Actions::SeekGarbageInGrabRange");
     if (DEBUG_MODE) std::cout << "SeekTargetItem\n";
-    IExamInterface *pInterface;
+    FrameQueries *pQueries;
+    pBlackboard->GetData(BlackboardKeys::Queries, pQueries);
+    assert(pQueries && "Queries not found in blackboard");
+    const FrameSnapshot *pSnapshot;
+    pBlackboard->GetData(BlackboardKeys::Snapshot, pSnapshot);
+    assert(pSnapshot && "Snapshot not found in blackboard");
 
-    pBlackboard->GetData("interface", pInterface);
-    assert(pInterface && "Interface not found in blackboard");
+    // The nearest one, that is the garbage GrabNearestItem picks up in RemoveGarbage
+    const ItemInfo *pGarbage = pQueries->GetNearestGarbage();
+    if (!pGarbage) return Elite::BehaviorState::Failure;
 
-    for (const auto &item: pInterface->GetItemsInFOV())
+    // If the item is within grab range, face it instead of seeking
+    const Elite::Vector2 itemPos = pGarbage->Location;
+    const Elite::Vector2 itemToAgent = (pSnapshot->GetAgentInfo().Position - itemPos);
+    if (itemToAgent.MagnitudeSquared() <= pSnapshot->GetAgentInfo().GrabRange * pSnapshot->GetAgentInfo().GrabRange)
     {
-        if (item.Type == eItemType::GARBAGE)
-        {
-            // If the item is within grab range, face it instead of seeking
-            const Elite::Vector2 itemPos = item.Location;
-            const Elite::Vector2 itemToAgent = (pInterface->Agent_GetInfo().Position - itemPos);
-            if (itemToAgent.MagnitudeSquared() <= pInterface->Agent_GetInfo().GrabRange * pInterface->
-                Agent_GetInfo().
-                GrabRange)
-            {
-                BT_Helpers::SetSteeringFaceTarget(pBlackboard, itemPos);
-                return Elite::BehaviorState::Success;
-            }
-            const Elite::Vector2 target = itemPos + itemToAgent.GetNormalized() * pInterface->Agent_GetInfo().
-                                          GrabRange *
-                                          0.3f;
-            BT_Helpers::SetSteeringSeekTarget(pBlackboard, target);
-            return Elite::BehaviorState::Success;
-        }
+        BT_Helpers::SetSteeringFaceTarget(pBlackboard, itemPos);
+        return Elite::BehaviorState::Success;
     }
-    return Elite::BehaviorState::Failure;
+    const Elite::Vector2 target = itemPos + itemToAgent.GetNormalized() * pSnapshot->GetAgentInfo().GrabRange * 0.3f;
+    BT_Helpers::SetSteeringSeekTarget(pBlackboard, target);
+    return Elite::BehaviorState::Success;
 }
 
 Elite::BehaviorState BT_Actions::GrabItem(Elite::Blackboard * const pBlackboard)
 {
+    EXAM_PROFILE_SCOPE("BT_Actions::GrabItem");
     if (DEBUG_MODE) std::cout << "GrabItem\n";
     IExamInterface *pInterface;
 
-    pBlackboard->GetData("interface", pInterface);
+    pBlackboard->GetData(BlackboardKeys::Interface, pInterface);
     assert(pInterface && "Interface not found in blackboard");
 
+    InventoryMirror *pInventory;
+    pBlackboard->GetData(BlackboardKeys::InventoryMirror, pInventory);
+    assert(pInventory && "Inventory not found in blackboard");
+
     ItemInfo item{};
-    if (pInterface->GrabNearestItem(item))
+    // The nearest item can be garbage the agent walked past, it has no slot and is left to RemoveGarbage
+    if (pInterface->GrabNearestItem(item) && AgentIndexMaps::InventorySlot.contains(item.Type))
     {
         int itemSlot = AgentIndexMaps::InventorySlot.at(item.Type);
         if (item.Type == eItemType::FOOD)
         {
-            ItemInfo dummyItem;
-            bool hasSlot1 = !pInterface->Inventory_GetItem(itemSlot, dummyItem);
-            if (!hasSlot1) ++itemSlot; // Food takes 2 slots, so we check the next slot
+            if (pInventory->IsOccupied(itemSlot)) ++itemSlot; // Food takes 2 slots, so we check the next slot
         }
-        if (pInterface->Inventory_AddItem(itemSlot, item))
+        if (pInventory->AddItem(itemSlot, item))
         {
+            pBlackboard->MarkChanged(BlackboardKeys::Inventory);
             MapSearchSystem *pMapSearch;
-            pBlackboard->GetData("mapSearch", pMapSearch);
+            pBlackboard->GetData(BlackboardKeys::MapSearch, pMapSearch);
             assert(pMapSearch && "MapSearch not found in blackboard");
             std::optional < eItemType > targetItemType;
-            pBlackboard->GetData("targetItemType", targetItemType);
+            pBlackboard->GetData(BlackboardKeys::TargetItemType, targetItemType);
             // if the target item has been grabbed
             if (targetItemType.has_value() && targetItemType.value() == item.Type)
             {
                 targetItemType.reset();
-                pBlackboard->ChangeData("targetItemType", targetItemType);
+                pBlackboard->ChangeData(BlackboardKeys::TargetItemType, targetItemType);
             }
             pMapSearch->PickedUpItem(item);
-            std::vector<ItemInfo> seekList;
-            pBlackboard->GetData("itemSeekList", seekList);
+            std::vector<ItemInfo> &seekList = pBlackboard->GetMutableRef(BlackboardKeys::ItemSeekList);
             // Remove the item from the seek list if it was there
             auto newEnd = std::ranges::remove_if(seekList,
                                                  [&item](const ItemInfo &i)
@@ -414,7 +457,6 @@ Elite::BehaviorState BT_Actions::GrabItem(Elite::Blackboard * const pBlackboard)
                                                      return i.Type == item.Type && i.Location == item.Location;
                                                  }).begin();
             seekList.erase(newEnd, seekList.end());
-            pBlackboard->ChangeData("itemSeekList", seekList);
             return Elite::BehaviorState::Success;
         }
     }
@@ -423,34 +465,31 @@ Elite::BehaviorState BT_Actions::GrabItem(Elite::Blackboard * const pBlackboard)
 
 Elite::BehaviorState BT_Actions::RemoveGarbage(Elite::Blackboard * const pBlackboard)
 {
+    EXAM_PROFILE_SCOPE("BT_Actions::RemoveGarbage");
     if (DEBUG_MODE) std::cout << "GrabItem\n";
     IExamInterface *pInterface;
 
-    pBlackboard->GetData("interface", pInterface);
+    pBlackboard->GetData(BlackboardKeys::Interface, pInterface);
     assert(pInterface && "Interface not found in blackboard");
 
+    InventoryMirror *pInventory;
+    pBlackboard->GetData(BlackboardKeys::InventoryMirror, pInventory);
+    assert(pInventory && "Inventory not found in blackboard");
+
     ItemInfo item{};
     if (pInterface->GrabNearestItem(item))
     {
         if (item.Type == eItemType::GARBAGE)
         {
-            int firstEmptySlot = -1;
-            for (int i{}; i <= 4; ++i)
-            {
-                ItemInfo dummyItem;
-                if (!pInterface->Inventory_GetItem(i, dummyItem))
-                {
-                    firstEmptySlot = i;
-                    break;
-                }
-            }
+            const int firstEmptySlot = pInventory->GetFirstEmptySlot();
             if (firstEmptySlot == -1)
             {
                 // No empty slot found, so we can't remove the garbage
                 return Elite::BehaviorState::Failure;
             }
-            pInterface->Inventory_AddItem(firstEmptySlot, item);
-            pInterface->Inventory_RemoveItem(firstEmptySlot);
+            pInventory->AddItem(firstEmptySlot, item);
+            pInventory->RemoveItem(firstEmptySlot);
+            pBlackboard->MarkChanged(BlackboardKeys::Inventory);
             return Elite::BehaviorState::Success;
         }
     }
@@ -459,87 +498,91 @@ Elite::BehaviorState BT_Actions::RemoveGarbage(Elite::Blackboard * const pBlackb
 
 Elite::BehaviorState BT_Actions::CheckItemNeeds(Elite::Blackboard * const pBlackboard)
 {
+    EXAM_PROFILE_SCOPE("BT_Actions::CheckItemNeeds");
     if (DEBUG_MODE) std::cout << "CheckItemNeeds\n";
-    IExamInterface *pInterface;
-    pBlackboard->GetData("interface", pInterface);
-    assert(pInterface && "Interface not found in blackboard");
+    InventoryMirror *pInventory;
+    pBlackboard->GetData(BlackboardKeys::InventoryMirror, pInventory);
+    assert(pInventory && "Inventory not found in blackboard");
 
-    std::map<eItemType, bool> itemNeedList;
-    pBlackboard->GetData("itemNeedList", itemNeedList);
+    std::map<eItemType, bool> &itemNeedList = pBlackboard->GetMutableRef(BlackboardKeys::ItemNeedList);
 
     for (eItemType itemType: AgentIndexMaps::PriorityItemList)
     {
-        ItemInfo dummyItem;
         int itemSlot = AgentIndexMaps::InventorySlot.at(itemType);
-        bool hasItem = pInterface->Inventory_GetItem(itemSlot, dummyItem);
+        bool hasItem = pInventory->IsOccupied(itemSlot);
         if (itemType == eItemType::FOOD && !hasItem)
         {
             // Food takes 2 slots, so we check the next slot too
-            hasItem = pInterface->Inventory_GetItem(itemSlot + 1, dummyItem);
+            hasItem = pInventory->IsOccupied(itemSlot + 1);
         }
         if (!hasItem) itemNeedList[itemType] = true;
         else itemNeedList[itemType] = false;
     }
-    pBlackboard->ChangeData("itemNeedList", itemNeedList);
     return Elite::BehaviorState::Success;
 }
 
 Elite::BehaviorState BT_Actions::SetPossibleItemTarget(Elite::Blackboard * const pBlackboard)
 {
+    EXAM_PROFILE_SCOPE("BT_Actions::SetPossibleItemTarget");
     if (DEBUG_MODE) std::cout << "SetPossibleItemTarget\n";
     std::optional < eItemType > targetItemType;
-    pBlackboard->GetData("targetItemType", targetItemType);
+    pBlackboard->GetData(BlackboardKeys::TargetItemType, targetItemType);
 
-    std::map<eItemType, bool> itemNeedList;
-    pBlackboard->GetData("itemNeedList", itemNeedList);
+    const std::map<eItemType, bool> &itemNeedList = pBlackboard->GetRef(BlackboardKeys::ItemNeedList);
 
     MapSearchSystem *pMapSearch;
-    pBlackboard->GetData("mapSearch", pMapSearch);
+    pBlackboard->GetData(BlackboardKeys::MapSearch, pMapSearch);
     assert(pMapSearch && "MapSearch not found in blackboard");
 
     for (eItemType itemType: AgentIndexMaps::PriorityItemList)
     {
-        if (itemNeedList[itemType] && pMapSearch->KnowsAnyItemLocation(itemType))
+        if (itemNeedList.at(itemType) && pMapSearch->KnowsAnyItemLocation(itemType))
         {
             targetItemType = itemType;
-            pBlackboard->ChangeData("targetItemType", targetItemType);
+            pBlackboard->ChangeData(BlackboardKeys::TargetItemType, targetItemType);
             return Elite::BehaviorState::Success;
         }
     }
     // No item needs, clear target
     targetItemType.reset();
-    pBlackboard->ChangeData("targetItemType", targetItemType);
+    pBlackboard->ChangeData(BlackboardKeys::TargetItemType, targetItemType);
     return Elite::BehaviorState::Success;
 }
 
 Elite::BehaviorState BT_Actions::UseItemIfNeeded(Elite::Blackboard * const pBlackboard)
 {
+    EXAM_PROFILE_SCOPE("BT_Actions::UseItemIfNeeded");
     if (DEBUG_MODE) std::cout << "UseItemIfNeeded\n";
-    IExamInterface *pInterface;
-    pBlackboard->GetData("interface", pInterface);
-    assert(pInterface && "Interface not found in blackboard");
-
-    ItemInfo item;
-    bool hasMedkit = pInterface->Inventory_GetItem(AgentIndexMaps::InventorySlot.at(eItemType::MEDKIT), item);
-    if (hasMedkit && 10.f - pInterface->Agent_GetInfo().Health > item.Value)
+    InventoryMirror *pInventory;
+    pBlackboard->GetData(BlackboardKeys::InventoryMirror, pInventory);
+    assert(pInventory && "Inventory not found in blackboard");
+    const FrameSnapshot *pSnapshot;
+    pBlackboard->GetData(BlackboardKeys::Snapshot, pSnapshot);
+    assert(pSnapshot && "Snapshot not found in blackboard");
+
+    const int medkitSlot = AgentIndexMaps::InventorySlot.at(eItemType::MEDKIT);
+    bool hasMedkit = pInventory->IsOccupied(medkitSlot);
+    if (hasMedkit && 10.f - pSnapshot->GetAgentInfo().Health > pInventory->GetValue(medkitSlot))
     {
         if (DEBUG_MODE) std::cout << "Using Medkit\n";
-        pInterface->Inventory_UseItem(AgentIndexMaps::InventorySlot.at(eItemType::MEDKIT));
-        pInterface->Inventory_RemoveItem(AgentIndexMaps::InventorySlot.at(eItemType::MEDKIT));
+        pInventory->UseItem(medkitSlot);
+        pInventory->RemoveItem(medkitSlot);
+        pBlackboard->MarkChanged(BlackboardKeys::Inventory);
     }
 
     int foodSlot = AgentIndexMaps::InventorySlot.at(eItemType::FOOD);
-    bool hasFood = pInterface->Inventory_GetItem(foodSlot, item);
+    bool hasFood = pInventory->IsOccupied(foodSlot);
     if (!hasFood)
     {
         // Check next slot too
-        hasFood = pInterface->Inventory_GetItem(++foodSlot, item);
+        hasFood = pInventory->IsOccupied(++foodSlot);
     }
-    if (hasFood && 10.f - pInterface->Agent_GetInfo().Energy > item.Value)
+    if (hasFood && 10.f - pSnapshot->GetAgentInfo().Energy > pInventory->GetValue(foodSlot))
     {
         if (DEBUG_MODE) std::cout << "Using Food\n";
-        pInterface->Inventory_UseItem(foodSlot);
-        pInterface->Inventory_RemoveItem(foodSlot);
+        pInventory->UseItem(foodSlot);
+        pInventory->RemoveItem(foodSlot);
+        pBlackboard->MarkChanged(BlackboardKeys::Inventory);
     }
 
     return Elite::BehaviorState::Success;
@@ -547,17 +590,20 @@ Elite::BehaviorState BT_Actions::UseItemIfNeeded(Elite::Blackboard * const pBlac
 
 Elite::BehaviorState BT_Actions::CheckoutItems(Elite::Blackboard * const pBlackboard)
 {
+    EXAM_PROFILE_SCOPE("BT_Actions::CheckoutItems");
     if (DEBUG_MODE) std::cout << "AddItemToSeekList\n";
 
-    IExamInterface *pInterface;
-    pBlackboard->GetData("interface", pInterface);
-    assert(pInterface && "Interface not found in blackboard");
+    InventoryMirror *pInventory;
+    pBlackboard->GetData(BlackboardKeys::InventoryMirror, pInventory);
+    assert(pInventory && "Inventory not found in blackboard");
+    const FrameSnapshot *pSnapshot;
+    pBlackboard->GetData(BlackboardKeys::Snapshot, pSnapshot);
+    assert(pSnapshot && "Snapshot not found in blackboard");
 
-    std::vector<ItemInfo> seekList;
-    pBlackboard->GetData("itemSeekList", seekList);
+    std::vector<ItemInfo> &seekList = pBlackboard->GetMutableRef(BlackboardKeys::ItemSeekList);
 
     MapSearchSystem *pMapSearch;
-    pBlackboard->GetData("mapSearch", pMapSearch);
+    pBlackboard->GetData(BlackboardKeys::MapSearch, pMapSearch);
     assert(pMapSearch && "MapSearch not found in blackboard");
 
     std::map<eItemType, int> itemsInSeekList;
@@ -567,15 +613,14 @@ Elite::BehaviorState BT_Actions::CheckoutItems(Elite::Blackboard * const pBlackb
         else itemsInSeekList[item.Type] = 1;
     }
 
-    for (auto &item: pInterface->GetItemsInFOV())
+    for (auto &item: pSnapshot->GetItemsInFOV())
     {
         if (item.Type == eItemType::GARBAGE) continue; // Don't add garbage to seek list
         int itemSlot = AgentIndexMaps::InventorySlot.at(item.Type);
-        ItemInfo dummyItem;
-        bool hasSpace = !pInterface->Inventory_GetItem(itemSlot, dummyItem);
+        bool hasSpace = pInventory->IsEmpty(itemSlot);
         if (item.Type == eItemType::FOOD)
         {
-            if (!hasSpace) hasSpace = !pInterface->Inventory_GetItem(itemSlot + 1, dummyItem);
+            if (!hasSpace) hasSpace = pInventory->IsEmpty(itemSlot + 1);
             if (!hasSpace || (itemsInSeekList.contains(item.Type) && itemsInSeekList[item.Type] >=2))
             {
                 pMapSearch->RememberItemLocation(item);
@@ -601,7 +646,6 @@ Elite::BehaviorState BT_Actions::CheckoutItems(Elite::Blackboard * const pBlackb
             }
         }
     }
-    pBlackboard->ChangeData("itemSeekList", seekList);
     return Elite::BehaviorState::Success;
 }
 
@@ -611,26 +655,29 @@ Elite::BehaviorState BT_Actions::CheckoutItems(Elite::Blackboard * const pBlackb
 
 Elite::BehaviorState BT_Actions::CheckoutHouse(Elite::Blackboard * const pBlackboard)
 {
+    EXAM_PROFILE_SCOPE("BT_Actions::CheckoutHouse");
     if (DEBUG_MODE) std::cout << "CheckoutHouse\n";
 
-    IExamInterface *pInterface;
-    pBlackboard->GetData("interface", pInterface);
-    assert(pInterface && "Interface not found in blackboard");
+    const FrameSnapshot *pSnapshot;
+    pBlackboard->GetData(BlackboardKeys::Snapshot, pSnapshot);
+    assert(pSnapshot && "Snapshot not found in blackboard");
 
     MapSearchSystem *pMapSearch;
-    pBlackboard->GetData("mapSearch", pMapSearch);
+    pBlackboard->GetData(BlackboardKeys::MapSearch, pMapSearch);
     assert(pMapSearch && "MapSearch not found in blackboard");
 
-    pMapSearch->FoundHouse(pInterface->GetHousesInFOV()[0]);
+    pMapSearch->FoundHouse(pSnapshot->GetHousesInFOV()[0]);
+    pBlackboard->MarkChanged(BlackboardKeys::FoundHouses);
     return Elite::BehaviorState::Success;
 }
 
 Elite::BehaviorState BT_Actions::GoToNextTarget(Elite::Blackboard * const pBlackboard)
 {
+    EXAM_PROFILE_SCOPE("BT_Actions::GoToNextTarget");
     if (DEBUG_MODE) std::cout << "GoToNextTarget\n";
 
     std::optional<Elite::Vector2> target;
-    pBlackboard->GetData("currentTarget", target);
+    pBlackboard->GetData(BlackboardKeys::CurrentTarget, target);
 
     BT_Helpers::SetSteeringSeekTarget(pBlackboard, target.value(), true, true);
 
@@ -639,47 +686,49 @@ Elite::BehaviorState BT_Actions::GoToNextTarget(Elite::Blackboard * const pBlack
 
 Elite::BehaviorState BT_Actions::GoToClosestHouse(Elite::Blackboard * const pBlackboard)
 {
+    EXAM_PROFILE_SCOPE("BT_Actions::GoToClosestHouse");
     if (DEBUG_MODE) std::cout << "GoToClosestHouse\n";
 
-    IExamInterface *pInterface;
-    pBlackboard->GetData("interface", pInterface);
-    assert(pInterface && "Interface not found in blackboard");
+    const FrameSnapshot *pSnapshot;
+    pBlackboard->GetData(BlackboardKeys::Snapshot, pSnapshot);
+    assert(pSnapshot && "Snapshot not found in blackboard");
 
     MapSearchSystem *pMapSearch;
-    pBlackboard->GetData("mapSearch", pMapSearch);
+    pBlackboard->GetData(BlackboardKeys::MapSearch, pMapSearch);
     assert(pMapSearch && "MapSearch not found in blackboard");
     HouseInfo housePos;
-    if (!pMapSearch->GetClosestHouse(pInterface->Agent_GetInfo().Position, housePos))
+    if (!pMapSearch->GetClosestHouse(pSnapshot->GetAgentInfo().Position, housePos))
         return Elite::BehaviorState::Failure;
-    Elite::Vector2 target = BT_Helpers::FindClosestCornerInHouse(pInterface->Agent_GetInfo().Position, housePos);
+    Elite::Vector2 target = BT_Helpers::FindClosestCornerInHouse(pSnapshot->GetAgentInfo().Position, housePos);
     BT_Helpers::SetSteeringSeekTarget(pBlackboard, target, false, true);
     return Elite::BehaviorState::Success;
 }
 
 Elite::BehaviorState BT_Actions::SetNextTarget(Elite::Blackboard * const pBlackboard)
 {
+    EXAM_PROFILE_SCOPE("BT_Actions::SetNextTarget");
     if (DEBUG_MODE) std::cout << "SetNextTarget\n";
 
-    IExamInterface *pInterface;
-    pBlackboard->GetData("interface", pInterface);
-    assert(pInterface && "Interface not found in blackboard");
+    const FrameSnapshot *pSnapshot;
+    pBlackboard->GetData(BlackboardKeys::Snapshot, pSnapshot);
+    assert(pSnapshot && "Snapshot not found in blackboard");
 
     MapSearchSystem *pMapSearch;
-    pBlackboard->GetData("mapSearch", pMapSearch);
+    pBlackboard->GetData(BlackboardKeys::MapSearch, pMapSearch);
     assert(pMapSearch && "MapSearch not found in blackboard");
 
     std::optional<Elite::Vector2> target;
-    pBlackboard->GetData("currentTarget", target);
+    pBlackboard->GetData(BlackboardKeys::CurrentTarget, target);
 
     Elite::Vector2 targetPos;
-    if (!pMapSearch->GetCurrentTarget(pInterface->Agent_GetInfo().Position, targetPos))
+    if (!pMapSearch->GetCurrentTarget(pSnapshot->GetAgentInfo().Position, targetPos))
     {
         target.reset();
-        pBlackboard->ChangeData("currentTarget", target);
+        pBlackboard->ChangeData(BlackboardKeys::CurrentTarget, target);
         return Elite::BehaviorState::Failure; // No target found
     }
     target = targetPos;
-    pBlackboard->ChangeData("currentTarget", target);
+    pBlackboard->ChangeData(BlackboardKeys::CurrentTarget, target);
     return Elite::BehaviorState::Success;
 }
 
@@ -689,15 +738,17 @@ Elite::BehaviorState BT_Actions::SetNextTarget(Elite::Blackboard * const pBlackb
 
 Elite::BehaviorState BT_Actions::GoIntoRadarMode(Elite::Blackboard * const pBlackboard)
 {
+    EXAM_PROFILE_SCOPE("BT_Actions::GoIntoRadarMode");
     if (DEBUG_MODE) std::cout << "GoIntoRadarMode\n";
-    pBlackboard->ChangeData("radarMode", true);
+    pBlackboard->ChangeData(BlackboardKeys::RadarMode, true);
     return Elite::BehaviorState::Success;
 }
 
 Elite::BehaviorState BT_Actions::Wander(Elite::Blackboard * const pBlackboard)
 {
-    PrioritySteering *pSteering;
-    pBlackboard->GetData("prioritySteering", pSteering);
+    EXAM_PROFILE_SCOPE("BT_Actions::Wander");
+    AgentSteering *pSteering;
+    pBlackboard->GetData(BlackboardKeys::PrioritySteering, pSteering);
     assert(pSteering && "Steering not found in blackboard");
 
     int steeringIdx = AgentIndexMaps::SteeringSlot.at(SteeringBehaviorType::Wander);
@@ -712,9 +763,10 @@ Elite::BehaviorState BT_Actions::Wander(Elite::Blackboard * const pBlackboard)
 
 Elite::BehaviorState BT_Actions::SetDebugSteering(Elite::Blackboard * const pBlackboard)
 {
+    EXAM_PROFILE_SCOPE("BT_Actions::SetDebugSteering");
     if (DEBUG_MODE) std::cout << "SetDebugSteering\n";
-    PrioritySteering *pSteering;
-    pBlackboard->GetData("prioritySteering", pSteering);
+    AgentSteering *pSteering;
+    pBlackboard->GetData(BlackboardKeys::PrioritySteering, pSteering);
     assert(pSteering && "Steering not found in blackboard");
 
     int steeringIdx = AgentIndexMaps::SteeringSlot.at(SteeringBehaviorType::SeekAndWander);
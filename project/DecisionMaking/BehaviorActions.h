@@ -4,6 +4,9 @@
 class BT_Actions final
 {
 public:
+    // Names the actions for BehaviorTree::WriteNodeStatsCsv
+    static void NameFunctions(Elite::BehaviorTree *const pBehaviorTree);
+
     // Purge zone actions
     static Elite::BehaviorState FleePurgeZone(Elite::Blackboard *const pBlackboard);
 
@@ -5,39 +5,81 @@
 #include "BehaviorTree.h"
 #include "Blackboard.h"
 #include "IExamInterface.h"
+#include "../BlackboardKeys.h"
+#include "../FrameQueries.h"
+#include "../FrameSnapshot.h"
 #include "../IndexMaps.h"
+#include "../InventoryMirror.h"
 #include "../MapSearchSystem.h"
 #include "../Steering/SteeringBehaviors.h"
+#include "../Profiler.h"
+
+void BT_Conditions::ObserveDependencies(Elite::BehaviorTree * const pBehaviorTree)
+{
+    using namespace BlackboardKeys;
+    // Has to list everything a condition reads, a missing channel trips the assert in FlatBehaviorTree
+    pBehaviorTree->ObserveCondition(IsInPurgeZone, {SnapshotFOVStats});
+    pBehaviorTree->ObserveCondition(CanGoForKill, {Inventory});
+    pBehaviorTree->ObserveCondition(IsFacingEnemy, {SnapshotFOVStats, SnapshotAgentInfo, SnapshotEnemiesInFOV});
+    pBehaviorTree->ObserveCondition(RanOutOfBullets, {Inventory});
+    pBehaviorTree->ObserveCondition(IsEnemyInHouse, {SnapshotFOVStats, SnapshotHousesInFOV, SnapshotAgentInfo,
+                                                     LastEnemyPos, FoundHouses});
+    pBehaviorTree->ObserveCondition(HasHouseInFOV, {SnapshotFOVStats});
+    pBehaviorTree->ObserveCondition(HasUncheckedHouseInFOV, {SnapshotFOVStats, SnapshotHousesInFOV, FoundHouses});
+    pBehaviorTree->ObserveCondition(RemembersAnyHouse, {FoundHouses});
+    pBehaviorTree->ObserveCondition(IsInHouse, {SnapshotFOVStats, SnapshotAgentInfo, SnapshotHousesInFOV});
+    pBehaviorTree->ObserveCondition(HasItemInFOV, {SnapshotFOVStats});
+    pBehaviorTree->ObserveCondition(HasGarbageInFOVAndOneEmptySlot, {SnapshotItemsInFOV, Inventory});
+    pBehaviorTree->ObserveCondition(IsItemInGrabRange, {SnapshotAgentInfo, ItemSeekList});
+    pBehaviorTree->ObserveCondition(IsGarbageInGrabRange, {SnapshotAgentInfo, SnapshotItemsInFOV});
+    pBehaviorTree->ObserveCondition(IsTargetItemSet, {TargetItemType});
+    pBehaviorTree->ObserveCondition(IsSeekListNotEmpty, {ItemSeekList});
+}
+
+void BT_Conditions::NameFunctions(Elite::BehaviorTree * const pBehaviorTree)
+{
+    pBehaviorTree->NameFunction(IsInPurgeZone, "BT_Conditions::IsInPurgeZone");
+    pBehaviorTree->NameFunction(CanGoForKill, "BT_Conditions::CanGoForKill");
+    pBehaviorTree->NameFunction(IsFacingEnemy, "BT_Conditions::IsFacingEnemy");
+    pBehaviorTree->NameFunction(RanOutOfBullets, "BT_Conditions::RanOutOfBullets");
+    pBehaviorTree->NameFunction(IsEnemyInHouse, "BT_Conditions::IsEnemyInHouse");
+    pBehaviorTree->NameFunction(HasHouseInFOV, "BT_Conditions::HasHouseInFOV");
+    pBehaviorTree->NameFunction(HasUncheckedHouseInFOV, "BT_Conditions::HasUncheckedHouseInFOV");
+    pBehaviorTree->NameFunction(RemembersAnyHouse, "BT_Conditions::RemembersAnyHouse");
+    pBehaviorTree->NameFunction(IsInHouse, "BT_Conditions::IsInHouse");
+    pBehaviorTree->NameFunction(HasItemInFOV, "BT_Conditions::HasItemInFOV");
+    pBehaviorTree->NameFunction(HasGarbageInFOVAndOneEmptySlot, "BT_Conditions::HasGarbageInFOVAndOneEmptySlot");
+    pBehaviorTree->NameFunction(IsItemInGrabRange, "BT_Conditions::IsItemInGrabRange");
+    pBehaviorTree->NameFunction(IsGarbageInGrabRange, "BT_Conditions::IsGarbageInGrabRange");
+    pBehaviorTree->NameFunction(IsTargetItemSet, "BT_Conditions::IsTargetItemSet");
+    pBehaviorTree->NameFunction(IsSeekListNotEmpty, "BT_Conditions::IsSeekListNotEmpty");
+}
 
 #pragma region Purge
 bool BT_Conditions::IsInPurgeZone(Elite::Blackboard * const pBlackboard)
 {
+    EXAM_PROFILE_SCOPE("BT_Conditions::IsInPurgeZone");
     if (DEBUG_MODE) std::cout << "IsInPurgeZone\n";
-    IExamInterface *pInterface;
-
-    pBlackboard->GetData("interface", pInterface);
-    assert(pInterface && "Interface not found in blackboard");
+    const FrameSnapshot *pSnapshot;
+    pBlackboard->GetData(BlackboardKeys::Snapshot, pSnapshot);
+    assert(pSnapshot && "Snapshot not found in blackboard");
 
-    return pInterface->FOV_GetStats().NumPurgeZones > 0;
+    return pSnapshot->GetFOVStats().NumPurgeZones > 0;
 }
 #pragma endregion
 
 #pragma region Enemy
 bool BT_Conditions::CanGoForKill(Elite::Blackboard * const pBlackboard)
 {
+    EXAM_PROFILE_SCOPE("BT_Conditions::CanGoForKill");
     if (DEBUG_MODE) std::cout << "CanGoForKill\n";
 
-    IExamInterface *pInterface;
+    InventoryMirror *pInventory;
+    pBlackboard->GetData(BlackboardKeys::InventoryMirror, pInventory);
+    assert(pInventory && "Inventory not found in blackboard");
 
-    pBlackboard->GetData("interface", pInterface);
-    assert(pInterface && "Interface not found in blackboard");
-
-    const int pistolSlot = AgentIndexMaps::InventorySlot.at(eItemType::PISTOL);
-    const int rifleSlot = AgentIndexMaps::InventorySlot.at(eItemType::SHOTGUN);
-    ItemInfo pistol;
-    const bool hasPistol = pInterface->Inventory_GetItem(pistolSlot, pistol);
-    ItemInfo rifle;
-    const bool hasRifle = pInterface->Inventory_GetItem(rifleSlot, rifle);
+    const bool hasPistol = pInventory->IsOccupied(AgentIndexMaps::InventorySlot.at(eItemType::PISTOL));
+    const bool hasRifle = pInventory->IsOccupied(AgentIndexMaps::InventorySlot.at(eItemType::SHOTGUN));
 
     if (hasPistol || hasRifle) return true;
     //more logic should be added here to check for the enemy type and ammo
@@ -46,18 +88,18 @@ bool BT_Conditions::CanGoForKill(Elite::Blackboard * const pBlackboard)
 
 bool BT_Conditions::IsFacingEnemy(Elite::Blackboard * const pBlackboard)
 {
+    EXAM_PROFILE_SCOPE("BT_Conditions::IsFacingEnemy");
     if (DEBUG_MODE) std::cout << "IsFacingEnemy\n";
 
-    IExamInterface *pInterface;
-
-    pBlackboard->GetData("interface", pInterface);
-    assert(pInterface && "Interface not found in blackboard");
+    const FrameSnapshot *pSnapshot;
+    pBlackboard->GetData(BlackboardKeys::Snapshot, pSnapshot);
+    assert(pSnapshot && "Snapshot not found in blackboard");
 
-    if (pInterface->FOV_GetStats().NumEnemies == 0) return false;
+    if (pSnapshot->GetFOVStats().NumEnemies == 0) return false;
 
-    float agentOrientation = pInterface->Agent_GetInfo().Orientation;
-    Elite::Vector2 agentPos = pInterface->Agent_GetInfo().Position;
-    Elite::Vector2 enemyPos = pInterface->GetEnemiesInFOV()[0].Location;
+    float agentOrientation = pSnapshot->GetAgentInfo().Orientation;
+    Elite::Vector2 agentPos = pSnapshot->GetAgentInfo().Position;
+    Elite::Vector2 enemyPos = pSnapshot->GetEnemiesInFOV()[0].Location;
     float toEnemyOrientation = Elite::VectorToOrientation(enemyPos - agentPos);
     if (abs(toEnemyOrientation - agentOrientation) <= Elite::ToRadians(5)) return true;
     return false;
@@ -65,46 +107,42 @@ bool BT_Conditions::IsFacingEnemy(Elite::Blackboard * const pBlackboard)
 
 bool BT_Conditions::RanOutOfBullets(Elite::Blackboard * const pBlackboard)
 {
+    EXAM_PROFILE_SCOPE("BT_Conditions::RanOutOfBullets");
     if (DEBUG_MODE) std::cout << "RanOutOfBullets\n";
 
-    IExamInterface *pInterface;
-
-    pBlackboard->GetData("interface", pInterface);
-    assert(pInterface && "Interface not found in blackboard");
+    InventoryMirror *pInventory;
+    pBlackboard->GetData(BlackboardKeys::InventoryMirror, pInventory);
+    assert(pInventory && "Inventory not found in blackboard");
 
     const int pistolSlot = AgentIndexMaps::InventorySlot.at(eItemType::PISTOL);
     const int rifleSlot = AgentIndexMaps::InventorySlot.at(eItemType::SHOTGUN);
-    ItemInfo pistol;
-    const bool hasPistol = pInterface->Inventory_GetItem(pistolSlot, pistol);
-    ItemInfo rifle;
-    const bool hasRifle = pInterface->Inventory_GetItem(rifleSlot, rifle);
-
-    if (hasPistol && pistol.Value <= 0) return true;
-    if (hasRifle && rifle.Value <= 0) return true;
+    if (pInventory->IsOccupied(pistolSlot) && pInventory->GetValue(pistolSlot) <= 0) return true;
+    if (pInventory->IsOccupied(rifleSlot) && pInventory->GetValue(rifleSlot) <= 0) return true;
     return false;
 }
 
 bool BT_Conditions::IsEnemyInHouse(Elite::Blackboard * const pBlackboard)
 {
+    EXAM_PROFILE_SCOPE("BT_Conditions::IsEnemyInHouse");
     if (DEBUG_MODE) std::cout << "IsInHouse\n";
 
-    IExamInterface *pInterface;
-    pBlackboard->GetData("interface", pInterface);
-    assert(pInterface && "Interface not found in blackboard");
+    const FrameSnapshot *pSnapshot;
+    pBlackboard->GetData(BlackboardKeys::Snapshot, pSnapshot);
+    assert(pSnapshot && "Snapshot not found in blackboard");
 
-    if (pInterface->FOV_GetStats().NumHouses == 0) return false;
+    if (pSnapshot->GetFOVStats().NumHouses == 0) return false;
 
     Elite::Vector2 lastEnemyPos(0, 0);
-    pBlackboard->GetData("lastEnemyPos", lastEnemyPos);
+    pBlackboard->GetData(BlackboardKeys::LastEnemyPos, lastEnemyPos);
 
-    const auto house = pInterface->GetHousesInFOV()[0];
+    const auto house = pSnapshot->GetHousesInFOV()[0];
     bool isInHouse = MapSearchSystem::IsPointInHouse(lastEnemyPos, house);
     if (isInHouse) return true;
     MapSearchSystem *pMapSearch;
-    pBlackboard->GetData("mapSearch", pMapSearch);
+    pBlackboard->GetData(BlackboardKeys::MapSearch, pMapSearch);
     assert(pMapSearch && "MapSearch not found in blackboard");
     HouseInfo closestHouse;
-    pMapSearch->GetClosestHouse(pInterface->Agent_GetInfo().Position, closestHouse);
+    pMapSearch->GetClosestHouse(pSnapshot->GetAgentInfo().Position, closestHouse);
     isInHouse = MapSearchSystem::IsPointInHouse(lastEnemyPos, closestHouse);
     return isInHouse;
 }
@@ -115,39 +153,41 @@ bool BT_Conditions::IsEnemyInHouse(Elite::Blackboard * const pBlackboard)
 
 bool BT_Conditions::HasHouseInFOV(Elite::Blackboard * const pBlackboard)
 {
+    EXAM_PROFILE_SCOPE("BT_Conditions::HasHouseInFOV");
     if (DEBUG_MODE) std::cout << "HasHouseInFOV\n";
 
-    IExamInterface *pInterface;
-
-    pBlackboard->GetData("interface", pInterface);
-    assert(pInterface && "Interface not found in blackboard");
+    const FrameSnapshot *pSnapshot;
+    pBlackboard->GetData(BlackboardKeys::Snapshot, pSnapshot);
+    assert(pSnapshot && "Snapshot not found in blackboard");
 
-    return pInterface->FOV_GetStats().NumHouses > 0;
+    return pSnapshot->GetFOVStats().NumHouses > 0;
 }
 
 bool BT_Conditions::HasUncheckedHouseInFOV(Elite::Blackboard * const pBlackboard)
 {
+    EXAM_PROFILE_SCOPE("BT_Conditions::HasUncheckedHouseInFOV");
     if (DEBUG_MODE) std::cout << "HasUncheckedHouseInFOV\n";
 
-    IExamInterface *pInterface;
-    pBlackboard->GetData("interface", pInterface);
-    assert(pInterface && "Interface not found in blackboard");
+    const FrameSnapshot *pSnapshot;
+    pBlackboard->GetData(BlackboardKeys::Snapshot, pSnapshot);
+    assert(pSnapshot && "Snapshot not found in blackboard");
 
-    if (pInterface->FOV_GetStats().NumHouses == 0) return false;
+    if (pSnapshot->GetFOVStats().NumHouses == 0) return false;
 
     MapSearchSystem *pMapSearch;
-    pBlackboard->GetData("mapSearch", pMapSearch);
+    pBlackboard->GetData(BlackboardKeys::MapSearch, pMapSearch);
     assert(pMapSearch && "MapSearch not found in blackboard");
 
-    return !pMapSearch->HasCheckedHouse(pInterface->GetHousesInFOV()[0]);
+    return !pMapSearch->HasCheckedHouse(pSnapshot->GetHousesInFOV()[0]);
 }
 
 bool BT_Conditions::RemembersAnyHouse(Elite::Blackboard * const pBlackboard)
 {
+    EXAM_PROFILE_SCOPE("BT_Conditions::RemembersAnyHouse");
     if (DEBUG_MODE) std::cout << "RemembersAnyHouse\n";
 
     MapSearchSystem *pMapSearch;
-    pBlackboard->GetData("mapSearch", pMapSearch);
+    pBlackboard->GetData(BlackboardKeys::MapSearch, pMapSearch);
     assert(pMapSearch && "MapSearch not found in blackboard");
 
     return pMapSearch->RemembersAnyHouses();
@@ -155,16 +195,17 @@ bool BT_Conditions::RemembersAnyHouse(Elite::Blackboard * const pBlackboard)
 
 bool BT_Conditions::IsInHouse(Elite::Blackboard * const pBlackboard)
 {
+    EXAM_PROFILE_SCOPE("BT_Conditions::IsInHouse");
     if (DEBUG_MODE) std::cout << "IsInHouse\n";
 
-    IExamInterface *pInterface;
-    pBlackboard->GetData("interface", pInterface);
-    assert(pInterface && "Interface not found in blackboard");
+    const FrameSnapshot *pSnapshot;
+    pBlackboard->GetData(BlackboardKeys::Snapshot, pSnapshot);
+    assert(pSnapshot && "Snapshot not found in blackboard");
 
-    if (pInterface->FOV_GetStats().NumHouses == 0) return false;
+    if (pSnapshot->GetFOVStats().NumHouses == 0) return false;
 
-    const Elite::Vector2 agentPos = pInterface->Agent_GetInfo().Position;
-    const auto house = pInterface->GetHousesInFOV()[0];
+    const Elite::Vector2 agentPos = pSnapshot->GetAgentInfo().Position;
+    const auto house = pSnapshot->GetHousesInFOV()[0];
     // Check if the agent is inside the house bounds
     bool isInHouse = MapSearchSystem::IsPointInHouse(agentPos, house);
     return isInHouse;
@@ -176,102 +217,83 @@ bool BT_Conditions::IsInHouse(Elite::Blackboard * const pBlackboard)
 
 bool BT_Conditions::HasItemInFOV(Elite::Blackboard * const pBlackboard)
 {
+    EXAM_PROFILE_SCOPE("BT_Conditions::HasItemInFOV");
     if (DEBUG_MODE) std::cout << "HasItemInFOV\n";
 
-    IExamInterface *pInterface;
+    const FrameSnapshot *pSnapshot;
+    pBlackboard->GetData(BlackboardKeys::Snapshot, pSnapshot);
+    assert(pSnapshot && "Snapshot not found in blackboard");
 
-    pBlackboard->GetData("interface", pInterface);
-    assert(pInterface && "Interface not found in blackboard");
-
-    return pInterface->FOV_GetStats().NumItems > 0;
+    return pSnapshot->GetFOVStats().NumItems > 0;
 }
 
 bool BT_Conditions::HasGarbageInFOVAndOneEmptySlot(Elite::Blackboard * const pBlackboard)
 {
+    EXAM_PROFILE_SCOPE("BT_Conditions::HasGarbageInFOVAndOneEmptySlot");
     if (DEBUG_MODE) std::cout << "HasGarbageInFOV\n";
 
-    IExamInterface *pInterface;
-
-    pBlackboard->GetData("interface", pInterface);
-    assert(pInterface && "Interface not found in blackboard");
-
-    bool hasGarbage = false;
-    for(const ItemInfo &item: pInterface->GetItemsInFOV())
-    {
-        if (item.Type == eItemType::GARBAGE)
-        {
-            hasGarbage = true;
-            break;
-        }
-    }
-    if (!hasGarbage) return false;
-    bool hasSpace = false;
-    for (int i{}; i<= 4; ++i)
-    {
-        ItemInfo dummyItem;
-        if (!pInterface->Inventory_GetItem(i, dummyItem))
-        {
-            hasSpace = true;
-            break;
-        }
-    }
-    return hasSpace;
+    FrameQueries *pQueries;
+    pBlackboard->GetData(BlackboardKeys::Queries, pQueries);
+    assert(pQueries && "Queries not found in blackboard");
+    InventoryMirror *pInventory;
+    pBlackboard->GetData(BlackboardKeys::InventoryMirror, pInventory);
+    assert(pInventory && "Inventory not found in blackboard");
+
+    return !pQueries->GetFovItemsByType(eItemType::GARBAGE).empty() && pInventory->GetEmptyMask() != 0;
 }
 
 bool BT_Conditions::IsItemInGrabRange(Elite::Blackboard * const pBlackboard)
 {
+    EXAM_PROFILE_SCOPE("BT_Conditions::IsItemInGrabRange");
     if (DEBUG_MODE) std::cout << "IsItemInGrabRange\n";
 
-    IExamInterface *pInterface;
-    pBlackboard->GetData("interface", pInterface);
-    assert(pInterface && "Interface not found in blackboard");
+    const FrameSnapshot *pSnapshot;
+    pBlackboard->GetData(BlackboardKeys::Snapshot, pSnapshot);
+    assert(pSnapshot && "Snapshot not found in blackboard");
 
-    std::vector<ItemInfo> seekList;
-    pBlackboard->GetData("itemSeekList", seekList);
+    const std::span<const ItemInfo> seekList = pBlackboard->View(BlackboardKeys::ItemSeekList);
 
     if (seekList.empty()) return false;
 
-    const ItemInfo itemInFov = seekList[0];
+    const ItemInfo &itemInFov = seekList[0];
 
-    const float distToItemSqr = (pInterface->Agent_GetInfo().Position - itemInFov.Location).MagnitudeSquared();
-    return distToItemSqr < pInterface->Agent_GetInfo().GrabRange * pInterface->Agent_GetInfo().GrabRange;
+    const float distToItemSqr = (pSnapshot->GetAgentInfo().Position - itemInFov.Location).MagnitudeSquared();
+    return distToItemSqr < pSnapshot->GetAgentInfo().GrabRange * pSnapshot->GetAgentInfo().GrabRange;
 }
 
 bool BT_Conditions::IsGarbageInGrabRange(Elite::Blackboard * const pBlackboard)
 {
+    EXAM_PROFILE_SCOPE("BT_Conditions::IsGarbageInGrabRange");
     if (DEBUG_MODE) std::cout << "IsGarbageInGrabRange\n";
 
-    IExamInterface *pInterface;
-    pBlackboard->GetData("interface", pInterface);
-    assert(pInterface && "Interface not found in blackboard");
-
-    for (const auto& item: pInterface->GetItemsInFOV())
-    {
-        if (item.Type == eItemType::GARBAGE)
-        {
-            const float distToItemSqr = (pInterface->Agent_GetInfo().Position - item.Location).MagnitudeSquared();
-            return distToItemSqr < pInterface->Agent_GetInfo().GrabRange * pInterface->Agent_GetInfo().GrabRange;
-        }
-    }
-    return false;
+    FrameQueries *pQueries;
+    pBlackboard->GetData(BlackboardKeys::Queries, pQueries);
+    assert(pQueries && "Queries not found in blackboard");
+    const FrameSnapshot *pSnapshot;
+    pBlackboard->GetData(BlackboardKeys::Snapshot, pSnapshot);
+    assert(pSnapshot && "Snapshot not found in blackboard");
+
+    const std::vector<ItemInfo> &items = pSnapshot->GetItemsInFOV();
+    return std::ranges::any_of(pQueries->GetItemsInGrabRange(),
+                               [&items](uint32_t i) { return items[i].Type == eItemType::GARBAGE; });
 }
 
 bool BT_Conditions::IsTargetItemSet(Elite::Blackboard * const pBlackboard)
 {
+    EXAM_PROFILE_SCOPE("BT_Conditions::IsTargetItemSet");
     if (DEBUG_MODE) std::cout << "IsTargetItemSet\n";
 
     std::optional<eItemType> targetItemType;
-    pBlackboard->GetData("targetItemType", targetItemType);
+    pBlackboard->GetData(BlackboardKeys::TargetItemType, targetItemType);
 
     return targetItemType.has_value();
 }
 
 bool BT_Conditions::IsSeekListNotEmpty(Elite::Blackboard * const pBlackboard)
 {
-    std::vector<ItemInfo> seekList;
-    pBlackboard->GetData("itemSeekList", seekList);
+    EXAM_PROFILE_SCOPE("BT_Conditions::IsSeekListNotEmpty");
     if (DEBUG_MODE) std::cout << "IsSeekListNotEmpty\n";
-    return !seekList.empty();
+    return !pBlackboard->GetRef(BlackboardKeys::ItemSeekList).empty();
 }
 
 #pragma endregion
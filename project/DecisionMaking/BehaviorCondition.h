@@ -3,11 +3,17 @@
 namespace Elite
 {
     class Blackboard;
+    class BehaviorTree;
 }
 
 class BT_Conditions final
 {
 public:
+    // Subscribes the conditions to what they read, for the event-driven backend
+    static void ObserveDependencies(Elite::BehaviorTree *const pBehaviorTree);
+    // Names the conditions for BehaviorTree::WriteNodeStatsCsv
+    static void NameFunctions(Elite::BehaviorTree *const pBehaviorTree);
+
     // Purge zone conditions
     static bool IsInPurgeZone(Elite::Blackboard *const pBlackboard);
 
@@ -4,51 +4,69 @@
 #include "BehaviorTree.h"
 #include "Blackboard.h"
 #include "IExamInterface.h"
+#include "../BlackboardKeys.h"
+#include "../FrameSnapshot.h"
 #include "../IndexMaps.h"
-#include "../Steering/CombinedSteeringBehaviors.h"
+#include "../PathPointCache.h"
+#include "../Steering/AgentSteering.h"
 #include "../Steering/SteeringBehaviors.h"
 
 void BT_Helpers::SetSteeringSeekTarget(Elite::Blackboard * const pBlackboard, Elite::Vector2 target, bool runMode,
     bool wanderMode)
 {
     IExamInterface *pInterface;
-    pBlackboard->GetData("interface", pInterface);
+    pBlackboard->GetData(BlackboardKeys::Interface, pInterface);
     assert(pInterface && "Interface not found in blackboard");
+    const FrameSnapshot *pSnapshot;
+    pBlackboard->GetData(BlackboardKeys::Snapshot, pSnapshot);
+    assert(pSnapshot && "Snapshot not found in blackboard");
 
-    PrioritySteering *pSteering;
-    pBlackboard->GetData("prioritySteering", pSteering);
+    AgentSteering *pSteering;
+    pBlackboard->GetData(BlackboardKeys::PrioritySteering, pSteering);
     assert(pSteering && "Steering not found in blackboard");
-    const Elite::Vector2 nextPointInPath = pInterface->NavMesh_GetClosestPathPoint(target);
+    PathPointCache *pPathCache;
+    pBlackboard->GetData(BlackboardKeys::PathCache, pPathCache);
+    assert(pPathCache && "Path cache not found in blackboard");
+    const Elite::Vector2 nextPointInPath =
+        pPathCache->GetClosestPathPoint(pInterface, pSnapshot->GetAgentInfo().Position, target);
     int steeringIdx = wanderMode
                           ? AgentIndexMaps::SteeringSlot.at(SteeringBehaviorType::SeekAndWander)
                           : AgentIndexMaps::SteeringSlot.at(SteeringBehaviorType::Seek);
     pSteering->SetValidSteeringIdx(steeringIdx);
     // Run only when stamina is high enough
-    if (runMode && pInterface->Agent_GetInfo().Stamina >= 9.5f) pSteering->SetRunningForIdx(steeringIdx, true);
+    if (runMode && pSnapshot->GetAgentInfo().Stamina >= 9.5f) pSteering->SetRunningForIdx(steeringIdx, true);
     pSteering->SetTargetForIdx(steeringIdx, nextPointInPath);
 }
 
 void BT_Helpers::SetSteeringEvade(Elite::Blackboard * const pBlackboard, Elite::Vector2 target)
 {
     IExamInterface *pInterface;
-    pBlackboard->GetData("interface", pInterface);
+    pBlackboard->GetData(BlackboardKeys::Interface, pInterface);
     assert(pInterface && "Interface not found in blackboard");
+    const FrameSnapshot *pSnapshot;
+    pBlackboard->GetData(BlackboardKeys::Snapshot, pSnapshot);
+    assert(pSnapshot && "Snapshot not found in blackboard");
 
     Elite::Vector2 lastEnemyPos;
-    pBlackboard->GetData("lastEnemyPos", lastEnemyPos);
+    pBlackboard->GetData(BlackboardKeys::LastEnemyPos, lastEnemyPos);
 
-    PrioritySteering *pSteering;
-    pBlackboard->GetData("prioritySteering", pSteering);
+    AgentSteering *pSteering;
+    pBlackboard->GetData(BlackboardKeys::PrioritySteering, pSteering);
     assert(pSteering && "Steering not found in blackboard");
-    const Elite::Vector2 nextPointInPath = pInterface->NavMesh_GetClosestPathPoint(target);
+    PathPointCache *pPathCache;
+    pBlackboard->GetData(BlackboardKeys::PathCache, pPathCache);
+    assert(pPathCache && "Path cache not found in blackboard");
+    const Elite::Vector2 nextPointInPath =
+        pPathCache->GetClosestPathPoint(pInterface, pSnapshot->GetAgentInfo().Position, target);
     int steeringIdx;
     // if there are enemies in FOV, evade the enemy
-    if (lastEnemyPos.DistanceSquared(pInterface->Agent_GetInfo().Position) < 100.f)
+    if (lastEnemyPos.DistanceSquared(pSnapshot->GetAgentInfo().Position) < 100.f)
     {
         steeringIdx = AgentIndexMaps::SteeringSlot.at(SteeringBehaviorType::SeekAndEvade);
         pSteering->SetTargetForIdx(steeringIdx, nextPointInPath);
-        auto* blendedSeekAndEvadeSteering = dynamic_cast<BlendedSteering *>(pSteering->GetBehaviorForIdx(steeringIdx));
-        blendedSeekAndEvadeSteering->GetWeightedBehaviorsRef()[1].pBehavior->SetTarget(lastEnemyPos);
+        // The evade half of the blend evades the enemy instead
+        constexpr size_t seekAndEvadeSlot = static_cast<size_t>(SteeringBehaviorType::SeekAndEvade);
+        pSteering->Get<seekAndEvadeSlot>().Get<1>().SetTarget(lastEnemyPos);
     }
     else
     {
@@ -56,17 +74,17 @@ void BT_Helpers::SetSteeringEvade(Elite::Blackboard * const pBlackboard, Elite::
         pSteering->SetTargetForIdx(steeringIdx, nextPointInPath);
     }
     pSteering->SetValidSteeringIdx(steeringIdx);
-    if (pInterface->Agent_GetInfo().Stamina >= 5.f) pSteering->SetRunningForIdx(steeringIdx, true);
+    if (pSnapshot->GetAgentInfo().Stamina >= 5.f) pSteering->SetRunningForIdx(steeringIdx, true);
 }
 
 void BT_Helpers::SetSteeringFaceTarget(Elite::Blackboard * const pBlackboard, Elite::Vector2 target)
 {
     IExamInterface *pInterface;
-    pBlackboard->GetData("interface", pInterface);
+    pBlackboard->GetData(BlackboardKeys::Interface, pInterface);
     assert(pInterface && "Interface not found in blackboard");
 
-    PrioritySteering *pSteering;
-    pBlackboard->GetData("prioritySteering", pSteering);
+    AgentSteering *pSteering;
+    pBlackboard->GetData(BlackboardKeys::PrioritySteering, pSteering);
     assert(pSteering && "Steering not found in blackboard");
 
     int steeringIdx = AgentIndexMaps::SteeringSlot.at(SteeringBehaviorType::Face);
@@ -76,17 +94,17 @@ void BT_Helpers::SetSteeringFaceTarget(Elite::Blackboard * const pBlackboard, El
 
 void BT_Helpers::SetSteeringFleeTarget(Elite::Blackboard * const pBlackboard, Elite::Vector2 target)
 {
-    IExamInterface *pInterface;
-    pBlackboard->GetData("interface", pInterface);
-    assert(pInterface && "Interface not found in blackboard");
+    const FrameSnapshot *pSnapshot;
+    pBlackboard->GetData(BlackboardKeys::Snapshot, pSnapshot);
+    assert(pSnapshot && "Snapshot not found in blackboard");
 
-    PrioritySteering *pSteering;
-    pBlackboard->GetData("prioritySteering", pSteering);
+    AgentSteering *pSteering;
+    pBlackboard->GetData(BlackboardKeys::PrioritySteering, pSteering);
     assert(pSteering && "Steering not found in blackboard");
 
     int steeringIdx = AgentIndexMaps::SteeringSlot.at(SteeringBehaviorType::Flee);
     pSteering->SetValidSteeringIdx(steeringIdx);
-    if (pInterface->Agent_GetInfo().Stamina >= 3.f) pSteering->SetRunningForIdx(steeringIdx, true);
+    if (pSnapshot->GetAgentInfo().Stamina >= 3.f) pSteering->SetRunningForIdx(steeringIdx, true);
     pSteering->SetTargetForIdx(steeringIdx, target);
 }
 
@@ -1,12 +1,22 @@
 #include "../stdafx.h"
 #include "BehaviorTree.h"
+#include "FlatBehaviorTree.h"
+#include <bit>
+#include "../Profiler.h"
 
-Elite::BehaviorTree::BehaviorTree(Blackboard * const pBlackBoard, IBehavior * const pRootBehavior): m_pBlackBoard(pBlackBoard), m_pRootBehavior(pRootBehavior){}
+thread_local Elite::BehaviorActionFn Elite::BehaviorTree::s_pLastActionRun = nullptr;
+
+Elite::BehaviorTree::BehaviorTree(Blackboard * const pBlackBoard, IBehavior * const pRootBehavior, bool ownsBlackboard):
+    m_pBlackBoard(pBlackBoard), m_pRootBehavior(pRootBehavior), m_OwnsBlackboard(ownsBlackboard){}
 
 Elite::BehaviorTree::~BehaviorTree()
 {
+    SAFE_DELETE(m_pFlatTree);
     SAFE_DELETE(m_pRootBehavior);
-    SAFE_DELETE(m_pBlackBoard); //Takes ownership of passed blackboard!
+    if (m_OwnsBlackboard)
+    {
+        SAFE_DELETE(m_pBlackBoard); //Takes ownership of passed blackboard!
+    }
 }
 
 void Elite::BehaviorTree::Update()
@@ -17,10 +27,160 @@ void Elite::BehaviorTree::Update()
         return;
     }
 
-    m_CurrentState = m_pRootBehavior->Execute(m_pBlackBoard);
+    s_pLastActionRun = nullptr;
+    m_CurrentState = m_pFlatTree
+        ? m_pFlatTree->Tick(m_pBlackBoard)
+        : m_pRootBehavior->Tick(m_pBlackBoard);
+    m_pLastAction = s_pLastActionRun;
+}
+
+bool Elite::BehaviorTree::SetBackend(BehaviorTreeBackend backend)
+{
+    if (backend == BehaviorTreeBackend::Virtual)
+    {
+        SAFE_DELETE(m_pFlatTree);
+    }
+    else if (m_pFlatTree == nullptr || backend != m_Backend)
+    {
+        //Only the event-driven backend memoizes the observed conditions
+        FlatBehaviorTree *pFlatTree = new FlatBehaviorTree();
+        const std::span<const ConditionDependencies> observed = backend == BehaviorTreeBackend::EventDriven
+            ? std::span<const ConditionDependencies>{m_ObservedConditions}
+            : std::span<const ConditionDependencies>{};
+        if (!pFlatTree->Build(m_pRootBehavior, observed))
+        {
+            SAFE_DELETE(pFlatTree);
+            return false;
+        }
+        SAFE_DELETE(m_pFlatTree);
+        m_pFlatTree = pFlatTree;
+    }
+    m_Backend = backend;
+    return true;
+}
+
+void Elite::BehaviorTree::ObserveCondition(bool (*pCondition)(Blackboard *),
+                                           std::initializer_list<BlackboardChannel> channels)
+{
+    m_ObservedConditions.push_back({pCondition, channels});
+}
+
+void Elite::BehaviorTree::SetNodeStatsEnabled(bool enabled)
+{
+    std::vector<IBehavior *> nodes{};
+    const auto collect = [&nodes](const auto &self, IBehavior *pNode) -> void
+    {
+        nodes.push_back(pNode);
+        for (IBehavior *pChild: pNode->GetChildren()) self(self, pChild);
+    };
+    if (m_pRootBehavior) collect(collect, m_pRootBehavior);
+
+    //Sized once, the nodes point into the vector
+    m_NodeStats.clear();
+    if (enabled) m_NodeStats.resize(nodes.size());
+    for (size_t i{}; i < nodes.size(); ++i) nodes[i]->m_pStats = enabled ? &m_NodeStats[i] : nullptr;
+}
+
+const char *Elite::BehaviorTree::GetFunctionName(const void *pFunction) const
+{
+    const auto name = m_FunctionNames.find(pFunction);
+    return name != m_FunctionNames.end() ? name->second : nullptr;
+}
+
+bool Elite::BehaviorTree::WriteNodeStatsCsv(const std::string &path) const
+{
+    if (!IsNodeStatsEnabled()) return false;
+    FILE *pFile = fopen(path.c_str(), "w");
+    if (pFile == nullptr) return false;
+
+    struct Row
+    {
+        const IBehavior *pNode;
+        int Parent;
+        int Depth;
+    };
+    std::vector<Row> rows{};
+    const auto collect = [&rows](const auto &self, const IBehavior *pNode, int parent, int depth) -> void
+    {
+        const int idx = static_cast<int>(rows.size());
+        rows.push_back({pNode, parent, depth});
+        for (const IBehavior *pChild: pNode->GetChildren()) self(self, pChild, idx, depth + 1);
+    };
+    collect(collect, m_pRootBehavior, -1, 0);
+
+    //Self time is what the node spent outside of its children
+    std::vector<uint64_t> childTicks(rows.size(), 0);
+    int numBuckets{1};
+    for (const Row &row: rows)
+    {
+        const BehaviorNodeStats &stats = *row.pNode->GetStats();
+        if (row.Parent >= 0) childTicks[row.Parent] += stats.TotalTicks;
+        for (int b{}; b < BehaviorNodeStats::NumLatencyBuckets; ++b)
+        {
+            if (stats.LatencyHistogram[b] > 0) numBuckets = std::max(numBuckets, b + 1);
+        }
+    }
+
+    const double nsPerTick = Profiler::GetNanosecondsPerTick();
+    //Upper bound of the bucket the percentile falls in
+    const auto percentile = [nsPerTick](const BehaviorNodeStats &stats, double p)
+    {
+        const double target = p * static_cast<double>(stats.NumExecutions);
+        uint64_t count{};
+        for (int b{}; b < BehaviorNodeStats::NumLatencyBuckets; ++b)
+        {
+            count += stats.LatencyHistogram[b];
+            if (count > 0 && static_cast<double>(count) >= target) return static_cast<double>(uint64_t{1} << b) * nsPerTick;
+        }
+        return 0.0;
+    };
+
+    fprintf(pFile, "node,parent,depth,type,function,executions,success,failure,running,total_us,self_us,mean_ns,p50_ns,p90_ns,p99_ns");
+    for (int b{}; b < numBuckets; ++b) fprintf(pFile, ",lt_%.1f_ns", static_cast<double>(uint64_t{1} << b) * nsPerTick);
+    fprintf(pFile, "\n");
+    for (size_t i{}; i < rows.size(); ++i)
+    {
+        const Row &row = rows[i];
+        const BehaviorNodeStats &stats = *row.pNode->GetStats();
+        const auto name = m_FunctionNames.find(row.pNode->GetFunctionAddress());
+        const double numExecutions = static_cast<double>(std::max<uint64_t>(stats.NumExecutions, 1));
+        fprintf(pFile, "%zu,%d,%d,%s,%s,%llu,%llu,%llu,%llu,%.3f,%.3f,%.1f,%.1f,%.1f,%.1f", i, row.Parent, row.Depth,
+                row.pNode->GetTypeName(), name != m_FunctionNames.end() ? name->second : "",
+                static_cast<unsigned long long>(stats.NumExecutions),
+                static_cast<unsigned long long>(stats.NumResults[static_cast<int>(BehaviorState::Success)]),
+                static_cast<unsigned long long>(stats.NumResults[static_cast<int>(BehaviorState::Failure)]),
+                static_cast<unsigned long long>(stats.NumResults[static_cast<int>(BehaviorState::Running)]),
+                static_cast<double>(stats.TotalTicks) * nsPerTick * 1e-3,
+                static_cast<double>(stats.TotalTicks - std::min(stats.TotalTicks, childTicks[i])) * nsPerTick * 1e-3,
+                static_cast<double>(stats.TotalTicks) * nsPerTick / numExecutions,
+                percentile(stats, 0.5), percentile(stats, 0.9), percentile(stats, 0.99));
+        for (int b{}; b < numBuckets; ++b) fprintf(pFile, ",%u", stats.LatencyHistogram[b]);
+        fprintf(pFile, "\n");
+    }
+    return fclose(pFile) == 0;
+}
+
+Elite::BehaviorState Elite::IBehavior::TickMeasured(Blackboard *const pBlackBoard)
+{
+    //Includes the children, and the clock reads of the children
+    const uint64_t start = Profiler::Now();
+    const BehaviorState state = Execute(pBlackBoard);
+    const uint64_t ticks = Profiler::Now() - start;
+
+    BehaviorNodeStats &stats = *m_pStats;
+    ++stats.NumExecutions;
+    ++stats.NumResults[static_cast<int>(state)];
+    stats.TotalTicks += ticks;
+    ++stats.LatencyHistogram[std::min(static_cast<int>(std::bit_width(ticks)), BehaviorNodeStats::NumLatencyBuckets - 1)];
+    return state;
+}
+
+uint32_t Elite::IBehavior::Compile(FlatBehaviorTree &flatTree) const
+{
+    return FlatBehaviorTree::InvalidNode;
 }
 
-Elite::BehaviorConditional::BehaviorConditional(std::function<bool(Blackboard *)> fp): m_fpConditional(std::move(fp)){}
+Elite::BehaviorConditional::BehaviorConditional(BehaviorConditionFn fp): m_fpConditional(fp){}
 
 Elite::BehaviorState Elite::BehaviorConditional::Execute(Blackboard * const pBlackBoard)
 {
@@ -29,13 +189,28 @@ Elite::BehaviorState Elite::BehaviorConditional::Execute(Blackboard * const pBla
     return m_CurrentState;
 }
 
-Elite::BehaviorAction::BehaviorAction(std::function<BehaviorState(Blackboard *)> fp): m_fpAction(std::move(fp)){}
+uint32_t Elite::BehaviorConditional::Compile(FlatBehaviorTree &flatTree) const
+{
+    FlatNode node{FlatNodeType::Conditional};
+    node.pCondition = m_fpConditional;
+    return flatTree.AddNode(node);
+}
+
+Elite::BehaviorAction::BehaviorAction(BehaviorActionFn fp): m_fpAction(fp){}
 
 Elite::BehaviorState Elite::BehaviorAction::Execute(Blackboard * const pBlackBoard)
 {
     if (m_fpAction == nullptr)
         return BehaviorState::Failure;
 
+    BehaviorTree::NoteActionRun(m_fpAction);
     m_CurrentState = m_fpAction(pBlackBoard);
     return m_CurrentState;
 }
+
+uint32_t Elite::BehaviorAction::Compile(FlatBehaviorTree &flatTree) const
+{
+    FlatNode node{FlatNodeType::Action};
+    node.pAction = m_fpAction;
+    return flatTree.AddNode(node);
+}
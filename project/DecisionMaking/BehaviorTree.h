@@ -1,10 +1,17 @@
 #pragma once
 
-#include <functional>
+#include <cstdint>
+#include <initializer_list>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
 #include "Blackboard.h"
 
 namespace Elite
 {
+    class FlatBehaviorTree;
+
     //-----------------------------------------------------------------
     // BEHAVIOR TREE HELPERS
     //-----------------------------------------------------------------
@@ -15,6 +22,38 @@ namespace Elite
         Running
     };
 
+    enum class BehaviorTreeBackend
+    {
+        Virtual, //Recursive IBehavior::Execute calls
+        Flat, //Compiled into a FlatBehaviorTree
+        EventDriven //Flat, observed conditions are only re-evaluated when one of their channels changed
+    };
+
+    //Conditions and actions are plain functions (the static members of BT_Conditions and BT_Actions),
+    //the nodes call them directly instead of through a std::function. Lambdas without captures convert to these
+    using BehaviorConditionFn = bool (*)(Blackboard *);
+    using BehaviorActionFn = BehaviorState (*)(Blackboard *);
+
+    //What a condition reads, the event-driven backend reuses its last result while none of the channels changed
+    struct ConditionDependencies
+    {
+        BehaviorConditionFn pCondition = nullptr;
+        std::vector<BlackboardChannel> Channels{};
+    };
+
+    //How often a node ran, how it ended and how long it took, including its children.
+    //Only written by the thread that ticks the tree, so there are no locks or atomics
+    struct BehaviorNodeStats
+    {
+        static constexpr int NumLatencyBuckets = 40;
+
+        uint64_t NumExecutions = 0;
+        uint64_t NumResults[3]{}; //Indexed by BehaviorState
+        uint64_t TotalTicks = 0;
+        //Bucket b counts the executions that took [2^(b-1), 2^b) clock ticks, bucket 0 the ones under a tick
+        uint32_t LatencyHistogram[NumLatencyBuckets]{};
+    };
+
     //-----------------------------------------------------------------
     // BEHAVIOR INTERFACES (BASE)
     //-----------------------------------------------------------------
@@ -27,8 +66,31 @@ namespace Elite
 
         virtual BehaviorState Execute(Blackboard *const pBlackBoard) = 0;
 
+        //Parents run their children through Tick, it only measures the node while its tree collects node stats
+        BehaviorState Tick(Blackboard *const pBlackBoard)
+        {
+            return m_pStats ? TickMeasured(pBlackBoard) : Execute(pBlackBoard);
+        }
+
+        //Adds this node (and its children) to the flat tree, returns the node index or
+        //FlatBehaviorTree::InvalidNode if the node can't be represented there
+        virtual uint32_t Compile(FlatBehaviorTree &flatTree) const;
+
+        virtual std::span<IBehavior *const> GetChildren() const { return {}; }
+        virtual const char *GetTypeName() const = 0;
+        //The action or condition the node calls, nullptr if it has none or it isn't a plain function
+        virtual const void *GetFunctionAddress() const { return nullptr; }
+        //nullptr while the tree doesn't collect node stats
+        const BehaviorNodeStats *GetStats() const { return m_pStats; }
+
     protected:
         BehaviorState m_CurrentState = BehaviorState::Failure;
+
+    private:
+        friend class BehaviorTree;
+        BehaviorState TickMeasured(Blackboard *const pBlackBoard);
+
+        BehaviorNodeStats *m_pStats = nullptr;
     };
 
     //-----------------------------------------------------------------
@@ -37,21 +99,93 @@ namespace Elite
     class BehaviorTree final
     {
     public:
-        explicit BehaviorTree(Blackboard *const pBlackBoard, IBehavior *const pRootBehavior);;
+        //Takes ownership of the root behavior, and of the blackboard unless ownsBlackboard is false
+        explicit BehaviorTree(Blackboard *const pBlackBoard, IBehavior *const pRootBehavior, bool ownsBlackboard = true);
+
+        BehaviorTree(const BehaviorTree &other) = delete;
+        BehaviorTree &operator=(const BehaviorTree &other) = delete;
 
         ~BehaviorTree();
 
         void Update();
 
+        //Returns false (and keeps the current backend) if the tree can't be compiled for the flat backend.
+        //The backends don't share running state, so switch before the first Update.
+        bool SetBackend(BehaviorTreeBackend backend);
+
+        //Subscribes a condition to the channels it reads, for the event-driven backend.
+        //The list has to be complete, conditions that aren't observed run every tick. Call before SetBackend.
+        void ObserveCondition(BehaviorConditionFn pCondition, std::initializer_list<BlackboardChannel> channels);
+
+        //nullptr on the virtual backend
+        const FlatBehaviorTree *GetFlatTree() const
+        {
+            return m_pFlatTree;
+        }
+
+        BehaviorTreeBackend GetBackend() const
+        {
+            return m_Backend;
+        }
+
         Blackboard *GetBlackboard() const
         {
             return m_pBlackBoard;
         }
 
+        //Per node execution counts and latency histograms, read them with IBehavior::GetStats or WriteNodeStatsCsv.
+        //Only the virtual backend runs through the nodes, the flat backends fold them and aren't measured.
+        //Enabling starts from zero, disabling drops the stats
+        void SetNodeStatsEnabled(bool enabled);
+        bool IsNodeStatsEnabled() const
+        {
+            return !m_NodeStats.empty();
+        }
+
+        const IBehavior *GetRootBehavior() const
+        {
+            return m_pRootBehavior;
+        }
+
+        //The action that ran last during the previous Update (the one a sequence of actions ended on), on either backend.
+        //nullptr if no action ran
+        BehaviorActionFn GetLastAction() const
+        {
+            return m_pLastAction;
+        }
+
+        //Called by the action leaves of both backends, Update hands the last one to the tree that ticked on this thread
+        static void NoteActionRun(BehaviorActionFn pAction)
+        {
+            s_pLastActionRun = pAction;
+        }
+
+        //Name WriteNodeStatsCsv shows for the nodes that call pFunction
+        template<typename Fn>
+        void NameFunction(Fn *pFunction, const char *pName)
+        {
+            m_FunctionNames[reinterpret_cast<const void *>(pFunction)] = pName;
+        }
+
+        //The name given to pFunction with NameFunction, nullptr if it has none
+        const char *GetFunctionName(const void *pFunction) const;
+
+        //One row per node in depth-first order: results, total and self time, percentiles and the histogram.
+        //Self time leaves out the children, for a condition decorator it is the cost of its guard
+        bool WriteNodeStatsCsv(const std::string &path) const;
+
     private:
         BehaviorState m_CurrentState = BehaviorState::Failure;
         Blackboard *m_pBlackBoard = nullptr;
         IBehavior *m_pRootBehavior = nullptr;
+        bool m_OwnsBlackboard = true;
+        BehaviorTreeBackend m_Backend = BehaviorTreeBackend::Virtual;
+        FlatBehaviorTree *m_pFlatTree = nullptr;
+        BehaviorActionFn m_pLastAction = nullptr;
+        static thread_local BehaviorActionFn s_pLastActionRun;
+        std::vector<ConditionDependencies> m_ObservedConditions{};
+        std::vector<BehaviorNodeStats> m_NodeStats{};
+        std::unordered_map<const void *, const char *> m_FunctionNames{};
     };
 
     //-----------------------------------------------------------------
@@ -60,12 +194,15 @@ namespace Elite
     class BehaviorConditional final : public IBehavior
     {
     public:
-        explicit BehaviorConditional(std::function<bool(Blackboard *)> fp);
+        explicit BehaviorConditional(BehaviorConditionFn fp);
 
         BehaviorState Execute(Blackboard *const pBlackBoard) override;
+        uint32_t Compile(FlatBehaviorTree &flatTree) const override;
+        const char *GetTypeName() const override { return "Conditional"; }
+        const void *GetFunctionAddress() const override { return reinterpret_cast<const void *>(m_fpConditional); }
 
     private:
-        std::function<bool(Blackboard *)> m_fpConditional = nullptr;
+        BehaviorConditionFn m_fpConditional = nullptr;
     };
 
     //-----------------------------------------------------------------
@@ -74,11 +211,14 @@ namespace Elite
     class BehaviorAction final : public IBehavior
     {
     public:
-        explicit BehaviorAction(std::function<BehaviorState(Blackboard *)> fp);
+        explicit BehaviorAction(BehaviorActionFn fp);
 
         BehaviorState Execute(Blackboard *const pBlackBoard) override;
+        uint32_t Compile(FlatBehaviorTree &flatTree) const override;
+        const char *GetTypeName() const override { return "Action"; }
+        const void *GetFunctionAddress() const override { return reinterpret_cast<const void *>(m_fpAction); }
 
     private:
-        std::function<BehaviorState(Blackboard *)> m_fpAction = nullptr;
+        BehaviorActionFn m_fpAction = nullptr;
     };
 }
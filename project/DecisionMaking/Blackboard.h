@@ -7,48 +7,158 @@
 // EBlackboard.h: Blackboard implementation
 /*=============================================================================*/
 //Includes
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <span>
 #include <unordered_map>
 #include <string>
+#include <type_traits>
+#include <typeinfo>
+#include <vector>
 
 namespace Elite
 {
 	//-----------------------------------------------------------------
 	// BLACKBOARD TYPES (BASE)
 	//-----------------------------------------------------------------
-	class IBlackBoardField
+	template<typename T>
+	struct BlackboardTypeTag
+	{
+		static constexpr char Tag = 0;
+	};
+
+	// Bump allocator that backs the blackboard fields which do not fit in a slot.
+	// Memory is only released when the arena is destroyed, fields are never removed from a blackboard.
+	class BlackboardArena final
+	{
+	public:
+		static constexpr size_t ChunkSize = 4096;
+
+		void* Allocate(size_t size, size_t alignment)
+		{
+			size_t offset = (m_ChunkOffset + alignment - 1) & ~(alignment - 1);
+			if (m_Chunks.empty() || offset + size > m_ChunkCapacity)
+			{
+				m_ChunkCapacity = size + alignment > ChunkSize ? size + alignment : ChunkSize;
+				m_Chunks.emplace_back(new std::byte[m_ChunkCapacity]);
+				offset = (reinterpret_cast<uintptr_t>(m_Chunks.back().get()) % alignment == 0)
+					? 0 : alignment - reinterpret_cast<uintptr_t>(m_Chunks.back().get()) % alignment;
+			}
+			m_ChunkOffset = offset + size;
+			return m_Chunks.back().get() + offset;
+		}
+
+	private:
+		std::vector<std::unique_ptr<std::byte[]>> m_Chunks{};
+		size_t m_ChunkOffset = 0;
+		size_t m_ChunkCapacity = 0;
+	};
+
+	// One blackboard entry. Small trivially copyable values (bools, pointers, Vector2, ...) live inline,
+	// everything else is constructed in the blackboard's arena.
+	struct BlackboardSlot final
+	{
+		static constexpr size_t InlineSize = 16;
+
+		template<typename T>
+		static constexpr bool IsStoredInline = std::is_trivially_copyable_v<T> && sizeof(T) <= InlineSize
+			&& alignof(T) <= InlineSize;
+
+		void* GetData() { return pExternalData ? pExternalData : static_cast<void*>(InlineData); }
+		const void* GetData() const { return pExternalData ? pExternalData : static_cast<const void*>(InlineData); }
+
+		alignas(InlineSize) std::byte InlineData[InlineSize];
+		void* pExternalData = nullptr;
+		const void* pTypeTag = nullptr; //nullptr means the slot is empty
+		void (*pDestroy)(void*) = nullptr; //only set for types that need a destructor call
+	};
+
+	//-----------------------------------------------------------------
+	// BLACKBOARD KEYS
+	//-----------------------------------------------------------------
+	// Maps key names to dense indices. The indices are shared by every blackboard in the process,
+	// so a key only has to be resolved once, no matter how many blackboards it is used with.
+	class BlackboardKeyRegistry final
 	{
 	public:
-		IBlackBoardField() = default;
-		virtual ~IBlackBoardField() = default;
+		static size_t Resolve(const std::string& name)
+		{
+			BlackboardKeyRegistry& registry = Get();
+			std::lock_guard lock{ registry.m_Mutex };
+			auto it = registry.m_Indices.find(name);
+			if (it != registry.m_Indices.end())
+				return it->second;
+			const size_t index = registry.m_Indices.size();
+			registry.m_Indices.emplace(name, index);
+			return index;
+		}
+
+	private:
+		static BlackboardKeyRegistry& Get()
+		{
+			static BlackboardKeyRegistry registry{};
+			return registry;
+		}
+
+		std::mutex m_Mutex{};
+		std::unordered_map<std::string, size_t> m_Indices{};
 	};
 
-	//BlackboardField does not take ownership of pointers whatsoever!
+	// Typed handle to a blackboard entry. Resolves its name once on construction,
+	// after that reads and writes are a plain array index without hashing or dynamic_cast.
 	template<typename T>
-	class BlackboardField : public IBlackBoardField
+	class BlackboardKey final
 	{
 	public:
-		explicit BlackboardField(T data) : m_Data(data)
+		explicit BlackboardKey(const std::string& name) : m_Name(name), m_Index(BlackboardKeyRegistry::Resolve(name))
+		{}
+
+		const std::string& GetName() const { return m_Name; }
+		size_t GetIndex() const { return m_Index; }
+
+	private:
+		std::string m_Name;
+		size_t m_Index;
+	};
+
+	// Untyped handle to a blackboard index, used to subscribe to changes.
+	// Every BlackboardKey converts to one, a channel can also be a name without any data behind it
+	// (e.g. a field of the frame snapshot) that is only ever marked as changed.
+	class BlackboardChannel final
+	{
+	public:
+		explicit BlackboardChannel(const std::string& name) : m_Index(BlackboardKeyRegistry::Resolve(name))
+		{}
+		template<typename T>
+		BlackboardChannel(const BlackboardKey<T>& key) : m_Index(key.GetIndex())
 		{}
-		T GetData() { return m_Data; };
-		void SetData(T data) { m_Data = data; }
+
+		size_t GetIndex() const { return m_Index; }
 
 	private:
-		T m_Data;
+		size_t m_Index;
 	};
 
 	//-----------------------------------------------------------------
 	// BLACKBOARD (BASE)
 	//-----------------------------------------------------------------
+	//Blackboard does not take ownership of pointers whatsoever!
 	class Blackboard final
 	{
 	public:
 		Blackboard() = default;
 		~Blackboard()
 		{
-			 for (auto& el : m_BlackboardData)
-			 {
-			 	delete el.second;
-			 }
+			for (BlackboardSlot& slot : m_BlackboardData)
+			{
+				if (slot.pDestroy)
+					slot.pDestroy(slot.GetData());
+			}
 			m_BlackboardData.clear();
 		}
 
@@ -57,31 +167,26 @@ namespace Elite
 		Blackboard(Blackboard&& other) = delete;
 		Blackboard& operator=(Blackboard&& other) = delete;
 
+		//String versions: every call resolves the name through BlackboardKeyRegistry, which locks its
+		//process-wide mutex and does a hash lookup. Agents ticked in parallel (AgentPool on the JobSystem)
+		//would contend on that mutex, so the tick path uses the BlackboardKey versions below
+
 		//Add data to the blackboard
-		template<typename T> bool AddData(const std::string& name, T data)
+		template<typename T> bool AddData(const std::string& name, const T& data)
 		{
-			auto it = m_BlackboardData.find(name);
-			if (it == m_BlackboardData.end())
-			{
-				m_BlackboardData[name] = new BlackboardField<T>(data);
-				return true;
-			}
-			printf("WARNING: Data '%s' of type '%s' already in Blackboard \n", name.c_str(), typeid(T).name());
-			return false;
+			return AddData(BlackboardKey<T>{ name }, data);
 		}
 
 		//Change the data of the blackboard
-		template<typename T> bool ChangeData(const std::string& name, T data)
+		template<typename T> bool ChangeData(const std::string& name, const T& data)
 		{
-			auto it = m_BlackboardData.find(name);
-			if (it != m_BlackboardData.end())
+			const size_t index = BlackboardKeyRegistry::Resolve(name);
+			T* p = FindData<T>(index);
+			if (p)
 			{
-				BlackboardField<T>* p = dynamic_cast<BlackboardField<T>*>(m_BlackboardData[name]);
-				if (p)
-				{
-					p->SetData(data);
-					return true;
-				}
+				*p = data;
+				MarkChanged(index);
+				return true;
 			}
 			printf("WARNING: Data '%s' of type '%s' not found in Blackboard \n", name.c_str(), typeid(T).name());
 			return false;
@@ -90,18 +195,146 @@ namespace Elite
 		//Get the data from the blackboard
 		template<typename T> bool GetData(const std::string& name, T& data)
 		{
-			BlackboardField<T>* p = dynamic_cast<BlackboardField<T>*>(m_BlackboardData[name]);
+			T* p = FindData<T>(BlackboardKeyRegistry::Resolve(name));
 			if (p != nullptr)
 			{
-				data = p->GetData();
+				data = *p;
 				return true;
 			}
 			printf("WARNING: Data '%s' of type '%s' not found in Blackboard \n", name.c_str(), typeid(T).name());
 			return false;
 		}
 
+		//Typed key versions of the above, these skip the string lookup
+		//References handed out by GetRef/View stay valid until a new key is added to this blackboard
+		template<typename T> bool AddData(const BlackboardKey<T>& key, const std::type_identity_t<T>& data)
+		{
+			if (key.GetIndex() >= m_BlackboardData.size())
+				m_BlackboardData.resize(key.GetIndex() + 1);
+
+			BlackboardSlot& slot = m_BlackboardData[key.GetIndex()];
+			if (slot.pTypeTag != nullptr)
+			{
+				printf("WARNING: Data '%s' of type '%s' already in Blackboard \n", key.GetName().c_str(), typeid(T).name());
+				return false;
+			}
+
+			if constexpr (BlackboardSlot::IsStoredInline<T>)
+			{
+				new (slot.InlineData) T(data);
+			}
+			else
+			{
+				slot.pExternalData = new (m_Arena.Allocate(sizeof(T), alignof(T))) T(data);
+				if constexpr (!std::is_trivially_destructible_v<T>)
+					slot.pDestroy = [](void* p) { static_cast<T*>(p)->~T(); };
+			}
+			slot.pTypeTag = &BlackboardTypeTag<T>::Tag;
+			MarkChanged(key.GetIndex());
+			return true;
+		}
+
+		template<typename T> bool ChangeData(const BlackboardKey<T>& key, const std::type_identity_t<T>& data)
+		{
+			T* p = GetSlotData(key);
+			if (p)
+			{
+				//Writing the same scalar again (e.g. a flag that is set every frame) is not a change
+				if constexpr (std::is_scalar_v<T>)
+				{
+					if (*p == data)
+						return true;
+				}
+				*p = data;
+				MarkChanged(key.GetIndex());
+				return true;
+			}
+			printf("WARNING: Data '%s' of type '%s' not found in Blackboard \n", key.GetName().c_str(), typeid(T).name());
+			return false;
+		}
+
+		template<typename T> bool GetData(const BlackboardKey<T>& key, T& data) const
+		{
+			const T* p = GetSlotData(key);
+			if (p)
+			{
+				data = *p;
+				return true;
+			}
+			printf("WARNING: Data '%s' of type '%s' not found in Blackboard \n", key.GetName().c_str(), typeid(T).name());
+			return false;
+		}
+
+		//Direct access without copying, the key has to be in the blackboard
+		template<typename T> const T& GetRef(const BlackboardKey<T>& key) const
+		{
+			const T* p = GetSlotData(key);
+			assert(p && "Data not found in Blackboard");
+			return *p;
+		}
+
+		//Counts as a change of the key, the reference is assumed to be written to right away
+		template<typename T> T& GetMutableRef(const BlackboardKey<T>& key)
+		{
+			T* p = GetSlotData(key);
+			assert(p && "Data not found in Blackboard");
+			MarkChanged(key.GetIndex());
+			return *p;
+		}
+
+		//Read-only view of a container entry, e.g. the item seek list
+		template<typename T> std::span<const T> View(const BlackboardKey<std::vector<T>>& key) const
+		{
+			return GetRef(key);
+		}
+
+		//Change tracking, used by the event-driven behavior tree to skip conditions whose inputs did not change.
+		//Every write stamps its key with the next value of a counter, channels without data are marked by hand
+		void MarkChanged(const BlackboardChannel& channel) { MarkChanged(channel.GetIndex()); }
+
+		uint64_t GetChangeStamp(size_t index) const
+		{
+			return index < m_ChangeStamps.size() ? m_ChangeStamps[index] : 0;
+		}
+
+		uint64_t GetChangeCounter() const { return m_ChangeCounter; }
+
 	private:
-		std::unordered_map<std::string, IBlackBoardField*> m_BlackboardData;
+		void MarkChanged(size_t index)
+		{
+			if (index >= m_ChangeStamps.size())
+				m_ChangeStamps.resize(index + 1);
+			m_ChangeStamps[index] = ++m_ChangeCounter;
+		}
+
+		// Slow path: the name was hashed by the caller
+		template<typename T> T* FindData(size_t index)
+		{
+			if (index >= m_BlackboardData.size() || m_BlackboardData[index].pTypeTag != &BlackboardTypeTag<T>::Tag)
+				return nullptr;
+			return static_cast<T*>(m_BlackboardData[index].GetData());
+		}
+
+		// Fast path: the key already knows its index, the type is only verified in debug builds
+		template<typename T> T* GetSlotData(const BlackboardKey<T>& key)
+		{
+			if (key.GetIndex() >= m_BlackboardData.size() || m_BlackboardData[key.GetIndex()].pTypeTag == nullptr)
+				return nullptr;
+			BlackboardSlot& slot = m_BlackboardData[key.GetIndex()];
+			assert(slot.pTypeTag == &BlackboardTypeTag<T>::Tag && "Blackboard key type does not match the stored data");
+			return static_cast<T*>(slot.GetData());
+		}
+
+		template<typename T> const T* GetSlotData(const BlackboardKey<T>& key) const
+		{
+			return const_cast<Blackboard*>(this)->GetSlotData(key);
+		}
+
+		// Indexed by BlackboardKey index, unused slots have no type tag
+		std::vector<BlackboardSlot> m_BlackboardData;
+		BlackboardArena m_Arena{};
+		// Indexed like the slots, but also covers channels without data
+		std::vector<uint64_t> m_ChangeStamps{};
+		uint64_t m_ChangeCounter = 0;
 	};
 }
-
@@ -0,0 +1,398 @@
+#include "../stdafx.h"
+#include "FlatBehaviorTree.h"
+
+using namespace Elite;
+
+bool FlatBehaviorTree::Build(const IBehavior* pRootBehavior, std::span<const ConditionDependencies> observedConditions)
+{
+    m_Nodes.clear();
+    m_Children.clear();
+    m_States.clear();
+    m_BoolKeys.clear();
+    m_IntKeys.clear();
+    m_Stack.clear();
+    m_ObservedConditions.clear();
+    m_Channels.clear();
+    m_NumConditionCalls = 0;
+    m_NumCachedConditions = 0;
+    m_Root = pRootBehavior ? pRootBehavior->Compile(*this) : InvalidNode;
+    if (m_Root == InvalidNode)
+    {
+        m_Nodes.clear();
+        return false;
+    }
+
+    m_States.resize(m_Nodes.size());
+    for (size_t i{}; i < m_Nodes.size(); ++i)
+    {
+        m_States[i].NumCycles = m_Nodes[i].Param;
+    }
+    // Selectors and sequences of leaves are run by their parent without a frame of their own
+    for (FlatNode& node: m_Nodes)
+    {
+        if (node.Type != FlatNodeType::Selector && node.Type != FlatNodeType::Sequence) continue;
+        node.InPlace = std::all_of(m_Children.begin() + node.FirstChild, m_Children.begin() + node.FirstChild + node.NumChildren,
+                                   [this](uint32_t child) { return IsLeaf(m_Nodes[child].Type); });
+    }
+    m_Stack.resize(GetDepth(m_Root));
+
+    // Every observed function gets one cache entry, shared by all the nodes that call it
+    for (const ConditionDependencies& dependencies: observedConditions)
+    {
+        m_ObservedConditions.push_back({dependencies.pCondition, static_cast<uint32_t>(m_Channels.size()),
+                                        static_cast<uint32_t>(dependencies.Channels.size())});
+        for (const BlackboardChannel& channel: dependencies.Channels) m_Channels.push_back(channel.GetIndex());
+    }
+    for (FlatNode& node: m_Nodes)
+    {
+        node.GuardObserver = FindObservedCondition(node.pGuard);
+        node.ConditionObserver = FindObservedCondition(node.pCondition);
+    }
+    return true;
+}
+
+int FlatBehaviorTree::FindObservedCondition(FlatConditionFn pCondition) const
+{
+    if (pCondition == nullptr) return -1;
+    const auto it = std::ranges::find(m_ObservedConditions, pCondition, &ObservedCondition::pCondition);
+    return it == m_ObservedConditions.end() ? -1 : static_cast<int>(it - m_ObservedConditions.begin());
+}
+
+uint32_t FlatBehaviorTree::AddNode(const FlatNode& node, std::span<IBehavior* const> children)
+{
+    const uint32_t index = static_cast<uint32_t>(m_Nodes.size());
+    m_Nodes.push_back(node);
+
+    std::vector<uint32_t> childIndices{};
+    childIndices.reserve(children.size());
+    for (const IBehavior* pChild: children)
+    {
+        const uint32_t childIndex = pChild ? pChild->Compile(*this) : InvalidNode;
+        if (childIndex == InvalidNode) return InvalidNode;
+        childIndices.push_back(childIndex);
+    }
+
+    m_Nodes[index].FirstChild = static_cast<uint32_t>(m_Children.size());
+    m_Nodes[index].NumChildren = static_cast<uint32_t>(childIndices.size());
+    m_Children.insert(m_Children.end(), childIndices.begin(), childIndices.end());
+    return index;
+}
+
+uint32_t FlatBehaviorTree::AddDecorator(const FlatNode& node, const IBehavior* pChild)
+{
+    const uint32_t childIndex = pChild ? pChild->Compile(*this) : InvalidNode;
+    if (childIndex == InvalidNode) return InvalidNode;
+
+    if (node.Type == FlatNodeType::Pass)
+    {
+        FlatNode& child = m_Nodes[childIndex];
+        // A guard is checked before the child's force is applied, so it can't go below a force
+        if (node.pGuard && node.Force == FlatForce::None && !child.pGuard && child.Force == FlatForce::None)
+        {
+            child.pGuard = node.pGuard;
+            return childIndex;
+        }
+        if (!node.pGuard && node.Force != FlatForce::None && child.Force == FlatForce::None)
+        {
+            child.Force = node.Force;
+            return childIndex;
+        }
+    }
+
+    const uint32_t index = static_cast<uint32_t>(m_Nodes.size());
+    m_Nodes.push_back(node);
+    m_Nodes[index].FirstChild = static_cast<uint32_t>(m_Children.size());
+    m_Nodes[index].NumChildren = 1;
+    m_Children.push_back(childIndex);
+    return index;
+}
+
+int FlatBehaviorTree::AddKey(const BlackboardKey<bool>& key)
+{
+    m_BoolKeys.push_back(key);
+    return static_cast<int>(m_BoolKeys.size() - 1);
+}
+
+int FlatBehaviorTree::AddKey(const BlackboardKey<int>& key)
+{
+    m_IntKeys.push_back(key);
+    return static_cast<int>(m_IntKeys.size() - 1);
+}
+
+BehaviorState FlatBehaviorTree::ApplyForce(const FlatNode& node, BehaviorState state)
+{
+    if (node.Force == FlatForce::None || state == BehaviorState::Running) return state;
+    return node.Force == FlatForce::Success ? BehaviorState::Success : BehaviorState::Failure;
+}
+
+bool FlatBehaviorTree::EvaluateCondition(FlatConditionFn pCondition, int observer, Blackboard* const pBlackBoard)
+{
+    if (observer < 0)
+    {
+        ++m_NumConditionCalls;
+        return pCondition(pBlackBoard);
+    }
+
+    ObservedCondition& observed = m_ObservedConditions[observer];
+    bool isDirty = !observed.HasResult;
+    for (uint32_t c{}; c < observed.NumChannels && !isDirty; ++c)
+        isDirty = pBlackBoard->GetChangeStamp(m_Channels[observed.FirstChannel + c]) > observed.EvaluatedAt;
+    if (!isDirty)
+    {
+        ++m_NumCachedConditions;
+#ifdef EXAM_VERIFY_OBSERVED_CONDITIONS
+        // Runs the condition after all, asserts stay on in Release so this needs its own switch
+        assert(pCondition(pBlackBoard) == observed.Result && "Observed condition changed without a change of its channels");
+#endif
+        return observed.Result;
+    }
+
+    ++m_NumConditionCalls;
+    observed.EvaluatedAt = pBlackBoard->GetChangeCounter();
+    observed.Result = pCondition(pBlackBoard);
+    observed.HasResult = true;
+    return observed.Result;
+}
+
+BehaviorState FlatBehaviorTree::EvaluateLeaf(const FlatNode& node, Blackboard* const pBlackBoard)
+{
+    // If chains instead of a switch, the indirect jump of a switch mispredicts when the leaf types alternate
+    BehaviorState state = BehaviorState::Failure;
+    if (node.pGuard && !EvaluateCondition(node.pGuard, node.GuardObserver, pBlackBoard)) return ApplyForce(node, state);
+    if (node.Type == FlatNodeType::Action)
+    {
+        if (node.pAction)
+        {
+            BehaviorTree::NoteActionRun(node.pAction);
+            state = node.pAction(pBlackBoard);
+        }
+    }
+    else if (node.pCondition && EvaluateCondition(node.pCondition, node.ConditionObserver, pBlackBoard) == (node.Type == FlatNodeType::Conditional))
+    {
+        state = BehaviorState::Success;
+    }
+    return ApplyForce(node, state);
+}
+
+template<bool LeavesOnly>
+bool FlatBehaviorTree::RunComposite(const FlatNode& node, NodeState& state, int& child, BehaviorState& result,
+                                    Blackboard* const pBlackBoard)
+{
+    // The result that moves on to the next child, anything else is returned right away
+    const BehaviorState nextState =
+        node.Type == FlatNodeType::Selector ? BehaviorState::Failure : BehaviorState::Success;
+    const uint32_t* const children = m_Children.data() + node.FirstChild;
+    const int numChildren = static_cast<int>(node.NumChildren);
+    for (; child < numChildren; ++child)
+    {
+        const FlatNode& childNode = m_Nodes[children[child]];
+        if (LeavesOnly || IsLeaf(childNode.Type)) result = EvaluateLeaf(childNode, pBlackBoard);
+        else if (!childNode.InPlace) return false;
+        else if (childNode.pGuard && !EvaluateCondition(childNode.pGuard, childNode.GuardObserver, pBlackBoard)) result = ApplyForce(childNode, BehaviorState::Failure);
+        else
+        {
+            NodeState& childState = m_States[children[child]];
+            int grandChild = childState.Cursor;
+            RunComposite<true>(childNode, childState, grandChild, result, pBlackBoard);
+            result = ApplyForce(childNode, result);
+        }
+
+        if (result != nextState)
+        {
+            state.Cursor = result == BehaviorState::Running ? child : 0;
+            return true;
+        }
+    }
+    // Every child failed (selector) or succeeded (sequence)
+    state.Cursor = 0;
+    result = nextState;
+    return true;
+}
+
+uint32_t FlatBehaviorTree::GetDepth(uint32_t node) const
+{
+    uint32_t depth{};
+    for (uint32_t c{}; c < m_Nodes[node].NumChildren; ++c)
+        depth = std::max(depth, GetDepth(m_Children[m_Nodes[node].FirstChild + c]));
+    return depth + 1;
+}
+
+BehaviorState FlatBehaviorTree::Tick(Blackboard* const pBlackBoard)
+{
+    if (m_Root == InvalidNode) return BehaviorState::Failure;
+    if (IsLeaf(m_Nodes[m_Root].Type)) return EvaluateLeaf(m_Nodes[m_Root], pBlackBoard);
+
+    // Every node either enters a child and waits for its result, or pops itself with a result.
+    // returning tells the node on top whether it is entered or resumed with the result of its child.
+    // The arrays are kept in locals, the conditions and actions could otherwise touch the members.
+    const FlatNode* const nodes = m_Nodes.data();
+    const uint32_t* const childIndices = m_Children.data();
+    NodeState* const states = m_States.data();
+    Frame* const stack = m_Stack.data();
+    int top{};
+    stack[0] = {m_Root, 0, 0};
+
+    BehaviorState result = BehaviorState::Failure;
+    bool returning = false;
+    while (top >= 0)
+    {
+        Frame& frame = stack[top];
+        const FlatNode& node = nodes[frame.Node];
+        NodeState& state = states[frame.Node];
+
+        // Set below, a child to enter or -1 to return result to the parent
+        int childToEnter = -1;
+        if (!returning && node.pGuard && !EvaluateCondition(node.pGuard, node.GuardObserver, pBlackBoard)) result = BehaviorState::Failure;
+        else if (node.Type == FlatNodeType::Selector || node.Type == FlatNodeType::Sequence)
+        {
+            // Composites are by far the most common frames, so they are kept out of the switch below
+            const BehaviorState nextState =
+                node.Type == FlatNodeType::Selector ? BehaviorState::Failure : BehaviorState::Success;
+            int child;
+            if (!returning) child = state.Cursor;
+            else if (result != nextState)
+            {
+                state.Cursor = result == BehaviorState::Running ? frame.Child : 0;
+                child = -1;
+            }
+            else child = frame.Child + 1;
+
+            if (child >= 0 && !RunComposite<false>(node, state, child, result, pBlackBoard))
+            {
+                frame.Child = child;
+                childToEnter = child;
+            }
+        }
+        else switch (node.Type)
+        {
+            case FlatNodeType::PartialSequence:
+                if (!returning)
+                {
+                    if (state.Cursor < static_cast<int>(node.NumChildren)) childToEnter = state.Cursor;
+                    else
+                    {
+                        state.Cursor = 0;
+                        result = BehaviorState::Success;
+                    }
+                }
+                else if (result == BehaviorState::Failure) state.Cursor = 0;
+                else if (result == BehaviorState::Success)
+                {
+                    ++state.Cursor;
+                    result = BehaviorState::Running;
+                }
+                break;
+            case FlatNodeType::Pass:
+                if (!returning) childToEnter = 0;
+                break;
+            case FlatNodeType::BlackboardCondition:
+            {
+                if (returning) break;
+                bool condition;
+                pBlackBoard->GetData(m_BoolKeys[node.Param], condition);
+                condition = node.Flag ? !condition : condition;
+                if (!condition) result = BehaviorState::Failure;
+                else childToEnter = 0;
+                break;
+            }
+            case FlatNodeType::Inverter:
+                if (!returning) childToEnter = 0;
+                else if (result == BehaviorState::Failure) result = BehaviorState::Success;
+                else if (result == BehaviorState::Success) result = BehaviorState::Failure;
+                break;
+            case FlatNodeType::RepeatBlackboardValue:
+                if (!returning) pBlackBoard->GetData(m_IntKeys[node.Param], state.NumCycles);
+                [[fallthrough]];
+            case FlatNodeType::Repeat:
+                // Phase 0 runs the remaining cycles in one frame, phase 1 is the single execute that follows it
+                if (!returning)
+                {
+                    frame.Child = node.Flag ? 0 : 1;
+                    frame.Start = state.Cursor;
+                }
+                else if (frame.Child == 1)
+                {
+                    if (result == BehaviorState::Success)
+                    {
+                        if (state.Cursor++ >= state.NumCycles)
+                        {
+                            state.Cursor = 0;
+                            result = BehaviorState::Success;
+                        }
+                        else result = BehaviorState::Running;
+                    }
+                    break;
+                }
+                else if (result != BehaviorState::Success) break;
+
+                if (frame.Child == 0)
+                {
+                    if (state.Cursor < state.NumCycles)
+                    {
+                        ++state.Cursor;
+                        childToEnter = 0;
+                        break;
+                    }
+                    state.Cursor = 0;
+                    if (frame.Start == 0)
+                    {
+                        result = BehaviorState::Success;
+                        break;
+                    }
+                    frame.Child = 1;
+                }
+                childToEnter = 0;
+                break;
+            case FlatNodeType::RetryUntilSuccessful:
+                if (!returning) childToEnter = 0;
+                else if (result == BehaviorState::Failure)
+                {
+                    ++state.Cursor;
+                    if (state.Cursor >= node.Param) state.Cursor = 0;
+                    else result = BehaviorState::Running;
+                }
+                break;
+            case FlatNodeType::KeepRunningUntilFailure:
+                if (!returning) childToEnter = 0;
+                else if (result == BehaviorState::Success) result = BehaviorState::Running;
+                break;
+            case FlatNodeType::RepeatUntil:
+                if (!returning) childToEnter = 0;
+                else if (node.pCondition == nullptr) result = BehaviorState::Failure;
+                else if (result == BehaviorState::Success
+                         && !EvaluateCondition(node.pCondition, node.ConditionObserver, pBlackBoard)) result = BehaviorState::Running;
+                break;
+            case FlatNodeType::AbortIf:
+                if (!returning) childToEnter = 0;
+                else if (node.pCondition == nullptr
+                         || EvaluateCondition(node.pCondition, node.ConditionObserver, pBlackBoard)) result = BehaviorState::Failure;
+                break;
+            default:
+                assert(false && "Leaves and composites are handled above");
+                break;
+        }
+
+        if (childToEnter < 0)
+        {
+            result = ApplyForce(node, result);
+            --top;
+            returning = true;
+            continue;
+        }
+
+        // Decorator children that don't need a frame are run right away and the decorator is resumed
+        const uint32_t childIndex = childIndices[node.FirstChild + childToEnter];
+        const FlatNode& child = nodes[childIndex];
+        if (IsLeaf(child.Type))
+        {
+            result = EvaluateLeaf(child, pBlackBoard);
+            returning = true;
+            continue;
+        }
+        ++top;
+        assert(top < static_cast<int>(m_Stack.size()) && "Flat behavior tree stack is not deep enough");
+        stack[top] = {childIndex, 0, 0};
+        returning = false;
+    }
+    return result;
+}
@@ -0,0 +1,159 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "BehaviorTree.h"
+
+namespace Elite
+{
+    //-----------------------------------------------------------------
+    // FLAT BEHAVIOR TREE
+    //-----------------------------------------------------------------
+    // Alternative backend for BehaviorTree: the IBehavior graph is compiled into one array of node records
+    // that point to their children through a range of a second array.
+    // Conditions and actions are stored as plain function pointers and Tick walks the records with an
+    // explicit stack instead of recursing through virtual Execute calls.
+    // Condition decorators and force success/failure are folded into the record of their child where possible,
+    // and leaves are run by their parent without a stack frame of their own.
+    // On the event-driven backend the observed conditions are memoized: they keep their last result until
+    // the blackboard reports a change on one of the channels they subscribed to.
+    enum class FlatNodeType : uint8_t
+    {
+        // Leaves
+        Action,
+        Conditional,
+        ConditionalInverter,
+        // Composites
+        Selector,
+        Sequence,
+        PartialSequence,
+        // Decorators
+        Pass, //Condition decorator or force success/failure that could not be folded into its child
+        BlackboardCondition,
+        Inverter,
+        Repeat,
+        RepeatBlackboardValue,
+        RetryUntilSuccessful,
+        KeepRunningUntilFailure,
+        RepeatUntil,
+        AbortIf
+    };
+
+    // Replaces the Success/Failure result of a node, Running is kept
+    enum class FlatForce : uint8_t
+    {
+        None,
+        Success,
+        Failure
+    };
+
+    using FlatConditionFn = BehaviorConditionFn;
+    using FlatActionFn = BehaviorActionFn;
+
+    struct FlatNode
+    {
+        FlatNodeType Type = FlatNodeType::Action;
+        FlatForce Force = FlatForce::None;
+        // Invert for BlackboardCondition, try to run in one frame for the repeats
+        bool Flag = false;
+        // Selector or sequence of leaves, its parent runs it without pushing a frame
+        bool InPlace = false;
+        // Range in the child index array
+        uint32_t FirstChild = 0;
+        uint32_t NumChildren = 0;
+        // Checked every time the node is entered, the node fails without running if it returns false
+        FlatConditionFn pGuard = nullptr;
+        // Conditional, ConditionalInverter, RepeatUntil and AbortIf
+        FlatConditionFn pCondition = nullptr;
+        FlatActionFn pAction = nullptr;
+        // Number of cycles/attempts, or the index of the blackboard key
+        int Param = 0;
+        // Cache entries of pGuard and pCondition on the event-driven backend, -1 if they run every time
+        int GuardObserver = -1;
+        int ConditionObserver = -1;
+    };
+
+    class FlatBehaviorTree final
+    {
+    public:
+        static constexpr uint32_t InvalidNode = static_cast<uint32_t>(-1);
+
+        // Returns false if a node of the graph can not be compiled (a node type without a Compile).
+        // The observed conditions reuse their last result until one of their channels changed.
+        bool Build(const IBehavior* pRootBehavior, std::span<const ConditionDependencies> observedConditions = {});
+        BehaviorState Tick(Blackboard* const pBlackBoard);
+
+        [[nodiscard]] size_t GetNumNodes() const { return m_Nodes.size(); }
+
+        // Statistics: conditions that ran and observed conditions that were answered from their cache
+        [[nodiscard]] size_t GetNumConditionCalls() const { return m_NumConditionCalls; }
+        [[nodiscard]] size_t GetNumCachedConditions() const { return m_NumCachedConditions; }
+
+        // Used by IBehavior::Compile, they return the index of the node or InvalidNode
+        uint32_t AddNode(const FlatNode& node, std::span<IBehavior* const> children = {});
+        // Compiles the child first, guards and forces are folded into it when its slot is still free
+        uint32_t AddDecorator(const FlatNode& node, const IBehavior* pChild);
+        int AddKey(const BlackboardKey<bool>& key);
+        int AddKey(const BlackboardKey<int>& key);
+
+        // Guard of a condition decorator without a condition, those always fail
+        static bool AlwaysFalse(Blackboard*) { return false; }
+
+    private:
+        // Per node state that survives between ticks, e.g. the child a composite was running
+        struct NodeState
+        {
+            int Cursor = 0;
+            int NumCycles = 0;
+        };
+
+        // Last result of a condition and the blackboard change counter it was computed at
+        struct ObservedCondition
+        {
+            FlatConditionFn pCondition;
+            // Range in the channel index array
+            uint32_t FirstChannel;
+            uint32_t NumChannels;
+            uint64_t EvaluatedAt = 0;
+            bool Result = false;
+            bool HasResult = false;
+        };
+
+        // One entry of the explicit call stack
+        struct Frame
+        {
+            uint32_t Node;
+            // Position in the node's child range, or the phase of a repeat
+            int Child;
+            // Cycle a repeat started from this tick
+            int Start;
+        };
+
+        [[nodiscard]] static bool IsLeaf(FlatNodeType type) { return type <= FlatNodeType::ConditionalInverter; }
+        [[nodiscard]] static BehaviorState ApplyForce(const FlatNode& node, BehaviorState state);
+        // Runs a leaf including its guard and force
+        BehaviorState EvaluateLeaf(const FlatNode& node, Blackboard* const pBlackBoard);
+        // Runs the condition, or returns its cached result if it is observed and none of its channels changed
+        bool EvaluateCondition(FlatConditionFn pCondition, int observer, Blackboard* const pBlackBoard);
+        [[nodiscard]] int FindObservedCondition(FlatConditionFn pCondition) const;
+        // Runs the children of a selector or sequence from child on, as long as they don't need a frame.
+        // Returns false if it stopped at a child that needs one, true (with the result set) if the node is done.
+        template<bool LeavesOnly>
+        bool RunComposite(const FlatNode& node, NodeState& state, int& child, BehaviorState& result,
+                          Blackboard* const pBlackBoard);
+        [[nodiscard]] uint32_t GetDepth(uint32_t node) const;
+
+        std::vector<FlatNode> m_Nodes{};
+        std::vector<uint32_t> m_Children{};
+        std::vector<NodeState> m_States{};
+        std::vector<BlackboardKey<bool>> m_BoolKeys{};
+        std::vector<BlackboardKey<int>> m_IntKeys{};
+        std::vector<Frame> m_Stack{};
+        std::vector<ObservedCondition> m_ObservedConditions{};
+        std::vector<size_t> m_Channels{};
+        uint32_t m_Root = InvalidNode;
+
+        size_t m_NumConditionCalls = 0;
+        size_t m_NumCachedConditions = 0;
+    };
+}
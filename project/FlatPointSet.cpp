@@ -0,0 +1,111 @@
+#include "stdafx.h"
+#include "FlatPointSet.h"
+
+FlatPointSet::FlatPointSet(float epsilon): m_Epsilon(epsilon), m_InvEpsilon(1.f / epsilon)
+{
+}
+
+bool FlatPointSet::Insert(const Elite::Vector2 &point)
+{
+    if (Find(point) != npos) return false;
+    m_X.push_back(point.x);
+    m_Y.push_back(point.y);
+
+    if (m_X.size() == HashIndexThreshold + 1) RebuildIndex();
+    else if (m_X.size() > HashIndexThreshold)
+        m_Index.emplace(GetKey(Quantize(point.x), Quantize(point.y)), static_cast<uint32_t>(m_X.size() - 1));
+    return true;
+}
+
+bool FlatPointSet::Erase(const Elite::Vector2 &point)
+{
+    const size_t idx = Find(point);
+    if (idx == npos) return false;
+    EraseAt(idx);
+    return true;
+}
+
+void FlatPointSet::EraseAt(size_t idx)
+{
+    const size_t lastIdx = m_X.size() - 1;
+    if (!m_Index.empty())
+    {
+        m_Index.erase(GetKey(Quantize(m_X[idx]), Quantize(m_Y[idx])));
+        if (idx != lastIdx) m_Index[GetKey(Quantize(m_X[lastIdx]), Quantize(m_Y[lastIdx]))] = static_cast<uint32_t>(idx);
+    }
+    m_X[idx] = m_X[lastIdx];
+    m_Y[idx] = m_Y[lastIdx];
+    m_X.pop_back();
+    m_Y.pop_back();
+
+    if (m_X.size() == HashIndexThreshold) m_Index.clear();
+}
+
+size_t FlatPointSet::Find(const Elite::Vector2 &point) const
+{
+    return m_X.size() > HashIndexThreshold ? FindHashed(point) : FindLinear(point);
+}
+
+bool FlatPointSet::FindNearest(const Elite::Vector2 &position, Elite::Vector2 &outPoint) const
+{
+    const size_t idx = Elite::FindNearestPoint(m_X.data(), m_Y.data(), m_X.size(), position);
+    if (idx == Elite::NearestPointNone) return false;
+    outPoint = {m_X[idx], m_Y[idx]};
+    return true;
+}
+
+void FlatPointSet::Clear()
+{
+    m_X.clear();
+    m_Y.clear();
+    m_Index.clear();
+}
+
+int64_t FlatPointSet::Quantize(float value) const
+{
+    return static_cast<int64_t>(floorf(value * m_InvEpsilon));
+}
+
+uint64_t FlatPointSet::GetKey(int64_t x, int64_t y)
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+}
+
+size_t FlatPointSet::FindLinear(const Elite::Vector2 &point) const
+{
+    const size_t count = m_X.size();
+    for (size_t i{}; i < count; ++i)
+    {
+        if (fabsf(m_X[i] - point.x) <= m_Epsilon && fabsf(m_Y[i] - point.y) <= m_Epsilon) return i;
+    }
+    return npos;
+}
+
+size_t FlatPointSet::FindHashed(const Elite::Vector2 &point) const
+{
+    // Points within epsilon are at most one quantization step away on each axis
+    const int64_t qx = Quantize(point.x);
+    const int64_t qy = Quantize(point.y);
+    for (int64_t x{qx - 1}; x <= qx + 1; ++x)
+    {
+        for (int64_t y{qy - 1}; y <= qy + 1; ++y)
+        {
+            const auto it = m_Index.find(GetKey(x, y));
+            if (it == m_Index.end()) continue;
+            const uint32_t idx = it->second;
+            if (fabsf(m_X[idx] - point.x) <= m_Epsilon && fabsf(m_Y[idx] - point.y) <= m_Epsilon) return idx;
+        }
+    }
+    return npos;
+}
+
+void FlatPointSet::RebuildIndex()
+{
+    m_Index.clear();
+    if (m_X.size() <= HashIndexThreshold) return;
+    m_Index.reserve(m_X.size());
+    for (size_t i{}; i < m_X.size(); ++i)
+    {
+        m_Index.emplace(GetKey(Quantize(m_X[i]), Quantize(m_Y[i])), static_cast<uint32_t>(i));
+    }
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Unordered set of points stored as separate x[] and y[] arrays (8 bytes per point).
+// Two points are the same when both coordinates are within the set's epsilon of each other.
+// Lookups are a linear scan over the arrays; once the set grows past HashIndexThreshold
+// an epsilon-quantized hash index is built so inserts and erases stay O(1).
+// Erase swaps the last point into the hole, so the order of the points is not stable.
+class FlatPointSet final
+{
+public:
+    static constexpr float DefaultEpsilon = 0.01f;
+    static constexpr size_t HashIndexThreshold = 64;
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    explicit FlatPointSet(float epsilon = DefaultEpsilon);
+
+    // Returns false if an equal point is already stored
+    bool Insert(const Elite::Vector2& point);
+    // Returns false if no equal point was stored
+    bool Erase(const Elite::Vector2& point);
+    void EraseAt(size_t idx);
+    // Removes every point the predicate returns true for, keeps the order of the others
+    template<typename Pred>
+    size_t EraseIf(Pred&& pred);
+
+    [[nodiscard]] bool Contains(const Elite::Vector2& point) const { return Find(point) != npos; }
+    // Returns the index of the equal point or npos
+    [[nodiscard]] size_t Find(const Elite::Vector2& point) const;
+    // Returns true if the set is not empty
+    bool FindNearest(const Elite::Vector2& position, Elite::Vector2& outPoint) const;
+
+    void Clear();
+    [[nodiscard]] size_t Size() const { return m_X.size(); }
+    [[nodiscard]] bool Empty() const { return m_X.empty(); }
+    [[nodiscard]] Elite::Vector2 operator[](size_t idx) const { return {m_X[idx], m_Y[idx]}; }
+
+private:
+    [[nodiscard]] int64_t Quantize(float value) const;
+    [[nodiscard]] static uint64_t GetKey(int64_t x, int64_t y);
+    [[nodiscard]] size_t FindLinear(const Elite::Vector2& point) const;
+    [[nodiscard]] size_t FindHashed(const Elite::Vector2& point) const;
+    void RebuildIndex();
+
+    const float m_Epsilon;
+    const float m_InvEpsilon;
+    std::vector<float> m_X{};
+    std::vector<float> m_Y{};
+    // Quantized position -> index, only used above HashIndexThreshold
+    std::unordered_map<uint64_t, uint32_t> m_Index{};
+};
+
+template<typename Pred>
+size_t FlatPointSet::EraseIf(Pred&& pred)
+{
+    size_t writeIdx{};
+    for (size_t readIdx{}; readIdx < m_X.size(); ++readIdx)
+    {
+        if (pred(Elite::Vector2{m_X[readIdx], m_Y[readIdx]})) continue;
+        m_X[writeIdx] = m_X[readIdx];
+        m_Y[writeIdx] = m_Y[readIdx];
+        ++writeIdx;
+    }
+    const size_t numErased = m_X.size() - writeIdx;
+    m_X.resize(writeIdx);
+    m_Y.resize(writeIdx);
+    if (numErased > 0) RebuildIndex();
+    return numErased;
+}
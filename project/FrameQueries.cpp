@@ -0,0 +1,74 @@
+#include "stdafx.h"
+#include "FrameQueries.h"
+#include "FrameSnapshot.h"
+
+FrameQueries::FrameQueries(const FrameSnapshot *const pSnapshot):
+    m_pSnapshot(pSnapshot)
+{
+}
+
+bool FrameQueries::Acquire(Query query)
+{
+    ++m_NumCalls;
+    if (m_ValidQueries & query) return false;
+    m_ValidQueries |= query;
+    ++m_NumComputations;
+    return true;
+}
+
+std::span<const uint32_t> FrameQueries::GetFovItemsByType(eItemType type)
+{
+    if (Acquire(FovItemsByType))
+    {
+        const std::vector<ItemInfo> &items = m_pSnapshot->GetItemsInFOV();
+        m_TypeBegin.fill(0);
+        for (const ItemInfo &item: items) ++m_TypeBegin[static_cast<size_t>(item.Type) + 1];
+        for (size_t type{1}; type <= NumItemTypes; ++type) m_TypeBegin[type] += m_TypeBegin[type - 1];
+
+        m_FovItemsByType.resize(items.size());
+        std::array<uint32_t, NumItemTypes> next{};
+        std::copy_n(m_TypeBegin.begin(), NumItemTypes, next.begin());
+        for (uint32_t i{}; i < items.size(); ++i) m_FovItemsByType[next[static_cast<size_t>(items[i].Type)]++] = i;
+    }
+    const size_t typeIndex = static_cast<size_t>(type);
+    assert(typeIndex < NumItemTypes && "Only the item types the interface reports are sorted");
+    return std::span<const uint32_t>{m_FovItemsByType}.subspan(m_TypeBegin[typeIndex],
+                                                               m_TypeBegin[typeIndex + 1] - m_TypeBegin[typeIndex]);
+}
+
+const ItemInfo *FrameQueries::GetNearestGarbage()
+{
+    if (Acquire(NearestGarbage))
+    {
+        const std::vector<ItemInfo> &items = m_pSnapshot->GetItemsInFOV();
+        const Elite::Vector2 agentPos = m_pSnapshot->GetAgentInfo().Position;
+        m_pNearestGarbage = nullptr;
+        float nearestDistSqr = FLT_MAX;
+        for (const uint32_t i: GetFovItemsByType(eItemType::GARBAGE))
+        {
+            const float distSqr = (items[i].Location - agentPos).MagnitudeSquared();
+            if (distSqr < nearestDistSqr)
+            {
+                nearestDistSqr = distSqr;
+                m_pNearestGarbage = &items[i];
+            }
+        }
+    }
+    return m_pNearestGarbage;
+}
+
+std::span<const uint32_t> FrameQueries::GetItemsInGrabRange()
+{
+    if (Acquire(ItemsInGrabRange))
+    {
+        const std::vector<ItemInfo> &items = m_pSnapshot->GetItemsInFOV();
+        const AgentInfo &agentInfo = m_pSnapshot->GetAgentInfo();
+        const float grabRangeSqr = agentInfo.GrabRange * agentInfo.GrabRange;
+        m_ItemsInGrabRange.clear();
+        for (uint32_t i{}; i < items.size(); ++i)
+        {
+            if ((agentInfo.Position - items[i].Location).MagnitudeSquared() < grabRangeSqr) m_ItemsInGrabRange.push_back(i);
+        }
+    }
+    return m_ItemsInGrabRange;
+}
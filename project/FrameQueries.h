@@ -0,0 +1,56 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "Exam_HelperStructs.h"
+
+class FrameSnapshot;
+
+// Values several BT nodes derive from the frame snapshot in the same tick.
+// Each one is computed the first time a node asks for it and then served from memory until the Agent
+// captures the next snapshot. Inventory questions go to the InventoryMirror, which is always up to date.
+class FrameQueries final
+{
+public:
+    explicit FrameQueries(const FrameSnapshot* pSnapshot);
+
+    // Called by Agent::CaptureFrameSnapshot, every value of the previous tick is stale from then on
+    void Invalidate() { m_ValidQueries = 0; }
+
+    // Indices into GetItemsInFOV of the items of one type, in FOV order
+    [[nodiscard]] std::span<const uint32_t> GetFovItemsByType(eItemType type);
+    // The garbage in the FOV closest to the agent, nullptr if there is none
+    [[nodiscard]] const ItemInfo* GetNearestGarbage();
+    // Indices into GetItemsInFOV of the items within grab range, in FOV order
+    [[nodiscard]] std::span<const uint32_t> GetItemsInGrabRange();
+
+    // Statistics: how often a value had to be computed, every other call was served from the memo
+    [[nodiscard]] size_t GetNumCalls() const { return m_NumCalls; }
+    [[nodiscard]] size_t GetNumComputations() const { return m_NumComputations; }
+
+private:
+    enum Query : uint32_t
+    {
+        FovItemsByType = 1u << 0,
+        NearestGarbage = 1u << 1,
+        ItemsInGrabRange = 1u << 2
+    };
+
+    // Counts the call and returns true if the value has to be computed first
+    bool Acquire(Query query);
+
+    static constexpr size_t NumItemTypes = static_cast<size_t>(eItemType::_LAST) + 1;
+
+    const FrameSnapshot* m_pSnapshot;
+    uint32_t m_ValidQueries = 0;
+
+    // Counting sort of the FOV indices by type, the items of type t are [m_TypeBegin[t], m_TypeBegin[t + 1])
+    std::vector<uint32_t> m_FovItemsByType{};
+    std::array<uint32_t, NumItemTypes + 1> m_TypeBegin{};
+    const ItemInfo* m_pNearestGarbage = nullptr;
+    std::vector<uint32_t> m_ItemsInGrabRange{};
+
+    size_t m_NumCalls = 0;
+    size_t m_NumComputations = 0;
+};
@@ -0,0 +1,88 @@
+#include "stdafx.h"
+#include "FrameSnapshot.h"
+#include "IExamInterface.h"
+
+namespace
+{
+    // Field by field, the structs have padding and ItemInfo::operator== only looks at the type and location
+    bool AreEqual(const AgentInfo& a, const AgentInfo& b)
+    {
+        return a.Stamina == b.Stamina && a.Health == b.Health && a.Energy == b.Energy && a.RunMode == b.RunMode
+            && a.IsInHouse == b.IsInHouse && a.Bitten == b.Bitten && a.WasBitten == b.WasBitten && a.Death == b.Death
+            && a.FOV_Angle == b.FOV_Angle && a.FOV_Range == b.FOV_Range && a.LinearVelocity == b.LinearVelocity
+            && a.AngularVelocity == b.AngularVelocity && a.CurrentLinearSpeed == b.CurrentLinearSpeed
+            && a.Position == b.Position && a.Orientation == b.Orientation && a.MaxLinearSpeed == b.MaxLinearSpeed
+            && a.MaxAngularSpeed == b.MaxAngularSpeed && a.GrabRange == b.GrabRange && a.AgentSize == b.AgentSize;
+    }
+
+    bool AreEqual(const FOVStats& a, const FOVStats& b)
+    {
+        return a.NumHouses == b.NumHouses && a.NumEnemies == b.NumEnemies && a.NumItems == b.NumItems
+            && a.NumPurgeZones == b.NumPurgeZones;
+    }
+
+    bool AreEqual(const HouseInfo& a, const HouseInfo& b)
+    {
+        return a.Center == b.Center && a.Size == b.Size;
+    }
+
+    bool AreEqual(const EnemyInfo& a, const EnemyInfo& b)
+    {
+        return a.Type == b.Type && a.Location == b.Location && a.LinearVelocity == b.LinearVelocity
+            && a.EnemyHash == b.EnemyHash && a.Size == b.Size && a.Health == b.Health;
+    }
+
+    bool AreEqual(const ItemInfo& a, const ItemInfo& b)
+    {
+        return a.Type == b.Type && a.Location == b.Location && a.ItemHash == b.ItemHash && a.Value == b.Value;
+    }
+
+    bool AreEqual(const PurgeZoneInfo& a, const PurgeZoneInfo& b)
+    {
+        return a.Center == b.Center && a.Radius == b.Radius && a.ZoneHash == b.ZoneHash;
+    }
+
+    // Copies into the existing buffer so its capacity is reused from frame to frame, returns true if the content changed
+    template<typename T>
+    bool CopyInto(std::vector<T>& buffer, const std::vector<T>& source)
+    {
+        const bool changed = !std::ranges::equal(buffer, source, [](const T& a, const T& b) { return AreEqual(a, b); });
+        if (changed) buffer.assign(source.begin(), source.end());
+        return changed;
+    }
+}
+
+void FrameSnapshot::Capture(IExamInterface *const pInterface)
+{
+    const bool isFirstCapture = m_NumInterfaceCalls == 0;
+    m_ChangedFields = 0;
+    const auto markChanged = [this](SnapshotField field, bool changed)
+    {
+        if (changed) m_ChangedFields |= 1u << static_cast<uint32_t>(field);
+    };
+
+    const AgentInfo agentInfo = pInterface->Agent_GetInfo();
+    const FOVStats fovStats = pInterface->FOV_GetStats();
+    m_NumInterfaceCalls += 2;
+    markChanged(SnapshotField::AgentInfo, isFirstCapture || !AreEqual(agentInfo, m_AgentInfo));
+    markChanged(SnapshotField::FOVStats, isFirstCapture || !AreEqual(fovStats, m_FOVStats));
+    m_AgentInfo = agentInfo;
+    m_FOVStats = fovStats;
+
+    // Only ask for the FOV vectors that actually have something in them
+    const std::vector<HouseInfo> noHouses{};
+    const std::vector<EnemyInfo> noEnemies{};
+    const std::vector<ItemInfo> noItems{};
+    const std::vector<PurgeZoneInfo> noPurgeZones{};
+    m_NumInterfaceCalls += (m_FOVStats.NumHouses > 0) + (m_FOVStats.NumEnemies > 0) + (m_FOVStats.NumItems > 0)
+        + (m_FOVStats.NumPurgeZones > 0);
+    markChanged(SnapshotField::HousesInFOV,
+                CopyInto(m_HousesInFOV, m_FOVStats.NumHouses > 0 ? pInterface->GetHousesInFOV() : noHouses));
+    markChanged(SnapshotField::EnemiesInFOV,
+                CopyInto(m_EnemiesInFOV, m_FOVStats.NumEnemies > 0 ? pInterface->GetEnemiesInFOV() : noEnemies));
+    markChanged(SnapshotField::ItemsInFOV,
+                CopyInto(m_ItemsInFOV, m_FOVStats.NumItems > 0 ? pInterface->GetItemsInFOV() : noItems));
+    markChanged(SnapshotField::PurgeZonesInFOV,
+                CopyInto(m_PurgeZonesInFOV, m_FOVStats.NumPurgeZones > 0 ? pInterface->GetPurgeZonesInFOV() : noPurgeZones));
+    if (isFirstCapture) m_ChangedFields = (1u << static_cast<uint32_t>(SnapshotField::Count)) - 1;
+}
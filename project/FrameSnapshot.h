@@ -0,0 +1,62 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "Exam_HelperStructs.h"
+
+class IExamInterface;
+
+enum class SnapshotField : uint8_t
+{
+    AgentInfo,
+    FOVStats,
+    HousesInFOV,
+    EnemiesInFOV,
+    ItemsInFOV,
+    PurgeZonesInFOV,
+    Count
+};
+
+// Copy of everything the agent queries from the interface each frame.
+// Captured once at the start of SurvivalAgentPlugin::UpdateSteering so the BT nodes
+// read plain memory instead of crossing the virtual interface and rebuilding the FOV vectors.
+class FrameSnapshot final
+{
+public:
+    FrameSnapshot() = default;
+
+    void Capture(IExamInterface* const pInterface);
+
+    [[nodiscard]] const AgentInfo& GetAgentInfo() const { CountRead(); return m_AgentInfo; }
+    [[nodiscard]] const FOVStats& GetFOVStats() const { CountRead(); return m_FOVStats; }
+    [[nodiscard]] const std::vector<HouseInfo>& GetHousesInFOV() const { CountRead(); return m_HousesInFOV; }
+    [[nodiscard]] const std::vector<EnemyInfo>& GetEnemiesInFOV() const { CountRead(); return m_EnemiesInFOV; }
+    [[nodiscard]] const std::vector<ItemInfo>& GetItemsInFOV() const { CountRead(); return m_ItemsInFOV; }
+    [[nodiscard]] const std::vector<PurgeZoneInfo>& GetPurgeZonesInFOV() const { CountRead(); return m_PurgeZonesInFOV; }
+
+    // True if the field differs from the previous capture, the first capture changes everything
+    [[nodiscard]] bool HasChanged(SnapshotField field) const { return m_ChangedFields & (1u << static_cast<uint32_t>(field)); }
+
+    // Statistics: every read would have been an interface call without the snapshot.
+    // The getters sit on the hot path, so reads are only counted in profiler builds (EXAM_PROFILER), 0 otherwise
+    [[nodiscard]] size_t GetNumReads() const { return m_NumReads; }
+    [[nodiscard]] size_t GetNumInterfaceCalls() const { return m_NumInterfaceCalls; }
+
+private:
+    void CountRead() const
+    {
+#ifdef EXAM_PROFILER
+        ++m_NumReads;
+#endif
+    }
+
+    AgentInfo m_AgentInfo{};
+    FOVStats m_FOVStats{};
+    std::vector<HouseInfo> m_HousesInFOV{};
+    std::vector<EnemyInfo> m_EnemiesInFOV{};
+    std::vector<ItemInfo> m_ItemsInFOV{};
+    std::vector<PurgeZoneInfo> m_PurgeZonesInFOV{};
+    uint32_t m_ChangedFields = 0;
+
+    mutable size_t m_NumReads = 0;
+    size_t m_NumInterfaceCalls = 0;
+};
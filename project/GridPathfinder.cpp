@@ -0,0 +1,387 @@
+#include "stdafx.h"
+#include "GridPathfinder.h"
+#include <bit>
+#include "Exam_HelperStructs.h"
+
+namespace
+{
+    constexpr float Sqrt2 = 1.41421356f;
+
+    // Length of the shortest 8-connected path over free cells between two cells that are dx, dy apart
+    float GetOctileDistance(int32_t dx, int32_t dy)
+    {
+        const int32_t absX = std::abs(dx);
+        const int32_t absY = std::abs(dy);
+        return static_cast<float>(std::max(absX, absY)) + (Sqrt2 - 1.f) * static_cast<float>(std::min(absX, absY));
+    }
+
+    // The blocked bits of the 64 cells of a line from pos on, bit i for cell pos + i
+    uint64_t LoadBits(const OccupancyGrid::BitLines &lines, int32_t line, int32_t pos)
+    {
+        const uint64_t *pLine = lines.pWords + static_cast<size_t>(line + 1) * lines.WordsPerLine;
+        const uint32_t bit = static_cast<uint32_t>(pos + OccupancyGrid::LinePadding);
+        const uint32_t shift = bit % 64;
+        const uint64_t low = pLine[bit / 64] >> shift;
+        return shift == 0 ? low : low | pLine[bit / 64 + 1] << (64 - shift);
+    }
+}
+
+#pragma region OccupancyGrid
+void OccupancyGrid::Reset(const WorldInfo &worldInfo, float cellSize)
+{
+    const auto numCells = [cellSize](float length) { return std::max(1u, static_cast<uint32_t>(std::ceil(length / cellSize))); };
+    Reset(worldInfo.Center - worldInfo.Dimensions * 0.5f, cellSize, numCells(worldInfo.Dimensions.x),
+          numCells(worldInfo.Dimensions.y));
+}
+
+void OccupancyGrid::Reset(const Elite::Vector2 &minCorner, float cellSize, uint32_t width, uint32_t height)
+{
+    assert(cellSize > 0.f && width > 0 && height > 0 && "The grid needs cells");
+    m_MinCorner = minCorner;
+    m_CellSize = cellSize;
+    m_InvCellSize = 1.f / cellSize;
+    m_Width = width;
+    m_Height = height;
+    ResetLines(m_RowBits, m_WordsPerRow, height, width);
+    ResetLines(m_ColumnBits, m_WordsPerColumn, width, height);
+}
+
+void OccupancyGrid::SetBlocked(uint32_t x, uint32_t y, bool isBlocked)
+{
+    assert(x < m_Width && y < m_Height && "Cell outside the grid");
+    const auto setBit = [isBlocked](std::vector<uint64_t> &bits, uint32_t wordsPerLine, uint32_t line, uint32_t pos)
+    {
+        const size_t bit = pos + LinePadding;
+        uint64_t &word = bits[(line + 1) * static_cast<size_t>(wordsPerLine) + bit / 64];
+        const uint64_t mask = uint64_t{1} << bit % 64;
+        word = isBlocked ? word | mask : word & ~mask;
+    };
+    setBit(m_RowBits, m_WordsPerRow, y, x);
+    setBit(m_ColumnBits, m_WordsPerColumn, x, y);
+}
+
+void OccupancyGrid::AddHouseWalls(const HouseInfo &house)
+{
+    const Elite::Vector2 halfSize = house.Size * 0.5f;
+    const uint32_t left = GetColumn(house.Center.x - halfSize.x);
+    const uint32_t right = GetColumn(house.Center.x + halfSize.x);
+    const uint32_t bottom = GetRow(house.Center.y - halfSize.y);
+    const uint32_t top = GetRow(house.Center.y + halfSize.y);
+    const auto isDoor = [this](uint32_t cell, float minCorner, float middle)
+    {
+        return std::abs(minCorner + (static_cast<float>(cell) + 0.5f) * m_CellSize - middle) < DoorWidth * 0.5f;
+    };
+
+    for (uint32_t x{left}; x <= right; ++x)
+    {
+        if (isDoor(x, m_MinCorner.x, house.Center.x)) continue;
+        SetBlocked(x, bottom, true);
+        SetBlocked(x, top, true);
+    }
+    for (uint32_t y{bottom}; y <= top; ++y)
+    {
+        if (isDoor(y, m_MinCorner.y, house.Center.y)) continue;
+        SetBlocked(left, y, true);
+        SetBlocked(right, y, true);
+    }
+}
+
+uint32_t OccupancyGrid::GetCell(const Elite::Vector2 &point) const
+{
+    return GetRow(point.y) * m_Width + GetColumn(point.x);
+}
+
+Elite::Vector2 OccupancyGrid::GetCellCenter(uint32_t cell) const
+{
+    return m_MinCorner + Elite::Vector2{static_cast<float>(cell % m_Width) + 0.5f, static_cast<float>(cell / m_Width) + 0.5f}
+           * m_CellSize;
+}
+
+uint32_t OccupancyGrid::GetColumn(float x) const
+{
+    const float column = std::floor((x - m_MinCorner.x) * m_InvCellSize);
+    return static_cast<uint32_t>(std::clamp(column, 0.f, static_cast<float>(m_Width - 1)));
+}
+
+uint32_t OccupancyGrid::GetRow(float y) const
+{
+    const float row = std::floor((y - m_MinCorner.y) * m_InvCellSize);
+    return static_cast<uint32_t>(std::clamp(row, 0.f, static_cast<float>(m_Height - 1)));
+}
+
+void OccupancyGrid::ResetLines(std::vector<uint64_t> &bits, uint32_t &wordsPerLine, uint32_t numLines, uint32_t lineLength)
+{
+    // The padding in front, the cells, and past them enough set bits for a 64 cell read starting on the line's end
+    wordsPerLine = (LinePadding + lineLength + 128) / 64 + 1;
+    bits.assign(static_cast<size_t>(numLines + 2) * wordsPerLine, ~uint64_t{0});
+    for (uint32_t line{1}; line <= numLines; ++line)
+    {
+        uint64_t *pLine = bits.data() + static_cast<size_t>(line) * wordsPerLine;
+        for (uint32_t pos{}; pos < lineLength; ++pos)
+            pLine[(pos + LinePadding) / 64] &= ~(uint64_t{1} << (pos + LinePadding) % 64);
+    }
+}
+#pragma endregion
+
+#pragma region GridPathfinder
+float GridPathfinder::GetPathCost(const OccupancyGrid &grid, const Elite::Vector2 &from, const Elite::Vector2 &to)
+{
+    const float cost = Search(grid, grid.GetCell(from), grid.GetCell(to));
+    return cost == NoPath ? NoPath : cost * grid.GetCellSize();
+}
+
+bool GridPathfinder::FindPath(const OccupancyGrid &grid, const Elite::Vector2 &from, const Elite::Vector2 &to,
+                              std::vector<Elite::Vector2> &outPath)
+{
+    const uint32_t start = grid.GetCell(from);
+    const uint32_t goal = grid.GetCell(to);
+    if (Search(grid, start, goal) == NoPath) return false;
+
+    // Back from the goal along the parents, the first and last cell are replaced by the points themselves
+    outPath.clear();
+    outPath.push_back(to);
+    for (uint32_t cell = m_Cells[goal].Parent; cell != NoCell && cell != start; cell = m_Cells[cell].Parent)
+        outPath.push_back(grid.GetCellCenter(cell));
+    outPath.push_back(from);
+    std::ranges::reverse(outPath);
+    return true;
+}
+
+float GridPathfinder::GetCostLowerBound(const OccupancyGrid &grid, const Elite::Vector2 &from, const Elite::Vector2 &to)
+{
+    const uint32_t start = grid.GetCell(from);
+    const uint32_t goal = grid.GetCell(to);
+    const int32_t width = static_cast<int32_t>(grid.GetWidth());
+    return GetOctileDistance(static_cast<int32_t>(goal) % width - static_cast<int32_t>(start) % width,
+                             static_cast<int32_t>(goal) / width - static_cast<int32_t>(start) / width) * grid.GetCellSize();
+}
+
+float GridPathfinder::Search(const OccupancyGrid &grid, uint32_t start, uint32_t goal)
+{
+    assert(!grid.IsEmpty() && "Search on a grid without cells");
+    m_pGrid = &grid;
+    m_Start = start;
+    m_Goal = goal;
+    const uint32_t width = grid.GetWidth();
+    m_StartX = static_cast<int32_t>(start % width);
+    m_StartY = static_cast<int32_t>(start / width);
+    m_GoalX = static_cast<int32_t>(goal % width);
+    m_GoalY = static_cast<int32_t>(goal / width);
+    m_NumExpanded = 0;
+
+    // Sized once per grid, after that a new generation is all it takes to forget the previous query
+    const size_t numCells = static_cast<size_t>(width) * grid.GetHeight();
+    if (m_Cells.size() != numCells)
+    {
+        m_Cells.assign(numCells, {});
+        m_Generation = 0;
+    }
+    if (++m_Generation == 0)
+    {
+        for (CellState &state: m_Cells) state.Generation = 0;
+        m_Generation = 1;
+    }
+    m_Open.clear();
+
+    float result = NoPath;
+    Relax(start, NoCell, 0.f);
+    while (!m_Open.empty())
+    {
+        std::ranges::pop_heap(m_Open, HasLowerPriority);
+        const OpenEntry entry = m_Open.back();
+        m_Open.pop_back();
+        // A cheaper way to the cell was found after this entry was pushed
+        if (entry.Cost > m_Cells[entry.Cell].Cost) continue;
+
+        ++m_NumExpanded;
+        if (entry.Cell == goal)
+        {
+            result = entry.Cost;
+            break;
+        }
+        if (m_Algorithm == Algorithm::JumpPoint) ExpandJumpPoint(entry.Cell, entry.Cost);
+        else ExpandAStar(entry.Cell, entry.Cost);
+    }
+    m_pGrid = nullptr;
+    return result;
+}
+
+void GridPathfinder::ExpandAStar(uint32_t cell, float cost)
+{
+    const uint32_t width = m_pGrid->GetWidth();
+    const int32_t x = static_cast<int32_t>(cell % width);
+    const int32_t y = static_cast<int32_t>(cell / width);
+    for (int32_t dy{-1}; dy <= 1; ++dy)
+    {
+        for (int32_t dx{-1}; dx <= 1; ++dx)
+        {
+            if ((dx == 0 && dy == 0) || !IsWalkable(x + dx, y + dy)) continue;
+            const bool isDiagonal = dx != 0 && dy != 0;
+            if (isDiagonal && (!IsWalkable(x + dx, y) || !IsWalkable(x, y + dy))) continue;
+            Relax(static_cast<uint32_t>(y + dy) * width + static_cast<uint32_t>(x + dx), cell, cost + (isDiagonal ? Sqrt2 : 1.f));
+        }
+    }
+}
+
+void GridPathfinder::ExpandJumpPoint(uint32_t cell, float cost)
+{
+    const uint32_t width = m_pGrid->GetWidth();
+    const int32_t x = static_cast<int32_t>(cell % width);
+    const int32_t y = static_cast<int32_t>(cell / width);
+    const auto jumpTowards = [&](int32_t dx, int32_t dy)
+    {
+        const uint32_t jumpPoint = Jump(x + dx, y + dy, dx, dy);
+        if (jumpPoint == NoCell) return;
+        const int32_t jumpX = static_cast<int32_t>(jumpPoint % width);
+        const int32_t jumpY = static_cast<int32_t>(jumpPoint / width);
+        Relax(jumpPoint, cell, cost + GetOctileDistance(jumpX - x, jumpY - y));
+    };
+
+    const uint32_t parent = m_Cells[cell].Parent;
+    if (parent == NoCell)
+    {
+        for (int32_t dy{-1}; dy <= 1; ++dy)
+        {
+            for (int32_t dx{-1}; dx <= 1; ++dx)
+            {
+                if (dx == 0 && dy == 0) continue;
+                if (dx != 0 && dy != 0 && (!IsWalkable(x + dx, y) || !IsWalkable(x, y + dy))) continue;
+                jumpTowards(dx, dy);
+            }
+        }
+        return;
+    }
+
+    // Only the neighbours a path coming in from the parent can't reach as cheaply without passing this cell
+    const int32_t dx = Elite::Clamp(x - static_cast<int32_t>(parent % width), -1, 1);
+    const int32_t dy = Elite::Clamp(y - static_cast<int32_t>(parent / width), -1, 1);
+    if (dx != 0 && dy != 0)
+    {
+        const bool isVerticalWalkable = IsWalkable(x, y + dy);
+        const bool isHorizontalWalkable = IsWalkable(x + dx, y);
+        if (isVerticalWalkable) jumpTowards(0, dy);
+        if (isHorizontalWalkable) jumpTowards(dx, 0);
+        if (isVerticalWalkable && isHorizontalWalkable) jumpTowards(dx, dy);
+    }
+    else if (dx != 0)
+    {
+        const bool isNextWalkable = IsWalkable(x + dx, y);
+        const bool isUpWalkable = IsWalkable(x, y + 1);
+        const bool isDownWalkable = IsWalkable(x, y - 1);
+        if (isNextWalkable)
+        {
+            jumpTowards(dx, 0);
+            if (isUpWalkable) jumpTowards(dx, 1);
+            if (isDownWalkable) jumpTowards(dx, -1);
+        }
+        if (isUpWalkable) jumpTowards(0, 1);
+        if (isDownWalkable) jumpTowards(0, -1);
+    }
+    else
+    {
+        const bool isNextWalkable = IsWalkable(x, y + dy);
+        const bool isRightWalkable = IsWalkable(x + 1, y);
+        const bool isLeftWalkable = IsWalkable(x - 1, y);
+        if (isNextWalkable)
+        {
+            jumpTowards(0, dy);
+            if (isRightWalkable) jumpTowards(1, dy);
+            if (isLeftWalkable) jumpTowards(-1, dy);
+        }
+        if (isRightWalkable) jumpTowards(1, 0);
+        if (isLeftWalkable) jumpTowards(-1, 0);
+    }
+}
+
+uint32_t GridPathfinder::Jump(int32_t x, int32_t y, int32_t dx, int32_t dy) const
+{
+    const uint32_t width = m_pGrid->GetWidth();
+    if (dy == 0)
+    {
+        const int32_t jumpX = ScanLine(m_pGrid->GetRows(), y, x, dx, {m_StartY, m_StartX}, {m_GoalY, m_GoalX});
+        return jumpX == NoPos ? NoCell : static_cast<uint32_t>(y) * width + static_cast<uint32_t>(jumpX);
+    }
+    if (dx == 0)
+    {
+        const int32_t jumpY = ScanLine(m_pGrid->GetColumns(), x, y, dy, {m_StartX, m_StartY}, {m_GoalX, m_GoalY});
+        return jumpY == NoPos ? NoCell : static_cast<uint32_t>(jumpY) * width + static_cast<uint32_t>(x);
+    }
+
+    while (IsWalkable(x, y))
+    {
+        const uint32_t cell = static_cast<uint32_t>(y) * width + static_cast<uint32_t>(x);
+        if (cell == m_Goal) return cell;
+        // A diagonal stops where one of its straight parts finds a jump point
+        if (Jump(x + dx, y, dx, 0) != NoCell || Jump(x, y + dy, 0, dy) != NoCell) return cell;
+        if (!IsWalkable(x + dx, y) || !IsWalkable(x, y + dy)) return NoCell;
+        x += dx;
+        y += dy;
+    }
+    return NoCell;
+}
+
+int32_t GridPathfinder::ScanLine(const OccupancyGrid::BitLines &lines, int32_t line, int32_t pos, int32_t dir,
+                                 const LineCell &start, const LineCell &goal)
+{
+    const auto isInWindow = [](const LineCell &cell, int32_t windowLine, int32_t base)
+    {
+        return cell.Line == windowLine && static_cast<uint32_t>(cell.Pos - base) < 64;
+    };
+    // The start and goal cell are walkable even when a wall runs through them
+    const auto loadWalls = [&](int32_t windowLine, int32_t base)
+    {
+        uint64_t bits = LoadBits(lines, windowLine, base);
+        if (isInWindow(start, windowLine, base)) bits &= ~(uint64_t{1} << (start.Pos - base));
+        if (isInWindow(goal, windowLine, base)) bits &= ~(uint64_t{1} << (goal.Pos - base));
+        return bits;
+    };
+
+    while (true)
+    {
+        // 64 cells in the direction of the scan, the first of them at pos
+        const int32_t base = dir > 0 ? pos : pos - 63;
+        const uint64_t walls = loadWalls(line, base);
+        // A straight line stops next to the end of a wall, where a path can turn around it
+        uint64_t stops = (~loadWalls(line - 1, base) & loadWalls(line - 1, base - dir))
+                         | (~loadWalls(line + 1, base) & loadWalls(line + 1, base - dir));
+        if (isInWindow(goal, line, base)) stops |= uint64_t{1} << (goal.Pos - base);
+
+        // A stop counts only before the first wall, a wall ends the line without a jump point
+        if (dir > 0)
+        {
+            const int32_t firstWall = std::countr_zero(walls);
+            const int32_t firstStop = std::countr_zero(stops);
+            if (firstStop < firstWall) return base + firstStop;
+        }
+        else
+        {
+            const int32_t firstWall = 63 - std::countl_zero(walls);
+            const int32_t firstStop = 63 - std::countl_zero(stops);
+            if (firstStop > firstWall) return base + firstStop;
+        }
+        if (walls != 0) return NoPos;
+        pos += 64 * dir;
+    }
+}
+
+void GridPathfinder::Relax(uint32_t cell, uint32_t parent, float cost)
+{
+    CellState &state = m_Cells[cell];
+    if (state.Generation == m_Generation && state.Cost <= cost) return;
+    state = {cost, parent, m_Generation};
+    m_Open.push_back({cost + GetHeuristic(cell), cost, cell});
+    std::ranges::push_heap(m_Open, HasLowerPriority);
+}
+
+bool GridPathfinder::HasLowerPriority(const OpenEntry &a, const OpenEntry &b)
+{
+    return a.Estimate > b.Estimate || (a.Estimate == b.Estimate && a.Cost < b.Cost);
+}
+
+float GridPathfinder::GetHeuristic(uint32_t cell) const
+{
+    const int32_t width = static_cast<int32_t>(m_pGrid->GetWidth());
+    return GetOctileDistance(static_cast<int32_t>(m_Goal) % width - static_cast<int32_t>(cell) % width,
+                             static_cast<int32_t>(m_Goal) / width - static_cast<int32_t>(cell) / width);
+}
+#pragma endregion
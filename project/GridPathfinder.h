@@ -0,0 +1,166 @@
+#pragma once
+#include <cfloat>
+#include <cstdint>
+#include <vector>
+#include "EliteMath/EMath.h"
+
+struct HouseInfo;
+struct WorldInfo;
+
+// Walkability of the world on a regular grid of square cells, for GridPathfinder.
+// A cell is blocked when a wall of a known house runs through it. Outside the grid everything is blocked.
+// The cells are kept as bits twice, row by row and column by column, so a search can test 64 cells of a line at once.
+class OccupancyGrid final
+{
+public:
+    // HouseInfo only has the outline of a house, so every side is given a door of this width in its middle
+    static constexpr float DoorWidth = 4.f;
+    // Set bits in front of every line, so reading the 64 cells from a position just before the grid stays in the line
+    static constexpr int32_t LinePadding = 64;
+
+    // The blocked bits of all rows or all columns. Cell pos of line is bit pos + LinePadding from the words of the
+    // line on, which start at (line + 1) * WordsPerLine: the lines -1 and past the last one are fully blocked,
+    // and so are the bits after the last cell of a line, up to a word beyond the end
+    struct BitLines
+    {
+        const uint64_t* pWords;
+        uint32_t WordsPerLine;
+    };
+
+    // Covers the world with free cells of cellSize
+    void Reset(const WorldInfo& worldInfo, float cellSize);
+    // width x height free cells with the corner of cell (0, 0) at minCorner
+    void Reset(const Elite::Vector2& minCorner, float cellSize, uint32_t width, uint32_t height);
+
+    // Blocks the cells the walls of the house run through, except for the doors
+    void AddHouseWalls(const HouseInfo& house);
+    void SetBlocked(uint32_t x, uint32_t y, bool isBlocked);
+
+    [[nodiscard]] bool IsBlocked(int32_t x, int32_t y) const
+    {
+        return static_cast<uint32_t>(x) >= m_Width || static_cast<uint32_t>(y) >= m_Height || GetBit(GetRows(), y, x);
+    }
+    [[nodiscard]] bool IsEmpty() const { return m_Width == 0; }
+    [[nodiscard]] uint32_t GetWidth() const { return m_Width; }
+    [[nodiscard]] uint32_t GetHeight() const { return m_Height; }
+    [[nodiscard]] float GetCellSize() const { return m_CellSize; }
+
+    // The cell a point lies in, points outside the grid are clamped to its border
+    [[nodiscard]] uint32_t GetCell(const Elite::Vector2& point) const;
+    [[nodiscard]] Elite::Vector2 GetCellCenter(uint32_t cell) const;
+
+    [[nodiscard]] BitLines GetRows() const { return {m_RowBits.data(), m_WordsPerRow}; }
+    [[nodiscard]] BitLines GetColumns() const { return {m_ColumnBits.data(), m_WordsPerColumn}; }
+
+private:
+    [[nodiscard]] uint32_t GetColumn(float x) const;
+    [[nodiscard]] uint32_t GetRow(float y) const;
+    static bool GetBit(const BitLines& lines, int32_t line, int32_t pos)
+    {
+        const size_t bit = static_cast<size_t>(pos + LinePadding);
+        return (lines.pWords[static_cast<size_t>(line + 1) * lines.WordsPerLine + bit / 64] >> bit % 64 & 1) != 0;
+    }
+    static void ResetLines(std::vector<uint64_t>& bits, uint32_t& wordsPerLine, uint32_t numLines, uint32_t lineLength);
+
+    Elite::Vector2 m_MinCorner{};
+    float m_CellSize = 1.f;
+    float m_InvCellSize = 1.f;
+    uint32_t m_Width = 0;
+    uint32_t m_Height = 0;
+    // A set bit for a blocked cell, laid out as described at BitLines
+    std::vector<uint64_t> m_RowBits{};
+    std::vector<uint64_t> m_ColumnBits{};
+    uint32_t m_WordsPerRow = 0;
+    uint32_t m_WordsPerColumn = 0;
+};
+
+// Shortest paths over an OccupancyGrid, moving to the 8 neighbours of a cell but never diagonally past a blocked one.
+// Jump point search by default, plain A* for reference; both find paths of the same cost.
+// The search state of every cell lives in an array that is sized to the grid once and then reused: a cell's entry only
+// counts when it was written in the current query, so nothing has to be cleared, and the open list keeps its capacity.
+// Straight jumps scan the bit lines of the grid 64 cells at a time.
+class GridPathfinder final
+{
+public:
+    enum class Algorithm
+    {
+        AStar,
+        JumpPoint
+    };
+    static constexpr float NoPath = FLT_MAX;
+
+    void SetAlgorithm(Algorithm algorithm) { m_Algorithm = algorithm; }
+    [[nodiscard]] Algorithm GetAlgorithm() const { return m_Algorithm; }
+
+    // Length in world units of the shortest path from the cell of from to the cell of to, NoPath if there is none.
+    // The cells of from and to are walkable even when a wall runs through them
+    [[nodiscard]] float GetPathCost(const OccupancyGrid& grid, const Elite::Vector2& from, const Elite::Vector2& to);
+    // The same search, the cells the path goes through (every cell for A*, the jump points for JPS) into outPath
+    bool FindPath(const OccupancyGrid& grid, const Elite::Vector2& from, const Elite::Vector2& to,
+                  std::vector<Elite::Vector2>& outPath);
+    // Never more than GetPathCost: the length of the path between the cells if there were no walls
+    [[nodiscard]] static float GetCostLowerBound(const OccupancyGrid& grid, const Elite::Vector2& from, const Elite::Vector2& to);
+
+    // Statistics: cells taken off the open list by the last query
+    [[nodiscard]] size_t GetNumExpanded() const { return m_NumExpanded; }
+
+private:
+    static constexpr uint32_t NoCell = UINT32_MAX;
+    static constexpr int32_t NoPos = INT32_MIN;
+
+    struct OpenEntry
+    {
+        float Estimate;
+        float Cost;
+        uint32_t Cell;
+    };
+    // The best cost found so far and the cell it came from, together so a visit touches one cache line
+    struct CellState
+    {
+        float Cost;
+        uint32_t Parent;
+        // Only valid when it holds m_Generation
+        uint32_t Generation;
+    };
+    // A cell as a position along a row or column
+    struct LineCell
+    {
+        int32_t Line;
+        int32_t Pos;
+    };
+
+    // Cost in cells from start to goal, NoPath if there is none. Leaves the parents of the path behind
+    float Search(const OccupancyGrid& grid, uint32_t start, uint32_t goal);
+    void ExpandAStar(uint32_t cell, float cost);
+    void ExpandJumpPoint(uint32_t cell, float cost);
+    // The next jump point from (x, y) on in direction (dx, dy), NoCell if the way is blocked first
+    [[nodiscard]] uint32_t Jump(int32_t x, int32_t y, int32_t dx, int32_t dy) const;
+    // Jump along one line of lines from pos on in direction dir (1 or -1), the position of the jump point or NoPos
+    [[nodiscard]] static int32_t ScanLine(const OccupancyGrid::BitLines& lines, int32_t line, int32_t pos, int32_t dir,
+                                          const LineCell& start, const LineCell& goal);
+    void Relax(uint32_t cell, uint32_t parent, float cost);
+
+    [[nodiscard]] bool IsWalkable(int32_t x, int32_t y) const
+    {
+        return !m_pGrid->IsBlocked(x, y) || (x == m_StartX && y == m_StartY) || (x == m_GoalX && y == m_GoalY);
+    }
+    // The top of the heap has the lowest estimate, of two equal ones the path that got furthest
+    static bool HasLowerPriority(const OpenEntry& a, const OpenEntry& b);
+    [[nodiscard]] float GetHeuristic(uint32_t cell) const;
+
+    Algorithm m_Algorithm = Algorithm::JumpPoint;
+
+    // Only valid during a query
+    const OccupancyGrid* m_pGrid = nullptr;
+    uint32_t m_Start = NoCell;
+    uint32_t m_Goal = NoCell;
+    int32_t m_StartX = 0, m_StartY = 0;
+    int32_t m_GoalX = 0, m_GoalY = 0;
+
+    std::vector<CellState> m_Cells{};
+    uint32_t m_Generation = 0;
+    // Binary heap on the estimate, the cheapest on top
+    std::vector<OpenEntry> m_Open{};
+
+    size_t m_NumExpanded = 0;
+};
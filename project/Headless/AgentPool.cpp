@@ -0,0 +1,65 @@
+#include "../stdafx.h"
+#include "AgentPool.h"
+
+AgentPool::Slot::Slot(const HeadlessWorldParams& params): World{params}, Interface{&World}, Survivor{&Interface, params.Seed}
+{
+}
+
+AgentPool::AgentPool(int numAgents, const HeadlessWorldParams& params, Elite::BehaviorTreeBackend backend,
+                     int numThreads):
+    m_NumAgents(numAgents), m_NumAlive(numAgents), m_Jobs(numThreads)
+{
+    // One allocation for every slot, the slots can't be moved once constructed
+    m_pSlots = m_Allocator.allocate(m_NumAgents);
+    for (int i{}; i < m_NumAgents; ++i)
+    {
+        HeadlessWorldParams agentParams = params;
+        agentParams.Seed = params.Seed + static_cast<unsigned int>(i);
+        std::construct_at(m_pSlots + i, agentParams);
+        if (!m_pSlots[i].Survivor.GetBehaviorTree()->SetBackend(backend))
+            printf("WARNING: Agent %d can't run on the requested behavior tree backend\n", i);
+    }
+}
+
+AgentPool::~AgentPool()
+{
+    for (int i{m_NumAgents - 1}; i >= 0; --i) std::destroy_at(m_pSlots + i);
+    m_Allocator.deallocate(m_pSlots, m_NumAgents);
+}
+
+void AgentPool::Tick(float dt)
+{
+    // The agents of a chunk only touch their own slots, the pool totals are counted afterwards
+    m_Jobs.ParallelFor(m_NumAgents, AgentsPerChunk, [this, dt](int begin, int end) { TickRange(begin, end, dt); });
+    m_NumAgentFrames += static_cast<size_t>(m_NumAlive);
+    m_NumAlive = 0;
+    for (int i{}; i < m_NumAgents; ++i)
+    {
+        if (m_pSlots[i].IsAlive) ++m_NumAlive;
+    }
+}
+
+void AgentPool::TickRange(int begin, int end, float dt)
+{
+    // Same order as SurvivalAgentPlugin::UpdateSteering, but phase by phase over the range
+    // so every phase runs its code for all agents while it is hot in the caches
+    for (int i{begin}; i < end; ++i)
+    {
+        if (m_pSlots[i].IsAlive) m_pSlots[i].Survivor.CaptureFrameSnapshot();
+    }
+    for (int i{begin}; i < end; ++i)
+    {
+        if (m_pSlots[i].IsAlive) m_pSlots[i].Survivor.Update(dt);
+    }
+    for (int i{begin}; i < end; ++i)
+    {
+        if (m_pSlots[i].IsAlive) m_pSlots[i].Steering = m_pSlots[i].Survivor.GetSteeringOutput(dt);
+    }
+    for (int i{begin}; i < end; ++i)
+    {
+        Slot& slot = m_pSlots[i];
+        if (!slot.IsAlive) continue;
+        slot.World.Step(dt, slot.Steering);
+        if (slot.World.IsAgentDead() || slot.Interface.IsShutdownRequested()) slot.IsAlive = false;
+    }
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <memory>
+#include "HeadlessInterface.h"
+#include "HeadlessWorld.h"
+#include "JobSystem.h"
+#include "../Agent.h"
+
+// Runs many independent survival agents in one process, each against its own HeadlessWorld.
+// The agents, their worlds and interfaces live in one contiguous array of slots (an Agent keeps its
+// blackboard, snapshot and steering behaviors inline), and Tick runs each phase of the frame for
+// every agent before it moves on to the next phase.
+// With more than one thread the pool is cut into chunks of agents that a JobSystem spreads over the threads,
+// each chunk runs the phases for its own agents. Every agent draws from its own random stream, so a run
+// ends the same no matter how many threads ticked it, and agent i replays the single agent run of its seed.
+class AgentPool final
+{
+public:
+    // Agent i plays on a world seeded with params.Seed + i, its random stream uses the same seed
+    AgentPool(int numAgents, const HeadlessWorldParams& params,
+              Elite::BehaviorTreeBackend backend = Elite::BehaviorTreeBackend::Virtual, int numThreads = 1);
+    ~AgentPool();
+
+    AgentPool(const AgentPool&) = delete;
+    AgentPool& operator=(const AgentPool&) = delete;
+    AgentPool(AgentPool&&) = delete;
+    AgentPool& operator=(AgentPool&&) = delete;
+
+    // One frame for every agent that is still alive
+    void Tick(float dt);
+
+    [[nodiscard]] int GetNumAgents() const { return m_NumAgents; }
+    [[nodiscard]] int GetNumAlive() const { return m_NumAlive; }
+    [[nodiscard]] int GetNumThreads() const { return m_Jobs.GetNumThreads(); }
+    [[nodiscard]] const JobSystem& GetJobSystem() const { return m_Jobs; }
+    [[nodiscard]] bool IsAlive(int idx) const { return m_pSlots[idx].IsAlive; }
+    [[nodiscard]] const HeadlessWorld& GetWorld(int idx) const { return m_pSlots[idx].World; }
+    [[nodiscard]] Agent& GetAgent(int idx) { return m_pSlots[idx].Survivor; }
+    // Frames ticked summed over all agents, dead agents are not ticked
+    [[nodiscard]] size_t GetNumAgentFrames() const { return m_NumAgentFrames; }
+
+private:
+    // Small enough to leave chunks to steal, big enough that a chunk still runs its phases in batches
+    static constexpr int AgentsPerChunk = 8;
+
+    struct Slot
+    {
+        explicit Slot(const HeadlessWorldParams& params);
+
+        HeadlessWorld World;
+        HeadlessInterface Interface;
+        Agent Survivor;
+        SteeringPlugin_Output Steering{};
+        bool IsAlive = true;
+    };
+
+    // One frame for the agents in [begin, end)
+    void TickRange(int begin, int end, float dt);
+
+    std::allocator<Slot> m_Allocator{};
+    Slot* m_pSlots = nullptr;
+    int m_NumAgents = 0;
+    int m_NumAlive = 0;
+    size_t m_NumAgentFrames = 0;
+    JobSystem m_Jobs;
+};
@@ -0,0 +1,135 @@
+#include "../stdafx.h"
+#include "HeadlessInterface.h"
+#include "HeadlessWorld.h"
+
+#pragma region FrameworkSymbols
+// These are normally provided by GPP_PluginBase.lib, which only exists for Windows.
+// The headless host does not link it, so it supplies them itself.
+IBaseInterface::IBaseInterface() = default;
+IBaseInterface::~IBaseInterface() = default;
+
+void IBaseInterface::Draw_Polygon(const Elite::Vector2* points, int count, const Elite::Vector3& color)
+{ Draw_Polygon(points, count, color, NextDepthSlice()); }
+void IBaseInterface::Draw_SolidPolygon(const Elite::Vector2* points, int count, const Elite::Vector3& color)
+{ Draw_SolidPolygon(points, count, color, NextDepthSlice()); }
+void IBaseInterface::Draw_Circle(const Elite::Vector2& center, float radius, const Elite::Vector3& color)
+{ Draw_Circle(center, radius, color, NextDepthSlice()); }
+void IBaseInterface::Draw_SolidCircle(const Elite::Vector2& center, float32 radius, const Elite::Vector2& axis, const Elite::Vector3& color)
+{ Draw_SolidCircle(center, radius, axis, color, NextDepthSlice()); }
+void IBaseInterface::Draw_Segment(const Elite::Vector2& p1, const Elite::Vector2& p2, const Elite::Vector3& color)
+{ Draw_Segment(p1, p2, color, NextDepthSlice()); }
+void IBaseInterface::Draw_Transform(const b2Transform& xf)
+{ Draw_Transform(xf, NextDepthSlice()); }
+void IBaseInterface::Draw_Point(const Elite::Vector2& p, float size, const Elite::Vector3& color)
+{ Draw_Point(p, size, color, NextDepthSlice()); }
+
+IExamInterface::IExamInterface() = default;
+IExamInterface::~IExamInterface() = default;
+#pragma endregion
+
+HeadlessInterface::HeadlessInterface(HeadlessWorld *const pWorld): m_pWorld(pWorld)
+{
+}
+
+WorldInfo HeadlessInterface::World_GetInfo() const
+{
+    ++m_NumCalls;
+    return m_pWorld->GetWorldInfo();
+}
+
+StatisticsInfo HeadlessInterface::World_GetStats() const
+{
+    ++m_NumCalls;
+    return m_pWorld->GetStats();
+}
+
+std::vector<HouseInfo> HeadlessInterface::GetHousesInFOV() const
+{
+    ++m_NumCalls;
+    return m_pWorld->GetHousesInFOV();
+}
+
+std::vector<EnemyInfo> HeadlessInterface::GetEnemiesInFOV() const
+{
+    ++m_NumCalls;
+    return m_pWorld->GetEnemiesInFOV();
+}
+
+std::vector<PurgeZoneInfo> HeadlessInterface::GetPurgeZonesInFOV() const
+{
+    ++m_NumCalls;
+    return m_pWorld->GetPurgeZonesInFOV();
+}
+
+std::vector<ItemInfo> HeadlessInterface::GetItemsInFOV() const
+{
+    ++m_NumCalls;
+    return m_pWorld->GetItemsInFOV();
+}
+
+const FOVStats& HeadlessInterface::FOV_GetStats() const
+{
+    ++m_NumCalls;
+    return m_pWorld->GetFOVStats();
+}
+
+AgentInfo HeadlessInterface::Agent_GetInfo() const
+{
+    ++m_NumCalls;
+    return m_pWorld->GetAgentInfo();
+}
+
+Elite::Vector2 HeadlessInterface::NavMesh_GetClosestPathPoint(Elite::Vector2 goal) const
+{
+    ++m_NumCalls;
+    // Houses have no walls in the headless world, so the straight line is always walkable
+    return goal;
+}
+
+bool HeadlessInterface::Inventory_AddItem(UINT slotId, ItemInfo item)
+{
+    ++m_NumCalls;
+    return m_pWorld->Inventory_AddItem(slotId, item);
+}
+
+bool HeadlessInterface::Inventory_UseItem(UINT slotId)
+{
+    ++m_NumCalls;
+    return m_pWorld->Inventory_UseItem(slotId);
+}
+
+bool HeadlessInterface::Inventory_RemoveItem(UINT slotId)
+{
+    ++m_NumCalls;
+    return m_pWorld->Inventory_RemoveItem(slotId);
+}
+
+bool HeadlessInterface::Inventory_GetItem(UINT slotId, ItemInfo &item)
+{
+    ++m_NumCalls;
+    return m_pWorld->Inventory_GetItem(slotId, item);
+}
+
+UINT HeadlessInterface::Inventory_GetCapacity() const
+{
+    ++m_NumCalls;
+    return HeadlessWorld::InventoryCapacity;
+}
+
+bool HeadlessInterface::GrabNearestItem(ItemInfo &item)
+{
+    ++m_NumCalls;
+    return m_pWorld->GrabNearestItem(item);
+}
+
+bool HeadlessInterface::GrabItem(const ItemInfo &item)
+{
+    ++m_NumCalls;
+    return m_pWorld->GrabItem(item);
+}
+
+bool HeadlessInterface::DestroyItem(const ItemInfo &item)
+{
+    ++m_NumCalls;
+    return m_pWorld->DestroyItem(item);
+}
@@ -0,0 +1,83 @@
+#pragma once
+#include "IExamInterface.h"
+
+class HeadlessWorld;
+
+// In-process implementation of IExamInterface on top of a HeadlessWorld.
+// Rendering and input are no-ops, everything else is forwarded to the world.
+class HeadlessInterface final : public IExamInterface
+{
+public:
+    explicit HeadlessInterface(HeadlessWorld* pWorld);
+
+    //WORLD & ENTITIES
+    WorldInfo World_GetInfo() const override;
+    StatisticsInfo World_GetStats() const override;
+
+    std::vector<HouseInfo> GetHousesInFOV() const override;
+    std::vector<EnemyInfo> GetEnemiesInFOV() const override;
+    std::vector<PurgeZoneInfo> GetPurgeZonesInFOV() const override;
+    std::vector<ItemInfo> GetItemsInFOV() const override;
+
+    const FOVStats& FOV_GetStats() const override;
+
+    AgentInfo Agent_GetInfo() const override;
+
+    //NAVMESH
+    Elite::Vector2 NavMesh_GetClosestPathPoint(Elite::Vector2 goal) const override;
+
+    //INVENTORY
+    bool Inventory_AddItem(UINT slotId, ItemInfo item) override;
+    bool Inventory_UseItem(UINT slotId) override;
+    bool Inventory_RemoveItem(UINT slotId) override;
+    bool Inventory_GetItem(UINT slotId, ItemInfo& item) override;
+    UINT Inventory_GetCapacity() const override;
+
+    //ITEMS
+    bool GrabNearestItem(ItemInfo& item) override;
+    bool GrabItem(const ItemInfo& item) override;
+    bool DestroyItem(const ItemInfo& item) override;
+
+    //DEBUG
+    Elite::Vector2 Debug_ConvertScreenToWorld(Elite::Vector2 screenPos) const override { return screenPos; }
+    Elite::Vector2 Debug_ConvertWorldToScreen(Elite::Vector2 worldPos) const override { return worldPos; }
+
+    //INPUT
+    bool Input_IsKeyboardKeyDown(Elite::InputScancode key) const override { return false; }
+    bool Input_IsKeyboardKeyUp(Elite::InputScancode key) const override { return false; }
+    bool Input_IsMouseButtonDown(Elite::InputMouseButton button) const override { return false; }
+    bool Input_IsMouseButtonUp(Elite::InputMouseButton button) const override { return false; }
+    Elite::MouseData Input_GetMouseData(Elite::InputType type, Elite::InputMouseButton button) const override { return {}; }
+
+    //EVENT
+    void RequestShutdown() const override { m_ShutdownRequested = true; }
+    [[nodiscard]] bool IsShutdownRequested() const { return m_ShutdownRequested; }
+
+    // Number of world queries and actions forwarded so far (draw and input calls are not counted)
+    [[nodiscard]] size_t GetNumCalls() const { return m_NumCalls; }
+
+    //RENDERER
+    void Draw_Polygon(const Elite::Vector2* points, int count, const Elite::Vector3& color, float depth) override {}
+    void Draw_SolidPolygon(const Elite::Vector2* points, int count, const Elite::Vector3& color, float depth, bool triangulate) override {}
+    void Draw_Circle(const Elite::Vector2& center, float radius, const Elite::Vector3& color, float depth) override {}
+    void Draw_SolidCircle(const Elite::Vector2& center, float32 radius, const Elite::Vector2& axis, const Elite::Vector3& color, float depth) override {}
+    void Draw_Segment(const Elite::Vector2& p1, const Elite::Vector2& p2, const Elite::Vector3& color, float depth) override {}
+    void Draw_Direction(const Elite::Vector2& p, Elite::Vector2 dir, float length, const Elite::Vector3& color, float depth) override {}
+    void Draw_Transform(const b2Transform& xf, float depth) override {}
+    void Draw_Point(const Elite::Vector2& p, float size, const Elite::Vector3& color, float depth) override {}
+    float NextDepthSlice() override { return 0.f; }
+
+    // Bring the non-virtual convenience overloads of IBaseInterface back into scope
+    using IBaseInterface::Draw_Polygon;
+    using IBaseInterface::Draw_SolidPolygon;
+    using IBaseInterface::Draw_Circle;
+    using IBaseInterface::Draw_SolidCircle;
+    using IBaseInterface::Draw_Segment;
+    using IBaseInterface::Draw_Transform;
+    using IBaseInterface::Draw_Point;
+
+private:
+    HeadlessWorld* m_pWorld = nullptr;
+    mutable bool m_ShutdownRequested = false;
+    mutable size_t m_NumCalls = 0;
+};
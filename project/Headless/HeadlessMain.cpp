@@ -0,0 +1,357 @@
+#include "../stdafx.h"
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include "AgentPool.h"
+#include "HeadlessInterface.h"
+#include "HeadlessWorld.h"
+#include "ReplayInterface.h"
+#include "../Agent.h"
+#include "../DecisionMaking/BehaviorTree.h"
+#include "../DecisionMaking/FlatBehaviorTree.h"
+#include "../Profiler.h"
+#include "../SurvivalAgentPlugin.h"
+#include "../Trajectory/RunLogWriter.h"
+#include "../Trajectory/TrajectoryReader.h"
+#include "../Trajectory/TrajectoryRecorder.h"
+
+// Headless host: runs SurvivalAgentPlugin against a HeadlessWorld at a fixed dt as fast as possible
+// and reports throughput, per-frame latency and survival stats.
+// Usage: Exam_Headless [--frames N] [--dt seconds] [--seed N] [--enemies N] [--godmode] [--flat-bt | --event-bt]
+//                      [--agents N [--threads N]] [--profile path] [--bt-stats path.csv] [--record path]
+//                      [--run-log path] [--no-path-cache] [--path-cost-targets]
+//        Exam_Headless --replay path [--flat-bt | --event-bt] [--profile path] [--run-log path] [--no-path-cache]
+//                      [--path-cost-targets]
+// With --agents the agents run in an AgentPool, each on its own world seeded from --seed on,
+// --threads spreads their ticks over that many threads.
+// --bt-stats writes the per node counters and latency histograms of the behavior tree (single agent, virtual backend).
+// --profile writes path.json (Chrome trace) and path.txt (per scope percentiles), the build needs EXAM_ENABLE_PROFILER.
+// --record writes the trajectory of the run (single agent), --replay plays one back through the plugin without a world
+// and stops at the first frame where the agent decides differently than it did in the recording.
+// --run-log writes the columnar log of a single agent run or of a replay (RunLogFormat.h), for offline analysis.
+// --no-path-cache asks the interface for every navmesh path point (single agent), a replay needs the same setting
+// as its recording because the cache decides which calls are made.
+// --path-cost-targets ranks the search targets by path cost around the found houses instead of by distance
+// (single agent), a replay needs the same setting as its recording.
+
+namespace
+{
+    struct HostParams
+    {
+        int MaxFrames = 60 * 60 * 10;
+        float Dt = 1.f / 60.f;
+        HeadlessWorldParams World{};
+        Elite::BehaviorTreeBackend Backend = Elite::BehaviorTreeBackend::Virtual;
+        // 0 runs the plugin itself, like the exam framework does
+        int NumAgents = 0;
+        int NumThreads = 1;
+        std::string ProfilePath{};
+        std::string BTStatsPath{};
+        std::string RecordPath{};
+        std::string ReplayPath{};
+        std::string RunLogPath{};
+        bool UsePathCache = true;
+        bool UsePathCostTargets = false;
+    };
+
+    HostParams ParseArgs(int argc, char* argv[])
+    {
+        HostParams params{};
+        for (int i{1}; i < argc; ++i)
+        {
+            const bool hasValue = i + 1 < argc;
+            if (!strcmp(argv[i], "--frames") && hasValue) params.MaxFrames = atoi(argv[++i]);
+            else if (!strcmp(argv[i], "--dt") && hasValue) params.Dt = static_cast<float>(atof(argv[++i]));
+            else if (!strcmp(argv[i], "--seed") && hasValue) params.World.Seed = static_cast<unsigned int>(atoi(argv[++i]));
+            else if (!strcmp(argv[i], "--enemies") && hasValue) params.World.EnemyCount = atoi(argv[++i]);
+            else if (!strcmp(argv[i], "--godmode")) params.World.GodMode = true;
+            else if (!strcmp(argv[i], "--flat-bt")) params.Backend = Elite::BehaviorTreeBackend::Flat;
+            else if (!strcmp(argv[i], "--event-bt")) params.Backend = Elite::BehaviorTreeBackend::EventDriven;
+            else if (!strcmp(argv[i], "--agents") && hasValue) params.NumAgents = atoi(argv[++i]);
+            else if (!strcmp(argv[i], "--threads") && hasValue) params.NumThreads = atoi(argv[++i]);
+            else if (!strcmp(argv[i], "--profile") && hasValue) params.ProfilePath = argv[++i];
+            else if (!strcmp(argv[i], "--bt-stats") && hasValue) params.BTStatsPath = argv[++i];
+            else if (!strcmp(argv[i], "--record") && hasValue) params.RecordPath = argv[++i];
+            else if (!strcmp(argv[i], "--replay") && hasValue) params.ReplayPath = argv[++i];
+            else if (!strcmp(argv[i], "--run-log") && hasValue) params.RunLogPath = argv[++i];
+            else if (!strcmp(argv[i], "--no-path-cache")) params.UsePathCache = false;
+            else if (!strcmp(argv[i], "--path-cost-targets")) params.UsePathCostTargets = true;
+            else printf("WARNING: Unknown argument '%s' ignored\n", argv[i]);
+        }
+        return params;
+    }
+
+    const char* GetBackendName(Elite::BehaviorTreeBackend backend)
+    {
+        switch (backend)
+        {
+            case Elite::BehaviorTreeBackend::Flat: return "flat";
+            case Elite::BehaviorTreeBackend::EventDriven: return "event-driven";
+            default: return "virtual";
+        }
+    }
+
+    double Percentile(const std::vector<double>& sorted, double p)
+    {
+        if (sorted.empty()) return 0.0;
+        const size_t idx = static_cast<size_t>(p * static_cast<double>(sorted.size() - 1) + 0.5);
+        return sorted[idx];
+    }
+
+    void WriteProfile(const HostParams& params)
+    {
+        if (params.ProfilePath.empty()) return;
+        if (!Profiler::IsCompiledIn())
+        {
+            printf("WARNING: --profile needs a build with EXAM_ENABLE_PROFILER, nothing was recorded\n");
+            return;
+        }
+        const std::string tracePath = params.ProfilePath + ".json";
+        const std::string summaryPath = params.ProfilePath + ".txt";
+        if (Profiler::WriteChromeTrace(tracePath) && Profiler::WriteSummary(summaryPath))
+            printf("Profile:             %zu events in %s and %s\n", Profiler::GetNumEvents(), tracePath.c_str(), summaryPath.c_str());
+        else
+            printf("WARNING: Could not write the profile to %s\n", params.ProfilePath.c_str());
+    }
+
+    // The frame's AgentInfo and the action the behavior tree ended on
+    void AddRunLogFrame(RunLogWriter& runLog, const AgentInfo& agentInfo, const Elite::BehaviorTree& behaviorTree)
+    {
+        const auto pAction = reinterpret_cast<const void*>(behaviorTree.GetLastAction());
+        runLog.AddFrame(agentInfo, runLog.GetActionId(pAction, behaviorTree.GetFunctionName(pAction)));
+    }
+
+    void WriteRunLog(const HostParams& params, const RunLogWriter& runLog)
+    {
+        if (params.RunLogPath.empty()) return;
+        if (runLog.Write(params.RunLogPath))
+            printf("Run log:             %zu frames in %s\n", runLog.GetNumFrames(), params.RunLogPath.c_str());
+        else
+            printf("WARNING: Could not write the run log to %s\n", params.RunLogPath.c_str());
+    }
+
+    int RunReplay(const HostParams& params)
+    {
+        TrajectoryReader reader{};
+        if (!reader.Open(params.ReplayPath))
+        {
+            printf("ERROR: %s is not a trajectory this build can read\n", params.ReplayPath.c_str());
+            return 1;
+        }
+        ReplayInterface replayInterface{&reader};
+
+        SurvivalAgentPlugin plugin{};
+        plugin.SetSeed(reader.GetSeed());
+        PluginInfo info{};
+        plugin.DllInit();
+        plugin.Initialize(&replayInterface, info);
+        if (!plugin.GetAgent()->GetBehaviorTree()->SetBackend(params.Backend))
+            printf("WARNING: The behavior tree can't run on the %s backend, using the virtual one\n",
+                   GetBackendName(params.Backend));
+        plugin.GetAgent()->GetPathCache().SetEnabled(params.UsePathCache);
+        plugin.GetAgent()->SetPathCostRanking(params.UsePathCostTargets);
+
+        const Elite::BehaviorTree& behaviorTree = *plugin.GetAgent()->GetBehaviorTree();
+        const bool isLogging = !params.RunLogPath.empty();
+        RunLogWriter runLog{};
+
+        // Nothing but the agent runs in this loop, the frames are decoded as they are needed
+        using Clock = std::chrono::steady_clock;
+        const auto runStart = Clock::now();
+        int frame{};
+        for (; replayInterface.BeginFrame(); ++frame)
+        {
+            const SteeringPlugin_Output steering = plugin.UpdateSteering(replayInterface.GetFrame()->Dt);
+            if (isLogging) AddRunLogFrame(runLog, replayInterface.GetFrame()->Agent, behaviorTree);
+            if (!replayInterface.EndFrame(steering)) break;
+        }
+        const double runSeconds = std::chrono::duration<double>(Clock::now() - runStart).count();
+        plugin.DllShutdown();
+
+        printf("=== Replay (%s, seed %d) ===\n", params.ReplayPath.c_str(), reader.GetSeed());
+        printf("Frames:              %d replayed\n", frame);
+        printf("Behavior tree:       %s backend\n", GetBackendName(params.Backend));
+        printf("Wall time:           %.3f s\n", runSeconds);
+        printf("Frames per second:   %.0f\n", runSeconds > 0.0 ? frame / runSeconds : 0.0);
+        printf("Trajectory:          %zu bytes read, %.1f bytes / frame\n", reader.GetNumBytes(),
+               reader.GetNumFrames() > 0 ? static_cast<double>(reader.GetNumBytes()) / reader.GetNumFrames() : 0.0);
+        if (reader.IsTruncated()) printf("WARNING: The trajectory ends in a partial frame, it was replayed up to the last complete one\n");
+        if (replayInterface.HasDiverged())
+            printf("Result:              DIVERGED at %s\n", replayInterface.GetDivergence().c_str());
+        else
+            printf("Result:              every frame matches the recording\n");
+        WriteRunLog(params, runLog);
+        WriteProfile(params);
+        return replayInterface.HasDiverged() ? 1 : 0;
+    }
+
+    int RunPool(const HostParams& params)
+    {
+        using Clock = std::chrono::steady_clock;
+        AgentPool pool{params.NumAgents, params.World, params.Backend, params.NumThreads};
+        const auto runStart = Clock::now();
+        int frame{};
+        for (; frame < params.MaxFrames && pool.GetNumAlive() > 0; ++frame) pool.Tick(params.Dt);
+        const double runSeconds = std::chrono::duration<double>(Clock::now() - runStart).count();
+
+        double totalSurvived{};
+        int totalScore{};
+        int minScore{INT_MAX};
+        int maxScore{INT_MIN};
+        for (int i{}; i < pool.GetNumAgents(); ++i)
+        {
+            const StatisticsInfo& stats = pool.GetWorld(i).GetStats();
+            totalSurvived += stats.TimeSurvived;
+            totalScore += stats.Score;
+            minScore = std::min(minScore, stats.Score);
+            maxScore = std::max(maxScore, stats.Score);
+        }
+        const double numAgents = static_cast<double>(pool.GetNumAgents());
+
+        printf("=== Headless pool run (%d agents, seeds %u-%u) ===\n", pool.GetNumAgents(), params.World.Seed,
+               params.World.Seed + static_cast<unsigned int>(pool.GetNumAgents()) - 1);
+        printf("Frames:              %d (dt %.4f s)\n", frame, params.Dt);
+        printf("Behavior tree:       %s backend\n", GetBackendName(params.Backend));
+        printf("Threads:             %d (%llu chunks stolen)\n", pool.GetNumThreads(),
+               static_cast<unsigned long long>(pool.GetJobSystem().GetNumSteals()));
+        printf("Wall time:           %.3f s\n", runSeconds);
+        printf("Agent frames / s:    %.0f (%zu agent frames)\n",
+               static_cast<double>(pool.GetNumAgentFrames()) / runSeconds, pool.GetNumAgentFrames());
+        printf("Alive:               %d / %d\n", pool.GetNumAlive(), pool.GetNumAgents());
+        printf("Survived:            %.1f s on average\n", totalSurvived / numAgents);
+        printf("Score:               %.1f on average (min %d, max %d)\n", totalScore / numAgents, minScore, maxScore);
+        WriteProfile(params);
+        return 0;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const HostParams params = ParseArgs(argc, argv);
+    // Room for about a minute of single agent frames per thread before the oldest events get overwritten
+    if (!params.ProfilePath.empty()) Profiler::SetBufferCapacity(size_t{1} << 20);
+    if (!params.ReplayPath.empty()) return RunReplay(params);
+    if (params.NumAgents > 0)
+    {
+        if (!params.RecordPath.empty()) printf("WARNING: --record only records single agent runs, the pool is not recorded\n");
+        return RunPool(params);
+    }
+
+    HeadlessWorld world{params.World};
+    HeadlessInterface examInterface{&world};
+
+    SurvivalAgentPlugin plugin{};
+    plugin.SetSeed(static_cast<int>(params.World.Seed));
+    plugin.SetTrajectoryPath(params.RecordPath);
+    PluginInfo info{};
+    plugin.DllInit();
+    plugin.Initialize(&examInterface, info);
+    if (!plugin.GetAgent()->GetBehaviorTree()->SetBackend(params.Backend))
+        printf("WARNING: The behavior tree can't run on the %s backend, using the virtual one\n",
+               GetBackendName(params.Backend));
+    plugin.GetAgent()->GetPathCache().SetEnabled(params.UsePathCache);
+    plugin.GetAgent()->SetPathCostRanking(params.UsePathCostTargets);
+    Elite::BehaviorTree* const pBehaviorTree = plugin.GetAgent()->GetBehaviorTree();
+    if (!params.BTStatsPath.empty())
+    {
+        if (pBehaviorTree->GetBackend() != Elite::BehaviorTreeBackend::Virtual)
+            printf("WARNING: --bt-stats only measures the virtual backend, the %s one runs without node stats\n",
+                   GetBackendName(pBehaviorTree->GetBackend()));
+        pBehaviorTree->SetNodeStatsEnabled(true);
+    }
+
+    std::vector<double> frameTimesUs{};
+    frameTimesUs.reserve(params.MaxFrames);
+    const bool isLogging = !params.RunLogPath.empty();
+    RunLogWriter runLog{};
+    if (isLogging) runLog.Reserve(params.MaxFrames);
+
+    using Clock = std::chrono::steady_clock;
+    const auto runStart = Clock::now();
+    int frame{};
+    for (; frame < params.MaxFrames && !world.IsAgentDead() && !examInterface.IsShutdownRequested(); ++frame)
+    {
+        // What the agent sees this frame, before its own item use changes it
+        const AgentInfo observed = isLogging ? world.GetAgentInfo() : AgentInfo{};
+        const auto frameStart = Clock::now();
+        const SteeringPlugin_Output steering = plugin.UpdateSteering(params.Dt);
+        frameTimesUs.push_back(std::chrono::duration<double, std::micro>(Clock::now() - frameStart).count());
+        if (isLogging) AddRunLogFrame(runLog, observed, *pBehaviorTree);
+
+        world.Step(params.Dt, steering);
+    }
+    const double runSeconds = std::chrono::duration<double>(Clock::now() - runStart).count();
+
+    // Every snapshot read stood for an interface call before the snapshot existed,
+    // capturing it costs the calls it makes itself. The reads are only counted in profiler builds
+    const FrameSnapshot& snapshot = plugin.GetAgent()->GetFrameSnapshot();
+    const double perFrame = frame > 0 ? 1.0 / frame : 0.0;
+    const double callsPerFrame = static_cast<double>(examInterface.GetNumCalls()) * perFrame;
+    const double savedPerFrame = (static_cast<double>(snapshot.GetNumReads()) -
+                                  static_cast<double>(snapshot.GetNumInterfaceCalls())) * perFrame;
+    const FrameQueries& queries = plugin.GetAgent()->GetFrameQueries();
+    const double queryCallsPerFrame = static_cast<double>(queries.GetNumCalls()) * perFrame;
+    const double queryComputationsPerFrame = static_cast<double>(queries.GetNumComputations()) * perFrame;
+    const PathPointCache& pathCache = plugin.GetAgent()->GetPathCache();
+    const double pathHitsPerFrame = static_cast<double>(pathCache.GetNumHits()) * perFrame;
+    const double pathMissesPerFrame = static_cast<double>(pathCache.GetNumMisses()) * perFrame;
+    const size_t numPathEvictions = pathCache.GetNumEvictions();
+    // After the count, verifying costs interface calls of its own
+    const bool isInventoryInSync = plugin.GetAgent()->GetInventory().Verify();
+    const bool wroteBTStats = !params.BTStatsPath.empty() && pBehaviorTree->WriteNodeStatsCsv(params.BTStatsPath);
+    const Elite::FlatBehaviorTree* pFlatTree = pBehaviorTree->GetFlatTree();
+    const bool hasFlatTree = pFlatTree != nullptr;
+    const double conditionCallsPerFrame = pFlatTree ? static_cast<double>(pFlatTree->GetNumConditionCalls()) * perFrame : 0.0;
+    const double cachedConditionsPerFrame = pFlatTree ? static_cast<double>(pFlatTree->GetNumCachedConditions()) * perFrame : 0.0;
+    const TrajectoryRecorder* pRecorder = plugin.GetTrajectoryRecorder();
+    const size_t numRecordedFrames = pRecorder ? pRecorder->GetNumFrames() : 0;
+    const size_t numRecordedBytes = pRecorder ? pRecorder->GetNumBytes() : 0;
+    plugin.DllShutdown();
+
+    std::vector<double> sorted = frameTimesUs;
+    std::ranges::sort(sorted);
+    double totalUs = 0.0;
+    for (const double t: frameTimesUs) totalUs += t;
+
+    const StatisticsInfo& stats = world.GetStats();
+    printf("=== Headless run (%s, seed %u) ===\n", info.BotName.c_str(), params.World.Seed);
+    printf("Frames:              %d (dt %.4f s)\n", frame, params.Dt);
+    printf("Behavior tree:       %s backend\n", GetBackendName(params.Backend));
+    if (hasFlatTree)
+        printf("BT conditions:       %.1f / frame run, %.1f / frame from cache\n",
+               conditionCallsPerFrame, cachedConditionsPerFrame);
+    printf("Wall time:           %.3f s\n", runSeconds);
+    printf("Frames per second:   %.0f\n", frame / runSeconds);
+    printf("UpdateSteering FPS:  %.0f\n", totalUs > 0.0 ? frame / (totalUs * 1e-6) : 0.0);
+    printf("Frame latency (us):  p50 %.2f | p90 %.2f | p99 %.2f | max %.2f\n",
+           Percentile(sorted, 0.5), Percentile(sorted, 0.9), Percentile(sorted, 0.99),
+           sorted.empty() ? 0.0 : sorted.back());
+    if (Profiler::IsCompiledIn())
+        printf("Interface calls:     %.1f / frame (%.1f / frame saved by the frame snapshot)\n",
+               callsPerFrame, savedPerFrame);
+    else printf("Interface calls:     %.1f / frame (snapshot reads are only counted with EXAM_ENABLE_PROFILER)\n",
+                callsPerFrame);
+    printf("Frame queries:       %.2f / frame asked, %.2f / frame computed\n",
+           queryCallsPerFrame, queryComputationsPerFrame);
+    printf("Path cache:          %.2f / frame hits, %.2f / frame misses asked the navmesh (%s, %zu evictions)\n",
+           pathHitsPerFrame, pathMissesPerFrame, params.UsePathCache ? "on" : "off", numPathEvictions);
+    printf("Inventory mirror:    %s\n", isInventoryInSync ? "matches the world" : "DIFFERS from the world");
+    printf("Survived:            %.1f s (stage %d)%s%s\n", stats.TimeSurvived, world.GetStage() + 1,
+           world.IsAgentDead() ? ", died by " : "", world.GetCauseOfDeath().c_str());
+    printf("Score:               %d\n", stats.Score);
+    printf("Enemies killed/hit:  %d / %d\n", stats.NumEnemiesKilled, stats.NumEnemiesHit);
+    printf("Missed shots:        %d\n", stats.NumMissedShots);
+    printf("Items picked up:     %d\n", stats.NumItemsPickUp);
+    if (!params.RecordPath.empty() && pRecorder)
+        printf("Trajectory:          %zu frames, %zu bytes (%.1f bytes / frame) in %s\n", numRecordedFrames,
+               numRecordedBytes, numRecordedFrames > 0 ? static_cast<double>(numRecordedBytes) / numRecordedFrames : 0.0,
+               params.RecordPath.c_str());
+    if (!params.BTStatsPath.empty())
+    {
+        if (wroteBTStats) printf("BT node stats:       %s\n", params.BTStatsPath.c_str());
+        else printf("WARNING: Could not write the behavior tree node stats to %s\n", params.BTStatsPath.c_str());
+    }
+    WriteRunLog(params, runLog);
+    WriteProfile(params);
+    return 0;
+}
@@ -0,0 +1,555 @@
+#include "../stdafx.h"
+#include "HeadlessWorld.h"
+
+namespace
+{
+    constexpr float MaxStat = 10.f;
+    constexpr float EnergyDrainPerSec = 0.1f;
+    constexpr float StaminaDrainPerSec = 2.f;
+    constexpr float StaminaRegenPerSec = 1.f;
+    constexpr float RunSpeedMultiplier = 2.f;
+    constexpr float WasBittenDuration = 0.5f;
+    constexpr float BiteCooldown = 1.f;
+    constexpr float EnemyDetectRange = 20.f;
+    constexpr float PistolRange = 50.f;
+    constexpr float ShotgunRange = 25.f;
+    constexpr float ShotgunHalfAngle = Elite::ToRadians(20.f);
+    constexpr float PurgeZoneDelay = 5.f;
+
+    Elite::Vector2 ClosestPointOnHouse(const Elite::Vector2& point, const HouseInfo& house)
+    {
+        const Elite::Vector2 halfSize = house.Size * 0.5f;
+        return {
+            Elite::Clamp(point.x, house.Center.x - halfSize.x, house.Center.x + halfSize.x),
+            Elite::Clamp(point.y, house.Center.y - halfSize.y, house.Center.y + halfSize.y)
+        };
+    }
+
+    bool IsPointInHouse(const Elite::Vector2& point, const HouseInfo& house)
+    {
+        return ClosestPointOnHouse(point, house) == point;
+    }
+
+    bool DoHousesOverlap(const HouseInfo& a, const HouseInfo& b, float margin)
+    {
+        return abs(a.Center.x - b.Center.x) * 2.f < a.Size.x + b.Size.x + margin * 2.f &&
+               abs(a.Center.y - b.Center.y) * 2.f < a.Size.y + b.Size.y + margin * 2.f;
+    }
+
+    template<typename T>
+    void SortByDistance(std::vector<T>& vec, const Elite::Vector2& from, Elite::Vector2 T::* location)
+    {
+        std::ranges::sort(vec, [&from, location](const T& a, const T& b)
+        {
+            return (a.*location).DistanceSquared(from) < (b.*location).DistanceSquared(from);
+        });
+    }
+}
+
+HeadlessWorld::HeadlessWorld(const HeadlessWorldParams &params): m_Params(params), m_Rng(params.Seed)
+{
+    m_WorldInfo.Center = {0.f, 0.f};
+    m_WorldInfo.Dimensions = params.WorldDimensions;
+
+    m_Agent = {};
+    m_Agent.Stamina = MaxStat;
+    m_Agent.Health = MaxStat;
+    m_Agent.Energy = MaxStat;
+    m_Agent.FOV_Angle = Elite::ToRadians(90.f);
+    m_Agent.FOV_Range = 20.f;
+    m_Agent.MaxLinearSpeed = 5.f;
+    m_Agent.MaxAngularSpeed = static_cast<float>(E_PI);
+    m_Agent.GrabRange = 3.f;
+    m_Agent.AgentSize = 1.5f;
+
+    m_Stats = {};
+    GenerateLevel();
+    UpdateFOV();
+}
+
+void HeadlessWorld::GenerateLevel()
+{
+    std::uniform_real_distribution<float> houseSize(15.f, 30.f);
+    std::uniform_real_distribution<float> villageSpread(-40.f, 40.f);
+
+    for (int v{}; v < m_Params.NumVillages; ++v)
+    {
+        const Elite::Vector2 villageCenter = RandomPointInWorld(60.f);
+        for (int h{}; h < m_Params.HousesPerVillage; ++h)
+        {
+            // Try a couple of times to find a spot that does not overlap an existing house
+            for (int attempt{}; attempt < 10; ++attempt)
+            {
+                HouseInfo house{};
+                house.Center = villageCenter + Elite::Vector2(villageSpread(m_Rng), villageSpread(m_Rng));
+                house.Size = {houseSize(m_Rng), houseSize(m_Rng)};
+                const bool overlaps = std::ranges::any_of(m_Houses, [&house](const HouseInfo& other)
+                {
+                    return DoHousesOverlap(house, other, 4.f);
+                });
+                if (overlaps) continue;
+
+                m_Houses.push_back(house);
+                for (int i{}; i < m_Params.ItemsPerHouse; ++i)
+                {
+                    std::uniform_real_distribution<float> offsetX(-house.Size.x * 0.5f + 2.f, house.Size.x * 0.5f - 2.f);
+                    std::uniform_real_distribution<float> offsetY(-house.Size.y * 0.5f + 2.f, house.Size.y * 0.5f - 2.f);
+                    m_Items.push_back(MakeRandomItem(house.Center + Elite::Vector2(offsetX(m_Rng), offsetY(m_Rng))));
+                }
+                break;
+            }
+        }
+    }
+
+    for (int i{}; i < m_Params.EnemyCount; ++i)
+    {
+        SpawnEnemy(true);
+    }
+}
+
+void HeadlessWorld::SpawnEnemy(bool awayFromAgent)
+{
+    Enemy enemy{};
+    enemy.Info.EnemyHash = m_NextHash++;
+    do
+    {
+        enemy.Info.Location = RandomPointInWorld();
+    }
+    while (awayFromAgent && enemy.Info.Location.DistanceSquared(m_Agent.Position) < 40.f * 40.f);
+    enemy.WanderTarget = enemy.Info.Location;
+
+    // Stronger zombies get more likely in later stages
+    std::uniform_int_distribution<int> typeRoll(0, 9 + m_Stage);
+    const int roll = typeRoll(m_Rng);
+    if (roll >= 10)
+    {
+        enemy.Info.Type = eEnemyType::ZOMBIE_HEAVY;
+        enemy.Info.Size = 1.5f;
+        enemy.Info.Health = 5.f;
+        enemy.Damage = 2.f;
+        enemy.Speed = 2.f;
+    }
+    else if (roll >= 7)
+    {
+        enemy.Info.Type = eEnemyType::ZOMBIE_RUNNER;
+        enemy.Info.Size = 0.8f;
+        enemy.Info.Health = 1.f;
+        enemy.Damage = 1.f;
+        enemy.Speed = 6.f;
+    }
+    else
+    {
+        enemy.Info.Type = eEnemyType::ZOMBIE_NORMAL;
+        enemy.Info.Size = 1.f;
+        enemy.Info.Health = 2.f;
+        enemy.Damage = 1.f;
+        enemy.Speed = 3.f;
+    }
+    m_Enemies.push_back(enemy);
+}
+
+ItemInfo HeadlessWorld::MakeRandomItem(const Elite::Vector2 &location)
+{
+    ItemInfo item{};
+    item.Location = location;
+    item.ItemHash = m_NextHash++;
+
+    std::uniform_int_distribution<int> typeRoll(0, static_cast<int>(eItemType::_LAST));
+    item.Type = static_cast<eItemType>(typeRoll(m_Rng));
+    switch (item.Type)
+    {
+        case eItemType::PISTOL:
+            item.Value = std::uniform_int_distribution<int>(10, 20)(m_Rng);
+            break;
+        case eItemType::SHOTGUN:
+            item.Value = std::uniform_int_distribution<int>(4, 8)(m_Rng);
+            break;
+        case eItemType::MEDKIT:
+            item.Value = std::uniform_int_distribution<int>(2, 5)(m_Rng);
+            break;
+        case eItemType::FOOD:
+            item.Value = std::uniform_int_distribution<int>(3, 7)(m_Rng);
+            break;
+        default:
+            item.Value = 0;
+            break;
+    }
+    return item;
+}
+
+void HeadlessWorld::Step(float dt, const SteeringPlugin_Output &steering)
+{
+    if (m_Agent.Death) return;
+
+    UpdateAgent(dt, steering);
+    UpdateEnemies(dt);
+    UpdatePurgeZones(dt);
+    UpdateStage();
+
+    m_Stats.TimeSurvived += dt;
+    m_ScoreTimer += dt;
+    while (m_ScoreTimer >= 1.f)
+    {
+        ++m_Stats.Score;
+        m_ScoreTimer -= 1.f;
+    }
+
+    m_Agent.Energy -= EnergyDrainPerSec * dt;
+    if (m_Agent.Energy <= 0.f) Kill("starvation");
+    if (m_Agent.Health <= 0.f) Kill("zombie");
+
+    UpdateFOV();
+}
+
+void HeadlessWorld::UpdateAgent(float dt, const SteeringPlugin_Output &steering)
+{
+    const bool isMoving = steering.LinearVelocity.MagnitudeSquared() > 0.0001f;
+    m_Agent.RunMode = steering.RunMode && m_Agent.Stamina > 0.f;
+    if (m_Agent.RunMode && isMoving) m_Agent.Stamina = std::max(0.f, m_Agent.Stamina - StaminaDrainPerSec * dt);
+    else m_Agent.Stamina = std::min(MaxStat, m_Agent.Stamina + StaminaRegenPerSec * dt);
+
+    const float maxSpeed = m_Agent.MaxLinearSpeed * (m_Agent.RunMode ? RunSpeedMultiplier : 1.f);
+    m_Agent.LinearVelocity = Elite::Clamp(steering.LinearVelocity, maxSpeed);
+    if (!isMoving) m_Agent.LinearVelocity = Elite::ZeroVector2;
+    m_Agent.CurrentLinearSpeed = m_Agent.LinearVelocity.Magnitude();
+
+    const Elite::Vector2 halfDimensions = m_WorldInfo.Dimensions * 0.5f;
+    m_Agent.Position += m_Agent.LinearVelocity * dt;
+    m_Agent.Position.x = Elite::Clamp(m_Agent.Position.x, m_WorldInfo.Center.x - halfDimensions.x,
+                                      m_WorldInfo.Center.x + halfDimensions.x);
+    m_Agent.Position.y = Elite::Clamp(m_Agent.Position.y, m_WorldInfo.Center.y - halfDimensions.y,
+                                      m_WorldInfo.Center.y + halfDimensions.y);
+
+    if (steering.AutoOrient)
+    {
+        m_Agent.AngularVelocity = 0.f;
+        if (isMoving) m_Agent.Orientation = Elite::VectorToOrientation(m_Agent.LinearVelocity);
+    }
+    else
+    {
+        m_Agent.AngularVelocity = Elite::Clamp(steering.AngularVelocity, -m_Agent.MaxAngularSpeed,
+                                               m_Agent.MaxAngularSpeed);
+        m_Agent.Orientation = Elite::ClampedAngle(m_Agent.Orientation + m_Agent.AngularVelocity * dt);
+    }
+
+    m_Agent.IsInHouse = std::ranges::any_of(m_Houses, [this](const HouseInfo& house)
+    {
+        return IsPointInHouse(m_Agent.Position, house);
+    });
+
+    m_Agent.Bitten = false;
+    m_WasBittenTimer = std::max(0.f, m_WasBittenTimer - dt);
+    m_Agent.WasBitten = m_WasBittenTimer > 0.f;
+}
+
+void HeadlessWorld::UpdateEnemies(float dt)
+{
+    std::uniform_real_distribution<float> wanderOffset(-30.f, 30.f);
+    for (Enemy& enemy: m_Enemies)
+    {
+        enemy.BiteCooldown = std::max(0.f, enemy.BiteCooldown - dt);
+        const Elite::Vector2 toAgent = m_Agent.Position - enemy.Info.Location;
+        Elite::Vector2 target;
+        if (toAgent.MagnitudeSquared() <= EnemyDetectRange * EnemyDetectRange)
+        {
+            target = m_Agent.Position;
+        }
+        else
+        {
+            if (enemy.WanderTarget.DistanceSquared(enemy.Info.Location) < 1.f)
+            {
+                enemy.WanderTarget = enemy.Info.Location + Elite::Vector2(wanderOffset(m_Rng), wanderOffset(m_Rng));
+            }
+            target = enemy.WanderTarget;
+        }
+
+        enemy.Info.LinearVelocity = (target - enemy.Info.Location).GetNormalized() * enemy.Speed;
+        enemy.Info.Location += enemy.Info.LinearVelocity * dt;
+
+        const float biteRange = (enemy.Info.Size + m_Agent.AgentSize) * 0.5f + 0.5f;
+        if (enemy.BiteCooldown <= 0.f && enemy.Info.Location.DistanceSquared(m_Agent.Position) <= biteRange * biteRange)
+        {
+            enemy.BiteCooldown = BiteCooldown;
+            m_Agent.Health -= enemy.Damage;
+            m_Agent.Bitten = true;
+            m_Agent.WasBitten = true;
+            m_WasBittenTimer = WasBittenDuration;
+        }
+    }
+}
+
+void HeadlessWorld::UpdatePurgeZones(float dt)
+{
+    if (m_Stage >= m_Params.PurgeZoneStartStage)
+    {
+        m_PurgeZoneTimer += dt;
+        if (m_PurgeZoneTimer >= m_Params.PurgeZoneInterval)
+        {
+            m_PurgeZoneTimer -= m_Params.PurgeZoneInterval;
+            std::uniform_real_distribution<float> offset(-40.f, 40.f);
+            PurgeZone zone{};
+            zone.Info.Center = m_Agent.Position + Elite::Vector2(offset(m_Rng), offset(m_Rng));
+            zone.Info.Radius = std::uniform_real_distribution<float>(15.f, 30.f)(m_Rng);
+            zone.Info.ZoneHash = m_NextHash++;
+            zone.TimeUntilPurge = PurgeZoneDelay;
+            m_PurgeZones.push_back(zone);
+        }
+    }
+
+    for (auto it = m_PurgeZones.begin(); it != m_PurgeZones.end();)
+    {
+        it->TimeUntilPurge -= dt;
+        if (it->TimeUntilPurge > 0.f)
+        {
+            ++it;
+            continue;
+        }
+        const float radiusSqr = it->Info.Radius * it->Info.Radius;
+        if (m_Agent.Position.DistanceSquared(it->Info.Center) <= radiusSqr) Kill("purge zone");
+        std::erase_if(m_Enemies, [&it, radiusSqr](const Enemy& enemy)
+        {
+            return enemy.Info.Location.DistanceSquared(it->Info.Center) <= radiusSqr;
+        });
+        it = m_PurgeZones.erase(it);
+    }
+}
+
+void HeadlessWorld::UpdateStage()
+{
+    const int stage = static_cast<int>(m_Stats.TimeSurvived / m_Params.StageDuration);
+    if (stage == m_Stage) return;
+    m_Stage = stage;
+    m_Stats.Difficulty = static_cast<float>(m_Stage);
+    for (int i{}; i < m_Params.EnemiesPerStage; ++i)
+    {
+        SpawnEnemy(true);
+    }
+}
+
+void HeadlessWorld::UpdateFOV()
+{
+    m_HousesInFOV.clear();
+    m_EnemiesInFOV.clear();
+    m_ItemsInFOV.clear();
+    m_PurgeZonesInFOV.clear();
+
+    for (const HouseInfo& house: m_Houses)
+    {
+        if (IsHouseInFOV(house)) m_HousesInFOV.push_back(house);
+    }
+    for (const Enemy& enemy: m_Enemies)
+    {
+        if (IsPointInFOV(enemy.Info.Location)) m_EnemiesInFOV.push_back(enemy.Info);
+    }
+    for (const ItemInfo& item: m_Items)
+    {
+        if (IsPointInFOV(item.Location)) m_ItemsInFOV.push_back(item);
+    }
+    for (const PurgeZone& zone: m_PurgeZones)
+    {
+        if (IsPointInFOV(zone.Info.Center, zone.Info.Radius)) m_PurgeZonesInFOV.push_back(zone.Info);
+    }
+
+    SortByDistance(m_EnemiesInFOV, m_Agent.Position, &EnemyInfo::Location);
+    SortByDistance(m_ItemsInFOV, m_Agent.Position, &ItemInfo::Location);
+    SortByDistance(m_HousesInFOV, m_Agent.Position, &HouseInfo::Center);
+
+    m_FOVStats.NumHouses = static_cast<int>(m_HousesInFOV.size());
+    m_FOVStats.NumEnemies = static_cast<int>(m_EnemiesInFOV.size());
+    m_FOVStats.NumItems = static_cast<int>(m_ItemsInFOV.size());
+    m_FOVStats.NumPurgeZones = static_cast<int>(m_PurgeZonesInFOV.size());
+}
+
+bool HeadlessWorld::IsPointInFOV(const Elite::Vector2 &point, float radius) const
+{
+    const Elite::Vector2 toPoint = point - m_Agent.Position;
+    const float distance = toPoint.Magnitude();
+    if (distance <= radius) return true;
+    if (distance - radius > m_Agent.FOV_Range) return false;
+    const float angle = Elite::AngleBetween(Elite::OrientationToVector(m_Agent.Orientation), toPoint);
+    return abs(angle) <= m_Agent.FOV_Angle * 0.5f;
+}
+
+bool HeadlessWorld::IsHouseInFOV(const HouseInfo &house) const
+{
+    if (IsPointInHouse(m_Agent.Position, house)) return true;
+    return IsPointInFOV(ClosestPointOnHouse(m_Agent.Position, house)) || IsPointInFOV(house.Center);
+}
+
+Elite::Vector2 HeadlessWorld::RandomPointInWorld(float margin)
+{
+    const Elite::Vector2 halfDimensions = m_WorldInfo.Dimensions * 0.5f - Elite::Vector2(margin, margin);
+    std::uniform_real_distribution<float> x(m_WorldInfo.Center.x - halfDimensions.x, m_WorldInfo.Center.x + halfDimensions.x);
+    std::uniform_real_distribution<float> y(m_WorldInfo.Center.y - halfDimensions.y, m_WorldInfo.Center.y + halfDimensions.y);
+    return {x(m_Rng), y(m_Rng)};
+}
+
+void HeadlessWorld::Kill(const std::string &cause)
+{
+    if (m_Params.GodMode || m_Agent.Death) return;
+    m_Agent.Death = true;
+    m_CauseOfDeath = cause;
+}
+
+#pragma region Items
+
+bool HeadlessWorld::GrabNearestItem(ItemInfo &item) const
+{
+    const float grabRangeSqr = m_Agent.GrabRange * m_Agent.GrabRange;
+    const ItemInfo* pClosest = nullptr;
+    float closestDistSqr = grabRangeSqr;
+    for (const ItemInfo& worldItem: m_Items)
+    {
+        const float distSqr = worldItem.Location.DistanceSquared(m_Agent.Position);
+        if (distSqr <= closestDistSqr)
+        {
+            closestDistSqr = distSqr;
+            pClosest = &worldItem;
+        }
+    }
+    if (!pClosest) return false;
+    item = *pClosest;
+    return true;
+}
+
+bool HeadlessWorld::GrabItem(const ItemInfo &item) const
+{
+    const float grabRangeSqr = m_Agent.GrabRange * m_Agent.GrabRange;
+    return std::ranges::any_of(m_Items, [&item, grabRangeSqr, this](const ItemInfo& worldItem)
+    {
+        return worldItem.ItemHash == item.ItemHash && worldItem.Location.DistanceSquared(m_Agent.Position) <= grabRangeSqr;
+    });
+}
+
+bool HeadlessWorld::DestroyItem(const ItemInfo &item)
+{
+    return std::erase_if(m_Items, [&item](const ItemInfo& worldItem) { return worldItem.ItemHash == item.ItemHash; }) > 0;
+}
+
+#pragma endregion
+
+#pragma region Inventory
+
+bool HeadlessWorld::Inventory_AddItem(unsigned int slotId, const ItemInfo &item)
+{
+    if (slotId >= InventoryCapacity || m_Inventory[slotId].has_value()) return false;
+    // The item has to be grabbed from the world, this is what ties Item_Grab and the inventory together
+    if (!GrabItem(item)) return false;
+
+    const auto it = std::ranges::find_if(m_Items, [&item](const ItemInfo& worldItem)
+    {
+        return worldItem.ItemHash == item.ItemHash;
+    });
+    m_Inventory[slotId] = *it;
+    m_Items.erase(it);
+    ++m_Stats.NumItemsPickUp;
+    m_Stats.Score += 2;
+    return true;
+}
+
+bool HeadlessWorld::Inventory_UseItem(unsigned int slotId)
+{
+    if (slotId >= InventoryCapacity || !m_Inventory[slotId].has_value()) return false;
+    ItemInfo& item = m_Inventory[slotId].value();
+    switch (item.Type)
+    {
+        case eItemType::PISTOL:
+        case eItemType::SHOTGUN:
+        {
+            if (item.Value <= 0) return false;
+            --item.Value;
+            const bool hit = item.Type == eItemType::PISTOL ? FirePistol() : FireShotgun();
+            if (!hit)
+            {
+                ++m_Stats.NumMissedShots;
+                m_Stats.Score -= 5;
+            }
+            return true;
+        }
+        case eItemType::MEDKIT:
+            m_Agent.Health = std::min(MaxStat, m_Agent.Health + static_cast<float>(item.Value));
+            item.Value = 0;
+            return true;
+        case eItemType::FOOD:
+            m_Agent.Energy = std::min(MaxStat, m_Agent.Energy + static_cast<float>(item.Value));
+            item.Value = 0;
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool HeadlessWorld::Inventory_RemoveItem(unsigned int slotId)
+{
+    if (slotId >= InventoryCapacity || !m_Inventory[slotId].has_value()) return false;
+    m_Inventory[slotId].reset();
+    return true;
+}
+
+bool HeadlessWorld::Inventory_GetItem(unsigned int slotId, ItemInfo &item) const
+{
+    if (slotId >= InventoryCapacity || !m_Inventory[slotId].has_value()) return false;
+    item = m_Inventory[slotId].value();
+    return true;
+}
+
+#pragma endregion
+
+#pragma region Shooting
+
+bool HeadlessWorld::FirePistol()
+{
+    const Elite::Vector2 direction = Elite::OrientationToVector(m_Agent.Orientation);
+    int hitIdx = -1;
+    float closestHit = PistolRange;
+    for (size_t i{}; i < m_Enemies.size(); ++i)
+    {
+        const Elite::Vector2 toEnemy = m_Enemies[i].Info.Location - m_Agent.Position;
+        const float alongRay = toEnemy.Dot(direction);
+        if (alongRay <= 0.f || alongRay > closestHit) continue;
+        const float hitRadius = m_Enemies[i].Info.Size * 0.5f + 0.25f;
+        if (abs(toEnemy.Cross(direction)) <= hitRadius)
+        {
+            closestHit = alongRay;
+            hitIdx = static_cast<int>(i);
+        }
+    }
+    if (hitIdx < 0) return false;
+    DamageEnemy(hitIdx, 1.f);
+    return true;
+}
+
+bool HeadlessWorld::FireShotgun()
+{
+    const Elite::Vector2 direction = Elite::OrientationToVector(m_Agent.Orientation);
+    std::vector<size_t> hits{};
+    for (size_t i{}; i < m_Enemies.size(); ++i)
+    {
+        const Elite::Vector2 toEnemy = m_Enemies[i].Info.Location - m_Agent.Position;
+        if (toEnemy.MagnitudeSquared() > ShotgunRange * ShotgunRange) continue;
+        if (abs(Elite::AngleBetween(direction, toEnemy)) <= ShotgunHalfAngle) hits.push_back(i);
+    }
+    // Damage back to front so erasing killed enemies keeps the other indices valid
+    for (auto it = hits.rbegin(); it != hits.rend(); ++it)
+    {
+        DamageEnemy(*it, 1.f);
+    }
+    return !hits.empty();
+}
+
+void HeadlessWorld::DamageEnemy(size_t idx, float damage)
+{
+    Enemy& enemy = m_Enemies[idx];
+    enemy.Info.Health -= damage;
+    ++m_Stats.NumEnemiesHit;
+    m_Stats.Score += 5;
+    if (enemy.Info.Health > 0.f) return;
+
+    ++m_Stats.NumEnemiesKilled;
+    m_Stats.Score += 15;
+    m_Enemies.erase(m_Enemies.begin() + static_cast<std::ptrdiff_t>(idx));
+    // Keep the zombie population stable, a new one shows up somewhere else
+    SpawnEnemy(true);
+}
+
+#pragma endregion
@@ -0,0 +1,132 @@
+#pragma once
+#include <array>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+#include "Exam_HelperStructs.h"
+
+struct SteeringPlugin_Output;
+
+// Parameters for the stand-in world, mirrors the knobs of GameDebugParams that matter for a headless run
+struct HeadlessWorldParams
+{
+    unsigned int Seed = 1337;
+    Elite::Vector2 WorldDimensions{500.f, 500.f};
+    int NumVillages = 6;
+    int HousesPerVillage = 4;
+    int ItemsPerHouse = 2;
+    int EnemyCount = 20;
+    // Extra zombies spawned each time a new stage starts
+    int EnemiesPerStage = 5;
+    float StageDuration = 60.f;
+    // Purge zones only start to spawn from this stage on (0 based)
+    int PurgeZoneStartStage = 2;
+    float PurgeZoneInterval = 15.f;
+    bool GodMode = false;
+};
+
+// Minimal, deterministic stand-in for the exam framework's world.
+// Holds houses, items, zombies and purge zones, simulates the agent's kinematics
+// and computes what the agent can see. Houses have no walls, so the navmesh is a straight line.
+class HeadlessWorld final
+{
+public:
+    static constexpr int InventoryCapacity = 5;
+
+    struct Enemy
+    {
+        EnemyInfo Info{};
+        Elite::Vector2 WanderTarget{};
+        float Damage = 1.f;
+        float Speed = 3.f;
+        float BiteCooldown = 0.f;
+    };
+
+    struct PurgeZone
+    {
+        PurgeZoneInfo Info{};
+        float TimeUntilPurge = 0.f;
+    };
+
+    explicit HeadlessWorld(const HeadlessWorldParams& params);
+
+    // Advances the world by dt using the steering the plugin returned this frame
+    void Step(float dt, const SteeringPlugin_Output& steering);
+
+    [[nodiscard]] bool IsAgentDead() const { return m_Agent.Death; }
+    [[nodiscard]] const std::string& GetCauseOfDeath() const { return m_CauseOfDeath; }
+
+    [[nodiscard]] WorldInfo GetWorldInfo() const { return m_WorldInfo; }
+    [[nodiscard]] const StatisticsInfo& GetStats() const { return m_Stats; }
+    [[nodiscard]] const AgentInfo& GetAgentInfo() const { return m_Agent; }
+    [[nodiscard]] int GetStage() const { return m_Stage; }
+
+    // FOV contents are computed once per Step, like the real framework does
+    [[nodiscard]] const FOVStats& GetFOVStats() const { return m_FOVStats; }
+    [[nodiscard]] const std::vector<HouseInfo>& GetHousesInFOV() const { return m_HousesInFOV; }
+    [[nodiscard]] const std::vector<EnemyInfo>& GetEnemiesInFOV() const { return m_EnemiesInFOV; }
+    [[nodiscard]] const std::vector<ItemInfo>& GetItemsInFOV() const { return m_ItemsInFOV; }
+    [[nodiscard]] const std::vector<PurgeZoneInfo>& GetPurgeZonesInFOV() const { return m_PurgeZonesInFOV; }
+
+    [[nodiscard]] const std::vector<HouseInfo>& GetHouses() const { return m_Houses; }
+    [[nodiscard]] const std::vector<ItemInfo>& GetItems() const { return m_Items; }
+    [[nodiscard]] const std::vector<Enemy>& GetEnemies() const { return m_Enemies; }
+
+    // Items
+    bool GrabNearestItem(ItemInfo& item) const;
+    bool GrabItem(const ItemInfo& item) const;
+    bool DestroyItem(const ItemInfo& item);
+
+    // Inventory
+    bool Inventory_AddItem(unsigned int slotId, const ItemInfo& item);
+    bool Inventory_UseItem(unsigned int slotId);
+    bool Inventory_RemoveItem(unsigned int slotId);
+    bool Inventory_GetItem(unsigned int slotId, ItemInfo& item) const;
+
+private:
+    void GenerateLevel();
+    void SpawnEnemy(bool awayFromAgent);
+    ItemInfo MakeRandomItem(const Elite::Vector2& location);
+
+    void UpdateAgent(float dt, const SteeringPlugin_Output& steering);
+    void UpdateEnemies(float dt);
+    void UpdatePurgeZones(float dt);
+    void UpdateStage();
+    void UpdateFOV();
+
+    // Shooting helpers, return true when at least one enemy was hit
+    bool FirePistol();
+    bool FireShotgun();
+    void DamageEnemy(size_t idx, float damage);
+
+    [[nodiscard]] bool IsPointInFOV(const Elite::Vector2& point, float radius = 0.f) const;
+    [[nodiscard]] bool IsHouseInFOV(const HouseInfo& house) const;
+    [[nodiscard]] Elite::Vector2 RandomPointInWorld(float margin = 10.f);
+    void Kill(const std::string& cause);
+
+    HeadlessWorldParams m_Params;
+    std::mt19937 m_Rng;
+    WorldInfo m_WorldInfo{};
+    StatisticsInfo m_Stats{};
+    AgentInfo m_Agent{};
+
+    std::vector<HouseInfo> m_Houses{};
+    std::vector<ItemInfo> m_Items{};
+    std::vector<Enemy> m_Enemies{};
+    std::vector<PurgeZone> m_PurgeZones{};
+    std::array<std::optional<ItemInfo>, InventoryCapacity> m_Inventory{};
+
+    FOVStats m_FOVStats{};
+    std::vector<HouseInfo> m_HousesInFOV{};
+    std::vector<EnemyInfo> m_EnemiesInFOV{};
+    std::vector<ItemInfo> m_ItemsInFOV{};
+    std::vector<PurgeZoneInfo> m_PurgeZonesInFOV{};
+
+    int m_NextHash = 1;
+    int m_Stage = 0;
+    float m_ScoreTimer = 0.f;
+    float m_WasBittenTimer = 0.f;
+    float m_PurgeZoneTimer = 0.f;
+    std::string m_CauseOfDeath{};
+};
@@ -0,0 +1,107 @@
+#include "../stdafx.h"
+#include "JobSystem.h"
+
+JobSystem::JobSystem(int numThreads):
+    m_NumThreads(std::max(numThreads, 1)), m_pQueues(std::make_unique<WorkQueue[]>(m_NumThreads))
+{
+    m_Workers.reserve(m_NumThreads - 1);
+    for (int thread{1}; thread < m_NumThreads; ++thread) m_Workers.emplace_back(&JobSystem::WorkerMain, this, thread);
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard lock{m_WakeMutex};
+        m_IsQuitting = true;
+    }
+    m_WakeCondition.notify_all();
+    for (std::thread& worker: m_Workers) worker.join();
+}
+
+void JobSystem::ParallelFor(int count, int grainSize, const RangeFn& fn)
+{
+    if (count <= 0) return;
+    grainSize = std::max(grainSize, 1);
+    const int numChunks = (count + grainSize - 1) / grainSize;
+    if (m_NumThreads == 1 || numChunks == 1)
+    {
+        for (int begin{}; begin < count; begin += grainSize) fn(begin, std::min(begin + grainSize, count));
+        return;
+    }
+
+    m_pFn = &fn;
+    m_NumPendingChunks.store(numChunks, std::memory_order_relaxed);
+    // Neighbouring chunks go to the same thread, its agents stay together as long as nobody steals them
+    for (int thread{}; thread < m_NumThreads; ++thread)
+    {
+        const int firstChunk = thread * numChunks / m_NumThreads;
+        const int lastChunk = (thread + 1) * numChunks / m_NumThreads;
+        WorkQueue& queue = m_pQueues[thread];
+        std::lock_guard lock{queue.Mutex};
+        for (int chunk{firstChunk}; chunk < lastChunk; ++chunk)
+        {
+            const int begin = chunk * grainSize;
+            queue.Chunks.push_back({begin, std::min(begin + grainSize, count)});
+        }
+    }
+    {
+        std::lock_guard lock{m_WakeMutex};
+        ++m_Generation;
+    }
+    m_WakeCondition.notify_all();
+
+    RunChunks(0);
+    // The last chunks may still be running on the threads that stole them
+    while (m_NumPendingChunks.load(std::memory_order_acquire) > 0) std::this_thread::yield();
+}
+
+void JobSystem::WorkerMain(int thread)
+{
+    uint64_t generation{};
+    for (;;)
+    {
+        {
+            std::unique_lock lock{m_WakeMutex};
+            m_WakeCondition.wait(lock, [this, generation]() { return m_IsQuitting || m_Generation != generation; });
+            if (m_IsQuitting) return;
+            generation = m_Generation;
+        }
+        RunChunks(thread);
+    }
+}
+
+void JobSystem::RunChunks(int thread)
+{
+    Chunk chunk{};
+    while (PopOwn(thread, chunk) || Steal(thread, chunk))
+    {
+        (*m_pFn)(chunk.Begin, chunk.End);
+        m_NumPendingChunks.fetch_sub(1, std::memory_order_release);
+    }
+}
+
+bool JobSystem::PopOwn(int thread, Chunk& chunk)
+{
+    WorkQueue& queue = m_pQueues[thread];
+    std::lock_guard lock{queue.Mutex};
+    if (queue.Chunks.empty()) return false;
+    chunk = queue.Chunks.back();
+    queue.Chunks.pop_back();
+    return true;
+}
+
+bool JobSystem::Steal(int thread, Chunk& chunk)
+{
+    // Thieves take from the front, the end of the block the owner gets to last
+    for (int offset{1}; offset < m_NumThreads; ++offset)
+    {
+        WorkQueue& queue = m_pQueues[(thread + offset) % m_NumThreads];
+        std::lock_guard lock{queue.Mutex};
+        if (queue.Chunks.empty()) continue;
+        chunk = queue.Chunks.front();
+        queue.Chunks.pop_front();
+        m_NumSteals.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fork-join job system with one deque of jobs per thread and work stealing.
+// ParallelFor cuts an index range into chunks and deals them out as contiguous blocks, one block per deque.
+// Every thread works through its own deque from the back and, once that is empty, steals chunks from the
+// front of the other deques, so threads whose agents died early help out the ones that still have work.
+// The calling thread is thread 0 and takes part in the work, so a JobSystem of one thread starts no threads.
+class JobSystem final
+{
+public:
+    using RangeFn = std::function<void(int begin, int end)>;
+
+    explicit JobSystem(int numThreads);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+    JobSystem(JobSystem&&) = delete;
+    JobSystem& operator=(JobSystem&&) = delete;
+
+    // Calls fn on [begin, end) chunks of at most grainSize indices that together cover [0, count),
+    // returns once every chunk ran. Chunks run concurrently, fn must only touch the indices it gets.
+    void ParallelFor(int count, int grainSize, const RangeFn& fn);
+
+    [[nodiscard]] int GetNumThreads() const { return m_NumThreads; }
+    // Chunks a thread took from another thread's deque, summed over all ParallelFor calls
+    [[nodiscard]] uint64_t GetNumSteals() const { return m_NumSteals.load(std::memory_order_relaxed); }
+
+private:
+    struct Chunk
+    {
+        int Begin;
+        int End;
+    };
+
+    // Own cache line per deque, the owner and the thieves only meet on the mutex
+    struct alignas(64) WorkQueue
+    {
+        std::mutex Mutex{};
+        std::deque<Chunk> Chunks{};
+    };
+
+    void WorkerMain(int thread);
+    // Runs chunks until none is left in any deque
+    void RunChunks(int thread);
+    bool PopOwn(int thread, Chunk& chunk);
+    bool Steal(int thread, Chunk& chunk);
+
+    int m_NumThreads;
+    std::unique_ptr<WorkQueue[]> m_pQueues;
+    std::vector<std::thread> m_Workers{};
+
+    // Set before the chunks of a ParallelFor are pushed, the queue mutexes publish it to the thieves
+    const RangeFn* m_pFn = nullptr;
+    std::atomic<int> m_NumPendingChunks{0};
+    std::atomic<uint64_t> m_NumSteals{0};
+
+    std::mutex m_WakeMutex{};
+    std::condition_variable m_WakeCondition{};
+    uint64_t m_Generation = 0;
+    bool m_IsQuitting = false;
+};
@@ -0,0 +1,192 @@
+#include "../stdafx.h"
+#include "ReplayInterface.h"
+#include "../Trajectory/TrajectoryReader.h"
+
+using Trajectory::Call;
+using Trajectory::CallType;
+
+ReplayInterface::ReplayInterface(TrajectoryReader *const pReader):
+    m_pReader(pReader),
+    m_pPending(pReader->ReadFrame())
+{
+}
+
+bool ReplayInterface::BeginFrame()
+{
+    if (!m_pPending || HasDiverged()) return false;
+    m_pFrame = m_pPending;
+    return true;
+}
+
+bool ReplayInterface::EndFrame(const SteeringPlugin_Output &steering)
+{
+    assert(m_pFrame && m_pFrame == m_pPending && "EndFrame without BeginFrame");
+    if (HasDiverged()) return false;
+    if (m_NextCall < m_pFrame->Calls.size())
+    {
+        Diverge("the agent did not call %s, it made %zu of the %zu recorded calls",
+                Trajectory::GetCallName(m_pFrame->Calls[m_NextCall].Type), m_NextCall, m_pFrame->Calls.size());
+        return false;
+    }
+    // Bit for bit, a float that comes out different in the last bit is a different decision path all the same
+    const SteeringPlugin_Output &recorded = m_pFrame->Steering;
+    if (std::bit_cast<uint64_t>(steering.LinearVelocity) != std::bit_cast<uint64_t>(recorded.LinearVelocity)
+        || std::bit_cast<uint32_t>(steering.AngularVelocity) != std::bit_cast<uint32_t>(recorded.AngularVelocity)
+        || steering.AutoOrient != recorded.AutoOrient || steering.RunMode != recorded.RunMode)
+    {
+        Diverge("steering (%.9g, %.9g) %.9g%s%s, recorded (%.9g, %.9g) %.9g%s%s",
+                steering.LinearVelocity.x, steering.LinearVelocity.y, steering.AngularVelocity,
+                steering.AutoOrient ? " auto orient" : "", steering.RunMode ? " run" : "",
+                recorded.LinearVelocity.x, recorded.LinearVelocity.y, recorded.AngularVelocity,
+                recorded.AutoOrient ? " auto orient" : "", recorded.RunMode ? " run" : "");
+        return false;
+    }
+    m_pPending = m_pReader->ReadFrame();
+    m_NextCall = 0;
+    return true;
+}
+
+const Call *ReplayInterface::NextCall(const Call &call) const
+{
+    if (HasDiverged()) return nullptr;
+    if (!m_pPending || m_NextCall == m_pPending->Calls.size())
+    {
+        Diverge("the agent called %s, no further call was recorded", Trajectory::GetCallName(call.Type));
+        return nullptr;
+    }
+    const Call &recorded = m_pPending->Calls[m_NextCall];
+    if (!Trajectory::HasSameArguments(call, recorded))
+    {
+        // Same type means different arguments
+        Diverge("the agent called %s, the recording has %s%s at call %zu", Trajectory::GetCallName(call.Type),
+                Trajectory::GetCallName(recorded.Type), call.Type == recorded.Type ? " with other arguments" : "",
+                m_NextCall);
+        return nullptr;
+    }
+    ++m_NextCall;
+    return &recorded;
+}
+
+void ReplayInterface::Diverge(const char *format, ...) const
+{
+    char message[512];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(message, sizeof(message), format, args);
+    va_end(args);
+    // The calls before the first frame are recorded with it
+    const uint32_t frame = m_pFrame ? m_pFrame->Index : 0;
+    m_Divergence = "frame " + std::to_string(frame) + (m_pFrame ? "" : " (before the first frame)") + ": " + message;
+}
+
+#pragma region Observations
+AgentInfo ReplayInterface::Agent_GetInfo() const
+{
+    return m_pFrame ? m_pFrame->Agent : m_pReader->GetInitialAgentInfo();
+}
+
+const FOVStats& ReplayInterface::FOV_GetStats() const
+{
+    return m_pFrame ? m_pFrame->Stats : m_NoStats;
+}
+
+std::vector<HouseInfo> ReplayInterface::GetHousesInFOV() const
+{
+    return m_pFrame ? m_pFrame->Houses : std::vector<HouseInfo>{};
+}
+
+std::vector<EnemyInfo> ReplayInterface::GetEnemiesInFOV() const
+{
+    return m_pFrame ? m_pFrame->Enemies : std::vector<EnemyInfo>{};
+}
+
+std::vector<PurgeZoneInfo> ReplayInterface::GetPurgeZonesInFOV() const
+{
+    return m_pFrame ? m_pFrame->PurgeZones : std::vector<PurgeZoneInfo>{};
+}
+
+std::vector<ItemInfo> ReplayInterface::GetItemsInFOV() const
+{
+    return m_pFrame ? m_pFrame->Items : std::vector<ItemInfo>{};
+}
+#pragma endregion
+
+#pragma region Calls
+WorldInfo ReplayInterface::World_GetInfo() const
+{
+    const Call *pRecorded = NextCall(Call{CallType::WorldGetInfo});
+    return pRecorded ? pRecorded->World : WorldInfo{};
+}
+
+StatisticsInfo ReplayInterface::World_GetStats() const
+{
+    const Call *pRecorded = NextCall(Call{CallType::WorldGetStats});
+    return pRecorded ? pRecorded->Stats : StatisticsInfo{};
+}
+
+Elite::Vector2 ReplayInterface::NavMesh_GetClosestPathPoint(Elite::Vector2 goal) const
+{
+    Call call{CallType::NavMeshGetClosestPathPoint};
+    call.Goal = goal;
+    const Call *pRecorded = NextCall(call);
+    return pRecorded ? pRecorded->PathPoint : goal;
+}
+
+bool ReplayInterface::Inventory_AddItem(UINT slotId, ItemInfo item)
+{
+    Call call{CallType::InventoryAddItem, slotId};
+    call.Item = item;
+    const Call *pRecorded = NextCall(call);
+    return pRecorded && pRecorded->Result;
+}
+
+bool ReplayInterface::Inventory_UseItem(UINT slotId)
+{
+    const Call *pRecorded = NextCall(Call{CallType::InventoryUseItem, slotId});
+    return pRecorded && pRecorded->Result;
+}
+
+bool ReplayInterface::Inventory_RemoveItem(UINT slotId)
+{
+    const Call *pRecorded = NextCall(Call{CallType::InventoryRemoveItem, slotId});
+    return pRecorded && pRecorded->Result;
+}
+
+bool ReplayInterface::Inventory_GetItem(UINT slotId, ItemInfo &item)
+{
+    const Call *pRecorded = NextCall(Call{CallType::InventoryGetItem, slotId});
+    if (!pRecorded || !pRecorded->Result) return false;
+    item = pRecorded->Item;
+    return true;
+}
+
+UINT ReplayInterface::Inventory_GetCapacity() const
+{
+    const Call *pRecorded = NextCall(Call{CallType::InventoryGetCapacity});
+    return pRecorded ? pRecorded->Capacity : 0;
+}
+
+bool ReplayInterface::GrabNearestItem(ItemInfo &item)
+{
+    const Call *pRecorded = NextCall(Call{CallType::GrabNearestItem});
+    if (!pRecorded || !pRecorded->Result) return false;
+    item = pRecorded->Item;
+    return true;
+}
+
+bool ReplayInterface::GrabItem(const ItemInfo &item)
+{
+    Call call{CallType::GrabItem};
+    call.Item = item;
+    const Call *pRecorded = NextCall(call);
+    return pRecorded && pRecorded->Result;
+}
+
+bool ReplayInterface::DestroyItem(const ItemInfo &item)
+{
+    Call call{CallType::DestroyItem};
+    call.Item = item;
+    const Call *pRecorded = NextCall(call);
+    return pRecorded && pRecorded->Result;
+}
+#pragma endregion
@@ -0,0 +1,106 @@
+#pragma once
+#include <string>
+#include "IExamInterface.h"
+
+class TrajectoryReader;
+struct TrajectoryFrame;
+namespace Trajectory { struct Call; }
+
+// Implementation of IExamInterface that plays a recorded trajectory back instead of a world.
+// The observation calls return what was recorded for the current frame, the other calls hand out the recorded results
+// in the recorded order once the agent asks for the same call with the same arguments.
+// A frame is played as BeginFrame, the plugin's UpdateSteering, EndFrame; EndFrame also checks that the steering matches.
+// From the first difference on the replay has diverged: the calls return defaults and BeginFrame returns false.
+class ReplayInterface final : public IExamInterface
+{
+public:
+    // Reads the first frame, the calls made while the agent is constructed are recorded with it
+    explicit ReplayInterface(TrajectoryReader* pReader);
+
+    // Makes the next recorded frame the current one, false at the end of the trajectory or after a divergence
+    bool BeginFrame();
+    // Compares the plugin's steering with the recorded one and checks every recorded call was made
+    bool EndFrame(const SteeringPlugin_Output& steering);
+    // The frame the replay is in, nullptr before the first BeginFrame
+    [[nodiscard]] const TrajectoryFrame* GetFrame() const { return m_pFrame; }
+
+    [[nodiscard]] bool HasDiverged() const { return !m_Divergence.empty(); }
+    // What differed and in which frame
+    [[nodiscard]] const std::string& GetDivergence() const { return m_Divergence; }
+
+    //WORLD & ENTITIES
+    WorldInfo World_GetInfo() const override;
+    StatisticsInfo World_GetStats() const override;
+
+    std::vector<HouseInfo> GetHousesInFOV() const override;
+    std::vector<EnemyInfo> GetEnemiesInFOV() const override;
+    std::vector<PurgeZoneInfo> GetPurgeZonesInFOV() const override;
+    std::vector<ItemInfo> GetItemsInFOV() const override;
+
+    const FOVStats& FOV_GetStats() const override;
+
+    AgentInfo Agent_GetInfo() const override;
+
+    //NAVMESH
+    Elite::Vector2 NavMesh_GetClosestPathPoint(Elite::Vector2 goal) const override;
+
+    //INVENTORY
+    bool Inventory_AddItem(UINT slotId, ItemInfo item) override;
+    bool Inventory_UseItem(UINT slotId) override;
+    bool Inventory_RemoveItem(UINT slotId) override;
+    bool Inventory_GetItem(UINT slotId, ItemInfo& item) override;
+    UINT Inventory_GetCapacity() const override;
+
+    //ITEMS
+    bool GrabNearestItem(ItemInfo& item) override;
+    bool GrabItem(const ItemInfo& item) override;
+    bool DestroyItem(const ItemInfo& item) override;
+
+    //DEBUG
+    Elite::Vector2 Debug_ConvertScreenToWorld(Elite::Vector2 screenPos) const override { return screenPos; }
+    Elite::Vector2 Debug_ConvertWorldToScreen(Elite::Vector2 worldPos) const override { return worldPos; }
+
+    //INPUT
+    bool Input_IsKeyboardKeyDown(Elite::InputScancode key) const override { return false; }
+    bool Input_IsKeyboardKeyUp(Elite::InputScancode key) const override { return false; }
+    bool Input_IsMouseButtonDown(Elite::InputMouseButton button) const override { return false; }
+    bool Input_IsMouseButtonUp(Elite::InputMouseButton button) const override { return false; }
+    Elite::MouseData Input_GetMouseData(Elite::InputType type, Elite::InputMouseButton button) const override { return {}; }
+
+    //EVENT
+    void RequestShutdown() const override {}
+
+    //RENDERER
+    void Draw_Polygon(const Elite::Vector2* points, int count, const Elite::Vector3& color, float depth) override {}
+    void Draw_SolidPolygon(const Elite::Vector2* points, int count, const Elite::Vector3& color, float depth, bool triangulate) override {}
+    void Draw_Circle(const Elite::Vector2& center, float radius, const Elite::Vector3& color, float depth) override {}
+    void Draw_SolidCircle(const Elite::Vector2& center, float32 radius, const Elite::Vector2& axis, const Elite::Vector3& color, float depth) override {}
+    void Draw_Segment(const Elite::Vector2& p1, const Elite::Vector2& p2, const Elite::Vector3& color, float depth) override {}
+    void Draw_Direction(const Elite::Vector2& p, Elite::Vector2 dir, float length, const Elite::Vector3& color, float depth) override {}
+    void Draw_Transform(const b2Transform& xf, float depth) override {}
+    void Draw_Point(const Elite::Vector2& p, float size, const Elite::Vector3& color, float depth) override {}
+    float NextDepthSlice() override { return 0.f; }
+
+    // Bring the non-virtual convenience overloads of IBaseInterface back into scope
+    using IBaseInterface::Draw_Polygon;
+    using IBaseInterface::Draw_SolidPolygon;
+    using IBaseInterface::Draw_Circle;
+    using IBaseInterface::Draw_SolidCircle;
+    using IBaseInterface::Draw_Segment;
+    using IBaseInterface::Draw_Transform;
+    using IBaseInterface::Draw_Point;
+
+private:
+    // The recorded call the agent makes next, nullptr (and diverged) if the agent made another call than recorded
+    const Trajectory::Call* NextCall(const Trajectory::Call& call) const;
+    void Diverge(const char* format, ...) const;
+
+    TrajectoryReader* m_pReader;
+    // The frame the observations come from, and the one whose calls come next: while a frame is played they are the same,
+    // between EndFrame and the next BeginFrame the calls already belong to the next frame
+    const TrajectoryFrame* m_pFrame = nullptr;
+    const TrajectoryFrame* m_pPending = nullptr;
+    mutable size_t m_NextCall = 0;
+    mutable std::string m_Divergence{};
+    FOVStats m_NoStats{};
+};
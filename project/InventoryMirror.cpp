@@ -0,0 +1,70 @@
+#include "stdafx.h"
+#include "InventoryMirror.h"
+#include "IExamInterface.h"
+
+InventoryMirror::InventoryMirror(IExamInterface *const pInterface):
+    m_pInterface(pInterface),
+    m_NumSlots(pInterface->Inventory_GetCapacity()),
+    m_AllSlotsMask(m_NumSlots >= MaxSlots ? ~0u : (1u << m_NumSlots) - 1)
+{
+    assert(m_NumSlots <= MaxSlots && "Inventory has more slots than the mirror's occupancy mask");
+    Sync();
+}
+
+bool InventoryMirror::AddItem(UINT slot, const ItemInfo &item)
+{
+    assert(slot < m_NumSlots && "Inventory slot out of range");
+    if (!m_pInterface->Inventory_AddItem(slot, item)) return false;
+    Store(slot, item);
+    return true;
+}
+
+bool InventoryMirror::UseItem(UINT slot)
+{
+    assert(slot < m_NumSlots && "Inventory slot out of range");
+    if (!m_pInterface->Inventory_UseItem(slot)) return false;
+    // How much a use takes off the value is up to the game, so the slot is read back instead of guessed
+    SyncSlot(slot);
+    return true;
+}
+
+bool InventoryMirror::RemoveItem(UINT slot)
+{
+    assert(slot < m_NumSlots && "Inventory slot out of range");
+    if (!m_pInterface->Inventory_RemoveItem(slot)) return false;
+    m_OccupiedMask &= ~(1u << slot);
+    return true;
+}
+
+void InventoryMirror::Sync()
+{
+    for (UINT slot{}; slot < m_NumSlots; ++slot) SyncSlot(slot);
+}
+
+void InventoryMirror::SyncSlot(UINT slot)
+{
+    ItemInfo item;
+    ++m_NumInterfaceReads;
+    if (m_pInterface->Inventory_GetItem(slot, item)) Store(slot, item);
+    else m_OccupiedMask &= ~(1u << slot);
+}
+
+bool InventoryMirror::Verify() const
+{
+    for (UINT slot{}; slot < m_NumSlots; ++slot)
+    {
+        ItemInfo item;
+        ++m_NumInterfaceReads;
+        const bool isOccupied = m_pInterface->Inventory_GetItem(slot, item);
+        if (isOccupied != IsOccupied(slot)) return false;
+        if (isOccupied && (item.Type != m_Types[slot] || item.Value != m_Values[slot])) return false;
+    }
+    return true;
+}
+
+void InventoryMirror::Store(UINT slot, const ItemInfo &item)
+{
+    m_OccupiedMask |= 1u << slot;
+    m_Types[slot] = item.Type;
+    m_Values[slot] = item.Value;
+}
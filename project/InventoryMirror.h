@@ -0,0 +1,65 @@
+#pragma once
+#include <array>
+#include <bit>
+#include <cstdint>
+#include "Exam_HelperStructs.h"
+
+class IExamInterface;
+
+// Local copy of the agent's inventory.
+// Every change the agent makes to its inventory goes through the mirror, which forwards it to the interface
+// and applies the same change to its own state: an occupancy bitmask plus the type and value of each slot.
+// Slot queries are bit operations on that state instead of Inventory_GetItem calls through the virtual interface.
+// The interface is only read again for the slot UseItem used, by Sync, after a change that bypassed the mirror,
+// and by Verify.
+class InventoryMirror final
+{
+public:
+    // One bit of the occupancy mask per slot
+    static constexpr UINT MaxSlots = 32;
+
+    // Takes the number of slots from Inventory_GetCapacity
+    explicit InventoryMirror(IExamInterface* pInterface);
+
+    // Same results as the Inventory_ functions of the interface, the mirror only changes if the interface did
+    bool AddItem(UINT slot, const ItemInfo& item);
+    bool UseItem(UINT slot);
+    bool RemoveItem(UINT slot);
+
+    [[nodiscard]] UINT GetNumSlots() const { return m_NumSlots; }
+    [[nodiscard]] uint32_t GetOccupiedMask() const { return m_OccupiedMask; }
+    [[nodiscard]] uint32_t GetEmptyMask() const { return ~m_OccupiedMask & m_AllSlotsMask; }
+    [[nodiscard]] bool IsOccupied(UINT slot) const { return m_OccupiedMask & (1u << slot); }
+    [[nodiscard]] bool IsEmpty(UINT slot) const { return !IsOccupied(slot); }
+    // Lowest empty slot, -1 if the inventory is full
+    [[nodiscard]] int GetFirstEmptySlot() const
+    {
+        const uint32_t emptyMask = GetEmptyMask();
+        return emptyMask ? std::countr_zero(emptyMask) : -1;
+    }
+    // Only meaningful for occupied slots
+    [[nodiscard]] eItemType GetType(UINT slot) const { return m_Types[slot]; }
+    // Ammo for weapons, health or energy for medkits and food
+    [[nodiscard]] int GetValue(UINT slot) const { return m_Values[slot]; }
+
+    // Reads every slot from the interface, for changes that did not go through the mirror
+    void Sync();
+    // True if every slot matches the interface, costs one interface call per slot
+    [[nodiscard]] bool Verify() const;
+
+    // Statistics: Inventory_GetItem calls made by UseItem, Sync and Verify
+    [[nodiscard]] size_t GetNumInterfaceReads() const { return m_NumInterfaceReads; }
+
+private:
+    void SyncSlot(UINT slot);
+    void Store(UINT slot, const ItemInfo& item);
+
+    IExamInterface* m_pInterface;
+    UINT m_NumSlots;
+    uint32_t m_AllSlotsMask;
+    uint32_t m_OccupiedMask = 0;
+    std::array<eItemType, MaxSlots> m_Types{};
+    std::array<int, MaxSlots> m_Values{};
+
+    mutable size_t m_NumInterfaceReads = 0;
+};
@@ -1,8 +1,8 @@
 #include "stdafx.h"
 #include "MapSearchSystem.h"
 #include "Exam_HelperStructs.h"
-#include "HouseInfoSet.h"
 #include "IExamInterface.h"
+#include "Profiler.h"
 
 MapSearchSystem::MapSearchSystem(const AgentInfo &agentInfo)
 {
@@ -13,7 +13,7 @@ MapSearchSystem::MapSearchSystem(const AgentInfo &agentInfo)
     {
         Elite::Vector2 target = Elite::Vector2(m_InnerSearchRadius * cosf(Elite::ToRadians(angle)),
                                                m_InnerSearchRadius * sinf(Elite::ToRadians(angle)));
-        m_InnerRadiusSearchTargets.emplace(target);
+        m_InnerRadiusSearchTargets.Insert(target);
     }
 
     // add outer radius search targets: in a radius of m_OuterSearchRadius with a center in (0,0) every m_OuterAngleStep degrees
@@ -21,30 +21,30 @@ MapSearchSystem::MapSearchSystem(const AgentInfo &agentInfo)
     {
         Elite::Vector2 target = Elite::Vector2(m_OuterSearchRadius * cosf(Elite::ToRadians(angle)),
                                                m_OuterSearchRadius * sinf(Elite::ToRadians(angle)));
-        m_OuterRadiusSearchTargets.emplace(target);
+        m_OuterRadiusSearchTargets.Insert(target);
     }
 }
 
 void MapSearchSystem::RenderDebug(IExamInterface *const pInterface) const
 {
     // m_pInterface->Draw_SolidCircle for all the search targets
-    for (const auto &target: m_InnerRadiusSearchTargets)
+    for (size_t i{}; i < m_InnerRadiusSearchTargets.Size(); ++i)
     {
-        pInterface->Draw_SolidCircle(target, 1.f, {0, 0}, {1, 0, 0});
+        pInterface->Draw_SolidCircle(m_InnerRadiusSearchTargets[i], 1.f, {0, 0}, {1, 0, 0});
     }
-    for (const auto &target: m_OuterRadiusSearchTargets)
+    for (size_t i{}; i < m_OuterRadiusSearchTargets.Size(); ++i)
     {
-        pInterface->Draw_SolidCircle(target, 1.f, {0, 0}, {0, 1, 0});
+        pInterface->Draw_SolidCircle(m_OuterRadiusSearchTargets[i], 1.f, {0, 0}, {0, 1, 0});
     }
-    for (const auto &target: m_VillageSearchTargets)
+    for (size_t i{}; i < m_VillageSearchTargets.Size(); ++i)
     {
-        pInterface->Draw_SolidCircle(target, 1.f, {0, 0}, {0, 0, 1});
+        pInterface->Draw_SolidCircle(m_VillageSearchTargets[i], 1.f, {0, 0}, {0, 0, 1});
     }
-    for (const auto &target: m_HouseSearchTargets)
+    for (size_t i{}; i < m_HouseSearchTargets.Size(); ++i)
     {
-        pInterface->Draw_SolidCircle(target, 1.f, {0, 0}, {1, 1, 0});
+        pInterface->Draw_SolidCircle(m_HouseSearchTargets[i], 1.f, {0, 0}, {1, 1, 0});
     }
-    for (const auto &house: m_FoundHouses)
+    for (const auto &house: m_FoundHouses.GetHouses())
     {
         const std::vector<Elite::Vector2> points = {
             {house.Center + Elite::Vector2(-house.Size.x * 0.5f, -house.Size.y * 0.5f)},
@@ -74,25 +74,49 @@ void MapSearchSystem::RenderDebug(IExamInterface *const pInterface) const
     }
 }
 
+void MapSearchSystem::EnablePathCostRanking(const WorldInfo &worldInfo)
+{
+    m_PathGrid.Reset(worldInfo, PathGridCellSize);
+    for (const HouseInfo &house: m_FoundHouses.GetHouses()) m_PathGrid.AddHouseWalls(house);
+}
+
+void MapSearchSystem::DisablePathCostRanking()
+{
+    m_PathGrid = {};
+}
+
+float MapSearchSystem::GetPathCost(const Elite::Vector2 &from, const Elite::Vector2 &to)
+{
+    if (m_PathGrid.IsEmpty()) return from.Distance(to);
+    EXAM_PROFILE_SCOPE("MapSearchSystem::GetPathCost");
+    return m_Pathfinder.GetPathCost(m_PathGrid, from, to);
+}
+
 bool MapSearchSystem::HasCheckedHouse(const HouseInfo &house) const
 {
-    return std::ranges::any_of(m_FoundHouses, [&house](const HouseInfo &h) { return h.Center == house.Center; });
+    return m_FoundHouses.Contains(house);
 }
 
 void MapSearchSystem::Update(float dt)
 {
+    EXAM_PROFILE_SCOPE("MapSearchSystem::Update");
+    m_PathSearchesLeft = MaxPathSearchesPerFrame;
     m_CurrTargetSearchTime += dt;
-    m_CurrTargetRefreshTime += dt;
     if (m_CurrTargetSearchTime >= m_TargetSearchInterval)
     {
         m_CurrentTarget.reset();
         m_CurrTargetSearchTime -= m_TargetSearchInterval;
     }
+#ifdef EXAM_VERIFY_SEARCH_TARGETS
+    // FoundHouse already keeps the targets out of the found houses, this only verifies it.
+    // Every target against every house, so only in builds that ask for it
+    m_CurrTargetRefreshTime += dt;
     if (m_CurrTargetRefreshTime >= m_TargetSearchInterval)
     {
-        CleanupObsoleteTargets();
+        assert(!HasObsoleteTargets() && "A search target lies inside a found house");
         m_CurrTargetRefreshTime -= m_TargetSearchInterval;
     }
+#endif
 }
 
 void MapSearchSystem::AddVillageSearchTargets(const HouseInfo &house)
@@ -106,10 +130,12 @@ void MapSearchSystem::AddVillageSearchTargets(const HouseInfo &house)
         const float halfWidth = house.Size.x * 0.5f;
         const float halfHeight = house.Size.y * 0.5f;
 
-        m_VillageSearchTargets.emplace(
+        const Elite::Vector2 target{
             house.Center.x + (halfWidth + offset) * sign.x,
             house.Center.y + (halfHeight + offset) * sign.y
-        );
+        };
+        // A corner can fall inside a neighbouring house that was found earlier
+        if (!IsPointInAnyFoundHouse(target)) m_VillageSearchTargets.Insert(target);
     }
 }
 
@@ -135,20 +161,22 @@ void MapSearchSystem::AddHouseSearchTargets(const HouseInfo &house)
         const float halfWidth = house.Size.x * 0.5f;
         const float halfHeight = house.Size.y * 0.5f;
 
-        m_HouseSearchTargets.emplace(
+        m_HouseSearchTargets.Insert({
             house.Center.x + (halfWidth + offset) * sign.x,
             house.Center.y + (halfHeight + offset) * sign.y
-        );
+        });
     }
 }
 
 void MapSearchSystem::FoundHouse(const HouseInfo &house)
 {
-    m_FoundHouses.emplace(house);
+    m_FoundHouses.Insert(house);
+    if (!m_PathGrid.IsEmpty()) m_PathGrid.AddHouseWalls(house);
+    RemoveTargetsInHouse(house);
     AddHouseSearchTargets(house);
 
     // The inner village is more spread, this is extra check to make sure we dont miss it
-    if ((m_InnerRadiusSearchTargets.empty() && m_VillageSearchTargets.empty()) || m_VillagesInfo.empty())
+    if ((m_InnerRadiusSearchTargets.Empty() && m_VillageSearchTargets.Empty()) || m_VillagesInfo.empty())
     {
         m_CurrVillageHousesCount = 0; // Reset the current village houses count
         m_VillagesInfo.push_back(house);
@@ -164,42 +192,31 @@ void MapSearchSystem::FoundHouse(const HouseInfo &house)
     if (m_CurrVillageHousesCount >= 4)
     {
         m_CurrVillageHousesCount = 0; // Reset for the next village
-        m_VillageSearchTargets.clear(); // Clear the village search targets for the next village
+        m_VillageSearchTargets.Clear(); // Clear the village search targets for the next village
     } else AddVillageSearchTargets(house);
 
-    if (m_VillagesInfo.size() >= 6 || m_FoundHouses.size() >= 20)
+    if (m_VillagesInfo.size() >= 6 || m_FoundHouses.Size() >= 20)
     {
         // we found all houses, no need to search anymore
-        m_InnerRadiusSearchTargets.clear();
-        m_OuterRadiusSearchTargets.clear();
+        m_InnerRadiusSearchTargets.Clear();
+        m_OuterRadiusSearchTargets.Clear();
     }
 }
 
 bool MapSearchSystem::IsDoneCheckingMap() const
 {
-    return m_OuterRadiusSearchTargets.empty() && m_InnerRadiusSearchTargets.empty();
+    return m_OuterRadiusSearchTargets.Empty() && m_InnerRadiusSearchTargets.Empty();
 }
 
 bool MapSearchSystem::GetClosestHouse(const Elite::Vector2 &agentPosition, HouseInfo &outTarget) const
 {
-    if (m_FoundHouses.empty())
-    {
-        return false; // No houses found
-    }
-    auto closestHouse = std::ranges::min_element(m_FoundHouses,
-                                                 [&agentPosition](const SetHouseInfo &a, const SetHouseInfo &b)
-                                                 {
-                                                     return (a.Center - agentPosition).MagnitudeSquared() < (
-                                                                b.Center - agentPosition).MagnitudeSquared();
-                                                 });
-
-    outTarget = *closestHouse;
-    return true;
+    // Returns false if no houses were found
+    return m_FoundHouses.FindClosest(agentPosition, outTarget);
 }
 
 bool MapSearchSystem::RemembersAnyHouses() const
 {
-    return !m_FoundHouses.empty();
+    return !m_FoundHouses.Empty();
 }
 
 bool MapSearchSystem::GetCurrentTarget(const Elite::Vector2 &agentPosition, Elite::Vector2 &outTarget)
@@ -225,9 +242,9 @@ bool MapSearchSystem::GetCurrentTarget(const Elite::Vector2 &agentPosition, Elit
         return true; // Found a target in the inner or outer radius
     }
     // If no targets found, we ll recheck all houses
-    for (const auto &house: m_FoundHouses)
+    for (const auto &house: m_FoundHouses.GetHouses())
     {
-        m_HouseSearchTargets.emplace(house.Center);
+        m_HouseSearchTargets.Insert(house.Center);
     }
     if (GetCurrentHouseExploreTarget(agentPosition, outTarget))
     {
@@ -240,41 +257,74 @@ bool MapSearchSystem::GetCurrentTarget(const Elite::Vector2 &agentPosition, Elit
 void MapSearchSystem::ReachedTarget(const Elite::Vector2 &target)
 {
     m_CurrentTarget.reset();
-    if (!m_HouseSearchTargets.empty()) m_HouseSearchTargets.erase(target);
-    else if (!m_VillageSearchTargets.empty()) m_VillageSearchTargets.erase(target);
-    else if (!m_InnerRadiusSearchTargets.empty()) m_InnerRadiusSearchTargets.erase(target);
-    else if (!m_OuterRadiusSearchTargets.empty()) m_OuterRadiusSearchTargets.erase(target);
+    if (!m_HouseSearchTargets.Empty()) m_HouseSearchTargets.Erase(target);
+    else if (!m_VillageSearchTargets.Empty()) m_VillageSearchTargets.Erase(target);
+    else if (!m_InnerRadiusSearchTargets.Empty()) m_InnerRadiusSearchTargets.Erase(target);
+    else if (!m_OuterRadiusSearchTargets.Empty()) m_OuterRadiusSearchTargets.Erase(target);
+}
+
+Elite::Vector2 MapSearchSystem::GetClosestPosFromVec(const Elite::Vector2 &agentPosition, const FlatPointSet &vec)
+{
+    Elite::Vector2 closest{};
+    if (m_PathGrid.IsEmpty())
+    {
+        vec.FindNearest(agentPosition, closest);
+        return closest;
+    }
+
+    // A path is never shorter than its lower bound, so once the next target's bound is no better than
+    // the best path found, none of the remaining targets can win
+    m_TargetOrder.clear();
+    for (uint32_t i{}; i < vec.Size(); ++i)
+        m_TargetOrder.emplace_back(GridPathfinder::GetCostLowerBound(m_PathGrid, agentPosition, vec[i]), i);
+    std::ranges::sort(m_TargetOrder);
+    // Out of searches for this frame, the best path found so far wins
+    float bestCost = GridPathfinder::NoPath;
+    for (const auto &[lowerBound, index]: m_TargetOrder)
+    {
+        if (lowerBound >= bestCost || m_PathSearchesLeft == 0) break;
+        --m_PathSearchesLeft;
+        const float cost = GetPathCost(agentPosition, vec[index]);
+        if (cost < bestCost)
+        {
+            bestCost = cost;
+            closest = vec[index];
+        }
+    }
+    // Walled off from every target searched, the closest one is still the best guess
+    if (bestCost == GridPathfinder::NoPath) vec.FindNearest(agentPosition, closest);
+    return closest;
 }
 
-Elite::Vector2 MapSearchSystem::GetClosestPosFromVec(const Elite::Vector2 &agentPosition,
-                                                     const std::set<Elite::Vector2> &vec)
+Elite::Vector2 MapSearchSystem::GetFirstTarget(const FlatPointSet &targets)
 {
-    if (vec.empty()) return {};
-    const auto it = std::ranges::min_element(vec, [&agentPosition](const Elite::Vector2 &a, const Elite::Vector2 &b)
+    if (targets.Empty()) return {};
+    Elite::Vector2 first = targets[0];
+    for (size_t i{1}; i < targets.Size(); ++i)
     {
-        return (a - agentPosition).MagnitudeSquared() < (b - agentPosition).MagnitudeSquared();
-    });
-    return (it != vec.end()) ? *it : Elite::Vector2{};
+        if (targets[i] < first) first = targets[i];
+    }
+    return first;
 }
 
-bool MapSearchSystem::GetCurrentExploreTarget(const Elite::Vector2 &agentPosition, Elite::Vector2 &outTarget) const
+bool MapSearchSystem::GetCurrentExploreTarget(const Elite::Vector2 &agentPosition, Elite::Vector2 &outTarget)
 {
-    if (m_InnerRadiusSearchTargets.empty() && m_OuterRadiusSearchTargets.empty())
+    if (m_InnerRadiusSearchTargets.Empty() && m_OuterRadiusSearchTargets.Empty())
     {
         return false; // No targets found
     }
 
     Elite::Vector2 closestTarget;
     // If inner radius targets are empty, use outer radius targets
-    if (m_InnerRadiusSearchTargets.empty())
+    if (m_InnerRadiusSearchTargets.Empty())
     {
-        if (agentPosition.x <= 5 && agentPosition.y <= 5) closestTarget = *m_OuterRadiusSearchTargets.begin();
+        if (agentPosition.x <= 5 && agentPosition.y <= 5) closestTarget = GetFirstTarget(m_OuterRadiusSearchTargets);
             // If the agent is at the origin, just return the first target
         else closestTarget = GetClosestPosFromVec(agentPosition, m_OuterRadiusSearchTargets);
     } else
     {
         // Use inner radius targets
-        if (agentPosition.x <= 5 && agentPosition.y <= 5) closestTarget = *m_InnerRadiusSearchTargets.begin();
+        if (agentPosition.x <= 5 && agentPosition.y <= 5) closestTarget = GetFirstTarget(m_InnerRadiusSearchTargets);
             // If the agent is at the origin, just return the first target
         else closestTarget = GetClosestPosFromVec(agentPosition, m_InnerRadiusSearchTargets);
     }
@@ -284,16 +334,16 @@ bool MapSearchSystem::GetCurrentExploreTarget(const Elite::Vector2 &agentPositio
 
 bool MapSearchSystem::GetCurrentHouseExploreTarget(const Elite::Vector2 &agentPosition, Elite::Vector2 &outTarget)
 {
-    if (m_HouseSearchTargets.empty()) return false;
+    if (m_HouseSearchTargets.Empty()) return false;
     outTarget = GetClosestPosFromVec(agentPosition, m_HouseSearchTargets);
     return true;
 }
 
 bool MapSearchSystem::GetCurrentVillageExploreTarget(const Elite::Vector2 &agentPosition, Elite::Vector2 &outTarget)
 {
-    if (m_VillageSearchTargets.empty()) return false;
+    if (m_VillageSearchTargets.Empty()) return false;
     outTarget = GetClosestPosFromVec(agentPosition, m_VillageSearchTargets);
-    if (m_VillageSearchTargets.empty()) m_CurrVillageHousesCount = 0;
+    if (m_VillageSearchTargets.Empty()) m_CurrVillageHousesCount = 0;
     // Reset the village houses count if we cleared the targets
     return true;
 }
@@ -301,38 +351,34 @@ bool MapSearchSystem::GetCurrentVillageExploreTarget(const Elite::Vector2 &agent
 
 void MapSearchSystem::RememberItemLocation(const ItemInfo &itemInfo)
 {
-    m_FoundItemLocationMap[itemInfo.Type].emplace(itemInfo.Location);
+    m_FoundItemLocationMap.try_emplace(itemInfo.Type, ItemGridCellSize).first->second.Insert(itemInfo.Location);
 }
 
 bool MapSearchSystem::GetItemClosestLocation(const Elite::Vector2 &agentPosition, const eItemType &itemType,
                                              Elite::Vector2 &outTarget) const
 {
-    if (!m_FoundItemLocationMap.contains(itemType) || m_FoundItemLocationMap.at(itemType).empty())
-    {
-        return false; // No locations found for this item type
-    }
-    const auto &locations = m_FoundItemLocationMap.at(itemType);
-    outTarget = GetClosestPosFromVec(agentPosition, locations);
-    return true;
+    const auto it = m_FoundItemLocationMap.find(itemType);
+    // Returns false if no locations were found for this item type
+    return it != m_FoundItemLocationMap.end() && it->second.FindNearest(agentPosition, outTarget);
 }
 
 void MapSearchSystem::PickedUpItem(const ItemInfo &itemInfo)
 {
-    m_FoundItemLocationMap[itemInfo.Type].erase(itemInfo.Location);
+    const auto it = m_FoundItemLocationMap.find(itemInfo.Type);
+    if (it != m_FoundItemLocationMap.end()) it->second.Erase(itemInfo.Location);
 }
 
 bool MapSearchSystem::RemembersItem(const ItemInfo &item) const
 {
-    if (!m_FoundItemLocationMap.contains(item.Type) || m_FoundItemLocationMap.at(item.Type).empty())
-    {
-        return false; // No locations found for this item type
-    }
-    return m_FoundItemLocationMap.at(item.Type).contains(item.Location); // Check if the item location is known
+    const auto it = m_FoundItemLocationMap.find(item.Type);
+    // Check if the item location is known
+    return it != m_FoundItemLocationMap.end() && it->second.Contains(item.Location);
 }
 
 bool MapSearchSystem::KnowsAnyItemLocation(const eItemType &itemType) const
 {
-    return m_FoundItemLocationMap.contains(itemType) && !m_FoundItemLocationMap.at(itemType).empty();
+    const auto it = m_FoundItemLocationMap.find(itemType);
+    return it != m_FoundItemLocationMap.end() && !it->second.Empty();
 }
 
 bool MapSearchSystem::IsPointInHouse(const Elite::Vector2 &point, const HouseInfo &house, float offset)
@@ -345,29 +391,36 @@ bool MapSearchSystem::IsPointInHouse(const Elite::Vector2 &point, const HouseInf
            point.y <= (house.Center.y + halfHeight);
 }
 
-// In MapSearchSystem.cpp
-
 bool MapSearchSystem::IsPointInAnyFoundHouse(const Elite::Vector2 &point) const
 {
-    return std::ranges::any_of(m_FoundHouses, [this, &point](const HouseInfo &house)
-    {
-        return IsPointInHouse(point, house, 4.f); // Using an offset of 4.f to avoid being too close to the house walls
-    });
+    // Using an offset to avoid being too close to the house walls
+    return m_FoundHouses.IsPointInAnyHouse(point, FoundHouseOffset);
 }
 
-void MapSearchSystem::CleanupObsoleteTargets()
+void MapSearchSystem::RemoveTargetsInHouse(const HouseInfo &house)
 {
-    auto removeIfInHouse = [this](std::set<Elite::Vector2> &targets)
+    auto removeIfInHouse = [&house](FlatPointSet &targets)
     {
-        for (auto it = targets.begin(); it != targets.end();)
+        targets.EraseIf([&house](const Elite::Vector2 &target)
         {
-            if (IsPointInAnyFoundHouse(*it))
-                it = targets.erase(it);
-            else
-                ++it;
-        }
+            return IsPointInHouse(target, house, FoundHouseOffset);
+        });
     };
     removeIfInHouse(m_VillageSearchTargets);
     removeIfInHouse(m_InnerRadiusSearchTargets);
     removeIfInHouse(m_OuterRadiusSearchTargets);
 }
+
+bool MapSearchSystem::HasObsoleteTargets() const
+{
+    auto anyInHouse = [this](const FlatPointSet &targets)
+    {
+        for (size_t i{}; i < targets.Size(); ++i)
+        {
+            if (IsPointInAnyFoundHouse(targets[i])) return true;
+        }
+        return false;
+    };
+    return anyInHouse(m_VillageSearchTargets) || anyInHouse(m_InnerRadiusSearchTargets) ||
+           anyInHouse(m_OuterRadiusSearchTargets);
+}
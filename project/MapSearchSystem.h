@@ -1,13 +1,15 @@
 #pragma once
 #include <map>
 #include <optional>
-#include <set>
+#include "FlatPointSet.h"
+#include "GridPathfinder.h"
+#include "SpatialHashGrid.h"
 
 class IExamInterface;
-struct SetHouseInfo;
 struct ItemInfo;
 struct AgentInfo;
 struct HouseInfo;
+struct WorldInfo;
 enum class eItemType;
 
 
@@ -17,12 +19,22 @@ public:
 
     void RenderDebug(IExamInterface* const pInterface) const;
 
+    // Off by default: lays the occupancy grid over the world, from then on targets are picked by path cost
+    // instead of distance. The house walls are guessed (GridPathfinder.h), so keep it opt-in until they can be
+    // checked against real wall and door data
+    void EnablePathCostRanking(const WorldInfo& worldInfo);
+    void DisablePathCostRanking();
+    [[nodiscard]] bool IsPathCostRankingEnabled() const { return !m_PathGrid.IsEmpty(); }
+    // Length of the shortest path around the walls of the found houses, the straight distance while ranking is off.
+    // GridPathfinder::NoPath if the walls close the way off
+    [[nodiscard]] float GetPathCost(const Elite::Vector2& from, const Elite::Vector2& to);
+
     // Returns true if the house has already been checked
     [[nodiscard]] bool HasCheckedHouse(const HouseInfo& house) const;
 
     void Update(float dt);
 
-    // Adds the house to the list and updates house search targets
+    // Adds the house to the list, updates house search targets and drops the targets the house covers
     void FoundHouse(const HouseInfo& house);
 
     [[nodiscard]] bool IsDoneCheckingMap() const;
@@ -48,12 +60,16 @@ private:
     void AddVillageSearchTargets(const HouseInfo &house);
     void AddHouseSearchTargets(const HouseInfo &house);
 
-    void CleanupObsoleteTargets();
+    // Erases the village, inner and outer targets that lie in the (just found) house
+    void RemoveTargetsInHouse(const HouseInfo &house);
+    // Debug check that no village, inner or outer target lies in any found house, run by Update in builds with
+    // EXAM_VERIFY_SEARCH_TARGETS
+    [[nodiscard]] bool HasObsoleteTargets() const;
 
     // Returns the closest location to the agent that has not been explored yet
     // This is for both inner and outer radius search targets
     // Returns true if a target was found
-    bool GetCurrentExploreTarget(const Elite::Vector2& agentPosition, Elite::Vector2& outTarget) const;
+    bool GetCurrentExploreTarget(const Elite::Vector2& agentPosition, Elite::Vector2& outTarget);
     // Returns the closest location to the agent that has not been explored yet
     // Returns true if a target was found
     bool GetCurrentHouseExploreTarget(const Elite::Vector2& agentPosition, Elite::Vector2& outTarget);
@@ -61,18 +77,38 @@ private:
     // Returns true if a target was found
     bool GetCurrentVillageExploreTarget(const Elite::Vector2& agentPosition, Elite::Vector2& outTarget);
 
-    static Elite::Vector2 GetClosestPosFromVec(const Elite::Vector2 &agentPosition,const std::set<Elite::Vector2> &vec);
+    // The target with the shortest path from the agent, searching the targets with the smallest lower bounds first
+    // within the frame's budget. The closest one while there is no grid or no searched target is reachable.
+    // Search targets are only a handful of points, a linear scan over them is cheaper than a spatial grid
+    Elite::Vector2 GetClosestPosFromVec(const Elite::Vector2 &agentPosition, const FlatPointSet &vec);
+    // The smallest target by Vector2::operator<, which is the one the targets used to start with
+    static Elite::Vector2 GetFirstTarget(const FlatPointSet &targets);
 
-    std::set<Elite::Vector2> m_InnerRadiusSearchTargets{};
-    std::set<Elite::Vector2> m_OuterRadiusSearchTargets{};
-    std::set<Elite::Vector2> m_VillageSearchTargets{};
-    std::set<Elite::Vector2> m_HouseSearchTargets{};
+    FlatPointSet m_InnerRadiusSearchTargets{};
+    FlatPointSet m_OuterRadiusSearchTargets{};
+    FlatPointSet m_VillageSearchTargets{};
+    FlatPointSet m_HouseSearchTargets{};
 
     // For debugging purposes
     std::vector<HouseInfo> m_VillagesInfo{};
 
-    std::map<eItemType, std::set<Elite::Vector2>> m_FoundItemLocationMap{};
-    std::set<SetHouseInfo> m_FoundHouses{};
+    // Remembered items and houses can grow into the thousands on big maps, so they are kept in spatial grids
+    static constexpr float ItemGridCellSize = 25.f;
+    static constexpr float HouseGridCellSize = 50.f;
+    // Offset used by IsPointInAnyFoundHouse
+    static constexpr float FoundHouseOffset = 4.f;
+    std::map<eItemType, PointHashGrid> m_FoundItemLocationMap{};
+    HouseHashGrid m_FoundHouses{HouseGridCellSize, FoundHouseOffset};
+    // Walls of the found houses over the world, empty while path cost ranking is off
+    static constexpr float PathGridCellSize = 2.f;
+    OccupancyGrid m_PathGrid{};
+    GridPathfinder m_Pathfinder{};
+    // A search floods the whole grid when its target is walled off, so a frame runs at most this many.
+    // Update hands out the budget, the GetClosestPosFromVec calls of the frame share it
+    static constexpr int MaxPathSearchesPerFrame = 4;
+    int m_PathSearchesLeft = MaxPathSearchesPerFrame;
+    // Search targets in the order GetClosestPosFromVec tries them, kept to reuse its capacity
+    std::vector<std::pair<float, uint32_t>> m_TargetOrder{};
     // how many houses have been found in the current village
     int m_CurrVillageHousesCount = 0;
 
@@ -0,0 +1,75 @@
+#include "stdafx.h"
+#include "PathPointCache.h"
+#include "IExamInterface.h"
+
+PathPointCache::PathPointCache(float cellSize):
+    m_InvCellSize(1.f / cellSize),
+    m_CellSizeSquared(cellSize * cellSize)
+{
+    assert(cellSize > 0.f && "The cells need a size");
+}
+
+Elite::Vector2 PathPointCache::GetClosestPathPoint(const IExamInterface *const pInterface, const Elite::Vector2 &agentPos,
+                                                   const Elite::Vector2 &goal)
+{
+    if (!m_IsEnabled)
+    {
+        ++m_NumMisses;
+        return pInterface->NavMesh_GetClosestPathPoint(goal);
+    }
+
+    // Empty entries were used last at 0, so they are the first to be taken
+    const Key key = MakeKey(agentPos, goal);
+    Entry *pEntry = nullptr;
+    Entry *pLeastRecent = &m_Entries[0];
+    for (Entry &entry: m_Entries)
+    {
+        if (entry.LastUse != 0 && entry.CellKey == key)
+        {
+            pEntry = &entry;
+            break;
+        }
+        if (entry.LastUse < pLeastRecent->LastUse) pLeastRecent = &entry;
+    }
+    ++m_UseCount;
+
+    // A path point the agent is about to reach was asked for from further back in the cell,
+    // the path may turn there, so the interface is asked for the next one
+    if (pEntry && pEntry->Goal == goal
+        && (pEntry->PathPoint == goal || pEntry->PathPoint.DistanceSquared(agentPos) > m_CellSizeSquared))
+    {
+        ++m_NumHits;
+        pEntry->LastUse = m_UseCount;
+        return pEntry->PathPoint;
+    }
+
+    ++m_NumMisses;
+    if (!pEntry)
+    {
+        if (pLeastRecent->LastUse != 0) ++m_NumEvictions;
+        pEntry = pLeastRecent;
+        pEntry->CellKey = key;
+    }
+    pEntry->Goal = goal;
+    pEntry->PathPoint = pInterface->NavMesh_GetClosestPathPoint(goal);
+    pEntry->LastUse = m_UseCount;
+    return pEntry->PathPoint;
+}
+
+void PathPointCache::SetEnabled(bool enabled)
+{
+    m_IsEnabled = enabled;
+    Clear();
+}
+
+void PathPointCache::Clear()
+{
+    m_Entries.fill({});
+    m_UseCount = 0;
+}
+
+PathPointCache::Key PathPointCache::MakeKey(const Elite::Vector2 &agentPos, const Elite::Vector2 &goal) const
+{
+    const auto cell = [this](float coordinate) { return static_cast<int32_t>(std::floor(coordinate * m_InvCellSize)); };
+    return {cell(agentPos.x), cell(agentPos.y), cell(goal.x), cell(goal.y)};
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include "EliteMath/EMath.h"
+
+class IExamInterface;
+
+// Remembers the answers of NavMesh_GetClosestPathPoint, so a seek towards the same goal doesn't ask the
+// interface again every tick. Entries are keyed on the grid cells of the agent and of the goal: crossing
+// a cell boundary looks up another entry, and a goal that moved within its cell refreshes the entry.
+// The least recently used entry makes room when the cache is full.
+class PathPointCache final
+{
+public:
+    static constexpr float DefaultCellSize = 4.f;
+    static constexpr size_t Capacity = 32;
+
+    explicit PathPointCache(float cellSize = DefaultCellSize);
+
+    // The next point on the navmesh path from the agent to goal, the interface is only asked on a miss
+    [[nodiscard]] Elite::Vector2 GetClosestPathPoint(const IExamInterface* pInterface, const Elite::Vector2& agentPos,
+                                                     const Elite::Vector2& goal);
+
+    // A disabled cache asks the interface on every call, and counts every call as a miss
+    void SetEnabled(bool enabled);
+    [[nodiscard]] bool IsEnabled() const { return m_IsEnabled; }
+    void Clear();
+
+    // Statistics: every miss was a call to the interface
+    [[nodiscard]] size_t GetNumHits() const { return m_NumHits; }
+    [[nodiscard]] size_t GetNumMisses() const { return m_NumMisses; }
+    [[nodiscard]] size_t GetNumEvictions() const { return m_NumEvictions; }
+
+private:
+    struct Key
+    {
+        int32_t AgentX, AgentY, GoalX, GoalY;
+        bool operator==(const Key&) const = default;
+    };
+    struct Entry
+    {
+        Key CellKey;
+        Elite::Vector2 Goal;
+        Elite::Vector2 PathPoint;
+        // Value of m_UseCount when the entry was last used, 0 for an empty entry
+        uint64_t LastUse;
+    };
+
+    [[nodiscard]] Key MakeKey(const Elite::Vector2& agentPos, const Elite::Vector2& goal) const;
+
+    float m_InvCellSize;
+    float m_CellSizeSquared;
+    bool m_IsEnabled = true;
+    // Few entries, looked up with a linear scan over one contiguous array
+    std::array<Entry, Capacity> m_Entries{};
+    uint64_t m_UseCount = 0;
+
+    size_t m_NumHits = 0;
+    size_t m_NumMisses = 0;
+    size_t m_NumEvictions = 0;
+};
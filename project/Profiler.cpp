@@ -0,0 +1,193 @@
+#include "stdafx.h"
+#include "Profiler.h"
+#include <atomic>
+#include <bit>
+#include <mutex>
+#include <unordered_map>
+
+namespace
+{
+    // Written by its own thread only. NumWritten is published after the event, an export reads it first
+    struct ThreadBuffer
+    {
+        std::unique_ptr<Profiler::Event[]> pEvents;
+        size_t Mask;
+        uint32_t ThreadIndex;
+        std::atomic<uint64_t> NumWritten{0};
+    };
+
+    struct BufferRegistry
+    {
+        std::mutex Mutex{};
+        std::vector<std::unique_ptr<ThreadBuffer>> Buffers{};
+        size_t Capacity = size_t{1} << 18;
+        // The exports measure the tick rate against steady_clock from here
+        uint64_t EpochTicks = Profiler::Now();
+        std::chrono::steady_clock::time_point EpochTime = std::chrono::steady_clock::now();
+    };
+
+    BufferRegistry& GetRegistry()
+    {
+        static BufferRegistry registry{};
+        return registry;
+    }
+
+    // Constructed during static initialization, so the epoch is older than any scope
+    [[maybe_unused]] const BufferRegistry& g_Registry = GetRegistry();
+
+    ThreadBuffer& GetThreadBuffer()
+    {
+        // The registry keeps the buffer alive after its thread ended, so an export still sees the events
+        thread_local ThreadBuffer* pBuffer = nullptr;
+        if (pBuffer == nullptr)
+        {
+            BufferRegistry& registry = GetRegistry();
+            std::lock_guard lock{registry.Mutex};
+            auto buffer = std::make_unique<ThreadBuffer>();
+            buffer->pEvents = std::make_unique_for_overwrite<Profiler::Event[]>(registry.Capacity);
+            buffer->Mask = registry.Capacity - 1;
+            buffer->ThreadIndex = static_cast<uint32_t>(registry.Buffers.size());
+            pBuffer = buffer.get();
+            registry.Buffers.push_back(std::move(buffer));
+        }
+        return *pBuffer;
+    }
+
+    // The events still in the buffer, oldest first
+    std::vector<Profiler::Event> ReadEvents(const ThreadBuffer& buffer)
+    {
+        const uint64_t numWritten = buffer.NumWritten.load(std::memory_order_acquire);
+        const uint64_t capacity = buffer.Mask + 1;
+        const uint64_t first = numWritten > capacity ? numWritten - capacity : 0;
+        std::vector<Profiler::Event> events{};
+        events.reserve(static_cast<size_t>(numWritten - first));
+        for (uint64_t i{first}; i < numWritten; ++i) events.push_back(buffer.pEvents[i & buffer.Mask]);
+        return events;
+    }
+
+    double Percentile(const std::vector<uint64_t>& sorted, double p)
+    {
+        const size_t idx = static_cast<size_t>(p * static_cast<double>(sorted.size() - 1) + 0.5);
+        return static_cast<double>(sorted[idx]);
+    }
+}
+
+void Profiler::Record(const char* pName, uint64_t start, uint64_t end)
+{
+    ThreadBuffer& buffer = GetThreadBuffer();
+    const uint64_t idx = buffer.NumWritten.load(std::memory_order_relaxed);
+    buffer.pEvents[idx & buffer.Mask] = {pName, start, end};
+    buffer.NumWritten.store(idx + 1, std::memory_order_release);
+}
+
+double Profiler::GetNanosecondsPerTick()
+{
+    // Measured over the time since the epoch, so the longer the run the more exact
+#ifdef EXAM_PROFILER_RDTSC
+    const BufferRegistry& registry = GetRegistry();
+    const uint64_t ticks = Now() - registry.EpochTicks;
+    const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - registry.EpochTime).count();
+    return ticks > 0 ? ns / static_cast<double>(ticks) : 0.0;
+#else
+    return 1.0;
+#endif
+}
+
+void Profiler::SetBufferCapacity(size_t numEvents)
+{
+    BufferRegistry& registry = GetRegistry();
+    std::lock_guard lock{registry.Mutex};
+    registry.Capacity = std::bit_ceil(std::max(numEvents, size_t{1}));
+}
+
+void Profiler::Clear()
+{
+    BufferRegistry& registry = GetRegistry();
+    std::lock_guard lock{registry.Mutex};
+    for (const auto& buffer: registry.Buffers) buffer->NumWritten.store(0, std::memory_order_relaxed);
+}
+
+size_t Profiler::GetNumEvents()
+{
+    BufferRegistry& registry = GetRegistry();
+    std::lock_guard lock{registry.Mutex};
+    size_t numEvents{};
+    for (const auto& buffer: registry.Buffers)
+        numEvents += static_cast<size_t>(std::min<uint64_t>(buffer->NumWritten.load(std::memory_order_acquire), buffer->Mask + 1));
+    return numEvents;
+}
+
+bool Profiler::WriteChromeTrace(const std::string& path)
+{
+    FILE* pFile = fopen(path.c_str(), "w");
+    if (pFile == nullptr) return false;
+
+    BufferRegistry& registry = GetRegistry();
+    std::lock_guard lock{registry.Mutex};
+    const double usPerTick = GetNanosecondsPerTick() * 1e-3;
+    fprintf(pFile, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+    bool isFirst = true;
+    for (const auto& buffer: registry.Buffers)
+    {
+        for (const Event& event: ReadEvents(*buffer))
+        {
+            // Complete events in microseconds, the scope names are identifiers and need no escaping
+            fprintf(pFile, "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                    isFirst ? "" : ",", event.pName, buffer->ThreadIndex,
+                    static_cast<double>(event.Start - registry.EpochTicks) * usPerTick,
+                    static_cast<double>(event.End - event.Start) * usPerTick);
+            isFirst = false;
+        }
+    }
+    fprintf(pFile, "\n]}\n");
+    return fclose(pFile) == 0;
+}
+
+bool Profiler::WriteSummary(const std::string& path)
+{
+    FILE* pFile = fopen(path.c_str(), "w");
+    if (pFile == nullptr) return false;
+
+    // Grouped by name, equal literals of different translation units don't have to share a pointer
+    std::unordered_map<std::string, std::vector<uint64_t>> durations{};
+    double usPerTick{};
+    {
+        BufferRegistry& registry = GetRegistry();
+        std::lock_guard lock{registry.Mutex};
+        usPerTick = GetNanosecondsPerTick() * 1e-3;
+        for (const auto& buffer: registry.Buffers)
+        {
+            for (const Event& event: ReadEvents(*buffer)) durations[event.pName].push_back(event.End - event.Start);
+        }
+    }
+
+    struct Row
+    {
+        std::string Name;
+        std::vector<uint64_t> Durations;
+        uint64_t Total;
+    };
+    std::vector<Row> rows{};
+    rows.reserve(durations.size());
+    for (auto& [name, scopeDurations]: durations)
+    {
+        std::ranges::sort(scopeDurations);
+        uint64_t total{};
+        for (const uint64_t duration: scopeDurations) total += duration;
+        rows.push_back({name, std::move(scopeDurations), total});
+    }
+    std::ranges::sort(rows, [](const Row& a, const Row& b) { return a.Total > b.Total; });
+
+    const double msPerTick = usPerTick * 1e-3;
+    fprintf(pFile, "%-48s %10s %12s %10s %10s %10s %10s %10s\n", "scope", "calls", "total ms", "mean us", "p50 us",
+            "p90 us", "p99 us", "max us");
+    for (const Row& row: rows)
+    {
+        const double numCalls = static_cast<double>(row.Durations.size());
+        fprintf(pFile, "%-48s %10zu %12.3f %10.3f %10.3f %10.3f %10.3f %10.3f\n", row.Name.c_str(), row.Durations.size(),
+                static_cast<double>(row.Total) * msPerTick, static_cast<double>(row.Total) * usPerTick / numCalls,
+                Percentile(row.Durations, 0.5) * usPerTick, Percentile(row.Durations, 0.9) * usPerTick,
+                Percentile(row.Durations, 0.99) * usPerTick, static_cast<double>(row.Durations.back()) * usPerTick);
+    }
+    return fclose(pFile) == 0;
+}
@@ -0,0 +1,90 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <string>
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#define EXAM_PROFILER_RDTSC
+#endif
+
+// Frame profiler for the hot path of UpdateSteering.
+// EXAM_PROFILE_SCOPE("Name") times the rest of the enclosing scope and writes one event into a ring buffer
+// owned by the calling thread: no lock, no allocation and no shared cache line on the hot path.
+// When the buffer is full the oldest events are overwritten, so the exports cover the last events recorded.
+// The scopes only exist when the build defines EXAM_PROFILER (CMake option EXAM_ENABLE_PROFILER),
+// otherwise the macros expand to nothing and the instrumented code compiles exactly as before.
+class Profiler final
+{
+public:
+    struct Event
+    {
+        // Has to be a string literal or outlive the export, only the pointer is stored
+        const char* pName;
+        // Ticks of Profiler::Now, the exports convert them to nanoseconds
+        uint64_t Start;
+        uint64_t End;
+    };
+
+    static constexpr bool IsCompiledIn()
+    {
+#ifdef EXAM_PROFILER
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    // The time stamp counter on x86, a few cycles instead of a clock call. Nanoseconds of steady_clock elsewhere
+    [[nodiscard]] static uint64_t Now()
+    {
+#ifdef EXAM_PROFILER_RDTSC
+        return __rdtsc();
+#else
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+    static void Record(const char* pName, uint64_t start, uint64_t end);
+
+    // Events per thread buffer, rounded up to a power of two. Only affects threads that record their first event later
+    static void SetBufferCapacity(size_t numEvents);
+    // Drops every recorded event, must not run while other threads record
+    static void Clear();
+
+    // The exports read the buffers of every thread and must not run while other threads record.
+    // Chrome trace JSON, open it in chrome://tracing or ui.perfetto.dev
+    static bool WriteChromeTrace(const std::string& path);
+    // Calls, total time and latency percentiles per scope name, the most expensive scope first
+    static bool WriteSummary(const std::string& path);
+    [[nodiscard]] static size_t GetNumEvents();
+    // Converts Now differences, measured against steady_clock since static initialization
+    [[nodiscard]] static double GetNanosecondsPerTick();
+};
+
+// Times its own lifetime
+class ProfileScope final
+{
+public:
+    explicit ProfileScope(const char* pName): m_pName(pName), m_Start(Profiler::Now()) {}
+    ~ProfileScope() { Profiler::Record(m_pName, m_Start, Profiler::Now()); }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    const char* m_pName;
+    uint64_t m_Start;
+};
+
+#define EXAM_PROFILE_CONCAT_IMPL(a, b) a##b
+#define EXAM_PROFILE_CONCAT(a, b) EXAM_PROFILE_CONCAT_IMPL(a, b)
+#ifdef EXAM_PROFILER
+#define EXAM_PROFILE_SCOPE(name) const ProfileScope EXAM_PROFILE_CONCAT(profileScope, __LINE__){name}
+#else
+#define EXAM_PROFILE_SCOPE(name) ((void)0)
+#endif
@@ -0,0 +1,214 @@
+#include "stdafx.h"
+#include "SpatialHashGrid.h"
+
+namespace
+{
+    uint64_t PackCell(int x, int y)
+    {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+    }
+}
+
+#pragma region PointHashGrid
+PointHashGrid::PointHashGrid(float cellSize): m_CellSize(cellSize), m_InvCellSize(1.f / cellSize)
+{
+}
+
+bool PointHashGrid::Insert(const Elite::Vector2 &point)
+{
+    const CellCoord cell = GetCell(point);
+    std::vector<Elite::Vector2> &points = m_Cells[GetKey(cell.X, cell.Y)];
+    if (std::ranges::find(points, point) != points.end()) return false;
+    points.push_back(point);
+
+    if (m_NumPoints == 0) m_MinCell = m_MaxCell = cell;
+    m_MinCell = {std::min(m_MinCell.X, cell.X), std::min(m_MinCell.Y, cell.Y)};
+    m_MaxCell = {std::max(m_MaxCell.X, cell.X), std::max(m_MaxCell.Y, cell.Y)};
+    ++m_NumPoints;
+    return true;
+}
+
+bool PointHashGrid::Erase(const Elite::Vector2 &point)
+{
+    const CellCoord cell = GetCell(point);
+    const auto cellIt = m_Cells.find(GetKey(cell.X, cell.Y));
+    if (cellIt == m_Cells.end()) return false;
+
+    std::vector<Elite::Vector2> &points = cellIt->second;
+    const auto it = std::ranges::find(points, point);
+    if (it == points.end()) return false;
+    // Order inside a cell does not matter
+    *it = points.back();
+    points.pop_back();
+    if (points.empty()) m_Cells.erase(cellIt);
+    --m_NumPoints;
+    return true;
+}
+
+bool PointHashGrid::Contains(const Elite::Vector2 &point) const
+{
+    const CellCoord cell = GetCell(point);
+    const auto cellIt = m_Cells.find(GetKey(cell.X, cell.Y));
+    return cellIt != m_Cells.end() && std::ranges::find(cellIt->second, point) != cellIt->second.end();
+}
+
+bool PointHashGrid::FindNearest(const Elite::Vector2 &position, Elite::Vector2 &outPoint) const
+{
+    if (m_NumPoints == 0) return false;
+
+    float bestDistSqr = FLT_MAX;
+    const CellCoord center = GetCell(position);
+    const int maxRing = std::max({
+        abs(center.X - m_MinCell.X), abs(center.X - m_MaxCell.X),
+        abs(center.Y - m_MinCell.Y), abs(center.Y - m_MaxCell.Y)
+    });
+
+    // Distance from the position to the border of its own cell, every cell of ring r is at least
+    // (r - 1) cells + this far away
+    const float cellMinX = static_cast<float>(center.X) * m_CellSize;
+    const float cellMinY = static_cast<float>(center.Y) * m_CellSize;
+    const float borderDist = std::min({
+        position.x - cellMinX, cellMinX + m_CellSize - position.x,
+        position.y - cellMinY, cellMinY + m_CellSize - position.y
+    });
+
+    VisitCell(center.X, center.Y, position, bestDistSqr, outPoint);
+    size_t numLookups{1};
+    for (int ring{1}; ring <= maxRing; ++ring)
+    {
+        const float ringDist = static_cast<float>(ring - 1) * m_CellSize + borderDist;
+        if (bestDistSqr <= ringDist * ringDist) break;
+
+        // Far away from a sparse grid walking the rings costs more than looking at every stored point
+        numLookups += 8 * static_cast<size_t>(ring);
+        if (numLookups > m_Cells.size() / 2)
+        {
+            for (const auto &cell: m_Cells) VisitPoints(cell.second, position, bestDistSqr, outPoint);
+            break;
+        }
+
+        for (int x{center.X - ring}; x <= center.X + ring; ++x)
+        {
+            VisitCell(x, center.Y - ring, position, bestDistSqr, outPoint);
+            VisitCell(x, center.Y + ring, position, bestDistSqr, outPoint);
+        }
+        for (int y{center.Y - ring + 1}; y <= center.Y + ring - 1; ++y)
+        {
+            VisitCell(center.X - ring, y, position, bestDistSqr, outPoint);
+            VisitCell(center.X + ring, y, position, bestDistSqr, outPoint);
+        }
+    }
+    return true;
+}
+
+void PointHashGrid::Clear()
+{
+    m_Cells.clear();
+    m_NumPoints = 0;
+    m_MinCell = m_MaxCell = {};
+}
+
+PointHashGrid::CellCoord PointHashGrid::GetCell(const Elite::Vector2 &point) const
+{
+    return {static_cast<int>(floorf(point.x * m_InvCellSize)), static_cast<int>(floorf(point.y * m_InvCellSize))};
+}
+
+uint64_t PointHashGrid::GetKey(int x, int y)
+{
+    return PackCell(x, y);
+}
+
+void PointHashGrid::VisitCell(int x, int y, const Elite::Vector2 &position, float &bestDistSqr,
+                              Elite::Vector2 &outPoint) const
+{
+    const auto cellIt = m_Cells.find(GetKey(x, y));
+    if (cellIt != m_Cells.end()) VisitPoints(cellIt->second, position, bestDistSqr, outPoint);
+}
+
+void PointHashGrid::VisitPoints(const std::vector<Elite::Vector2> &points, const Elite::Vector2 &position,
+                                float &bestDistSqr, Elite::Vector2 &outPoint)
+{
+    const size_t idx = Elite::FindNearestPoint(points.data(), points.size(), position);
+    if (idx == Elite::NearestPointNone) return;
+    const float distSqr = position.DistanceSquared(points[idx]);
+    if (distSqr < bestDistSqr)
+    {
+        bestDistSqr = distSqr;
+        outPoint = points[idx];
+    }
+}
+#pragma endregion
+
+#pragma region HouseHashGrid
+HouseHashGrid::HouseHashGrid(float cellSize, float maxOffset):
+    m_InvCellSize(1.f / cellSize), m_MaxOffset(maxOffset), m_Centers(cellSize)
+{
+}
+
+bool HouseHashGrid::Insert(const HouseInfo &house)
+{
+    if (!m_Centers.Insert(house.Center)) return false;
+
+    const uint32_t index = static_cast<uint32_t>(m_Houses.size());
+    m_Houses.push_back(house);
+
+    const float halfWidth = house.Size.x * 0.5f + m_MaxOffset;
+    const float halfHeight = house.Size.y * 0.5f + m_MaxOffset;
+    const int minX = ToCell(house.Center.x - halfWidth);
+    const int maxX = ToCell(house.Center.x + halfWidth);
+    const int minY = ToCell(house.Center.y - halfHeight);
+    const int maxY = ToCell(house.Center.y + halfHeight);
+    for (int x{minX}; x <= maxX; ++x)
+        for (int y{minY}; y <= maxY; ++y)
+            m_Cells[GetKey(x, y)].push_back(index);
+    return true;
+}
+
+bool HouseHashGrid::Contains(const HouseInfo &house) const
+{
+    return m_Centers.Contains(house.Center);
+}
+
+bool HouseHashGrid::IsPointInAnyHouse(const Elite::Vector2 &point, float offset) const
+{
+    assert(offset <= m_MaxOffset && "Offset is bigger than the margin the houses were indexed with");
+    const auto cellIt = m_Cells.find(GetKey(ToCell(point.x), ToCell(point.y)));
+    if (cellIt == m_Cells.end()) return false;
+    return std::ranges::any_of(cellIt->second, [this, &point, offset](uint32_t index)
+    {
+        const HouseInfo &house = m_Houses[index];
+        const float halfWidth = house.Size.x * 0.5f + offset;
+        const float halfHeight = house.Size.y * 0.5f + offset;
+        return point.x >= (house.Center.x - halfWidth) &&
+               point.x <= (house.Center.x + halfWidth) &&
+               point.y >= (house.Center.y - halfHeight) &&
+               point.y <= (house.Center.y + halfHeight);
+    });
+}
+
+bool HouseHashGrid::FindClosest(const Elite::Vector2 &position, HouseInfo &outHouse) const
+{
+    Elite::Vector2 center;
+    if (!m_Centers.FindNearest(position, center)) return false;
+
+    // A house is always indexed in the cell of its own center
+    const std::vector<uint32_t> &indices = m_Cells.at(GetKey(ToCell(center.x), ToCell(center.y)));
+    const auto it = std::ranges::find_if(indices, [this, &center](uint32_t index)
+    {
+        return m_Houses[index].Center == center;
+    });
+    assert(it != indices.end() && "House center is not indexed in its own cell");
+    outHouse = m_Houses[*it];
+    return true;
+}
+
+int HouseHashGrid::ToCell(float value) const
+{
+    return static_cast<int>(floorf(value * m_InvCellSize));
+}
+
+uint64_t HouseHashGrid::GetKey(int x, int y)
+{
+    return PackCell(x, y);
+}
+#pragma endregion
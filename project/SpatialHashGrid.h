@@ -0,0 +1,87 @@
+#pragma once
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "Exam_HelperStructs.h"
+
+// Uniform grid over the (unbounded) world, cells are only allocated when something is stored in them.
+// Used by MapSearchSystem so nearest/contains queries only look at the cells around the query point
+// instead of scanning everything it remembers.
+class PointHashGrid final
+{
+public:
+    explicit PointHashGrid(float cellSize);
+
+    // Returns false if an equal point (Vector2::operator==) is already stored
+    bool Insert(const Elite::Vector2& point);
+    // Returns false if the point was not stored
+    bool Erase(const Elite::Vector2& point);
+    [[nodiscard]] bool Contains(const Elite::Vector2& point) const;
+    // Returns true if a point was found
+    bool FindNearest(const Elite::Vector2& position, Elite::Vector2& outPoint) const;
+
+    void Clear();
+    [[nodiscard]] size_t Size() const { return m_NumPoints; }
+    [[nodiscard]] bool Empty() const { return m_NumPoints == 0; }
+
+    template<typename Fn>
+    void ForEach(Fn&& fn) const
+    {
+        for (const auto& cell: m_Cells)
+            for (const Elite::Vector2& point: cell.second) fn(point);
+    }
+
+private:
+    struct CellCoord
+    {
+        int X;
+        int Y;
+    };
+
+    [[nodiscard]] CellCoord GetCell(const Elite::Vector2& point) const;
+    [[nodiscard]] static uint64_t GetKey(int x, int y);
+    // Checks the points of one cell against the current best, does nothing if the cell is empty
+    void VisitCell(int x, int y, const Elite::Vector2& position, float& bestDistSqr, Elite::Vector2& outPoint) const;
+    static void VisitPoints(const std::vector<Elite::Vector2>& points, const Elite::Vector2& position,
+                            float& bestDistSqr, Elite::Vector2& outPoint);
+
+    const float m_CellSize;
+    const float m_InvCellSize;
+    std::unordered_map<uint64_t, std::vector<Elite::Vector2>> m_Cells{};
+    size_t m_NumPoints = 0;
+
+    // Bounds of every cell that has ever been used since the last Clear, limits the ring search
+    CellCoord m_MinCell{};
+    CellCoord m_MaxCell{};
+};
+
+// Houses indexed into every cell their rectangle (grown by a margin) overlaps,
+// so a point-in-house test only checks the houses of a single cell.
+class HouseHashGrid final
+{
+public:
+    // maxOffset is the biggest offset IsPointInAnyHouse will be called with
+    HouseHashGrid(float cellSize, float maxOffset);
+
+    // Returns false if a house with the same center is already stored
+    bool Insert(const HouseInfo& house);
+    [[nodiscard]] bool Contains(const HouseInfo& house) const;
+    [[nodiscard]] bool IsPointInAnyHouse(const Elite::Vector2& point, float offset = 0.f) const;
+    // Closest house by center, returns true if a house was found
+    bool FindClosest(const Elite::Vector2& position, HouseInfo& outHouse) const;
+
+    [[nodiscard]] const std::vector<HouseInfo>& GetHouses() const { return m_Houses; }
+    [[nodiscard]] size_t Size() const { return m_Houses.size(); }
+    [[nodiscard]] bool Empty() const { return m_Houses.empty(); }
+
+private:
+    [[nodiscard]] int ToCell(float value) const;
+    [[nodiscard]] static uint64_t GetKey(int x, int y);
+
+    const float m_InvCellSize;
+    const float m_MaxOffset;
+    std::vector<HouseInfo> m_Houses{};
+    // Indices into m_Houses
+    std::unordered_map<uint64_t, std::vector<uint32_t>> m_Cells{};
+    PointHashGrid m_Centers;
+};
@@ -0,0 +1,8 @@
+#pragma once
+#include "StaticSteering.h"
+
+// The Agent's steering pipeline. Slot i of the priority is the SteeringBehaviorType with value i, the same
+// order as AgentIndexMaps::SteeringSlot
+using SeekAndWanderSteering = Blended<Weighted<Seek, 0.8f>, Weighted<Wander, 0.2f>>;
+using SeekAndEvadeSteering = Blended<Weighted<Seek, 0.4f>, Weighted<Evade, 0.6f>>;
+using AgentSteering = Priority<SeekAndWanderSteering, Seek, FleeWhileFacing, Face, Wander, SeekAndEvadeSteering>;
@@ -1,5 +1,6 @@
 #include "../stdafx.h"
 #include "CombinedSteeringBehaviors.h"
+#include "../Profiler.h"
 
 BlendedSteering::BlendedSteering(const std::vector<WeightedBehavior> &weightedBehaviors)
     : m_WeightedBehaviors(weightedBehaviors)
@@ -76,6 +77,7 @@ SteeringOutput BlendedSteering::CalculateSteering(const AgentInfo &agent)
 //PRIORITY STEERING
 SteeringOutput PrioritySteering::CalculateSteering(const AgentInfo &agent)
 {
+    EXAM_PROFILE_SCOPE("PrioritySteering::CalculateSteering");
     assert((m_ValidIdx < m_PriorityBehaviors.size() && m_ValidIdx >=0) && "Idx invalid for steering! - priority steering");
 
     SteeringOutput steering = {};
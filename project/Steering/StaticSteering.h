@@ -0,0 +1,189 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <tuple>
+#include <utility>
+#include "SteeringBehaviors.h"
+#include "../Profiler.h"
+
+// Compile-time counterparts of BlendedSteering and PrioritySteering.
+// The composition is part of the type, e.g. Blended<Weighted<Seek, 0.4f>, Weighted<Evade, 0.6f>>, so every
+// child is called directly instead of through ISteeringBehavior, the whole evaluation can inline and the weights
+// are constants. Like the virtual composites they only refer to their children, one behavior can be shared
+// by several composites and keeps its target and running state across them.
+
+namespace StaticSteering
+{
+    // Non-virtual call, also for the ISteeringBehavior leaves
+    template<typename Behavior>
+    SteeringOutput Calculate(Behavior &behavior, const AgentInfo &agent)
+    {
+        return behavior.Behavior::CalculateSteering(agent);
+    }
+}
+
+//****************
+//WEIGHTED
+template<typename TBehavior, float TWeight>
+struct Weighted final
+{
+    using Behavior = TBehavior;
+    static constexpr float Weight = TWeight;
+};
+
+//****************
+//BLENDED STEERING
+template<typename... TWeighted>
+class Blended final
+{
+public:
+    explicit Blended(typename TWeighted::Behavior &... behaviors) : m_Behaviors(behaviors...) {}
+
+    // Same blend as BlendedSteering::CalculateSteering, with the weights, their sum and the heaviest behavior known up front
+    SteeringOutput CalculateSteering(const AgentInfo &agent)
+    {
+        return Blend(agent, std::index_sequence_for<TWeighted...>{});
+    }
+
+    void SetTarget(const TargetData &target)
+    {
+        std::apply([&target](auto &... behaviors) { (behaviors.SetTarget(target), ...); }, m_Behaviors);
+    }
+
+    void SetRunning(bool isRunning)
+    {
+        std::apply([isRunning](auto &... behaviors) { (behaviors.SetRunning(isRunning), ...); }, m_Behaviors);
+    }
+
+    template<size_t Idx>
+    [[nodiscard]] auto &Get() { return std::get<Idx>(m_Behaviors); }
+
+private:
+    static constexpr float Weights[]{TWeighted::Weight...};
+
+    static constexpr float SumWeights()
+    {
+        float totalWeight = 0.f;
+        for (const float weight: Weights) totalWeight += weight;
+        return totalWeight;
+    }
+
+    // The extra attributes (e.g. RunMode) come from the first behavior with the largest positive weight
+    static constexpr size_t FindMaxWeightIdx()
+    {
+        size_t maxIdx = sizeof...(TWeighted);
+        float maxWeight = 0.f;
+        for (size_t idx{}; idx < sizeof...(TWeighted); ++idx)
+        {
+            if (Weights[idx] > maxWeight)
+            {
+                maxWeight = Weights[idx];
+                maxIdx = idx;
+            }
+        }
+        return maxIdx;
+    }
+
+    static constexpr float TotalWeight = SumWeights();
+    static constexpr size_t MaxWeightIdx = FindMaxWeightIdx();
+
+    template<size_t... Idx>
+    SteeringOutput Blend(const AgentInfo &agent, std::index_sequence<Idx...>)
+    {
+        SteeringOutput blendedSteering = {};
+        SteeringOutput outputSteering = {};
+        // The fold runs the behaviors in order, they can have side effects (stamina, random streams)
+        ([&]
+        {
+            const SteeringOutput steering = StaticSteering::Calculate(std::get<Idx>(m_Behaviors), agent);
+            if constexpr (Idx == MaxWeightIdx) outputSteering = steering;
+            blendedSteering.LinearVelocity += steering.LinearVelocity * Weights[Idx];
+            blendedSteering.AngularVelocity += steering.AngularVelocity * Weights[Idx];
+        }(), ...);
+        if constexpr (TotalWeight > 0.f)
+        {
+            blendedSteering /= TotalWeight;
+        }
+        blendedSteering.AngularVelocity = blendedSteering.AngularVelocity > 1.f ? 1.f : blendedSteering.AngularVelocity < -1.f ? -1.f : blendedSteering.AngularVelocity;
+        outputSteering.AngularVelocity = blendedSteering.AngularVelocity * agent.MaxAngularSpeed;
+        outputSteering.LinearVelocity = blendedSteering.LinearVelocity.GetNormalized() * agent.MaxLinearSpeed;
+
+        return outputSteering;
+    }
+
+    std::tuple<typename TWeighted::Behavior &...> m_Behaviors;
+};
+
+//*****************
+//PRIORITY STEERING
+// The slot is still picked at runtime, by the BT. CalculateSteering makes one indirect call through a table with a
+// function per slot, each with the whole slot inlined, where PrioritySteering and BlendedSteering make one virtual call per behavior
+template<typename... TBehaviors>
+class Priority final
+{
+public:
+    static constexpr int NumBehaviors = static_cast<int>(sizeof...(TBehaviors));
+
+    explicit Priority(TBehaviors &... behaviors) : m_Behaviors(behaviors...) {}
+
+    SteeringOutput CalculateSteering(const AgentInfo &agent)
+    {
+        EXAM_PROFILE_SCOPE("Priority::CalculateSteering");
+        assert((m_ValidIdx < NumBehaviors && m_ValidIdx >= 0) && "Idx invalid for steering! - priority steering");
+        return CalculateTable[m_ValidIdx](m_Behaviors, agent);
+    }
+
+    void SetValidSteeringIdx(int idx) { m_ValidIdx = idx; }
+    [[nodiscard]] int GetValidIdx() const { return m_ValidIdx; }
+
+    void SetRunningForIdx(int idx, bool isRunning)
+    {
+        assert((idx < NumBehaviors && idx >= 0) && "Idx invalid for steering! - priority steering SetRunningForIdx");
+        Visit(idx, [isRunning](auto &behavior) { behavior.SetRunning(isRunning); });
+    }
+
+    // set target for specific behavior
+    void SetTargetForIdx(int idx, const TargetData &target)
+    {
+        assert((idx < NumBehaviors && idx >= 0) && "Idx invalid for set target! - priority steering");
+        Visit(idx, [&target](auto &behavior) { behavior.SetTarget(target); });
+    }
+
+    // Typed access replaces GetBehaviorForIdx and the cast back from ISteeringBehavior
+    template<size_t Idx>
+    [[nodiscard]] auto &Get() { return std::get<Idx>(m_Behaviors); }
+
+private:
+    template<typename Fn>
+    void Visit(int idx, Fn &&fn)
+    {
+        VisitImpl(idx, fn, std::index_sequence_for<TBehaviors...>{});
+    }
+
+    template<typename Fn, size_t... Idx>
+    void VisitImpl(int idx, Fn &fn, std::index_sequence<Idx...>)
+    {
+        (void)((static_cast<int>(Idx) == idx ? (fn(std::get<Idx>(m_Behaviors)), true) : false) || ...);
+    }
+
+    using Behaviors = std::tuple<TBehaviors &...>;
+    using CalculateFn = SteeringOutput (*)(Behaviors &, const AgentInfo &);
+
+    template<size_t Idx>
+    static SteeringOutput CalculateIdx(Behaviors &behaviors, const AgentInfo &agent)
+    {
+        return StaticSteering::Calculate(std::get<Idx>(behaviors), agent);
+    }
+
+    template<size_t... Idx>
+    static constexpr std::array<CalculateFn, sizeof...(Idx)> MakeCalculateTable(std::index_sequence<Idx...>)
+    {
+        return {&CalculateIdx<Idx>...};
+    }
+
+    static constexpr std::array<CalculateFn, sizeof...(TBehaviors)> CalculateTable =
+        MakeCalculateTable(std::index_sequence_for<TBehaviors...>{});
+
+    Behaviors m_Behaviors;
+    int m_ValidIdx = 0;
+};
@@ -0,0 +1,270 @@
+#include "../stdafx.h"
+#include "SteeringBatch.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define STEERING_BATCH_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define STEERING_BATCH_SSE2
+#endif
+
+namespace
+{
+    // The kernels are written once against these lane types: the vector one for full groups of agents,
+    // ScalarLanes for the tail. Every operation is IEEE-exact in both, so the tail matches the vector lanes.
+    struct ScalarLanes final
+    {
+        using V = float;
+        using Mask = bool;
+        static constexpr size_t Width = 1;
+
+        static V Load(const float* p) { return *p; }
+        static void Store(float* p, V v) { *p = v; }
+        static V Set(float f) { return f; }
+        static V Add(V a, V b) { return a + b; }
+        static V Sub(V a, V b) { return a - b; }
+        static V Mul(V a, V b) { return a * b; }
+        static V Div(V a, V b) { return a / b; }
+        static V Sqrt(V a) { return sqrtf(a); }
+        static V Min(V a, V b) { return a < b ? a : b; }
+        static V Max(V a, V b) { return a > b ? a : b; }
+        static V Abs(V a) { return fabsf(a); }
+        // Nearest, ties to even, like the vector conversions in the default rounding mode
+        static V Round(V a) { return nearbyintf(a); }
+        static Mask Less(V a, V b) { return a < b; }
+        static Mask Greater(V a, V b) { return a > b; }
+        static V Select(Mask mask, V a, V b) { return mask ? a : b; }
+    };
+
+#if defined(STEERING_BATCH_AVX2)
+    struct VectorLanes final
+    {
+        using V = __m256;
+        using Mask = __m256;
+        static constexpr size_t Width = 8;
+
+        static V Load(const float* p) { return _mm256_loadu_ps(p); }
+        static void Store(float* p, V v) { _mm256_storeu_ps(p, v); }
+        static V Set(float f) { return _mm256_set1_ps(f); }
+        static V Add(V a, V b) { return _mm256_add_ps(a, b); }
+        static V Sub(V a, V b) { return _mm256_sub_ps(a, b); }
+        static V Mul(V a, V b) { return _mm256_mul_ps(a, b); }
+        static V Div(V a, V b) { return _mm256_div_ps(a, b); }
+        static V Sqrt(V a) { return _mm256_sqrt_ps(a); }
+        static V Min(V a, V b) { return _mm256_min_ps(a, b); }
+        static V Max(V a, V b) { return _mm256_max_ps(a, b); }
+        static V Abs(V a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.f), a); }
+        static V Round(V a) { return _mm256_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+        static Mask Less(V a, V b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+        static Mask Greater(V a, V b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+        static V Select(Mask mask, V a, V b) { return _mm256_blendv_ps(b, a, mask); }
+    };
+#elif defined(STEERING_BATCH_SSE2)
+    struct VectorLanes final
+    {
+        using V = __m128;
+        using Mask = __m128;
+        static constexpr size_t Width = 4;
+
+        static V Load(const float* p) { return _mm_loadu_ps(p); }
+        static void Store(float* p, V v) { _mm_storeu_ps(p, v); }
+        static V Set(float f) { return _mm_set1_ps(f); }
+        static V Add(V a, V b) { return _mm_add_ps(a, b); }
+        static V Sub(V a, V b) { return _mm_sub_ps(a, b); }
+        static V Mul(V a, V b) { return _mm_mul_ps(a, b); }
+        static V Div(V a, V b) { return _mm_div_ps(a, b); }
+        static V Sqrt(V a) { return _mm_sqrt_ps(a); }
+        static V Min(V a, V b) { return _mm_min_ps(a, b); }
+        static V Max(V a, V b) { return _mm_max_ps(a, b); }
+        static V Abs(V a) { return _mm_andnot_ps(_mm_set1_ps(-0.f), a); }
+        // SSE2 has no round, the conversion rounds to nearest (angles stay far below the int range)
+        static V Round(V a) { return _mm_cvtepi32_ps(_mm_cvtps_epi32(a)); }
+        static Mask Less(V a, V b) { return _mm_cmplt_ps(a, b); }
+        static Mask Greater(V a, V b) { return _mm_cmpgt_ps(a, b); }
+        // SSE2 has no blendv
+        static V Select(Mask mask, V a, V b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+    };
+#else
+    using VectorLanes = ScalarLanes;
+#endif
+
+    // Runs kernel(lanes, i) over the batch, i being the first agent of the group
+    template<typename Kernel>
+    void Run(size_t count, Kernel kernel)
+    {
+        constexpr size_t width = VectorLanes::Width;
+        size_t i{};
+        for (; i + width <= count; i += width) kernel(VectorLanes{}, i);
+        for (; i < count; ++i) kernel(ScalarLanes{}, i);
+    }
+
+    // Seek::CalculateSteering: full speed towards the target, standing still within half a unit of it
+    template<typename L>
+    void SeekLanes(typename L::V posX, typename L::V posY, typename L::V targetX, typename L::V targetY,
+                   typename L::V maxSpeed, typename L::V &linearX, typename L::V &linearY)
+    {
+        const typename L::V dx = L::Sub(targetX, posX);
+        const typename L::V dy = L::Sub(targetY, posY);
+        const typename L::V distance = L::Sqrt(L::Add(L::Mul(dx, dx), L::Mul(dy, dy)));
+        const typename L::Mask arrived = L::Less(distance, L::Set(0.5f));
+        const typename L::V invDistance = L::Div(L::Set(1.f), distance);
+        const typename L::V zero = L::Set(0.f);
+        linearX = L::Select(arrived, zero, L::Mul(L::Mul(dx, invDistance), maxSpeed));
+        linearY = L::Select(arrived, zero, L::Mul(L::Mul(dy, invDistance), maxSpeed));
+    }
+
+    // Pursuit::CalculateSteering: seeks where the target will be after the time it takes to cover the distance
+    template<typename L>
+    void PursuitLanes(const SteeringBatch::Input &input, size_t i, typename L::V &linearX, typename L::V &linearY)
+    {
+        const typename L::V posX = L::Load(input.PositionX + i);
+        const typename L::V posY = L::Load(input.PositionY + i);
+        const typename L::V targetX = L::Load(input.TargetX + i);
+        const typename L::V targetY = L::Load(input.TargetY + i);
+        const typename L::V maxSpeed = L::Load(input.MaxLinearSpeed + i);
+        const typename L::V dx = L::Sub(targetX, posX);
+        const typename L::V dy = L::Sub(targetY, posY);
+        const typename L::V expectedTime = L::Div(L::Sqrt(L::Add(L::Mul(dx, dx), L::Mul(dy, dy))), maxSpeed);
+        const typename L::V predictedX = L::Add(targetX, L::Mul(L::Load(input.TargetVelocityX + i), expectedTime));
+        const typename L::V predictedY = L::Add(targetY, L::Mul(L::Load(input.TargetVelocityY + i), expectedTime));
+        SeekLanes<L>(posX, posY, predictedX, predictedY, maxSpeed, linearX, linearY);
+    }
+
+    // Elite::FastAtan2 on lanes
+    template<typename L>
+    typename L::V Atan2Lanes(typename L::V y, typename L::V x)
+    {
+        const typename L::V absX = L::Abs(x);
+        const typename L::V absY = L::Abs(y);
+        // The minimum keeps 0 / 0 at 0 like atan2f(0, 0)
+        const typename L::V ratio = L::Div(L::Min(absX, absY), L::Max(L::Max(absX, absY), L::Set(FLT_MIN)));
+        const typename L::V s = L::Mul(ratio, ratio);
+        typename L::V poly = L::Set(0.f);
+        for (const float coefficient: Elite::FastMathDetail::AtanCoefficients) poly = L::Add(L::Mul(poly, s), L::Set(coefficient));
+        typename L::V angle = L::Mul(poly, ratio);
+        angle = L::Select(L::Greater(absY, absX), L::Sub(L::Set(static_cast<float>(M_PI_2)), angle), angle);
+        angle = L::Select(L::Less(x, L::Set(0.f)), L::Sub(L::Set(static_cast<float>(M_PI)), angle), angle);
+        return L::Select(L::Less(y, L::Set(0.f)), L::Sub(L::Set(0.f), angle), angle);
+    }
+
+    // Face::CalculateSteering: turns at full angular speed towards the target, unless within 5 degrees of it
+    template<typename L>
+    typename L::V FaceLanes(const SteeringBatch::Input &input, size_t i)
+    {
+        const typename L::V dx = L::Sub(L::Load(input.TargetX + i), L::Load(input.PositionX + i));
+        const typename L::V dy = L::Sub(L::Load(input.TargetY + i), L::Load(input.PositionY + i));
+        typename L::V angleDifference = L::Sub(Atan2Lanes<L>(dy, dx), L::Load(input.Orientation + i));
+        // Elite::WrapAngle, the shortest way round in [-pi, pi]
+        const typename L::V turns = L::Round(L::Mul(angleDifference, L::Set(static_cast<float>(0.5 / M_PI))));
+        angleDifference = L::Sub(angleDifference, L::Mul(turns, L::Set(Elite::FastMathDetail::TwoPiHigh)));
+        angleDifference = L::Sub(angleDifference, L::Mul(turns, L::Set(Elite::FastMathDetail::TwoPiLow)));
+        const typename L::V pi = L::Set(0.5f * Elite::FastMathDetail::TwoPiHigh);
+        const typename L::V fixTurn = L::Select(L::Less(angleDifference, pi),
+                                                L::Select(L::Greater(angleDifference, L::Sub(L::Set(0.f), pi)), L::Set(0.f), L::Set(-1.f)),
+                                                L::Set(1.f));
+        angleDifference = L::Sub(angleDifference, L::Mul(fixTurn, L::Set(Elite::FastMathDetail::TwoPiHigh)));
+        angleDifference = L::Sub(angleDifference, L::Mul(fixTurn, L::Set(Elite::FastMathDetail::TwoPiLow)));
+
+        const typename L::V maxAngularSpeed = L::Load(input.MaxAngularSpeed + i);
+        const typename L::V turn = L::Select(L::Greater(angleDifference, L::Set(0.f)), maxAngularSpeed,
+                                             L::Sub(L::Set(0.f), maxAngularSpeed));
+        return L::Select(L::Greater(L::Abs(angleDifference), L::Set(Elite::ToRadians(5.f))), turn, L::Set(0.f));
+    }
+}
+
+namespace SteeringBatch
+{
+    void Seek(const Input &input, const Output &output)
+    {
+        Run(input.Count, [&input, &output]<typename L>(L, size_t i)
+        {
+            typename L::V linearX, linearY;
+            SeekLanes<L>(L::Load(input.PositionX + i), L::Load(input.PositionY + i), L::Load(input.TargetX + i),
+                         L::Load(input.TargetY + i), L::Load(input.MaxLinearSpeed + i), linearX, linearY);
+            L::Store(output.LinearX + i, linearX);
+            L::Store(output.LinearY + i, linearY);
+            L::Store(output.Angular + i, L::Set(0.f));
+        });
+    }
+
+    void Flee(const Input &input, const Output &output)
+    {
+        Run(input.Count, [&input, &output]<typename L>(L, size_t i)
+        {
+            typename L::V linearX, linearY;
+            SeekLanes<L>(L::Load(input.PositionX + i), L::Load(input.PositionY + i), L::Load(input.TargetX + i),
+                         L::Load(input.TargetY + i), L::Load(input.MaxLinearSpeed + i), linearX, linearY);
+            L::Store(output.LinearX + i, L::Mul(linearX, L::Set(-1.f)));
+            L::Store(output.LinearY + i, L::Mul(linearY, L::Set(-1.f)));
+            L::Store(output.Angular + i, L::Set(0.f));
+        });
+    }
+
+    void Pursuit(const Input &input, const Output &output)
+    {
+        assert(input.TargetVelocityX && input.TargetVelocityY && "Pursuit needs the target velocities");
+        Run(input.Count, [&input, &output]<typename L>(L, size_t i)
+        {
+            typename L::V linearX, linearY;
+            PursuitLanes<L>(input, i, linearX, linearY);
+            L::Store(output.LinearX + i, linearX);
+            L::Store(output.LinearY + i, linearY);
+            L::Store(output.Angular + i, L::Set(0.f));
+        });
+    }
+
+    void Evade(const Input &input, const Output &output, float evasionRadius)
+    {
+        assert(input.TargetVelocityX && input.TargetVelocityY && "Evade needs the target velocities");
+        Run(input.Count, [&input, &output, evasionRadius]<typename L>(L, size_t i)
+        {
+            const typename L::V dx = L::Sub(L::Load(input.TargetX + i), L::Load(input.PositionX + i));
+            const typename L::V dy = L::Sub(L::Load(input.TargetY + i), L::Load(input.PositionY + i));
+            const typename L::Mask outOfRange = L::Greater(L::Sqrt(L::Add(L::Mul(dx, dx), L::Mul(dy, dy))),
+                                                           L::Set(evasionRadius));
+            typename L::V linearX, linearY;
+            PursuitLanes<L>(input, i, linearX, linearY);
+            const typename L::V zero = L::Set(0.f);
+            L::Store(output.LinearX + i, L::Select(outOfRange, zero, L::Mul(linearX, L::Set(-1.f))));
+            L::Store(output.LinearY + i, L::Select(outOfRange, zero, L::Mul(linearY, L::Set(-1.f))));
+            L::Store(output.Angular + i, zero);
+        });
+    }
+
+    void Face(const Input &input, const Output &output)
+    {
+        assert(input.Orientation && input.MaxAngularSpeed && "Face needs the orientations and angular speeds");
+        Run(input.Count, [&input, &output]<typename L>(L, size_t i)
+        {
+            L::Store(output.LinearX + i, L::Set(0.f));
+            L::Store(output.LinearY + i, L::Set(0.f));
+            L::Store(output.Angular + i, FaceLanes<L>(input, i));
+        });
+    }
+
+    void FleeWhileFacing(const Input &input, const Output &output)
+    {
+        assert(input.Orientation && input.MaxAngularSpeed && "FleeWhileFacing needs the orientations and angular speeds");
+        Run(input.Count, [&input, &output]<typename L>(L, size_t i)
+        {
+            typename L::V linearX, linearY;
+            SeekLanes<L>(L::Load(input.PositionX + i), L::Load(input.PositionY + i), L::Load(input.TargetX + i),
+                         L::Load(input.TargetY + i), L::Load(input.MaxLinearSpeed + i), linearX, linearY);
+            L::Store(output.LinearX + i, L::Mul(linearX, L::Set(-1.f)));
+            L::Store(output.LinearY + i, L::Mul(linearY, L::Set(-1.f)));
+            L::Store(output.Angular + i, FaceLanes<L>(input, i));
+        });
+    }
+
+    const char *GetKernelName()
+    {
+#if defined(STEERING_BATCH_AVX2)
+        return "AVX2";
+#elif defined(STEERING_BATCH_SSE2)
+        return "SSE2";
+#else
+        return "scalar";
+#endif
+    }
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <cstddef>
+
+// Batched counterparts of the Seek, Flee, Pursuit, Evade, Face and FleeWhileFacing behaviors.
+// Element i of the batch is one agent steering towards its own target. The inputs and outputs are structure-of-arrays,
+// so the kernels evaluate 8 (AVX2) or 4 (SSE2) agents per instruction and the rest one at a time with the same math.
+// The behavior classes stay the reference: Seek, Flee, Pursuit and Evade give bit-identical velocities, Face compares
+// against an approximated atan2 (error below 1e-6 rad) and can only disagree right at the 5 degree dead zone or at +-pi.
+//
+// The batch is stateless. It has no running or stamina state (RunMode, AutoOrient stay with the behaviors), and
+// Pursuit predicts from the given target without storing the prediction as Pursuit::CalculateSteering does.
+// Wander is not batched, its angle is a random walk per behavior; the wander targets can be fed to Seek instead.
+namespace SteeringBatch
+{
+    struct Input final
+    {
+        const float* PositionX = nullptr;
+        const float* PositionY = nullptr;
+        const float* Orientation = nullptr;
+        const float* MaxLinearSpeed = nullptr;
+        const float* MaxAngularSpeed = nullptr;
+
+        const float* TargetX = nullptr;
+        const float* TargetY = nullptr;
+        // Only read by Pursuit and Evade
+        const float* TargetVelocityX = nullptr;
+        const float* TargetVelocityY = nullptr;
+
+        size_t Count = 0;
+    };
+
+    // SteeringOutput::LinearVelocity and AngularVelocity, Count elements each
+    struct Output final
+    {
+        float* LinearX = nullptr;
+        float* LinearY = nullptr;
+        float* Angular = nullptr;
+    };
+
+    void Seek(const Input& input, const Output& output);
+    void Flee(const Input& input, const Output& output);
+    void Pursuit(const Input& input, const Output& output);
+    void Evade(const Input& input, const Output& output, float evasionRadius = 10.f);
+    void Face(const Input& input, const Output& output);
+    void FleeWhileFacing(const Input& input, const Output& output);
+
+    // Name of the instruction set the kernels use, for benchmarks and logs
+    const char* GetKernelName();
+}
@@ -59,11 +59,8 @@ SteeringOutput Face::CalculateSteering(const AgentInfo &agent)
     const Elite::Vector2 direction = m_Target.Position - agent.Position;
     const float targetOrientation = Elite::VectorToOrientation(direction);
     const float currentOrientation = agent.Orientation;
-    float angleDifference = targetOrientation - currentOrientation;
-
-    // Normalize the angle to the range [-pi, pi] so the shortest path is taken
-    while (angleDifference > M_PI) angleDifference -= 2 * M_PI;
-    while (angleDifference < -M_PI) angleDifference += 2 * M_PI;
+    // Wrap the angle to the range [-pi, pi] so the shortest path is taken
+    const float angleDifference = Elite::WrapAngle(targetOrientation - currentOrientation);
     if (abs(angleDifference) <= Elite::ToRadians(5.f))
     {
         steering.AngularVelocity = 0.f;
@@ -131,8 +128,13 @@ SteeringOutput Evade::CalculateSteering(const AgentInfo &agent)
 SteeringOutput Wander::CalculateSteering(const AgentInfo &agent)
 {
     RunStaminaCheck(agent);
-    const float randomAngle = (m_MaxAngleChange * static_cast<float>(rand()) / RAND_MAX)
-                              - (m_MaxAngleChange * static_cast<float>(rand()) / RAND_MAX) + m_WanderAngle;
+    if (m_NumAngleChanges == 0)
+    {
+        assert(m_pRng && "Wander has no random engine");
+        m_pRng->FillBinomial(m_AngleChanges.data(), m_AngleChanges.size(), m_MaxAngleChange);
+        m_NumAngleChanges = m_AngleChanges.size();
+    }
+    const float randomAngle = m_AngleChanges[m_AngleChanges.size() - m_NumAngleChanges--] + m_WanderAngle;
     m_WanderAngle = randomAngle;
     const Elite::Vector2 circleCenter = agent.Position + m_OffsetDistance * agent.LinearVelocity.GetNormalized();
     const Elite::Vector2 targetPos = circleCenter + m_Radius * Elite::Vector2(sin(randomAngle), cos(randomAngle));
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <type_traits>
 #include "SteeringHelpers.h"
 
@@ -117,15 +118,21 @@ public:
 
 	void SetWanderOffset(float offset) { m_OffsetDistance = offset; }
 	void SetWanderRadius(float radius) { m_Radius = radius; }
-	void SetMaxAngleChange(float angle) { m_MaxAngleChange = angle; }
+	void SetMaxAngleChange(float angle) { m_MaxAngleChange = angle; m_NumAngleChanges = 0; }
 	void SetSlowRadius(float radius) { m_SlowRadius = radius; }
 	void SetTargetRadius(float radius) { m_TargetRadius = radius; }
+	//Random stream of the owning agent, agents ticked on other threads never share one
+	void SetRandomEngine(Elite::RandomEngine* pRng) { m_pRng = pRng; m_NumAngleChanges = 0; }
 
 protected:
 	float m_SlowRadius = 15.f;
 	float m_TargetRadius = 3.f;
 
 private:
+	Elite::RandomEngine* m_pRng = nullptr;
+	//Angle changes are drawn in batches, the next one is m_AngleChanges[size - m_NumAngleChanges]
+	std::array<float, 32> m_AngleChanges{};
+	size_t m_NumAngleChanges = 0;
 	float m_OffsetDistance = 6.f;
 	float m_Radius = 4.f;
 	float m_MaxAngleChange = Elite::ToRadians(45);
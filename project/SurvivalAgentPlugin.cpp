@@ -3,7 +3,9 @@
 
 #include "Agent.h"
 #include "IExamInterface.h"
+#include "Profiler.h"
 #include "Steering/SteeringHelpers.h"
+#include "Trajectory/TrajectoryRecorder.h"
 
 //Called only once, during initialization
 void SurvivalAgentPlugin::Initialize(IBaseInterface* pInterface, PluginInfo& info)
@@ -11,7 +13,18 @@ void SurvivalAgentPlugin::Initialize(IBaseInterface* pInterface, PluginInfo& inf
 	//Retrieving the interface
 	//This interface gives you access to certain actions the AI_Framework can perform for you
 	m_pInterface = static_cast<IExamInterface*>(pInterface);
-	m_pAgent = new Agent(m_pInterface);
+	if (!m_TrajectoryPath.empty())
+	{
+		m_pRecorder = new TrajectoryRecorder(m_pInterface);
+		if (m_pRecorder->Open(m_TrajectoryPath, GetSeed())) m_pInterface = m_pRecorder;
+		else
+		{
+			std::cout << "WARNING: Could not create the trajectory " << m_TrajectoryPath << ", the run is not recorded\n";
+			SAFE_DELETE(m_pRecorder);
+		}
+	}
+	//Same seed as the world, whichever of Initialize and InitGameDebugParams runs first picks it
+	m_pAgent = new Agent(m_pInterface, static_cast<uint64_t>(static_cast<unsigned int>(GetSeed())));
 	//m_pAgent = new Agent(m_pInterface);
 	//Information for the leaderboards!
 	info.BotName = "MinionExam";
@@ -33,6 +46,7 @@ void SurvivalAgentPlugin::DllShutdown()
 {
 	//Called when the plugin gets unloaded
 	SAFE_DELETE(m_pAgent);
+	SAFE_DELETE(m_pRecorder);
 }
 
 //Called only once, during initialization. Only works in DEBUG Mode
@@ -52,7 +66,7 @@ void SurvivalAgentPlugin::InitGameDebugParams(GameDebugParams& params)
 	params.SpawnPurgeZonesOnMiddleClick = true;
 	params.PrintDebugMessages = true;
 	params.ShowDebugItemNames = true;
-	params.Seed = int(time(nullptr)); //-1 = don't set seed. Any other number = fixed seed //TIP: use Seed = int(time(nullptr)) for pure randomness
+	params.Seed = GetSeed(); //-1 = don't set seed. Any other number = fixed seed //TIP: use SetSeed for a fixed seed, by default it's int(time(nullptr))
 }
 
 //Only Active in DEBUG Mode
@@ -119,6 +133,8 @@ void SurvivalAgentPlugin::Update_Debug(float dt)
 //This function calculates the new SteeringOutput, called once per frame
 SteeringPlugin_Output SurvivalAgentPlugin::UpdateSteering(float dt)
 {
+	EXAM_PROFILE_SCOPE("SurvivalAgentPlugin::UpdateSteering");
+	m_pAgent->CaptureFrameSnapshot();
 	m_pAgent->Update(dt);
 	auto steering = m_pAgent->GetSteeringOutput(dt);
 
@@ -135,25 +151,27 @@ SteeringPlugin_Output SurvivalAgentPlugin::UpdateSteering(float dt)
 		{
 			//Once grabbed, you can add it to a specific inventory slot
 			//Slot must be empty
-			m_pInterface->Inventory_AddItem(m_InventorySlot, item);
+			m_pAgent->GetInventory().AddItem(m_InventorySlot, item);
+			m_pAgent->MarkInventoryChanged();
 		}
 	}
 
 	if (m_UseItem)
 	{
 		//Use an item (make sure there is an item at the given inventory slot)
-		m_pInterface->Inventory_UseItem(m_InventorySlot);
+		m_pAgent->GetInventory().UseItem(m_InventorySlot);
+		m_pAgent->MarkInventoryChanged();
 	}
 
 	if (m_RemoveItem)
 	{
 		//Remove an item from a inventory slot
-		m_pInterface->Inventory_RemoveItem(m_InventorySlot);
+		m_pAgent->GetInventory().RemoveItem(m_InventorySlot);
+		m_pAgent->MarkInventoryChanged();
 	}
-	auto vItemsInFOV = m_pInterface->GetItemsInFOV();
 	if (m_DestroyItemsInFOV)
 	{
-		for (auto& item : vItemsInFOV)
+		for (auto& item : m_pAgent->GetFrameSnapshot().GetItemsInFOV())
 		{
 			m_pInterface->DestroyItem(item);
 		}
@@ -166,6 +184,7 @@ SteeringPlugin_Output SurvivalAgentPlugin::UpdateSteering(float dt)
 	m_RemoveItem = false;
 	m_DestroyItemsInFOV = false;
 
+	if (m_pRecorder) m_pRecorder->RecordFrame(dt, steering);
 	return steering;
 }
 
@@ -181,3 +200,9 @@ void SurvivalAgentPlugin::Render(float dt) const
 
 
 
+
+int SurvivalAgentPlugin::GetSeed()
+{
+	if (m_Seed == -1) m_Seed = int(time(nullptr));
+	return m_Seed;
+}
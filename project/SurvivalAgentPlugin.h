@@ -5,6 +5,7 @@
 class Agent;
 class IBaseInterface;
 class IExamInterface;
+class TrajectoryRecorder;
 
 class SurvivalAgentPlugin :public IExamPlugin
 {
@@ -24,11 +25,24 @@ public:
 	SteeringPlugin_Output UpdateSteering(float dt) override;
 	void Render(float dt) const override;
 
+	//Seed of the world and of the agent's random stream, a run replays from it.
+	//Picked from the clock on first use unless a host without InitGameDebugParams sets it before Initialize
+	void SetSeed(int seed) { m_Seed = seed; }
+	//Records every frame to this file (see TrajectoryRecorder), has to be set before Initialize
+	void SetTrajectoryPath(const std::string& path) { m_TrajectoryPath = path; }
+	[[nodiscard]] const TrajectoryRecorder* GetTrajectoryRecorder() const { return m_pRecorder; }
+
+	[[nodiscard]] const Agent* GetAgent() const { return m_pAgent; }
+	[[nodiscard]] Agent* GetAgent() { return m_pAgent; }
+
 private:
 
 	//Interface, used to request data from/perform actions with the AI Framework
 	IExamInterface* m_pInterface = nullptr;
 	Agent* m_pAgent = nullptr;
+	//Sits between the agent and the framework's interface while a trajectory is recorded
+	TrajectoryRecorder* m_pRecorder = nullptr;
+	std::string m_TrajectoryPath{};
 	bool m_CanRun = false; //Demo purpose
 	bool m_GrabItem = false; //Demo purpose
 	bool m_UseItem = false; //Demo purpose
@@ -37,9 +51,13 @@ private:
 	float m_AngSpeed = 0.f; //Demo purpose
 
 	UINT m_InventorySlot = 0;
+	int m_Seed = -1;
+
+	int GetSeed();
 };
 
 //ENTRY
+#ifdef _WIN32
 //This is the first function that is called by the host program
 //The plugin returned by this function is also the plugin used by the host program
 extern "C"
@@ -48,4 +66,5 @@ extern "C"
 	{
 		return new SurvivalAgentPlugin();
 	}
-}
\ No newline at end of file
+}
+#endif
@@ -0,0 +1,80 @@
+#include "../stdafx.h"
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+#ifdef _WIN32
+bool MappedFile::Open(const std::string &path)
+{
+    assert(!IsOpen() && "The file is already mapped");
+    m_hFile = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (m_hFile == INVALID_HANDLE_VALUE)
+    {
+        m_hFile = nullptr;
+        return false;
+    }
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(m_hFile, &size) || size.QuadPart == 0)
+    {
+        Close();
+        return false;
+    }
+    m_hMapping = CreateFileMappingA(m_hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    m_pData = m_hMapping ? static_cast<const uint8_t *>(MapViewOfFile(m_hMapping, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+    if (!m_pData)
+    {
+        Close();
+        return false;
+    }
+    m_Size = static_cast<size_t>(size.QuadPart);
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (m_pData) UnmapViewOfFile(m_pData);
+    if (m_hMapping) CloseHandle(m_hMapping);
+    if (m_hFile) CloseHandle(m_hFile);
+    m_pData = nullptr;
+    m_Size = 0;
+    m_hMapping = nullptr;
+    m_hFile = nullptr;
+}
+#else
+bool MappedFile::Open(const std::string &path)
+{
+    assert(!IsOpen() && "The file is already mapped");
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat status{};
+    void *pData = MAP_FAILED;
+    if (fstat(fd, &status) == 0 && status.st_size > 0)
+        pData = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping keeps the file alive on its own
+    close(fd);
+    if (pData == MAP_FAILED) return false;
+    m_pData = static_cast<const uint8_t *>(pData);
+    m_Size = static_cast<size_t>(status.st_size);
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (m_pData) munmap(const_cast<uint8_t *>(m_pData), m_Size);
+    m_pData = nullptr;
+    m_Size = 0;
+}
+#endif
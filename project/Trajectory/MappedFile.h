@@ -0,0 +1,34 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Read-only view of a whole file mapped into memory, the pages are loaded by the OS as they are touched.
+// The data stays valid until Close or the destructor.
+class MappedFile final
+{
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&&) = delete;
+    MappedFile& operator=(MappedFile&&) = delete;
+
+    // False if the file can't be opened or is empty
+    bool Open(const std::string& path);
+    void Close();
+
+    [[nodiscard]] bool IsOpen() const { return m_pData != nullptr; }
+    [[nodiscard]] const uint8_t* GetData() const { return m_pData; }
+    [[nodiscard]] size_t GetSize() const { return m_Size; }
+
+private:
+    const uint8_t* m_pData = nullptr;
+    size_t m_Size = 0;
+#ifdef _WIN32
+    void* m_hFile = nullptr;
+    void* m_hMapping = nullptr;
+#endif
+};
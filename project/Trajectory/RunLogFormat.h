@@ -0,0 +1,66 @@
+#pragma once
+#include <cstdint>
+#include <type_traits>
+
+// Columnar log of an agent run for offline analysis, written by RunLogWriter and memory-mapped by RunLogReader.
+// Where a trajectory (TrajectoryFormat.h) keeps everything needed to replay a run frame by frame, a run log keeps a
+// few values per frame, each in its own array, so a scan over one value reads nothing else and the arrays can be
+// used straight from the mapped file. All values are little-endian.
+//
+//   header        magic "EXRL", version, number of frames, number of actions, the offset and size of every section
+//   action names  the names of the behavior tree actions the action column refers to, each ending in a 0
+//   columns       one array per column with an element per frame, every array starts at a multiple of 64 bytes
+namespace RunLog
+{
+    constexpr char Magic[4]{'E', 'X', 'R', 'L'};
+    constexpr uint32_t Version = 1;
+    // Cache line, so a column scan never shares its first line with the previous column
+    constexpr uint64_t Alignment = 64;
+
+    enum class Column : uint32_t
+    {
+        PositionX,
+        PositionY,
+        VelocityX,
+        VelocityY,
+        Health,
+        Energy,
+        Stamina,
+        // Index into the action names, the behavior tree action that ran last in the frame
+        Action,
+        Count
+    };
+    constexpr uint32_t NumColumns = static_cast<uint32_t>(Column::Count);
+    constexpr uint32_t NumFloatColumns = static_cast<uint32_t>(Column::Action);
+    // Action of a frame in which no action ran
+    constexpr uint16_t NoAction = 0xFFFF;
+
+    struct Section
+    {
+        uint64_t Offset;
+        uint64_t Size;
+    };
+
+    // Read in place from the start of the mapping, which is page aligned
+    struct FileHeader
+    {
+        char Magic[4];
+        uint32_t Version;
+        uint64_t NumFrames;
+        uint32_t NumActions;
+        uint32_t NumColumns;
+        Section ActionNames;
+        Section Columns[RunLog::NumColumns];
+    };
+    static_assert(std::is_trivially_copyable_v<FileHeader> && sizeof(FileHeader) == 24 + 16 * (NumColumns + 1));
+
+    constexpr uint64_t GetElementSize(Column column)
+    {
+        return column == Column::Action ? sizeof(uint16_t) : sizeof(float);
+    }
+
+    constexpr uint64_t AlignUp(uint64_t offset)
+    {
+        return (offset + Alignment - 1) / Alignment * Alignment;
+    }
+}
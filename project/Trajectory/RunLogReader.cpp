@@ -0,0 +1,80 @@
+#include "../stdafx.h"
+#include "RunLogReader.h"
+
+using RunLog::Column;
+
+bool RunLogReader::Open(const std::string &path)
+{
+    if (!m_File.Open(path)) return false;
+
+    const uint8_t *const pData = m_File.GetData();
+    const uint64_t size = m_File.GetSize();
+    const auto *pHeader = reinterpret_cast<const RunLog::FileHeader *>(pData);
+    if (size < sizeof(RunLog::FileHeader) || memcmp(pHeader->Magic, RunLog::Magic, sizeof(RunLog::Magic)) != 0
+        || pHeader->Version != RunLog::Version || pHeader->NumColumns != RunLog::NumColumns)
+    {
+        m_File.Close();
+        return false;
+    }
+    // Every section has to lie inside the file, the columns aligned and as long as the run
+    const auto isInside = [size](const RunLog::Section &section)
+    {
+        return section.Offset <= size && section.Size <= size - section.Offset;
+    };
+    bool isValid = isInside(pHeader->ActionNames);
+    for (uint32_t c{}; c < RunLog::NumColumns; ++c)
+    {
+        const RunLog::Section &section = pHeader->Columns[c];
+        isValid &= isInside(section) && section.Offset % RunLog::Alignment == 0
+            && section.Size == pHeader->NumFrames * RunLog::GetElementSize(static_cast<Column>(c));
+    }
+    if (!isValid)
+    {
+        m_File.Close();
+        return false;
+    }
+
+    m_NumFrames = pHeader->NumFrames;
+    for (uint32_t c{}; c < RunLog::NumFloatColumns; ++c)
+        m_FloatColumns[c] = {reinterpret_cast<const float *>(pData + pHeader->Columns[c].Offset), m_NumFrames};
+    m_Actions = {reinterpret_cast<const uint16_t *>(pData + pHeader->Columns[static_cast<size_t>(Column::Action)].Offset),
+                 m_NumFrames};
+
+    // The names follow each other, each ending in a 0
+    const char *pName = reinterpret_cast<const char *>(pData + pHeader->ActionNames.Offset);
+    const char *const pNamesEnd = pName + pHeader->ActionNames.Size;
+    m_ActionNames.clear();
+    for (uint32_t a{}; a < pHeader->NumActions && pName < pNamesEnd; ++a)
+    {
+        m_ActionNames.push_back(pName);
+        pName = static_cast<const char *>(memchr(pName, 0, pNamesEnd - pName));
+        if (!pName) break;
+        ++pName;
+    }
+    if (m_ActionNames.size() != pHeader->NumActions || !pName)
+    {
+        m_File.Close();
+        return false;
+    }
+    return true;
+}
+
+RunLogFrame RunLogReader::GetFrame(size_t frame) const
+{
+    assert(frame < m_NumFrames && "Frame out of range");
+    const auto value = [this, frame](Column column) { return m_FloatColumns[static_cast<size_t>(column)][frame]; };
+    RunLogFrame result{};
+    result.Position = {value(Column::PositionX), value(Column::PositionY)};
+    result.Velocity = {value(Column::VelocityX), value(Column::VelocityY)};
+    result.Health = value(Column::Health);
+    result.Energy = value(Column::Energy);
+    result.Stamina = value(Column::Stamina);
+    result.Action = m_Actions[frame];
+    return result;
+}
+
+const char *RunLogReader::GetActionName(uint16_t action) const
+{
+    if (action == RunLog::NoAction) return "none";
+    return action < m_ActionNames.size() ? m_ActionNames[action] : "unknown action";
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <span>
+#include <string>
+#include <vector>
+#include "MappedFile.h"
+#include "RunLogFormat.h"
+#include "EliteMath/EMath.h"
+
+// All columns of one frame
+struct RunLogFrame final
+{
+    Elite::Vector2 Position{};
+    Elite::Vector2 Velocity{};
+    float Health = 0.f;
+    float Energy = 0.f;
+    float Stamina = 0.f;
+    uint16_t Action = RunLog::NoAction;
+};
+
+// Maps a run log and reads it in place: opening only checks the header, nothing is parsed or copied.
+// Columns come back as spans into the mapping, for scans over whole runs or ranges of frames,
+// and GetFrame gathers one frame from every column for random access.
+class RunLogReader final
+{
+public:
+    // False if the file can't be mapped or is not a run log of this version
+    bool Open(const std::string& path);
+
+    [[nodiscard]] size_t GetNumFrames() const { return m_NumFrames; }
+
+    // One of the float columns, the frames [first, first + count) clamped to the end of the run
+    [[nodiscard]] std::span<const float> GetColumn(RunLog::Column column, size_t first = 0, size_t count = SIZE_MAX) const
+    {
+        assert(column != RunLog::Column::Action && "The action column holds ids, use GetActions");
+        return Clamp(m_FloatColumns[static_cast<size_t>(column)], first, count);
+    }
+    [[nodiscard]] std::span<const uint16_t> GetActions(size_t first = 0, size_t count = SIZE_MAX) const
+    {
+        return Clamp(m_Actions, first, count);
+    }
+
+    [[nodiscard]] RunLogFrame GetFrame(size_t frame) const;
+
+    [[nodiscard]] size_t GetNumActions() const { return m_ActionNames.size(); }
+    // "none" for NoAction
+    [[nodiscard]] const char* GetActionName(uint16_t action) const;
+
+private:
+    template<typename T>
+    static std::span<const T> Clamp(std::span<const T> column, size_t first, size_t count)
+    {
+        first = std::min(first, column.size());
+        return column.subspan(first, std::min(count, column.size() - first));
+    }
+
+    MappedFile m_File{};
+    size_t m_NumFrames = 0;
+    std::span<const float> m_FloatColumns[RunLog::NumFloatColumns]{};
+    std::span<const uint16_t> m_Actions{};
+    // Point into the mapping
+    std::vector<const char*> m_ActionNames{};
+};
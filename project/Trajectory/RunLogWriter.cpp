@@ -0,0 +1,75 @@
+#include "../stdafx.h"
+#include "RunLogWriter.h"
+
+using RunLog::Column;
+
+void RunLogWriter::Reserve(size_t numFrames)
+{
+    for (std::vector<float> &column: m_FloatColumns) column.reserve(numFrames);
+    m_Actions.reserve(numFrames);
+}
+
+void RunLogWriter::AddFrame(const AgentInfo &agentInfo, uint16_t action)
+{
+    const auto column = [this](Column c) -> std::vector<float>& { return m_FloatColumns[static_cast<size_t>(c)]; };
+    column(Column::PositionX).push_back(agentInfo.Position.x);
+    column(Column::PositionY).push_back(agentInfo.Position.y);
+    column(Column::VelocityX).push_back(agentInfo.LinearVelocity.x);
+    column(Column::VelocityY).push_back(agentInfo.LinearVelocity.y);
+    column(Column::Health).push_back(agentInfo.Health);
+    column(Column::Energy).push_back(agentInfo.Energy);
+    column(Column::Stamina).push_back(agentInfo.Stamina);
+    m_Actions.push_back(action);
+}
+
+uint16_t RunLogWriter::GetActionId(const void *pAction, const char *pName)
+{
+    if (!pAction) return RunLog::NoAction;
+    const auto [it, isNew] = m_ActionIds.try_emplace(pAction, static_cast<uint16_t>(m_ActionNames.size()));
+    if (isNew)
+    {
+        assert(m_ActionNames.size() < RunLog::NoAction && "Too many actions for the action column");
+        m_ActionNames.emplace_back(pName ? pName : "unnamed action");
+    }
+    return it->second;
+}
+
+bool RunLogWriter::Write(const std::string &path) const
+{
+    FILE *pFile = fopen(path.c_str(), "wb");
+    if (!pFile) return false;
+
+    // Lay the sections out behind the header first, then write them in that order
+    RunLog::FileHeader header{};
+    memcpy(header.Magic, RunLog::Magic, sizeof(header.Magic));
+    header.Version = RunLog::Version;
+    header.NumFrames = GetNumFrames();
+    header.NumActions = static_cast<uint32_t>(m_ActionNames.size());
+    header.NumColumns = RunLog::NumColumns;
+    uint64_t offset = sizeof(header);
+    header.ActionNames.Offset = offset;
+    for (const std::string &name: m_ActionNames) header.ActionNames.Size += name.size() + 1;
+    offset += header.ActionNames.Size;
+    for (uint32_t c{}; c < RunLog::NumColumns; ++c)
+    {
+        offset = RunLog::AlignUp(offset);
+        header.Columns[c] = {offset, header.NumFrames * RunLog::GetElementSize(static_cast<Column>(c))};
+        offset += header.Columns[c].Size;
+    }
+
+    bool isWritten = fwrite(&header, sizeof(header), 1, pFile) == 1;
+    for (const std::string &name: m_ActionNames) isWritten &= fwrite(name.c_str(), name.size() + 1, 1, pFile) == 1;
+    uint64_t written = header.ActionNames.Offset + header.ActionNames.Size;
+    const uint8_t padding[RunLog::Alignment]{};
+    for (uint32_t c{}; c < RunLog::NumColumns && isWritten; ++c)
+    {
+        const RunLog::Section &section = header.Columns[c];
+        isWritten &= fwrite(padding, 1, section.Offset - written, pFile) == section.Offset - written;
+        const void *pData = c < RunLog::NumFloatColumns
+            ? static_cast<const void *>(m_FloatColumns[c].data())
+            : static_cast<const void *>(m_Actions.data());
+        isWritten &= fwrite(pData, 1, section.Size, pFile) == section.Size;
+        written = section.Offset + section.Size;
+    }
+    return fclose(pFile) == 0 && isWritten;
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include <array>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Exam_HelperStructs.h"
+#include "RunLogFormat.h"
+
+// Collects the columns of a run log in memory, frame by frame, and writes the file in one go at the end
+class RunLogWriter final
+{
+public:
+    void Reserve(size_t numFrames);
+    void AddFrame(const AgentInfo& agentInfo, uint16_t action);
+    // Id of an action for AddFrame, named the first time it is asked for. The same pointer always gets the same id
+    uint16_t GetActionId(const void* pAction, const char* pName);
+
+    // False if the file can't be written
+    bool Write(const std::string& path) const;
+
+    [[nodiscard]] size_t GetNumFrames() const { return m_Actions.size(); }
+
+private:
+    std::array<std::vector<float>, RunLog::NumFloatColumns> m_FloatColumns{};
+    std::vector<uint16_t> m_Actions{};
+    std::vector<std::string> m_ActionNames{};
+    std::unordered_map<const void*, uint16_t> m_ActionIds{};
+};
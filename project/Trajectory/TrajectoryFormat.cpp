@@ -0,0 +1,155 @@
+#include "../stdafx.h"
+#include "TrajectoryFormat.h"
+
+namespace Trajectory
+{
+    namespace
+    {
+        bool IsSameItem(const ItemInfo& a, const ItemInfo& b)
+        {
+            return a.Type == b.Type && std::bit_cast<uint64_t>(a.Location) == std::bit_cast<uint64_t>(b.Location)
+                && a.ItemHash == b.ItemHash && a.Value == b.Value;
+        }
+    }
+
+    const char* GetCallName(CallType type)
+    {
+        switch (type)
+        {
+            case CallType::WorldGetInfo: return "World_GetInfo";
+            case CallType::WorldGetStats: return "World_GetStats";
+            case CallType::NavMeshGetClosestPathPoint: return "NavMesh_GetClosestPathPoint";
+            case CallType::InventoryAddItem: return "Inventory_AddItem";
+            case CallType::InventoryUseItem: return "Inventory_UseItem";
+            case CallType::InventoryRemoveItem: return "Inventory_RemoveItem";
+            case CallType::InventoryGetItem: return "Inventory_GetItem";
+            case CallType::InventoryGetCapacity: return "Inventory_GetCapacity";
+            case CallType::GrabNearestItem: return "GrabNearestItem";
+            case CallType::GrabItem: return "GrabItem";
+            case CallType::DestroyItem: return "DestroyItem";
+            default: return "unknown call";
+        }
+    }
+
+    bool HasSameArguments(const Call& a, const Call& b)
+    {
+        if (a.Type != b.Type) return false;
+        switch (a.Type)
+        {
+            case CallType::NavMeshGetClosestPathPoint:
+                return std::bit_cast<uint64_t>(a.Goal) == std::bit_cast<uint64_t>(b.Goal);
+            case CallType::InventoryAddItem:
+                return a.Slot == b.Slot && IsSameItem(a.Item, b.Item);
+            case CallType::InventoryUseItem:
+            case CallType::InventoryRemoveItem:
+            case CallType::InventoryGetItem:
+                return a.Slot == b.Slot;
+            case CallType::GrabItem:
+            case CallType::DestroyItem:
+                return IsSameItem(a.Item, b.Item);
+            default:
+                return true;
+        }
+    }
+
+    void WriteCall(ByteWriter& writer, const Call& call, Elite::Vector2& previousGoal)
+    {
+        writer.WriteBytes(call.Type);
+        switch (call.Type)
+        {
+            case CallType::WorldGetInfo:
+                writer.WriteStruct(call.World);
+                break;
+            case CallType::WorldGetStats:
+                writer.WriteStruct(call.Stats);
+                break;
+            case CallType::NavMeshGetClosestPathPoint:
+                writer.WriteDelta(call.Goal, previousGoal);
+                writer.WriteDelta(call.PathPoint, call.Goal);
+                previousGoal = call.Goal;
+                break;
+            case CallType::InventoryAddItem:
+                writer.WriteVarUInt(call.Slot);
+                writer.WriteStructDelta(call.Item, ItemInfo{});
+                writer.WriteRaw(call.Result);
+                break;
+            case CallType::InventoryUseItem:
+            case CallType::InventoryRemoveItem:
+                writer.WriteVarUInt(call.Slot);
+                writer.WriteRaw(call.Result);
+                break;
+            case CallType::InventoryGetItem:
+                writer.WriteVarUInt(call.Slot);
+                writer.WriteRaw(call.Result);
+                // The item is only handed out with a true result
+                if (call.Result) writer.WriteStructDelta(call.Item, ItemInfo{});
+                break;
+            case CallType::InventoryGetCapacity:
+                writer.WriteVarUInt(call.Capacity);
+                break;
+            case CallType::GrabNearestItem:
+                writer.WriteRaw(call.Result);
+                if (call.Result) writer.WriteStructDelta(call.Item, ItemInfo{});
+                break;
+            case CallType::GrabItem:
+            case CallType::DestroyItem:
+                writer.WriteStructDelta(call.Item, ItemInfo{});
+                writer.WriteRaw(call.Result);
+                break;
+            default:
+                assert(false && "Unknown trajectory call type");
+                break;
+        }
+    }
+
+    void ReadCall(ByteReader& reader, Call& call, Elite::Vector2& previousGoal)
+    {
+        call = Call{};
+        reader.ReadBytes(call.Type);
+        switch (call.Type)
+        {
+            case CallType::WorldGetInfo:
+                reader.ReadStruct(call.World);
+                break;
+            case CallType::WorldGetStats:
+                reader.ReadStruct(call.Stats);
+                break;
+            case CallType::NavMeshGetClosestPathPoint:
+                reader.ReadDelta(call.Goal, previousGoal);
+                reader.ReadDelta(call.PathPoint, call.Goal);
+                previousGoal = call.Goal;
+                break;
+            case CallType::InventoryAddItem:
+                call.Slot = static_cast<UINT>(reader.ReadVarUInt());
+                reader.ReadStructDelta(call.Item, ItemInfo{});
+                reader.ReadRaw(call.Result);
+                break;
+            case CallType::InventoryUseItem:
+            case CallType::InventoryRemoveItem:
+                call.Slot = static_cast<UINT>(reader.ReadVarUInt());
+                reader.ReadRaw(call.Result);
+                break;
+            case CallType::InventoryGetItem:
+                call.Slot = static_cast<UINT>(reader.ReadVarUInt());
+                reader.ReadRaw(call.Result);
+                if (call.Result) reader.ReadStructDelta(call.Item, ItemInfo{});
+                break;
+            case CallType::InventoryGetCapacity:
+                call.Capacity = static_cast<UINT>(reader.ReadVarUInt());
+                break;
+            case CallType::GrabNearestItem:
+                reader.ReadRaw(call.Result);
+                if (call.Result) reader.ReadStructDelta(call.Item, ItemInfo{});
+                break;
+            case CallType::GrabItem:
+            case CallType::DestroyItem:
+                reader.ReadStructDelta(call.Item, ItemInfo{});
+                reader.ReadRaw(call.Result);
+                break;
+            default:
+                // Not a call this version writes, the rest of the section can't be decoded
+                reader.Invalidate();
+                break;
+        }
+    }
+}
@@ -0,0 +1,378 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+#include "Exam_HelperStructs.h"
+
+// Binary layout of the trajectories TrajectoryRecorder writes and TrajectoryReader reads back, all values little-endian.
+//
+// A file is a header followed by one record per frame, appended while the frames are played:
+//   header        magic "EXTR", version, seed of the run, size of a frame record, AgentInfo seen by Initialize
+//   frame record  fixed size, stored raw: frame index, dt, AgentInfo, FOVStats, steering output, size of the sections
+//   sections      the FOV entities (houses, enemies, items, purge zones), then the interface calls made since the
+//                 previous record with their arguments and results
+// The sections are varints. Every entity is delta-encoded against the entity it matches in the previous frame (same hash,
+// houses by index): floats as the XOR of their bits, integers as the zigzag difference, so a field that did not change
+// costs one byte. A run that was cut short leaves a partial last record, readers stop at the last complete one.
+namespace Trajectory
+{
+    constexpr char Magic[4]{'E', 'X', 'T', 'R'};
+    constexpr uint32_t Version = 1;
+
+    // Interface calls the agent's decisions depend on besides the observations the frame record holds
+    enum class CallType : uint8_t
+    {
+        WorldGetInfo,
+        WorldGetStats,
+        NavMeshGetClosestPathPoint,
+        InventoryAddItem,
+        InventoryUseItem,
+        InventoryRemoveItem,
+        InventoryGetItem,
+        InventoryGetCapacity,
+        GrabNearestItem,
+        GrabItem,
+        DestroyItem,
+        Count
+    };
+
+    const char* GetCallName(CallType type);
+
+    // One call with its arguments (Slot, Goal, the item passed in) and results (the rest, the item handed out)
+    struct Call final
+    {
+        CallType Type{};
+        UINT Slot = 0;
+        Elite::Vector2 Goal{};
+        ItemInfo Item{};
+        bool Result = false;
+        Elite::Vector2 PathPoint{};
+        WorldInfo World{};
+        StatisticsInfo Stats{};
+        UINT Capacity = 0;
+    };
+
+    // True if both calls have the same type and arguments, what a replay checks before it hands out the recorded results
+    bool HasSameArguments(const Call& a, const Call& b);
+
+#pragma region Fields
+    // The members that get stored, in file order
+    template<typename T>
+    struct Fields;
+
+    template<>
+    struct Fields<AgentInfo>
+    {
+        static constexpr std::tuple Members{
+            &AgentInfo::Stamina, &AgentInfo::Health, &AgentInfo::Energy, &AgentInfo::RunMode, &AgentInfo::IsInHouse,
+            &AgentInfo::Bitten, &AgentInfo::WasBitten, &AgentInfo::Death, &AgentInfo::FOV_Angle, &AgentInfo::FOV_Range,
+            &AgentInfo::LinearVelocity, &AgentInfo::AngularVelocity, &AgentInfo::CurrentLinearSpeed, &AgentInfo::Position,
+            &AgentInfo::Orientation, &AgentInfo::MaxLinearSpeed, &AgentInfo::MaxAngularSpeed, &AgentInfo::GrabRange,
+            &AgentInfo::AgentSize
+        };
+    };
+
+    template<>
+    struct Fields<FOVStats>
+    {
+        static constexpr std::tuple Members{
+            &FOVStats::NumHouses, &FOVStats::NumEnemies, &FOVStats::NumItems, &FOVStats::NumPurgeZones
+        };
+    };
+
+    template<>
+    struct Fields<SteeringPlugin_Output>
+    {
+        static constexpr std::tuple Members{
+            &SteeringPlugin_Output::LinearVelocity, &SteeringPlugin_Output::AngularVelocity,
+            &SteeringPlugin_Output::AutoOrient, &SteeringPlugin_Output::RunMode
+        };
+    };
+
+    template<>
+    struct Fields<WorldInfo>
+    {
+        static constexpr std::tuple Members{&WorldInfo::Center, &WorldInfo::Dimensions};
+    };
+
+    template<>
+    struct Fields<StatisticsInfo>
+    {
+        static constexpr std::tuple Members{
+            &StatisticsInfo::Score, &StatisticsInfo::Difficulty, &StatisticsInfo::TimeSurvived,
+            &StatisticsInfo::KillCountdown, &StatisticsInfo::NumEnemiesKilled, &StatisticsInfo::NumEnemiesHit,
+            &StatisticsInfo::NumItemsPickUp, &StatisticsInfo::NumMissedShots, &StatisticsInfo::NumChkpntsReached
+        };
+    };
+
+    // Entities also say which entity of the previous frame they are delta-encoded against
+    template<>
+    struct Fields<HouseInfo>
+    {
+        static constexpr std::tuple Members{&HouseInfo::Center, &HouseInfo::Size};
+        // Houses have no hash, the reference is the house at the same index
+        static bool IsSame(const HouseInfo&, const HouseInfo&) { return false; }
+    };
+
+    template<>
+    struct Fields<EnemyInfo>
+    {
+        static constexpr std::tuple Members{
+            &EnemyInfo::Type, &EnemyInfo::Location, &EnemyInfo::LinearVelocity, &EnemyInfo::EnemyHash, &EnemyInfo::Size,
+            &EnemyInfo::Health
+        };
+        static bool IsSame(const EnemyInfo& a, const EnemyInfo& b) { return a.EnemyHash == b.EnemyHash; }
+    };
+
+    template<>
+    struct Fields<ItemInfo>
+    {
+        static constexpr std::tuple Members{&ItemInfo::Type, &ItemInfo::Location, &ItemInfo::ItemHash, &ItemInfo::Value};
+        static bool IsSame(const ItemInfo& a, const ItemInfo& b) { return a.ItemHash == b.ItemHash; }
+    };
+
+    template<>
+    struct Fields<PurgeZoneInfo>
+    {
+        static constexpr std::tuple Members{&PurgeZoneInfo::Center, &PurgeZoneInfo::Radius, &PurgeZoneInfo::ZoneHash};
+        static bool IsSame(const PurgeZoneInfo& a, const PurgeZoneInfo& b) { return a.ZoneHash == b.ZoneHash; }
+    };
+
+    // Bytes of a field stored raw: bools take one, enums are stored as 32 bit integers
+    template<typename Field>
+    constexpr size_t RawFieldSize = std::is_same_v<Field, bool> ? 1 : (std::is_same_v<Field, Elite::Vector2> ? 8 : 4);
+
+    template<typename T>
+    constexpr size_t RawSize = std::apply([](auto... members)
+    {
+        return (RawFieldSize<std::remove_cvref_t<decltype(std::declval<T>().*members)>> + ...);
+    }, Fields<T>::Members);
+
+    // Index, dt, the raw structs and the size of the sections behind the record
+    constexpr size_t FrameRecordSize = 4 + 4 + RawSize<AgentInfo> + RawSize<FOVStats> + RawSize<SteeringPlugin_Output> + 4;
+    constexpr size_t HeaderSize = sizeof(Magic) + 4 + 4 + 4 + RawSize<AgentInfo>;
+#pragma endregion
+
+#pragma region Bytes
+    class ByteWriter final
+    {
+    public:
+        explicit ByteWriter(std::vector<uint8_t>& buffer): m_Buffer(buffer) {}
+
+        template<typename T>
+        void WriteBytes(const T& value)
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            const size_t offset = m_Buffer.size();
+            m_Buffer.resize(offset + sizeof(T));
+            memcpy(m_Buffer.data() + offset, &value, sizeof(T));
+        }
+
+        // LEB128: 7 bits per byte, the high bit says another byte follows
+        void WriteVarUInt(uint64_t value)
+        {
+            for (; value >= 0x80; value >>= 7) m_Buffer.push_back(static_cast<uint8_t>(value | 0x80));
+            m_Buffer.push_back(static_cast<uint8_t>(value));
+        }
+
+        // Zigzag maps small negative numbers to small varints too
+        void WriteVarInt(int64_t value)
+        {
+            WriteVarUInt((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+        }
+
+        template<typename Field>
+        void WriteRaw(const Field& field)
+        {
+            if constexpr (std::is_same_v<Field, Elite::Vector2>)
+            {
+                WriteBytes(field.x);
+                WriteBytes(field.y);
+            }
+            else if constexpr (std::is_same_v<Field, bool>) WriteBytes(static_cast<uint8_t>(field));
+            else if constexpr (std::is_enum_v<Field>) WriteBytes(static_cast<int32_t>(field));
+            else WriteBytes(field);
+        }
+
+        template<typename Field>
+        void WriteDelta(const Field& field, const Field& reference)
+        {
+            if constexpr (std::is_same_v<Field, Elite::Vector2>)
+            {
+                WriteDelta(field.x, reference.x);
+                WriteDelta(field.y, reference.y);
+            }
+            else if constexpr (std::is_same_v<Field, float>)
+                WriteVarUInt(std::bit_cast<uint32_t>(field) ^ std::bit_cast<uint32_t>(reference));
+            else if constexpr (std::is_same_v<Field, bool>) WriteBytes(static_cast<uint8_t>(field));
+            else WriteVarInt(static_cast<int64_t>(field) - static_cast<int64_t>(reference));
+        }
+
+        template<typename T>
+        void WriteStruct(const T& value)
+        {
+            std::apply([&](auto... members) { (WriteRaw(value.*members), ...); }, Fields<T>::Members);
+        }
+
+        template<typename T>
+        void WriteStructDelta(const T& value, const T& reference)
+        {
+            std::apply([&](auto... members) { (WriteDelta(value.*members, reference.*members), ...); }, Fields<T>::Members);
+        }
+
+        // The entities of one FOV list, each against its match in the previous frame's list
+        template<typename T>
+        void WriteEntities(const std::vector<T>& entities, const std::vector<T>& previous)
+        {
+            WriteVarUInt(entities.size());
+            for (size_t i{}; i < entities.size(); ++i)
+            {
+                size_t reference = i < previous.size() ? i : previous.size();
+                if (reference == previous.size() || !Fields<T>::IsSame(entities[i], previous[reference]))
+                {
+                    const auto it = std::ranges::find_if(previous, [&](const T& p) { return Fields<T>::IsSame(entities[i], p); });
+                    if (it != previous.end()) reference = static_cast<size_t>(it - previous.begin());
+                }
+                // 0 is no reference, the entity is stored against a zeroed one
+                WriteVarUInt(reference < previous.size() ? reference + 1 : 0);
+                WriteStructDelta(entities[i], reference < previous.size() ? previous[reference] : T{});
+            }
+        }
+
+    private:
+        std::vector<uint8_t>& m_Buffer;
+    };
+
+    // Reads what ByteWriter wrote. Reading past the end gives zeroes and makes the reader invalid for good
+    class ByteReader final
+    {
+    public:
+        ByteReader(const uint8_t* pData, size_t size): m_pData(pData), m_pEnd(pData + size) {}
+
+        [[nodiscard]] bool IsValid() const { return m_IsValid; }
+        [[nodiscard]] bool IsAtEnd() const { return m_pData == m_pEnd; }
+        void Invalidate() { m_IsValid = false; }
+
+        template<typename T>
+        void ReadBytes(T& value)
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            if (static_cast<size_t>(m_pEnd - m_pData) < sizeof(T))
+            {
+                m_IsValid = false;
+                value = T{};
+                return;
+            }
+            memcpy(&value, m_pData, sizeof(T));
+            m_pData += sizeof(T);
+        }
+
+        uint64_t ReadVarUInt()
+        {
+            uint64_t value{};
+            for (int shift{}; shift < 64; shift += 7)
+            {
+                if (m_pData == m_pEnd) break;
+                const uint8_t byte = *m_pData++;
+                value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if (!(byte & 0x80)) return value;
+            }
+            m_IsValid = false;
+            return 0;
+        }
+
+        int64_t ReadVarInt()
+        {
+            const uint64_t value = ReadVarUInt();
+            return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+        }
+
+        template<typename Field>
+        void ReadRaw(Field& field)
+        {
+            if constexpr (std::is_same_v<Field, Elite::Vector2>)
+            {
+                ReadBytes(field.x);
+                ReadBytes(field.y);
+            }
+            else if constexpr (std::is_same_v<Field, bool>)
+            {
+                uint8_t byte;
+                ReadBytes(byte);
+                field = byte != 0;
+            }
+            else if constexpr (std::is_enum_v<Field>)
+            {
+                int32_t value;
+                ReadBytes(value);
+                field = static_cast<Field>(value);
+            }
+            else ReadBytes(field);
+        }
+
+        template<typename Field>
+        void ReadDelta(Field& field, const Field& reference)
+        {
+            if constexpr (std::is_same_v<Field, Elite::Vector2>)
+            {
+                ReadDelta(field.x, reference.x);
+                ReadDelta(field.y, reference.y);
+            }
+            else if constexpr (std::is_same_v<Field, float>)
+                field = std::bit_cast<float>(static_cast<uint32_t>(ReadVarUInt()) ^ std::bit_cast<uint32_t>(reference));
+            else if constexpr (std::is_same_v<Field, bool>) ReadRaw(field);
+            else field = static_cast<Field>(static_cast<int64_t>(reference) + ReadVarInt());
+        }
+
+        template<typename T>
+        void ReadStruct(T& value)
+        {
+            std::apply([&](auto... members) { (ReadRaw(value.*members), ...); }, Fields<T>::Members);
+        }
+
+        template<typename T>
+        void ReadStructDelta(T& value, const T& reference)
+        {
+            std::apply([&](auto... members) { (ReadDelta(value.*members, reference.*members), ...); }, Fields<T>::Members);
+        }
+
+        // Reuses the capacity of entities, previous has to be the list the writer was given
+        template<typename T>
+        void ReadEntities(std::vector<T>& entities, const std::vector<T>& previous)
+        {
+            const uint64_t count = ReadVarUInt();
+            // Every entity takes at least one byte per field, a larger count is a corrupt file
+            if (count > static_cast<uint64_t>(m_pEnd - m_pData))
+            {
+                m_IsValid = false;
+                entities.clear();
+                return;
+            }
+            entities.resize(count);
+            for (T& entity: entities)
+            {
+                const uint64_t reference = ReadVarUInt();
+                if (reference > previous.size())
+                {
+                    m_IsValid = false;
+                    return;
+                }
+                ReadStructDelta(entity, reference > 0 ? previous[reference - 1] : T{});
+            }
+        }
+
+    private:
+        const uint8_t* m_pData;
+        const uint8_t* m_pEnd;
+        bool m_IsValid = true;
+    };
+#pragma endregion
+
+    // The goal of a navmesh query is stored against the previous goal, the path point against the goal
+    void WriteCall(ByteWriter& writer, const Call& call, Elite::Vector2& previousGoal);
+    void ReadCall(ByteReader& reader, Call& call, Elite::Vector2& previousGoal);
+}
@@ -0,0 +1,80 @@
+#include "../stdafx.h"
+#include "TrajectoryReader.h"
+#include <array>
+
+TrajectoryReader::~TrajectoryReader()
+{
+    if (m_pFile) fclose(m_pFile);
+}
+
+bool TrajectoryReader::Open(const std::string &path)
+{
+    assert(!m_pFile && "The trajectory is already open");
+    m_pFile = fopen(path.c_str(), "rb");
+    if (!m_pFile) return false;
+
+    m_Bytes.resize(Trajectory::HeaderSize);
+    m_NumBytes = fread(m_Bytes.data(), 1, m_Bytes.size(), m_pFile);
+    Trajectory::ByteReader reader{m_Bytes.data(), m_NumBytes};
+    std::array<char, sizeof(Trajectory::Magic)> magic;
+    uint32_t version;
+    int32_t seed;
+    uint32_t frameRecordSize;
+    reader.ReadBytes(magic);
+    reader.ReadBytes(version);
+    reader.ReadBytes(seed);
+    reader.ReadBytes(frameRecordSize);
+    reader.ReadStruct(m_InitialAgentInfo);
+    m_Seed = seed;
+    return reader.IsValid() && !memcmp(magic.data(), Trajectory::Magic, magic.size()) && version == Trajectory::Version
+        && frameRecordSize == Trajectory::FrameRecordSize;
+}
+
+const TrajectoryFrame *TrajectoryReader::ReadFrame()
+{
+    if (!m_pFile || m_IsTruncated) return nullptr;
+
+    m_Bytes.resize(Trajectory::FrameRecordSize);
+    const size_t numRecordBytes = fread(m_Bytes.data(), 1, m_Bytes.size(), m_pFile);
+    if (numRecordBytes != Trajectory::FrameRecordSize)
+    {
+        m_IsTruncated = numRecordBytes > 0;
+        return nullptr;
+    }
+
+    TrajectoryFrame &frame = m_Frames[m_NumFrames % 2];
+    const TrajectoryFrame &previous = m_Frames[(m_NumFrames + 1) % 2];
+    Trajectory::ByteReader record{m_Bytes.data(), m_Bytes.size()};
+    uint32_t sectionSize;
+    record.ReadBytes(frame.Index);
+    record.ReadBytes(frame.Dt);
+    record.ReadStruct(frame.Agent);
+    record.ReadStruct(frame.Stats);
+    record.ReadStruct(frame.Steering);
+    record.ReadBytes(sectionSize);
+
+    m_Bytes.resize(sectionSize);
+    if (fread(m_Bytes.data(), 1, sectionSize, m_pFile) != sectionSize)
+    {
+        m_IsTruncated = true;
+        return nullptr;
+    }
+    Trajectory::ByteReader sections{m_Bytes.data(), m_Bytes.size()};
+    sections.ReadEntities(frame.Houses, previous.Houses);
+    sections.ReadEntities(frame.Enemies, previous.Enemies);
+    sections.ReadEntities(frame.Items, previous.Items);
+    sections.ReadEntities(frame.PurgeZones, previous.PurgeZones);
+    const uint64_t numCalls = sections.ReadVarUInt();
+    // A call takes at least its type byte
+    frame.Calls.resize(sections.IsValid() && numCalls <= sectionSize ? numCalls : 0);
+    for (Trajectory::Call &call: frame.Calls) Trajectory::ReadCall(sections, call, m_PreviousGoal);
+    if (!sections.IsValid() || !sections.IsAtEnd() || frame.Index != m_NumFrames)
+    {
+        m_IsTruncated = true;
+        return nullptr;
+    }
+
+    m_NumBytes += Trajectory::FrameRecordSize + sectionSize;
+    ++m_NumFrames;
+    return &frame;
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "TrajectoryFormat.h"
+
+// One decoded frame of a trajectory
+struct TrajectoryFrame final
+{
+    uint32_t Index = 0;
+    float Dt = 0.f;
+    AgentInfo Agent{};
+    FOVStats Stats{};
+    SteeringPlugin_Output Steering{};
+    std::vector<HouseInfo> Houses{};
+    std::vector<EnemyInfo> Enemies{};
+    std::vector<ItemInfo> Items{};
+    std::vector<PurgeZoneInfo> PurgeZones{};
+    // Calls made since the previous frame, in call order
+    std::vector<Trajectory::Call> Calls{};
+};
+
+// Streams the frames of a trajectory written by TrajectoryRecorder, one at a time and in order.
+// The frames are decoded into two buffers that take turns, so the previous frame stays readable while the next
+// one is decoded and reading does not allocate once the buffers have grown to the largest frame.
+class TrajectoryReader final
+{
+public:
+    TrajectoryReader() = default;
+    ~TrajectoryReader();
+
+    TrajectoryReader(const TrajectoryReader&) = delete;
+    TrajectoryReader& operator=(const TrajectoryReader&) = delete;
+    TrajectoryReader(TrajectoryReader&&) = delete;
+    TrajectoryReader& operator=(TrajectoryReader&&) = delete;
+
+    // Opens the file and checks its header, false if it is not a trajectory of this version
+    bool Open(const std::string& path);
+
+    [[nodiscard]] int GetSeed() const { return m_Seed; }
+    // What Agent_GetInfo returned before the first frame, when the agent was constructed
+    [[nodiscard]] const AgentInfo& GetInitialAgentInfo() const { return m_InitialAgentInfo; }
+
+    // Decodes the next frame, nullptr at the end of the file. The frame stays valid until the second call after this one
+    const TrajectoryFrame* ReadFrame();
+    // True if reading stopped at a partial or corrupt frame instead of the end of the file
+    [[nodiscard]] bool IsTruncated() const { return m_IsTruncated; }
+
+    [[nodiscard]] size_t GetNumFrames() const { return m_NumFrames; }
+    [[nodiscard]] size_t GetNumBytes() const { return m_NumBytes; }
+
+private:
+    FILE* m_pFile = nullptr;
+    int m_Seed = 0;
+    AgentInfo m_InitialAgentInfo{};
+    bool m_IsTruncated = false;
+    size_t m_NumFrames = 0;
+    size_t m_NumBytes = 0;
+
+    TrajectoryFrame m_Frames[2]{};
+    std::vector<uint8_t> m_Bytes{};
+    Elite::Vector2 m_PreviousGoal{};
+};
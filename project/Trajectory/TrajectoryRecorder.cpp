@@ -0,0 +1,218 @@
+#include "../stdafx.h"
+#include "TrajectoryRecorder.h"
+
+using Trajectory::Call;
+using Trajectory::CallType;
+
+TrajectoryRecorder::TrajectoryRecorder(IExamInterface *const pInterface):
+    m_pInterface(pInterface)
+{
+}
+
+TrajectoryRecorder::~TrajectoryRecorder()
+{
+    if (m_pFile) fclose(m_pFile);
+}
+
+bool TrajectoryRecorder::Open(const std::string &path, int seed)
+{
+    assert(!m_pFile && "The trajectory is already open");
+    m_pFile = fopen(path.c_str(), "wb");
+    if (!m_pFile) return false;
+
+    std::vector<uint8_t> header{};
+    Trajectory::ByteWriter writer{header};
+    writer.WriteBytes(Trajectory::Magic);
+    writer.WriteBytes(Trajectory::Version);
+    writer.WriteBytes(static_cast<int32_t>(seed));
+    writer.WriteBytes(static_cast<uint32_t>(Trajectory::FrameRecordSize));
+    writer.WriteStruct(m_pInterface->Agent_GetInfo());
+    assert(header.size() == Trajectory::HeaderSize);
+    m_NumBytes = fwrite(header.data(), 1, header.size(), m_pFile);
+    return m_NumBytes == header.size();
+}
+
+void TrajectoryRecorder::RecordFrame(float dt, const SteeringPlugin_Output &steering)
+{
+    if (!m_pFile) return;
+
+    m_FrameBytes.clear();
+    Trajectory::ByteWriter writer{m_FrameBytes};
+    writer.WriteBytes(m_NumFrames);
+    writer.WriteBytes(dt);
+    writer.WriteStruct(m_AgentInfo);
+    writer.WriteStruct(m_FOVStats);
+    writer.WriteStruct(steering);
+    writer.WriteBytes(uint32_t{}); // Section size, filled in below
+    assert(m_FrameBytes.size() == Trajectory::FrameRecordSize);
+
+    writer.WriteEntities(m_Houses, m_PreviousHouses);
+    writer.WriteEntities(m_Enemies, m_PreviousEnemies);
+    writer.WriteEntities(m_Items, m_PreviousItems);
+    writer.WriteEntities(m_PurgeZones, m_PreviousPurgeZones);
+    writer.WriteVarUInt(m_NumCalls);
+    m_FrameBytes.insert(m_FrameBytes.end(), m_CallBytes.begin(), m_CallBytes.end());
+
+    const auto sectionSize = static_cast<uint32_t>(m_FrameBytes.size() - Trajectory::FrameRecordSize);
+    memcpy(m_FrameBytes.data() + Trajectory::FrameRecordSize - sizeof(sectionSize), &sectionSize, sizeof(sectionSize));
+    m_NumBytes += fwrite(m_FrameBytes.data(), 1, m_FrameBytes.size(), m_pFile);
+    ++m_NumFrames;
+
+    // This frame's lists become the reference of the next one, swapping keeps the capacity of both
+    m_PreviousHouses.swap(m_Houses);
+    m_PreviousEnemies.swap(m_Enemies);
+    m_PreviousItems.swap(m_Items);
+    m_PreviousPurgeZones.swap(m_PurgeZones);
+    m_Houses.clear();
+    m_Enemies.clear();
+    m_Items.clear();
+    m_PurgeZones.clear();
+    m_CallBytes.clear();
+    m_NumCalls = 0;
+}
+
+void TrajectoryRecorder::AddCall(const Call &call) const
+{
+    Trajectory::ByteWriter writer{m_CallBytes};
+    Trajectory::WriteCall(writer, call, m_PreviousGoal);
+    ++m_NumCalls;
+}
+
+#pragma region Observations
+AgentInfo TrajectoryRecorder::Agent_GetInfo() const
+{
+    m_AgentInfo = m_pInterface->Agent_GetInfo();
+    return m_AgentInfo;
+}
+
+const FOVStats& TrajectoryRecorder::FOV_GetStats() const
+{
+    const FOVStats& stats = m_pInterface->FOV_GetStats();
+    m_FOVStats = stats;
+    return stats;
+}
+
+std::vector<HouseInfo> TrajectoryRecorder::GetHousesInFOV() const
+{
+    std::vector<HouseInfo> houses = m_pInterface->GetHousesInFOV();
+    m_Houses.assign(houses.begin(), houses.end());
+    return houses;
+}
+
+std::vector<EnemyInfo> TrajectoryRecorder::GetEnemiesInFOV() const
+{
+    std::vector<EnemyInfo> enemies = m_pInterface->GetEnemiesInFOV();
+    m_Enemies.assign(enemies.begin(), enemies.end());
+    return enemies;
+}
+
+std::vector<PurgeZoneInfo> TrajectoryRecorder::GetPurgeZonesInFOV() const
+{
+    std::vector<PurgeZoneInfo> purgeZones = m_pInterface->GetPurgeZonesInFOV();
+    m_PurgeZones.assign(purgeZones.begin(), purgeZones.end());
+    return purgeZones;
+}
+
+std::vector<ItemInfo> TrajectoryRecorder::GetItemsInFOV() const
+{
+    std::vector<ItemInfo> items = m_pInterface->GetItemsInFOV();
+    m_Items.assign(items.begin(), items.end());
+    return items;
+}
+#pragma endregion
+
+#pragma region Calls
+WorldInfo TrajectoryRecorder::World_GetInfo() const
+{
+    Call call{CallType::WorldGetInfo};
+    call.World = m_pInterface->World_GetInfo();
+    AddCall(call);
+    return call.World;
+}
+
+StatisticsInfo TrajectoryRecorder::World_GetStats() const
+{
+    Call call{CallType::WorldGetStats};
+    call.Stats = m_pInterface->World_GetStats();
+    AddCall(call);
+    return call.Stats;
+}
+
+Elite::Vector2 TrajectoryRecorder::NavMesh_GetClosestPathPoint(Elite::Vector2 goal) const
+{
+    Call call{CallType::NavMeshGetClosestPathPoint};
+    call.Goal = goal;
+    call.PathPoint = m_pInterface->NavMesh_GetClosestPathPoint(goal);
+    AddCall(call);
+    return call.PathPoint;
+}
+
+bool TrajectoryRecorder::Inventory_AddItem(UINT slotId, ItemInfo item)
+{
+    Call call{CallType::InventoryAddItem, slotId};
+    call.Item = item;
+    call.Result = m_pInterface->Inventory_AddItem(slotId, item);
+    AddCall(call);
+    return call.Result;
+}
+
+bool TrajectoryRecorder::Inventory_UseItem(UINT slotId)
+{
+    Call call{CallType::InventoryUseItem, slotId};
+    call.Result = m_pInterface->Inventory_UseItem(slotId);
+    AddCall(call);
+    return call.Result;
+}
+
+bool TrajectoryRecorder::Inventory_RemoveItem(UINT slotId)
+{
+    Call call{CallType::InventoryRemoveItem, slotId};
+    call.Result = m_pInterface->Inventory_RemoveItem(slotId);
+    AddCall(call);
+    return call.Result;
+}
+
+bool TrajectoryRecorder::Inventory_GetItem(UINT slotId, ItemInfo &item)
+{
+    Call call{CallType::InventoryGetItem, slotId};
+    call.Result = m_pInterface->Inventory_GetItem(slotId, item);
+    call.Item = item;
+    AddCall(call);
+    return call.Result;
+}
+
+UINT TrajectoryRecorder::Inventory_GetCapacity() const
+{
+    Call call{CallType::InventoryGetCapacity};
+    call.Capacity = m_pInterface->Inventory_GetCapacity();
+    AddCall(call);
+    return call.Capacity;
+}
+
+bool TrajectoryRecorder::GrabNearestItem(ItemInfo &item)
+{
+    Call call{CallType::GrabNearestItem};
+    call.Result = m_pInterface->GrabNearestItem(item);
+    call.Item = item;
+    AddCall(call);
+    return call.Result;
+}
+
+bool TrajectoryRecorder::GrabItem(const ItemInfo &item)
+{
+    Call call{CallType::GrabItem};
+    call.Item = item;
+    call.Result = m_pInterface->GrabItem(item);
+    AddCall(call);
+    return call.Result;
+}
+
+bool TrajectoryRecorder::DestroyItem(const ItemInfo &item)
+{
+    Call call{CallType::DestroyItem};
+    call.Item = item;
+    call.Result = m_pInterface->DestroyItem(item);
+    AddCall(call);
+    return call.Result;
+}
+#pragma endregion
@@ -0,0 +1,132 @@
+#pragma once
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "IExamInterface.h"
+#include "TrajectoryFormat.h"
+
+// Records a run while it is played, in the format of TrajectoryFormat.h.
+// The recorder sits between the plugin and the framework's interface and forwards every call. It keeps what the
+// observation calls (AgentInfo, FOV) returned and logs the arguments and results of the calls that act on the world.
+// RecordFrame appends one frame: the observations, the steering the plugin chose and the calls made since the
+// previous frame. The file is only ever appended to, a run that ends in a crash still replays up to its last frame.
+// Rendering and input are forwarded without being recorded.
+class TrajectoryRecorder final : public IExamInterface
+{
+public:
+    explicit TrajectoryRecorder(IExamInterface* pInterface);
+    ~TrajectoryRecorder() override;
+
+    TrajectoryRecorder(const TrajectoryRecorder&) = delete;
+    TrajectoryRecorder& operator=(const TrajectoryRecorder&) = delete;
+    TrajectoryRecorder(TrajectoryRecorder&&) = delete;
+    TrajectoryRecorder& operator=(TrajectoryRecorder&&) = delete;
+
+    // Creates the file and writes the header with the AgentInfo the agent is constructed from, false if it can't
+    bool Open(const std::string& path, int seed);
+    // Appends the frame that ends with this steering output
+    void RecordFrame(float dt, const SteeringPlugin_Output& steering);
+
+    [[nodiscard]] bool IsOpen() const { return m_pFile != nullptr; }
+    [[nodiscard]] size_t GetNumFrames() const { return m_NumFrames; }
+    [[nodiscard]] size_t GetNumBytes() const { return m_NumBytes; }
+
+    //WORLD & ENTITIES
+    WorldInfo World_GetInfo() const override;
+    StatisticsInfo World_GetStats() const override;
+
+    std::vector<HouseInfo> GetHousesInFOV() const override;
+    std::vector<EnemyInfo> GetEnemiesInFOV() const override;
+    std::vector<PurgeZoneInfo> GetPurgeZonesInFOV() const override;
+    std::vector<ItemInfo> GetItemsInFOV() const override;
+
+    const FOVStats& FOV_GetStats() const override;
+
+    AgentInfo Agent_GetInfo() const override;
+
+    //NAVMESH
+    Elite::Vector2 NavMesh_GetClosestPathPoint(Elite::Vector2 goal) const override;
+
+    //INVENTORY
+    bool Inventory_AddItem(UINT slotId, ItemInfo item) override;
+    bool Inventory_UseItem(UINT slotId) override;
+    bool Inventory_RemoveItem(UINT slotId) override;
+    bool Inventory_GetItem(UINT slotId, ItemInfo& item) override;
+    UINT Inventory_GetCapacity() const override;
+
+    //ITEMS
+    bool GrabNearestItem(ItemInfo& item) override;
+    bool GrabItem(const ItemInfo& item) override;
+    bool DestroyItem(const ItemInfo& item) override;
+
+    //DEBUG
+    Elite::Vector2 Debug_ConvertScreenToWorld(Elite::Vector2 screenPos) const override
+    { return m_pInterface->Debug_ConvertScreenToWorld(screenPos); }
+    Elite::Vector2 Debug_ConvertWorldToScreen(Elite::Vector2 worldPos) const override
+    { return m_pInterface->Debug_ConvertWorldToScreen(worldPos); }
+
+    //INPUT
+    bool Input_IsKeyboardKeyDown(Elite::InputScancode key) const override { return m_pInterface->Input_IsKeyboardKeyDown(key); }
+    bool Input_IsKeyboardKeyUp(Elite::InputScancode key) const override { return m_pInterface->Input_IsKeyboardKeyUp(key); }
+    bool Input_IsMouseButtonDown(Elite::InputMouseButton button) const override { return m_pInterface->Input_IsMouseButtonDown(button); }
+    bool Input_IsMouseButtonUp(Elite::InputMouseButton button) const override { return m_pInterface->Input_IsMouseButtonUp(button); }
+    Elite::MouseData Input_GetMouseData(Elite::InputType type, Elite::InputMouseButton button) const override
+    { return m_pInterface->Input_GetMouseData(type, button); }
+
+    //EVENT
+    void RequestShutdown() const override { m_pInterface->RequestShutdown(); }
+
+    //RENDERER
+    void Draw_Polygon(const Elite::Vector2* points, int count, const Elite::Vector3& color, float depth) override
+    { m_pInterface->Draw_Polygon(points, count, color, depth); }
+    void Draw_SolidPolygon(const Elite::Vector2* points, int count, const Elite::Vector3& color, float depth, bool triangulate) override
+    { m_pInterface->Draw_SolidPolygon(points, count, color, depth, triangulate); }
+    void Draw_Circle(const Elite::Vector2& center, float radius, const Elite::Vector3& color, float depth) override
+    { m_pInterface->Draw_Circle(center, radius, color, depth); }
+    void Draw_SolidCircle(const Elite::Vector2& center, float32 radius, const Elite::Vector2& axis, const Elite::Vector3& color, float depth) override
+    { m_pInterface->Draw_SolidCircle(center, radius, axis, color, depth); }
+    void Draw_Segment(const Elite::Vector2& p1, const Elite::Vector2& p2, const Elite::Vector3& color, float depth) override
+    { m_pInterface->Draw_Segment(p1, p2, color, depth); }
+    void Draw_Direction(const Elite::Vector2& p, Elite::Vector2 dir, float length, const Elite::Vector3& color, float depth) override
+    { m_pInterface->Draw_Direction(p, dir, length, color, depth); }
+    void Draw_Transform(const b2Transform& xf, float depth) override { m_pInterface->Draw_Transform(xf, depth); }
+    void Draw_Point(const Elite::Vector2& p, float size, const Elite::Vector3& color, float depth) override
+    { m_pInterface->Draw_Point(p, size, color, depth); }
+    float NextDepthSlice() override { return m_pInterface->NextDepthSlice(); }
+
+    // Bring the non-virtual convenience overloads of IBaseInterface back into scope
+    using IBaseInterface::Draw_Polygon;
+    using IBaseInterface::Draw_SolidPolygon;
+    using IBaseInterface::Draw_Circle;
+    using IBaseInterface::Draw_SolidCircle;
+    using IBaseInterface::Draw_Segment;
+    using IBaseInterface::Draw_Transform;
+    using IBaseInterface::Draw_Point;
+
+private:
+    void AddCall(const Trajectory::Call& call) const;
+
+    IExamInterface* m_pInterface;
+    FILE* m_pFile = nullptr;
+    uint32_t m_NumFrames = 0;
+    size_t m_NumBytes = 0;
+
+    // What the observation calls returned since the previous frame, the FOV lists that were not asked for stay empty
+    mutable AgentInfo m_AgentInfo{};
+    mutable FOVStats m_FOVStats{};
+    mutable std::vector<HouseInfo> m_Houses{};
+    mutable std::vector<EnemyInfo> m_Enemies{};
+    mutable std::vector<ItemInfo> m_Items{};
+    mutable std::vector<PurgeZoneInfo> m_PurgeZones{};
+    // The lists of the previous frame, the entities are delta-encoded against them
+    std::vector<HouseInfo> m_PreviousHouses{};
+    std::vector<EnemyInfo> m_PreviousEnemies{};
+    std::vector<ItemInfo> m_PreviousItems{};
+    std::vector<PurgeZoneInfo> m_PreviousPurgeZones{};
+
+    // Calls since the previous frame, already encoded
+    mutable std::vector<uint8_t> m_CallBytes{};
+    mutable uint32_t m_NumCalls = 0;
+    mutable Elite::Vector2 m_PreviousGoal{};
+    std::vector<uint8_t> m_FrameBytes{};
+};
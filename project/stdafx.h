@@ -31,11 +31,17 @@
 #include <GL/gl3w.h>
 #include <ImGui/imgui.h>
 #include <SDL2/SDL.h>
+#ifdef _WIN32
 #include <SDL2/SDL_syswm.h>
+#endif
 
 #include "EliteMath/EMath.h"
 #include "EliteInput/EInputCodes.h"
 #include "EliteInput/EInputData.h"
 #pragma endregion
 
+#ifndef _WIN32
+typedef unsigned int UINT;
+#endif
+
 #define SAFE_DELETE(p) if (p) { delete (p); (p) = nullptr; }